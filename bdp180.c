@@ -80,22 +80,6 @@ static void bdp180LongSum(u64 *augend, u64 *addend, u64 *result, u64 *carry);
 **  -----------------
 */
 
-//
-// Masks used in merging bytes into words
-//
-static u64 mergeMasks[9] =
-    {
-    0xffffffffffffffff,
-    0x00ffffffffffffff,
-    0x0000ffffffffffff,
-    0x000000ffffffffff,
-    0x00000000ffffffff,
-    0x0000000000ffffff,
-    0x000000000000ffff,
-    0x00000000000000ff,
-    0x0000000000000000
-    };
-
 //
 // Maximum allowed length of each BDP operand type
 //
@@ -277,74 +261,12 @@ void bdp180AddDigit(BdpOperand *operand, u8 digit)
 **------------------------------------------------------------------------*/
 bool bdp180CopyFromBuf(Cpu180Context *ctx, u64 pva, u16 count, u8 *buffer)
     {
-    u8               *bp;
     MonitorCondition cond;
-    u16              i;
-    u64              mask;
-    u16              n;
-    u32              rmas[32];
-    u8               shift;
-    u64              word;
-    u32              wordAddr;
 
-    //
-    //  Copy bytes from the buffer to the destination block. Optimize the copy by storing
-    //  whole words in memory.
-    //
-    bp = buffer;
-    if ((pva & Mask3) != 0 && count > 0)
-        {
-        //
-        // Destination not word-aligned, so copy enough bytes to reach next word boundary
-        //
-        n     = 8 - (pva & Mask3);
-        shift = (u8)((n - 1) << 3);
-        if (n > count)
-            {
-            n = count;
-            }
-        if (cpu180TranslatePvaSequence(ctx, pva, 1, (u8)n, RingOf(pva), AccessModeWrite, rmas, &cond) == FALSE)
-            {
-            cpu180SetMonitorCondition(ctx, cond);
-            return FALSE;
-            }
-        pva     += n;
-        count   -= n;
-        wordAddr = rmas[0] >> 3;
-        word     = cpMem[wordAddr];
-        while (n-- > 0)
-            {
-            mask   = ~((u64)0xffU << shift);
-            word   = (word & mask) | ((u64)*bp++ << shift);
-            shift -= 8;
-            }
-        cpMem[wordAddr] = word;
-        }
-    if (count > 0)
+    if (cpu180WriteBytes(ctx, pva, count, RingOf(pva), buffer, &cond) == FALSE)
         {
-        //
-        // Copy up to eight bytes at a time, word-aligned
-        //
-        if (cpu180TranslatePvaSequence(ctx, pva, (count + 7) >> 3, 8, RingOf(pva), AccessModeWrite, rmas, &cond) == FALSE)
-            {
-            cpu180SetMonitorCondition(ctx, cond);
-            return FALSE;
-            }
-        i = 0;
-        while (count > 0) // copy a whole word at a time
-            {
-            n        = (count >= 8) ? 8 : count;
-            count   -= n;
-            wordAddr = rmas[i++] >> 3;
-            word     = cpMem[wordAddr] & mergeMasks[n];
-            shift    = 56;
-            while (n-- > 0)
-                {
-                word  |= (u64)*bp++ << shift;
-                shift -= 8;
-                }
-            cpMem[wordAddr] = word;
-            }
+        cpu180SetMonitorCondition(ctx, cond);
+        return FALSE;
         }
 
     return TRUE;
@@ -364,68 +286,12 @@ bool bdp180CopyFromBuf(Cpu180Context *ctx, u64 pva, u16 count, u8 *buffer)
 **------------------------------------------------------------------------*/
 bool bdp180CopyToBuf(Cpu180Context *ctx, u64 pva, u16 count, u8 *buffer)
     {
-    u8               *bp;
     MonitorCondition cond;
-    u8               i;
-    u16              n;
-    u32              rmas[32];
-    u8               shift;
-    u64              word;
 
-    //
-    //  Copy bytes of the source block to the buffer. Optimize the copy by fetching
-    //  whole words from memory.
-    //
-    bp = buffer;
-    if ((pva & Mask3) != 0 && count > 0)
+    if (cpu180ReadBytes(ctx, pva, count, RingOf(pva), AccessModeRead, buffer, &cond) == FALSE)
         {
-        //
-        // Source not word-aligned, so copy enough bytes to reach next word boundary
-        //
-        n     = 8 - (pva & Mask3);
-        shift = (u8)((n - 1) << 3);
-        if (n > count)
-            {
-            n = count;
-            }
-        if (cpu180TranslatePvaSequence(ctx, pva, 1, (u8)n, RingOf(pva), AccessModeRead, rmas, &cond) == FALSE)
-            {
-            cpu180SetMonitorCondition(ctx, cond);
-            return FALSE;
-            }
-        pva   += n;
-        count -= n;
-        word   = cpMem[rmas[0] >> 3];
-        while (n-- > 0)
-            {
-            *bp++  = (u8)(word >> shift);
-            shift -= 8;
-            }
-        }
-    //
-    // Copy a whole word at a time
-    //
-    if (count > 0)
-        {
-        n = (count + 7) >> 3;
-        if (cpu180TranslatePvaSequence(ctx, pva, n, 8, RingOf(pva), AccessModeRead, rmas, &cond) == FALSE)
-            {
-            cpu180SetMonitorCondition(ctx, cond);
-            return FALSE;
-            }
-        i = 0;
-        while (count > 0)
-            {
-            n      = (count >= 8) ? 8 : count;
-            word   = cpMem[rmas[i++] >> 3];
-            count -= n;
-            shift  = 56;
-            while (n-- > 0)
-                {
-                *bp++  = (u8)(word >> shift);
-                shift -= 8;
-                }
-            }
+        cpu180SetMonitorCondition(ctx, cond);
+        return FALSE;
         }
 
     return TRUE;
@@ -1023,7 +1023,7 @@ void cdcnetCheckStatus(void)
 
             case StTcpConnected:
             case StUdpBound:
-                if (gp->unackedBlocks < 7)
+                if ((gp->unackedBlocks < 7) && !npuBipIsCongested())
                     {
                     FD_SET(gp->connFd, &readFds);
                     if (gp->connFd > maxFd)
@@ -59,6 +59,8 @@
 **  Private Function Prototypes
 **  ---------------------------
 */
+static void channelDisconnectExpired(void *arg);
+static void channelStatusExpired(void *arg);
 
 /*
 **  ----------------
@@ -113,6 +115,8 @@ void channelInit(u8 count)
     for (ch = 0; ch < MaxChannels; ch++)
         {
         channel[ch].id = ch;
+        schedInitEvent(&channel[ch].statusEvent, channelStatusExpired, &channel[ch]);
+        schedInitEvent(&channel[ch].disconnectEvent, channelDisconnectExpired, &channel[ch]);
         }
 
     /*
@@ -347,6 +351,11 @@ void channelTerminate(void)
                 dcc6681Terminate(dp);
                 }
 
+            if (dp->devType == DtDd8xx)
+                {
+                dd8xxTerminate(dp);
+                }
+
             if (dp->devType == DtMt669)
                 {
                 mt669Terminate(dp);
@@ -362,7 +371,8 @@ void channelTerminate(void)
                 }
 
             /*
-            **  Free all unit contexts and close all open files.
+            **  Free all unit contexts and close all open files, saving RAM
+            **  disks which are to be kept.
             */
             for (i = 0; i < MaxUnits; i++)
                 {
@@ -373,7 +383,7 @@ void channelTerminate(void)
 
                 if (dp->fcb[i] != NULL)
                     {
-                    fclose(dp->fcb[i]);
+                    ramDiskClose(dp->fcb[i]);
                     }
                 }
             }
@@ -707,7 +717,8 @@ void channelSetFull(void)
             }
         }
 
-    activeChannel->full = TRUE;
+    activeChannel->full       = TRUE;
+    activeChannel->wordCount += 1;
     }
 
 /*--------------------------------------------------------------------------
@@ -729,42 +740,84 @@ void channelSetEmpty(void)
             }
         }
 
-    activeChannel->full = FALSE;
+    activeChannel->full       = FALSE;
+    activeChannel->wordCount += 1;
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Handle delayed channel disconnect.
+**  Purpose:        Delay the disconnect of a channel.
 **
 **  Parameters:     Name        Description.
+**                  cc          channel
+**                  cycles      number of major cycles before disconnect
 **
 **  Returns:        Nothing.
 **
 **------------------------------------------------------------------------*/
-void channelStep(void)
+void channelDelayDisconnect(ChSlot *cc, u8 cycles)
     {
-    ChSlot *cc;
+    cc->delayDisconnect = cycles;
+    schedAfter(&cc->disconnectEvent, cycles);
+    }
 
-    /*
-    **  Process any delayed disconnects.
-    */
-    for (ch = 0; ch < channelCount; ch++)
-        {
-        cc = &channel[ch];
-        if (cc->delayDisconnect != 0)
-            {
-            cc->delayDisconnect -= 1;
-            if (cc->delayDisconnect == 0)
-                {
-                cc->active         = FALSE;
-                cc->discAfterInput = FALSE;
-                }
-            }
+/*--------------------------------------------------------------------------
+**  Purpose:        Delay the change of a channel's empty/full status.
+**
+**  Parameters:     Name        Description.
+**                  cc          channel
+**                  cycles      number of major cycles of delay
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void channelDelayStatus(ChSlot *cc, u8 cycles)
+    {
+    cc->delayStatus = cycles;
+    schedAfter(&cc->statusEvent, cycles);
+    }
 
-        if (cc->delayStatus != 0)
-            {
-            cc->delayStatus -= 1;
-            }
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Handle delayed channel disconnect. Nothing is done if
+**                  the delay was cancelled in the meantime.
+**
+**  Parameters:     Name        Description.
+**                  arg         channel
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void channelDisconnectExpired(void *arg)
+    {
+    ChSlot *cc = (ChSlot *)arg;
+
+    if (cc->delayDisconnect != 0)
+        {
+        cc->delayDisconnect = 0;
+        cc->active          = FALSE;
+        cc->discAfterInput  = FALSE;
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        End a delayed change of channel status.
+**
+**  Parameters:     Name        Description.
+**                  arg         channel
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void channelStatusExpired(void *arg)
+    {
+    ((ChSlot *)arg)->delayStatus = 0;
+    }
+
 /*---------------------------  End Of File  ------------------------------*/
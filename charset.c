@@ -5,7 +5,9 @@
 **  Name: charset.c
 **
 **  Description:
-**      CDC 6600 character set conversions.
+**      CDC 6600 character set conversions, and conversion of whole
+**      buffers between character sets and between 8 bit bytes, PP
+**      words and 60 bit words.
 **
 **  This program is free software: you can redistribute it and/or modify
 **  it under the terms of the GNU General Public License version 3 as
@@ -491,4 +493,182 @@ const unsigned char platoStringToAscii[4][65] =
     "\001\001\001\xa9\001\001\xc6\xd8|\xc5\xc4\001\001\001\001\001\001\001\001\001\001\001\001\001\xd6\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001\001"
     };
 
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Pack 8 bit bytes into 12 bit PP words, three bytes to
+**                  two words. A partial last word is zero filled.
+**
+**  Parameters:     Name        Description.
+**                  dst         PP words
+**                  src         bytes
+**                  len         number of bytes
+**
+**  Returns:        Number of PP words stored.
+**
+**------------------------------------------------------------------------*/
+int charsetPack8To12(PpWord *dst, const u8 *src, int len)
+    {
+    u8       c1, c2, c3;
+    const u8 *end;
+
+    end = src + (len - (len % 3));
+    while (src < end)
+        {
+        c1     = src[0];
+        c2     = src[1];
+        c3     = src[2];
+        dst[0] = (PpWord)((c1 << 4) | (c2 >> 4));
+        dst[1] = (PpWord)(((c2 & 0x0F) << 8) | c3);
+        src   += 3;
+        dst   += 2;
+        }
+
+    switch (len % 3)
+        {
+    case 1:
+        dst[0] = (PpWord)(src[0] << 4);
+        break;
+
+    case 2:
+        dst[0] = (PpWord)((src[0] << 4) | (src[1] >> 4));
+        dst[1] = (PpWord)((src[1] & 0x0F) << 8);
+        break;
+
+    default:
+        break;
+        }
+
+    return ((len * 2) + 2) / 3;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Translate a buffer through a character set table.
+**                  The source and destination may be the same buffer.
+**
+**  Parameters:     Name        Description.
+**                  dst         translated characters
+**                  src         characters to translate
+**                  len         number of characters
+**                  table       conversion table indexed by source
+**                              character
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void charsetTranslate(u8 *dst, const u8 *src, int len, const u8 *table)
+    {
+    u8 c0, c1, c2, c3, c4, c5, c6, c7;
+
+    /*
+    **  Eight characters are looked up before any is stored, so the
+    **  lookups are independent of the stores and of each other.
+    */
+    while (len >= 8)
+        {
+        c0     = table[src[0]];
+        c1     = table[src[1]];
+        c2     = table[src[2]];
+        c3     = table[src[3]];
+        c4     = table[src[4]];
+        c5     = table[src[5]];
+        c6     = table[src[6]];
+        c7     = table[src[7]];
+        dst[0] = c0;
+        dst[1] = c1;
+        dst[2] = c2;
+        dst[3] = c3;
+        dst[4] = c4;
+        dst[5] = c5;
+        dst[6] = c6;
+        dst[7] = c7;
+        src   += 8;
+        dst   += 8;
+        len   -= 8;
+        }
+
+    while (len-- > 0)
+        {
+        *dst++ = table[*src++];
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Unpack 12 bit PP words into 8 bit bytes, two words to
+**                  three bytes. An odd last word yields one byte and a
+**                  byte holding its low four bits, zero filled.
+**
+**  Parameters:     Name        Description.
+**                  dst         bytes
+**                  src         PP words
+**                  words       number of PP words
+**
+**  Returns:        Number of bytes stored.
+**
+**------------------------------------------------------------------------*/
+int charsetUnpack12To8(u8 *dst, const PpWord *src, int words)
+    {
+    const PpWord *end;
+    PpWord       w1, w2;
+
+    end = src + (words & ~1);
+    while (src < end)
+        {
+        w1     = src[0];
+        w2     = src[1];
+        dst[0] = (u8)(w1 >> 4);
+        dst[1] = (u8)(((w1 << 4) & 0xF0) | ((w2 >> 8) & 0x0F));
+        dst[2] = (u8)w2;
+        src   += 2;
+        dst   += 3;
+        }
+
+    if ((words & 1) != 0)
+        {
+        dst[0] = (u8)(src[0] >> 4);
+        dst[1] = (u8)((src[0] << 4) & 0xF0);
+        }
+
+    return ((words * 3) + 1) / 2;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Unpack 60 bit words into 6 bit characters, ten to a
+**                  word.
+**
+**  Parameters:     Name        Description.
+**                  dst         6 bit characters, right justified
+**                  src         60 bit words
+**                  words       number of words
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void charsetUnpack60To6(u8 *dst, const CpWord *src, int words)
+    {
+    CpWord word;
+
+    while (words-- > 0)
+        {
+        word   = *src++;
+        dst[0] = (u8)((word >> 54) & Mask6);
+        dst[1] = (u8)((word >> 48) & Mask6);
+        dst[2] = (u8)((word >> 42) & Mask6);
+        dst[3] = (u8)((word >> 36) & Mask6);
+        dst[4] = (u8)((word >> 30) & Mask6);
+        dst[5] = (u8)((word >> 24) & Mask6);
+        dst[6] = (u8)((word >> 18) & Mask6);
+        dst[7] = (u8)((word >> 12) & Mask6);
+        dst[8] = (u8)((word >> 6) & Mask6);
+        dst[9] = (u8)(word & Mask6);
+        dst   += 10;
+        }
+    }
+
 /*---------------------------  End Of File  ------------------------------*/
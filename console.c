@@ -236,39 +236,41 @@ long widthPX;
 **  Private Variables
 **  -----------------
 */
-static bool      doOpenConsoleWindow   = TRUE;
-static bool      isConsoleWindowOpen   = FALSE;
-
-static u8        consoleChannelNo;
-static u8        consoleEqNo;
-
-static CycleData *currentCycleData;
-static int       currentCycleDataIndex = 0;
-static CycleData cycleDataSequences[MaxCycleDataEntries];
-static u64       minRefreshInterval;
-static u64       earliestCycleFlush;
-
-static u8        currentFontType       = FontTypeSmall;
-static u16       currentIncrement      = 8;
-static u8        currentScreen         = 0xff;
-static u16       currentX              = 0;
-static u16       currentY              = 0;
-static u8        fontSizes[4]          = { FontDot, FontSmall, FontMedium, FontLarge };
-static u16       xOffsets[2]           = { OffLeftScreen, OffRightScreen };
-
-static SOCKET    connFd                = INVALID_SOCKET;
-static SOCKET    listenFd              = INVALID_SOCKET;
-
-static u8        cycleDataBuf[CycleDataBufSize];
-static int       cycleDataIn           = 0;
-static int       cycleDataOut          = 0;
-
-static u8        inBuf[InBufSize];
-static int       inBufIn               = 0;
-static int       inBufOut              = 0;
-
-static u8        outBuf[OutBufSize];
-static int       outBufIn              = 0;
+static bool         doOpenConsoleWindow   = TRUE;
+static bool         isConsoleWindowOpen   = FALSE;
+
+static u8           consoleChannelNo;
+static u8           consoleEqNo;
+
+static CycleData    *currentCycleData;
+static int          currentCycleDataIndex = 0;
+static CycleData    cycleDataSequences[MaxCycleDataEntries];
+static u64          minRefreshInterval;
+static u64          earliestCycleFlush;
+
+static u8           currentFontType       = FontTypeSmall;
+static u16          currentIncrement      = 8;
+static u8           currentScreen         = 0xff;
+static u16          currentX              = 0;
+static u16          currentY              = 0;
+static u8           fontSizes[4]          = { FontDot, FontSmall, FontMedium, FontLarge };
+static u16          xOffsets[2]           = { OffLeftScreen, OffRightScreen };
+
+static SOCKET       connFd                = INVALID_SOCKET;
+static NetPollEntry connPoll;
+static SOCKET       listenFd              = INVALID_SOCKET;
+static NetPollEntry listenPoll;
+
+static u8           cycleDataBuf[CycleDataBufSize];
+static int          cycleDataIn           = 0;
+static int          cycleDataOut          = 0;
+
+static u8           inBuf[InBufSize];
+static int          inBufIn               = 0;
+static int          inBufOut              = 0;
+
+static u8           outBuf[OutBufSize];
+static int          outBufIn              = 0;
 
 #if DEBUG
 static FILE *consoleLog   = NULL;
@@ -353,6 +355,7 @@ void consoleInit(u8 eqNo, u8 unitNo, u8 channelNo, char *params)
             logDtError(LogErrorLocation, "Failed to listen for TCP connections on port %d\n", consolePort);
             exit(1);
             }
+        netPollAdd(&listenPoll, listenFd, NetPollIn);
         fprintf(stdout, "(console) Listening for connections on port %d\n", consolePort);
         }
 
@@ -361,7 +364,7 @@ void consoleInit(u8 eqNo, u8 unitNo, u8 channelNo, char *params)
     /*
     **  Open console window, if enabled.
     */
-    if (doOpenConsoleWindow)
+    if (doOpenConsoleWindow && !benchmarkMode)
         {
         windowInit();
         isConsoleWindowOpen = TRUE;
@@ -387,6 +390,7 @@ void consoleCloseRemote(void)
     {
     if (connFd != INVALID_SOCKET)
         {
+        netPollRemove(&connPoll);
         netCloseConnection(connFd);
         connFd      = INVALID_SOCKET;
         cycleDataIn = cycleDataOut = 0;
@@ -663,18 +667,13 @@ static void consoleIo(void)
 **------------------------------------------------------------------------*/
 static void consoleAcceptConnection(void)
     {
-    int            n;
-    fd_set         readFds;
-    struct timeval timeout;
-
-    FD_ZERO(&readFds);
-    FD_SET(listenFd, &readFds);
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select((int)(listenFd + 1), &readFds, NULL, NULL, &timeout);
-    if (n > 0)
+    if (netPollTake(&listenPoll, NetPollIn))
         {
         connFd = netAcceptConnection(listenFd);
+        if (connFd != INVALID_SOCKET)
+            {
+            netPollAdd(&connPoll, connFd, NetPollIn);
+            }
         consoleInitCycleData();
         consoleQueueCurState();
         minRefreshInterval = InfiniteRefreshInterval;
@@ -875,16 +874,8 @@ static void consoleInitCycleData(void)
 **------------------------------------------------------------------------*/
 static void consoleNetIo(void)
     {
-    u8             ch;
-    ssize_t        n;
-    fd_set         readFds;
-    struct timeval timeout;
-
-    FD_ZERO(&readFds);
-    FD_SET(connFd, &readFds);
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select((int)(connFd + 1), &readFds, NULL, NULL, &timeout);
+    u8      ch;
+    ssize_t n;
 
     if ((ppKeyIn == 0) && (inBufOut < inBufIn))
         {
@@ -919,7 +910,8 @@ static void consoleNetIo(void)
             inBufIn = inBufOut = 0;
             }
         }
-    if ((n > 0) && (inBufIn < InBufSize) && FD_ISSET(connFd, &readFds))
+    netPollWant(&connPoll, inBufIn < InBufSize ? NetPollIn : 0);
+    if (netPollTake(&connPoll, NetPollIn))
         {
         n = recv(connFd, &inBuf[inBufIn], InBufSize - inBufIn, 0);
         if (n <= 0)
@@ -123,6 +123,18 @@
 #define DtMSUFrend                 31
 #define DtHcp                      32
 
+#define MaxDevTypes                33
+
+/*
+**  Kinds of disk and tape operation recorded per unit, and the number
+**  of power of two microsecond buckets in their host latency histograms.
+*/
+#define MetricsIoRead              0
+#define MetricsIoWrite             1
+#define MetricsIoPosition          2
+#define MetricsIoKinds             3
+#define MetricsLatencyBuckets      16
+
 /*
 **  Special channels.
 */
@@ -283,6 +295,12 @@
 #define MaskActive                 0x4000
 #define MaskFull                   0x2000
 
+/*
+**  Socket readiness reported by the network poller.
+*/
+#define NetPollIn                  0x01
+#define NetPollOut                 0x02
+
 /*
 **  ----------------------
 **  Public Macro Functions
@@ -42,7 +42,11 @@
 #if defined(_WIN32)
 #include <windows.h>
 #else
+#include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -69,6 +73,17 @@
 #define EcsBankSize            (131072 - 5120)
 #define EsmBankSize            131072
 
+/*
+**  Number of 4-bit EM flag registers (models 865 and 875).
+*/
+#define EcsFlagRegisterCount   16384
+
+/*
+**  Identification of a shared extended memory segment ("DTEM").
+*/
+#define EcsSharedMagic         0x4454454D
+#define EcsSharedVersion       2
+
 /*
 **  -----------------------
 **  Private Macro Functions
@@ -80,6 +95,30 @@
 **  Private Typedef and Structure Definitions
 **  -----------------------------------------
 */
+
+/*
+**  Header of an extended memory segment shared by several emulators on
+**  the same host. The flag registers live here so that all hosts see the
+**  same flags, the memory words follow the header. The header size is a
+**  multiple of 8 so the words are naturally aligned. The flag lock is a
+**  robust process-shared mutex, so an emulator which dies holding it
+**  does not hang the others. macOS has no robust mutexes, so there it
+**  is a plain process-shared mutex.
+*/
+typedef struct ecsSharedHeader
+    {
+    volatile u32    magic;
+    u32             version;
+    u32             words;
+    u32             emType;
+    volatile u32    attachCount;
+    volatile u32    flagRegister;
+#if !defined(_WIN32)
+    pthread_mutex_t flagLock;
+#endif
+    volatile u8     flagRegisters16K[EcsFlagRegisterCount];
+    } EcsSharedHeader;
+
 typedef struct opDispatch
     {
     void (*execute)(Cpu170Context *activeCpu);
@@ -113,7 +152,10 @@ static bool cpuCmuGetByte(Cpu170Context *activeCpu, u32 address, u32 pos, u8 *by
 static void cpuCmuMoveDirect(Cpu170Context *activeCpu);
 static void cpuCmuMoveIndirect(Cpu170Context *activeCpu);
 static bool cpuCmuPutByte(Cpu170Context *activeCpu, u32 address, u32 pos, u8 byte);
+static void cpuEcsLockFlags(void);
+static bool cpuEcsMapShared(u32 words, ExtMemory emType);
 static void cpuEcsTransfer(Cpu170Context *activeCpu, bool writeToEcs);
+static void cpuEcsUnlockFlags(void);
 static void cpuEcsWord(Cpu170Context *activeCpu, bool writeToEcs);
 static void cpuExchangeJump(Cpu170Context *activeCpu, u32 address, bool doChangeMode);
 static void cpuExchangeTo180(Cpu170Context *activeCpu, bool setSysCall, bool setExitModeHalt);
@@ -219,8 +261,11 @@ Cpu170Context   *cpus170;
 static FILE *cmHandle;
 static FILE *ecsHandle;
 
-static volatile u32 ecsFlagRegister = 0;
-static volatile u8  ecs16Kx4bitFlagRegisters[16384];
+static volatile u32 ecsPrivateFlagRegister = 0;
+static volatile u8  ecsPrivateFlagRegisters16K[EcsFlagRegisterCount];
+static volatile u32 *ecsFlagRegister          = &ecsPrivateFlagRegister;
+static volatile u8  *ecs16Kx4bitFlagRegisters = ecsPrivateFlagRegisters16K;
+static EcsSharedHeader *ecsShared             = NULL;
 
 #if CcSMM_EJT
 static int skipStep = 0;
@@ -341,9 +386,10 @@ static u8 cpOp01Length[8] = { 30, 30, 30, 30, 15, 15, 15, 30 };
 **------------------------------------------------------------------------*/
 void cpuInit(char *model, u16 *serialNumbers, u32 memory, u32 emBanks, ExtMemory emType)
     {
-    int cpuNum;
-    u32 extBanksSize = 0;
-    int i;
+    int  cpuNum;
+    u32  extBanksSize = 0;
+    int  i;
+    bool isEcsLoadable;
 
     /*
     **  Allocate configured central memory.
@@ -373,13 +419,22 @@ void cpuInit(char *model, u16 *serialNumbers, u32 memory, u32 emBanks, ExtMemory
         }
 
     /*
-    **  Allocate configured ECS memory.
+    **  Allocate configured ECS memory, or attach to ECS shared with other
+    **  emulators on this host.
     */
-    extMem = calloc(emBanks * extBanksSize, sizeof(CpWord));
-    if (extMem == NULL)
+    isEcsLoadable = TRUE;
+    if ((ecsSharedName[0] != '\0') && (emBanks > 0))
         {
-        logDtError(LogErrorLocation, "Failed to allocate ECS memory\n");
-        exit(1);
+        isEcsLoadable = cpuEcsMapShared(emBanks * extBanksSize, emType);
+        }
+    else
+        {
+        extMem = calloc(emBanks * extBanksSize, sizeof(CpWord));
+        if (extMem == NULL)
+            {
+            logDtError(LogErrorLocation, "Failed to allocate ECS memory\n");
+            exit(1);
+            }
         }
 
     extMaxMemory = emBanks * extBanksSize;
@@ -423,7 +478,8 @@ void cpuInit(char *model, u16 *serialNumbers, u32 memory, u32 emBanks, ExtMemory
             }
 
         /*
-        **  Try to open existing ECS file.
+        **  Try to open existing ECS file. Shared ECS which is already in
+        **  use by another emulator keeps its current contents.
         */
         strcpy(fileName, persistDir);
         strcat(fileName, "/ecsStore");
@@ -433,7 +489,8 @@ void cpuInit(char *model, u16 *serialNumbers, u32 memory, u32 emBanks, ExtMemory
             /*
             **  Read ECS contents.
             */
-            if (fread((void *)extMem, sizeof(CpWord), extMaxMemory, ecsHandle) != extMaxMemory)
+            if (isEcsLoadable
+                && (fread((void *)extMem, sizeof(CpWord), extMaxMemory, ecsHandle) != extMaxMemory))
                 {
                 printf("(cpu    ) Unexpected length of ECS backing file, clearing ECS\n");
                 memset((void *)extMem, 0, extMaxMemory);
@@ -478,12 +535,15 @@ void cpuInit(char *model, u16 *serialNumbers, u32 memory, u32 emBanks, ExtMemory
 
     /*
     **  Initialize 16K x 4-bit EM flag registers. Currently, only models 865 and 875
-    **  have this feature.
+    **  have this feature. Shared flag registers are cleared only when the
+    **  segment is created.
     */
-
-    for (i = 0; i < (int)sizeof(ecs16Kx4bitFlagRegisters); i++)
+    if (ecsShared == NULL)
         {
-        ecs16Kx4bitFlagRegisters[i] = 0;
+        for (i = 0; i < EcsFlagRegisterCount; i++)
+            {
+            ecs16Kx4bitFlagRegisters[i] = 0;
+            }
         }
 
 #if defined(_WIN32)
@@ -763,6 +823,17 @@ void cpuTerminate(void)
 
         fclose(ecsHandle);
         }
+
+#if !defined(_WIN32)
+    /*
+    **  Detach from shared ECS. The segment itself survives, so that its
+    **  contents remain available to the other emulators.
+    */
+    if (ecsShared != NULL)
+        {
+        __atomic_sub_fetch(&ecsShared->attachCount, 1, __ATOMIC_SEQ_CST);
+        }
+#endif
     }
 
 /*--------------------------------------------------------------------------
@@ -791,8 +862,11 @@ void cpuPpReadMem(u32 address, CpWord *data)
         }
     else
         {
-        address %= cpuMaxMemory;
-        *data    = cpMem[address] & Mask60;
+        if (address >= cpuMaxMemory)
+            {
+            address %= cpuMaxMemory;
+            }
+        *data = cpMem[address] & Mask60;
         }
     }
 
@@ -818,7 +892,10 @@ void cpuPpWriteMem(u32 address, CpWord data)
         }
     else
         {
-        address       %= cpuMaxMemory;
+        if (address >= cpuMaxMemory)
+            {
+            address %= cpuMaxMemory;
+            }
         cpMem[address] = data & Mask60;
         }
     }
@@ -862,10 +939,18 @@ void cpuStep(Cpu170Context *activeCpu)
             return;
             }
         //
-        //  Check for pending requests such as asynchronous interrupts.
+        //  Check for pending requests such as asynchronous interrupts. The
+        //  registers need only be examined when something has been raised.
         //
-        cpu180CheckPendingInterrupts(ctx180);
-        cpu180CheckConditions(ctx180);
+        if ((ctx180->pendingRequests != 0) || ctx180->isConditionPending)
+            {
+            cpu180CheckPendingInterrupts(ctx180);
+            cpu180CheckConditions(ctx180);
+            }
+        else
+            {
+            ctx180->pendingAction = Rni;
+            }
         if (ctx180->pendingAction > Stack)
             {
             if (ctx180->pendingAction == Trap)
@@ -1000,6 +1085,7 @@ void cpuStep(Cpu170Context *activeCpu)
         **  Execute instruction.
         */
         decodeCpuOpcode[activeCpu->opFm].execute(activeCpu);
+        activeCpu->instructionCount += 1;
 
         /*
         **  Force B0 to 0.
@@ -1069,6 +1155,7 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
     result = TRUE;
 
     cpuAcquireMutex(&flagRegMutex);
+    cpuEcsLockFlags();
 
     if ((((ecsAddress & (1 << 29)) != 0) && ((ecsAddress & (1 << 20)) != 0)))
         {
@@ -1133,9 +1220,9 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
             **  Ready/Select.
             */
 #if DEBUG_ECS
-            fprintf(emLog, "\n    Ready/Select: flag register %06o, flag word %06o", ecsFlagRegister, flagWord);
+            fprintf(emLog, "\n    Ready/Select: flag register %06o, flag word %06o", *ecsFlagRegister, flagWord);
 #endif
-            if ((ecsFlagRegister & flagWord) != 0)
+            if ((*ecsFlagRegister & flagWord) != 0)
                 {
                 /*
                 **  Error exit.
@@ -1144,7 +1231,7 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
                 }
             else
                 {
-                ecsFlagRegister |= flagWord;
+                *ecsFlagRegister |= flagWord;
                 }
             break;
 
@@ -1153,9 +1240,9 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
             **  Selective Set.
             */
 #if DEBUG_ECS
-            fprintf(emLog, "\n    Selective Set: flag register %06o, flag word %06o", ecsFlagRegister, flagWord);
+            fprintf(emLog, "\n    Selective Set: flag register %06o, flag word %06o", *ecsFlagRegister, flagWord);
 #endif
-            ecsFlagRegister |= flagWord;
+            *ecsFlagRegister |= flagWord;
             break;
 
         case 2:
@@ -1163,9 +1250,9 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
             **  Status.
             */
 #if DEBUG_ECS
-            fprintf(emLog, "\n    Status: flag register %06o, flag word %06o", ecsFlagRegister, flagWord);
+            fprintf(emLog, "\n    Status: flag register %06o, flag word %06o", *ecsFlagRegister, flagWord);
 #endif
-            if ((ecsFlagRegister & flagWord) != 0)
+            if ((*ecsFlagRegister & flagWord) != 0)
                 {
                 /*
                 **  Error exit.
@@ -1179,13 +1266,14 @@ bool cpuEcsFlagRegister(u32 ecsAddress)
             **  Selective Clear,
             */
 #if DEBUG_ECS
-            fprintf(emLog, "\n    Selective Clear: flag register %06o, flag word %06o", ecsFlagRegister, flagWord);
+            fprintf(emLog, "\n    Selective Clear: flag register %06o, flag word %06o", *ecsFlagRegister, flagWord);
 #endif
-            ecsFlagRegister = (ecsFlagRegister & ~flagWord) & Mask18;
+            *ecsFlagRegister = (*ecsFlagRegister & ~flagWord) & Mask18;
             break;
             }
         }
 
+    cpuEcsUnlockFlags();
     cpuReleaseMutex(&flagRegMutex);
 
     return result;
@@ -1607,7 +1695,8 @@ static void cpuExchangeTo180(Cpu170Context *activeCpu, bool setSysCall, bool set
     ctx180 = &cpus180[activeCpu->id];
     if (setSysCall)
         {
-        ctx180->regMcr |= 0x0020; // set system call status bit
+        ctx180->regMcr            |= 0x0020; // set system call status bit
+        ctx180->isConditionPending = TRUE;
         }
     cpu180Store170Xp(ctx180, ctx180->regJps);
     if (setExitModeHalt)
@@ -2384,6 +2473,194 @@ static void cpuUemWord(Cpu170Context *activeCpu, bool writeToUem)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Lock the flag registers of shared ECS against other
+**                  emulators. The lock is held only while a single flag
+**                  register function executes.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void cpuEcsLockFlags(void)
+    {
+#if !defined(_WIN32)
+    int rc;
+
+    if (ecsShared != NULL)
+        {
+        rc = pthread_mutex_lock(&ecsShared->flagLock);
+#if !defined(__APPLE__)
+        if (rc == EOWNERDEAD)
+            {
+            /*
+            **  Another emulator died while holding the lock. Each flag
+            **  register function updates a single word, so the flags
+            **  are consistent and the lock can be recovered.
+            */
+            printf("(cpu    ) Recovered shared ECS flag lock from an emulator which exited while holding it\n");
+            pthread_mutex_consistent(&ecsShared->flagLock);
+            rc = 0;
+            }
+#endif
+        if (rc != 0)
+            {
+            logDtError(LogErrorLocation, "Failed to lock shared ECS flag registers: %s\n", strerror(rc));
+            exit(1);
+            }
+        }
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Create or attach to an extended memory segment shared
+**                  with other emulators on this host.
+**
+**  Parameters:     Name        Description.
+**                  words       extended memory size in words
+**                  emType      ECS or ESM
+**
+**  Returns:        TRUE if the segment was created and may be loaded
+**                  from the persistent store.
+**
+**------------------------------------------------------------------------*/
+static bool cpuEcsMapShared(u32 words, ExtMemory emType)
+    {
+#if defined(_WIN32)
+    logDtError(LogErrorLocation, "Shared ECS is not supported on this platform\n");
+    exit(1);
+#else
+    pthread_mutexattr_t attr;
+    u32                 count;
+    int                 fd;
+    EcsSharedHeader     *hp;
+    int                 i;
+    bool                isCreator;
+    size_t              size;
+    struct stat         st;
+
+    size      = sizeof(EcsSharedHeader) + (size_t)words * sizeof(CpWord);
+    isCreator = TRUE;
+    fd        = shm_open(ecsSharedName, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if ((fd < 0) && (errno == EEXIST))
+        {
+        isCreator = FALSE;
+        fd        = shm_open(ecsSharedName, O_RDWR, 0);
+        }
+    if (fd < 0)
+        {
+        logDtError(LogErrorLocation, "Failed to open shared ECS segment %s: %s\n", ecsSharedName, strerror(errno));
+        exit(1);
+        }
+
+    if (isCreator)
+        {
+        if (ftruncate(fd, (off_t)size) != 0)
+            {
+            logDtError(LogErrorLocation, "Failed to size shared ECS segment %s: %s\n", ecsSharedName, strerror(errno));
+            shm_unlink(ecsSharedName);
+            exit(1);
+            }
+        }
+    else
+        {
+        /*
+        **  The creator may still be sizing the segment.
+        */
+        for (i = 0; i < 100; i++)
+            {
+            if ((fstat(fd, &st) == 0) && (st.st_size >= (off_t)size))
+                {
+                break;
+                }
+            usleep(10000);
+            }
+        if (i >= 100)
+            {
+            logDtError(LogErrorLocation, "Shared ECS segment %s is smaller than the configured %s\n",
+                       ecsSharedName, (emType == ESM) ? "ESM" : "ECS");
+            exit(1);
+            }
+        }
+
+    hp = (EcsSharedHeader *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (hp == (EcsSharedHeader *)MAP_FAILED)
+        {
+        logDtError(LogErrorLocation, "Failed to map shared ECS segment %s: %s\n", ecsSharedName, strerror(errno));
+        exit(1);
+        }
+
+    /*
+    **  The creator publishes the header last. Everyone else waits for it
+    **  and checks that all emulators agree on the configuration.
+    */
+    if (isCreator)
+        {
+        if ((pthread_mutexattr_init(&attr) != 0)
+            || (pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) != 0)
+#if !defined(__APPLE__)
+            || (pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) != 0)
+#endif
+            || (pthread_mutex_init(&hp->flagLock, &attr) != 0))
+            {
+            logDtError(LogErrorLocation, "Failed to initialize shared ECS flag lock\n");
+            shm_unlink(ecsSharedName);
+            exit(1);
+            }
+        pthread_mutexattr_destroy(&attr);
+        hp->version = EcsSharedVersion;
+        hp->words   = words;
+        hp->emType  = (u32)emType;
+        __atomic_store_n(&hp->magic, EcsSharedMagic, __ATOMIC_RELEASE);
+        }
+    else
+        {
+        for (i = 0; i < 100 && __atomic_load_n(&hp->magic, __ATOMIC_ACQUIRE) != EcsSharedMagic; i++)
+            {
+            usleep(10000);
+            }
+        if ((hp->magic != EcsSharedMagic) || (hp->version != EcsSharedVersion)
+            || (hp->words != words) || (hp->emType != (u32)emType))
+            {
+            logDtError(LogErrorLocation, "Shared ECS segment %s does not match the configured %s size or type\n",
+                       ecsSharedName, (emType == ESM) ? "ESM" : "ECS");
+            exit(1);
+            }
+        }
+
+    count                    = __atomic_add_fetch(&hp->attachCount, 1, __ATOMIC_SEQ_CST);
+    ecsShared                = hp;
+    extMem                   = (volatile CpWord *)(hp + 1);
+    ecsFlagRegister          = &hp->flagRegister;
+    ecs16Kx4bitFlagRegisters = hp->flagRegisters16K;
+
+    printf("(cpu    ) %s shared %s segment %s (%u emulator%s attached)\n", isCreator ? "Created" : "Attached to",
+           (emType == ESM) ? "ESM" : "ECS", ecsSharedName, count, (count == 1) ? "" : "s");
+
+    return isCreator;
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Unlock the flag registers of shared ECS.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void cpuEcsUnlockFlags(void)
+    {
+#if !defined(_WIN32)
+    if (ecsShared != NULL)
+        {
+        pthread_mutex_unlock(&ecsShared->flagLock);
+        }
+#endif
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Transfer word to/from ECS initiated by a CPU instruction.
 **
@@ -3981,8 +4258,9 @@ static void cpOp01(Cpu170Context *activeCpu)
             /*
             **  RT  Xj,Xk,K  (TRAP 180 instruction)
             */
-            activeCpu->opOffset            = 60;
-            cpus180[activeCpu->id].regUcr |= 0x8000; // set privileged instruction fault bit
+            activeCpu->opOffset                       = 60;
+            cpus180[activeCpu->id].regUcr            |= 0x8000; // set privileged instruction fault bit
+            cpus180[activeCpu->id].isConditionPending = TRUE;
             }
         else
             {
@@ -238,6 +238,12 @@
 */
 #define MaxInstructionsPerStep    4
 
+/*
+**  Maximum number of pages spanned by a byte string of up to 65535 bytes,
+**  given the minimum page size of 512 bytes.
+*/
+#define MaxByteStringPages        ((65536 >> 9) + 2)
+
 /*
 **  Mask used in preserving left half of X register
 */
@@ -445,9 +451,11 @@ typedef struct debugMaskPvaPair
 static bool cpu180AddInt32(Cpu180Context *ctx, u32 augend, u32 addend, u32 *sum);
 static bool cpu180AddInt64(Cpu180Context *ctx, u64 augend, u64 addend, u64 *sum);
 static void cpu180ApplyBdpOperator(Cpu180Context *ctx, bool (*operator)(BdpOperand *src, BdpOperand *dst, BdpOperand *result, UserCondition *cond));
+static void cpu180BytesToCm(u32 rma, u16 count, u8 *bp);
 static bool cpu180CallIndirect(Cpu180Context *ctx, u64 bsp, u64 cbp, u64 pp, u8 at, u8 xs, u8 xt, bool doSaveCrs, MonitorCondition *cond);
-static void cpu180CheckMonitorConditions(Cpu180Context *ctx);
-static void cpu180CheckUserConditions(Cpu180Context *ctx);
+static bool cpu180CheckMonitorConditions(Cpu180Context *ctx);
+static bool cpu180CheckUserConditions(Cpu180Context *ctx);
+static void cpu180CmToBytes(u32 rma, u16 count, u8 *bp);
 static void cpu180Exchange(Cpu180Context *activeCpu);
 static bool cpu180FindPte(Cpu180Context *ctx, u16 asid, u32 byteNum, bool doIgnValidity, u32 *pti, u8 *count);
 static void cpu180Get170State(Cpu180Context *ctx);
@@ -478,6 +486,7 @@ static void cpu180SetTos(Cpu180Context *ctx, u16 ring, u64 pva);
 static void cpu180Store180Xp(Cpu180Context *ctx, u32 xpa);
 static bool cpu180SubInt32(Cpu180Context *ctx, u32 minend, u32 subend, u32 *diff);
 static bool cpu180SubInt64(Cpu180Context *ctx, u64 minend, u64 subend, u64 *diff);
+static int  cpu180TranslateByteString(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, Cpu180AccessMode access, u32 *rmas, u16 *lengths, MonitorCondition *cond);
 static void cpu180UpdatePageSize(Cpu180Context *ctx);
 static bool cpu180ValidateAccess(Cpu180Context *ctx, u64 sde, u8 ring, Cpu180AccessMode access, MonitorCondition *cond);
 
@@ -1373,6 +1382,9 @@ static u16 traceKeypointList[] = TRACE_KEYPOINT_LIST;
 **
 **                  Ordinarily, this is called after an exchange or return
 **                  operation to check for previously stacked conditions.
+**                  The condition pending flag remains set for as long as
+**                  any enabled condition is present, because its action
+**                  may change with the trap enable and monitor mode state.
 **
 **  Parameters:     Name        Description.
 **                  ctx         pointer to CPU context
@@ -1382,9 +1394,13 @@ static u16 traceKeypointList[] = TRACE_KEYPOINT_LIST;
 **------------------------------------------------------------------------*/
 void cpu180CheckConditions(Cpu180Context *ctx)
     {
-    ctx->pendingAction = Rni;
-    cpu180CheckMonitorConditions(ctx);
-    cpu180CheckUserConditions(ctx);
+    bool isMonitorCondition;
+    bool isUserCondition;
+
+    ctx->pendingAction      = Rni;
+    isMonitorCondition      = cpu180CheckMonitorConditions(ctx);
+    isUserCondition         = cpu180CheckUserConditions(ctx);
+    ctx->isConditionPending = isMonitorCondition || isUserCondition;
     }
 
 /*--------------------------------------------------------------------------
@@ -1633,6 +1649,8 @@ void cpu180Load180Xp(Cpu180Context *ctx, u32 xpa)
     ctx->regDi     = (word >> 58) & Mask6;
     ctx->regDm     = (word >> 48) & Mask7;
 
+    ctx->isConditionPending = TRUE;
+
 #if CcDebug > 0
     traceExchange180(ctx, xpa, "Load");
 #endif
@@ -1838,7 +1856,8 @@ void cpu180MacHaltCp(Cpu180Context *ctx)
 **------------------------------------------------------------------------*/
 void cpu180MacMasterClearCp(Cpu180Context *ctx)
     {
-    ctx->pendingRequests = 0;
+    ctx->pendingRequests    = 0;
+    ctx->isConditionPending = TRUE;
 #if CcDebug > 0
     traceMasterClearCpu180(ctx);
 #endif
@@ -2097,13 +2116,15 @@ void cpu180MacSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word)
         ctx->regMdw = word;
         break;
     case RegMonitorCondition:
-        ctx->regMcr = (u16)(word & Mask16);
+        ctx->regMcr             = (u16)(word & Mask16);
+        ctx->isConditionPending = TRUE;
 #if DEBUG && DEBUG_SET_STATE_REG
         fprintf(cpu180Log, "        MMR %04x MCR %04x\n", ctx->regMmr, ctx->regMcr);
 #endif
         break;
     case RegMonitorMask:
-        ctx->regMmr = (u16)(word & Mask16);
+        ctx->regMmr             = (u16)(word & Mask16);
+        ctx->isConditionPending = TRUE;
 #if DEBUG && DEBUG_SET_STATE_REG
         fprintf(cpu180Log, "        MMR %04x MCR %04x\n", ctx->regMmr, ctx->regMcr);
 #endif
@@ -2129,7 +2150,8 @@ void cpu180MacSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word)
 #endif
         if (ctx->regPit == 0)
             {
-            ctx->regUcr |= ucrDefns[UCR51].bitMask;
+            ctx->regUcr            |= ucrDefns[UCR51].bitMask;
+            ctx->isConditionPending = TRUE;
             }
         break;
     case RegRegisterP:
@@ -2149,7 +2171,8 @@ void cpu180MacSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word)
 #endif
         if (ctx->regSit == 0)
             {
-            ctx->regMcr |= mcrDefns[MCR59].bitMask;
+            ctx->regMcr            |= mcrDefns[MCR59].bitMask;
+            ctx->isConditionPending = TRUE;
             }
         break;
     case RegTestMode:
@@ -2162,7 +2185,8 @@ void cpu180MacSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word)
         ctx->regUtp = word & Mask48;
         break;
     case RegUserCondition:
-        ctx->regUcr = (u16)(word & Mask16);
+        ctx->regUcr             = (u16)(word & Mask16);
+        ctx->isConditionPending = TRUE;
 #if DEBUG && DEBUG_SET_STATE_REG
         fprintf(cpu180Log, "        UMR %04x UCR %04x\n", ctx->regUmr, ctx->regUcr);
 #endif
@@ -2174,7 +2198,8 @@ void cpu180MacSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word)
             ctx->regDi  = 0;
             ctx->regDm &= ~(u8)(DM_SP | DM_EL);
             }
-        ctx->regUmr = val16;
+        ctx->regUmr             = val16;
+        ctx->isConditionPending = TRUE;
 #if DEBUG && DEBUG_SET_STATE_REG
         fprintf(cpu180Log, "        UMR %04x UCR %04x\n", ctx->regUmr, ctx->regUcr);
 #endif
@@ -2582,6 +2607,45 @@ bool cpu180PvaToRma(Cpu180Context *ctx, u64 pva, Cpu180AccessMode access, u32 *r
     return FALSE;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Read a string of bytes starting at a specified PVA.
+**                  Each page spanned by the string is translated once,
+**                  and whole words are copied where possible.
+**
+**  Parameters:     Name        Description.
+**                  ctx         pointer to CPU context
+**                  pva         PVA of the first byte
+**                  count       number of bytes to read
+**                  ring        ring for which to validate access
+**                  access      access mode (read or execute)
+**                  buffer      (out) the bytes read
+**                  cond        (out) monitor condition if error condition detected
+**
+**  Returns:        TRUE if successful, FALSE if address specification
+**                  error, access violation, or page fault.
+**
+**------------------------------------------------------------------------*/
+bool cpu180ReadBytes(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, Cpu180AccessMode access, u8 *buffer, MonitorCondition *cond)
+    {
+    int i;
+    u16 lengths[MaxByteStringPages];
+    int pages;
+    u32 rmas[MaxByteStringPages];
+
+    pages = cpu180TranslateByteString(ctx, pva, count, ring, access, rmas, lengths, cond);
+    if (pages < 0)
+        {
+        return FALSE;
+        }
+    for (i = 0; i < pages; i++)
+        {
+        cpu180CmToBytes(rmas[i], lengths[i], buffer);
+        buffer += lengths[i];
+        }
+
+    return TRUE;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Set a monitor condition
 **
@@ -2597,9 +2661,10 @@ void cpu180SetMonitorCondition(Cpu180Context *ctx, MonitorCondition cond)
     ConditionAction     action;
     ConditionActionDefn *defn;
 
-    defn         = &mcrDefns[cond];
-    ctx->regMcr |= defn->bitMask;
-    action       = cpu180GetActionForMonitorCondition(ctx, cond);
+    defn                    = &mcrDefns[cond];
+    ctx->regMcr            |= defn->bitMask;
+    ctx->isConditionPending = TRUE;
+    action                  = cpu180GetActionForMonitorCondition(ctx, cond);
     if (action > ctx->pendingAction)
         {
         ctx->pendingAction = action;
@@ -2638,9 +2703,10 @@ void cpu180SetUserCondition(Cpu180Context *ctx, UserCondition cond)
     ConditionAction     action;
     ConditionActionDefn *defn;
 
-    defn         = &ucrDefns[cond];
-    ctx->regUcr |= defn->bitMask;
-    action       = cpu180GetActionForUserCondition(ctx, cond);
+    defn                    = &ucrDefns[cond];
+    ctx->regUcr            |= defn->bitMask;
+    ctx->isConditionPending = TRUE;
+    action                  = cpu180GetActionForUserCondition(ctx, cond);
 
     if (action > ctx->pendingAction)
         {
@@ -2694,10 +2760,16 @@ void cpu180Step(Cpu180Context *activeCpu)
             }
         /*
         **  First, check for interrupt conditions and initiate trap or
-        **  exchange operations, or halt the CPU as required.
+        **  exchange operations, or halt the CPU as required. Producers
+        **  of interrupts and conditions raise pendingRequests or
+        **  isConditionPending, so nothing needs to be examined while
+        **  both are clear.
         */
-        cpu180CheckPendingInterrupts(activeCpu);
-        cpu180CheckConditions(activeCpu);
+        if ((activeCpu->pendingRequests != 0) || activeCpu->isConditionPending)
+            {
+            cpu180CheckPendingInterrupts(activeCpu);
+            cpu180CheckConditions(activeCpu);
+            }
         if (activeCpu->pendingAction > Stack)
             {
             if (activeCpu->pendingAction == Trap)
@@ -2843,6 +2915,7 @@ void cpu180Step(Cpu180Context *activeCpu)
             activeCpu->nextKey = activeCpu->key;
             activeCpu->nextP   = activeCpu->regP + length;
             odp->execute(activeCpu);
+            activeCpu->instructionCount += 1;
             activeCpu->key     = activeCpu->nextKey;
             activeCpu->regP    = activeCpu->nextP;
 
@@ -2968,23 +3041,26 @@ void cpu180Trap(Cpu180Context *ctx)
         || cpu180PvaToRma(ctx, ctx->regTp, AccessModeRead, &rma, &pti, &cond) == FALSE)
         {
         cpu180SetMonitorCondition(ctx, cond);
-        ctx->regMcr       |= mcrDefns[MCR63].bitMask; // Trap exception
-        ctx->pendingAction = cpu180GetActionForTrapCondition(ctx, cond);
+        ctx->regMcr            |= mcrDefns[MCR63].bitMask; // Trap exception
+        ctx->isConditionPending = TRUE;
+        ctx->pendingAction      = cpu180GetActionForTrapCondition(ctx, cond);
         return;
         }
     cbp = cpMem[rma >> 3];
     if (((cbp >> 56) & Mask4) != 0 || ((cbp >> 55) & 1) == 0) // not VMID 0 or not external flag
         {
         cpu180SetMonitorCondition(ctx, MCR55);        // Environment specification error
-        ctx->regMcr       |= mcrDefns[MCR63].bitMask; // Trap exception
-        ctx->pendingAction = cpu180GetActionForTrapCondition(ctx, MCR55);
+        ctx->regMcr            |= mcrDefns[MCR63].bitMask; // Trap exception
+        ctx->isConditionPending = TRUE;
+        ctx->pendingAction      = cpu180GetActionForTrapCondition(ctx, MCR55);
         return;
         }
     if (cpu180CallIndirect(ctx, ctx->regTp, cbp, ctx->regA[4], 0xf, 0x0, 0xf, TRUE, &cond) == FALSE)
         {
         cpu180SetMonitorCondition(ctx, cond);
-        ctx->regMcr       |= mcrDefns[MCR63].bitMask; // Trap exception
-        ctx->pendingAction = cpu180GetActionForTrapCondition(ctx, cond);
+        ctx->regMcr            |= mcrDefns[MCR63].bitMask; // Trap exception
+        ctx->isConditionPending = TRUE;
+        ctx->pendingAction      = cpu180GetActionForTrapCondition(ctx, cond);
         return;
         }
 
@@ -3044,6 +3120,45 @@ void cpu180UpdateIntervalTimers(Cpu180Context *ctx)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Write a string of bytes starting at a specified PVA.
+**                  All pages spanned by the string are translated before
+**                  any byte is stored, so a page fault leaves memory
+**                  unchanged.
+**
+**  Parameters:     Name        Description.
+**                  ctx         pointer to CPU context
+**                  pva         PVA of the first byte
+**                  count       number of bytes to write
+**                  ring        ring for which to validate access
+**                  buffer      the bytes to write
+**                  cond        (out) monitor condition if error condition detected
+**
+**  Returns:        TRUE if successful, FALSE if address specification
+**                  error, access violation, or page fault.
+**
+**------------------------------------------------------------------------*/
+bool cpu180WriteBytes(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, u8 *buffer, MonitorCondition *cond)
+    {
+    int i;
+    u16 lengths[MaxByteStringPages];
+    int pages;
+    u32 rmas[MaxByteStringPages];
+
+    pages = cpu180TranslateByteString(ctx, pva, count, ring, AccessModeWrite, rmas, lengths, cond);
+    if (pages < 0)
+        {
+        return FALSE;
+        }
+    for (i = 0; i < pages; i++)
+        {
+        cpu180BytesToCm(rmas[i], lengths[i], buffer);
+        buffer += lengths[i];
+        }
+
+    return TRUE;
+    }
+
 /*
  **--------------------------------------------------------------------------
  **
@@ -3079,7 +3194,8 @@ static bool cpu180AddInt32(Cpu180Context *ctx, u32 augend, u32 addend, u32 *sum)
             cpu180SetUserCondition(ctx, UCR57);
             return FALSE;
             }
-        ctx->regUcr |= mask;
+        ctx->regUcr            |= mask;
+        ctx->isConditionPending = TRUE;
         }
 
     return TRUE;
@@ -3112,7 +3228,8 @@ static bool cpu180AddInt64(Cpu180Context *ctx, u64 augend, u64 addend, u64 *sum)
             cpu180SetUserCondition(ctx, UCR57);
             return FALSE;
             }
-        ctx->regUcr |= mask;
+        ctx->regUcr            |= mask;
+        ctx->isConditionPending = TRUE;
         }
 
     return TRUE;
@@ -3198,6 +3315,62 @@ static void cpu180ApplyBdpOperator(Cpu180Context *ctx, bool (*operator)(BdpOpera
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Store a string of bytes at contiguous real memory
+**                  addresses. Bytes are numbered from the most
+**                  significant end of each word.
+**
+**  Parameters:     Name        Description.
+**                  rma         RMA of the first byte
+**                  count       number of bytes
+**                  bp          pointer to the bytes
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void cpu180BytesToCm(u32 rma, u16 count, u8 *bp)
+    {
+    u8  shift;
+    u64 word;
+    u32 wordAddr;
+
+    wordAddr = rma >> 3;
+    if (((rma & Mask3) != 0) && (count > 0))
+        {
+        shift = (u8)(56 - ((rma & Mask3) << 3));
+        word  = cpMem[wordAddr];
+        while (count > 0)
+            {
+            word   = (word & ~((u64)0xff << shift)) | ((u64)*bp++ << shift);
+            count -= 1;
+            if (shift == 0)
+                {
+                break;
+                }
+            shift -= 8;
+            }
+        cpMem[wordAddr++] = word;
+        }
+    while (count >= 8)
+        {
+        cpMem[wordAddr++] = ((u64)bp[0] << 56) | ((u64)bp[1] << 48) | ((u64)bp[2] << 40) | ((u64)bp[3] << 32)
+                            | ((u64)bp[4] << 24) | ((u64)bp[5] << 16) | ((u64)bp[6] << 8) | (u64)bp[7];
+        bp    += 8;
+        count -= 8;
+        }
+    if (count > 0)
+        {
+        word  = cpMem[wordAddr];
+        shift = 56;
+        while (count-- > 0)
+            {
+            word   = (word & ~((u64)0xff << shift)) | ((u64)*bp++ << shift);
+            shift -= 8;
+            }
+        cpMem[wordAddr] = word;
+        }
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Initiate a CYBER 180 indirect procedure call
 **
@@ -3350,13 +3523,14 @@ static bool cpu180CallIndirect(Cpu180Context *ctx, u64 bsp, u64 cbp, u64 pp, u8
 **  Parameters:     Name        Description.
 **                  ctx         pointer to CPU context
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if any enabled monitor condition is present.
 **
 **------------------------------------------------------------------------*/
-static void cpu180CheckMonitorConditions(Cpu180Context *ctx)
+static bool cpu180CheckMonitorConditions(Cpu180Context *ctx)
     {
     ConditionAction  action;
     u16              cr;
+    bool             isPresent;
     u16              mask;
     MonitorCondition mCond;
 
@@ -3368,6 +3542,7 @@ static void cpu180CheckMonitorConditions(Cpu180Context *ctx)
         //
         cr &= ~mcrDefns[MCR53].bitMask;
         }
+    isPresent = cr != 0;
     for (mCond = MCR48; cr != 0 && mCond <= MCR63; mCond++)
         {
         mask = mcrDefns[mCond].bitMask;
@@ -3381,6 +3556,8 @@ static void cpu180CheckMonitorConditions(Cpu180Context *ctx)
             cr &= ~mask;
             }
         }
+
+    return isPresent;
     }
 
 /*--------------------------------------------------------------------------
@@ -3402,25 +3579,29 @@ void cpu180CheckPendingInterrupts(Cpu180Context *ctx)
         cpuAcquireInterruptMutex();
         if ((ctx->pendingRequests & PR_EXT_INTRPT) != 0)
             {
-            ctx->pendingRequests &= ~(u8)PR_EXT_INTRPT;
-            ctx->regMcr          |= mcrDefns[MCR56].bitMask; // set External Interrupt
+            ctx->pendingRequests   &= ~(u8)PR_EXT_INTRPT;
+            ctx->regMcr            |= mcrDefns[MCR56].bitMask; // set External Interrupt
+            ctx->isConditionPending = TRUE;
             }
         if ((ctx->pendingRequests & PR_SIT) != 0)
             {
-            ctx->pendingRequests &= ~(u8)PR_SIT;
-            ctx->regMcr          |= mcrDefns[MCR59].bitMask; // set System Interval Timer Interrupt
+            ctx->pendingRequests   &= ~(u8)PR_SIT;
+            ctx->regMcr            |= mcrDefns[MCR59].bitMask; // set System Interval Timer Interrupt
+            ctx->isConditionPending = TRUE;
             }
         if ((ctx->pendingRequests & PR_PIT) != 0)
             {
-            ctx->pendingRequests &= ~(u8)PR_PIT;
-            ctx->regUcr          |= ucrDefns[UCR51].bitMask; // set Process Interval Timer Interrupt
+            ctx->pendingRequests   &= ~(u8)PR_PIT;
+            ctx->regUcr            |= ucrDefns[UCR51].bitMask; // set Process Interval Timer Interrupt
+            ctx->isConditionPending = TRUE;
             }
         if ((ctx->pendingRequests & PR_EXCH_170) != 0)
             {
             ctx->pendingRequests &= ~(u8)PR_EXCH_170;
             if (ctx->regVmid == 0 || (ctx->regMcr & ctx->regMmr) != 0)
                 {
-                ctx->regMcr |= mcrDefns[MCR53].bitMask; // set CYBER 170 exchange request
+                ctx->regMcr            |= mcrDefns[MCR53].bitMask; // set CYBER 170 exchange request
+                ctx->isConditionPending = TRUE;
                 }
             }
         if ((ctx->pendingRequests & PR_HALT) != 0)
@@ -3441,17 +3622,19 @@ void cpu180CheckPendingInterrupts(Cpu180Context *ctx)
 **  Parameters:     Name        Description.
 **                  ctx         pointer to CPU context
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if any enabled user condition is present.
 **
 **------------------------------------------------------------------------*/
-static void cpu180CheckUserConditions(Cpu180Context *ctx)
+static bool cpu180CheckUserConditions(Cpu180Context *ctx)
     {
     ConditionAction  action;
     u16              cr;
+    bool             isPresent;
     u16              mask;
     UserCondition    uCond;
 
-    cr = ctx->regUcr & ctx->regUmr;
+    cr        = ctx->regUcr & ctx->regUmr;
+    isPresent = cr != 0;
     for (uCond = UCR48; cr != 0 && uCond <= UCR63; uCond++)
         {
         mask = ucrDefns[uCond].bitMask;
@@ -3465,6 +3648,69 @@ static void cpu180CheckUserConditions(Cpu180Context *ctx)
             cr &= ~mask;
             }
         }
+
+    return isPresent;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Fetch a string of bytes from contiguous real memory
+**                  addresses. Bytes are numbered from the most
+**                  significant end of each word.
+**
+**  Parameters:     Name        Description.
+**                  rma         RMA of the first byte
+**                  count       number of bytes
+**                  bp          (out) pointer to the bytes
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void cpu180CmToBytes(u32 rma, u16 count, u8 *bp)
+    {
+    u8  shift;
+    u64 word;
+    u32 wordAddr;
+
+    wordAddr = rma >> 3;
+    if (((rma & Mask3) != 0) && (count > 0))
+        {
+        shift = (u8)(56 - ((rma & Mask3) << 3));
+        word  = cpMem[wordAddr++];
+        while (count > 0)
+            {
+            *bp++  = (u8)(word >> shift);
+            count -= 1;
+            if (shift == 0)
+                {
+                break;
+                }
+            shift -= 8;
+            }
+        }
+    while (count >= 8)
+        {
+        word   = cpMem[wordAddr++];
+        bp[0]  = (u8)(word >> 56);
+        bp[1]  = (u8)(word >> 48);
+        bp[2]  = (u8)(word >> 40);
+        bp[3]  = (u8)(word >> 32);
+        bp[4]  = (u8)(word >> 24);
+        bp[5]  = (u8)(word >> 16);
+        bp[6]  = (u8)(word >> 8);
+        bp[7]  = (u8)word;
+        bp    += 8;
+        count -= 8;
+        }
+    if (count > 0)
+        {
+        word  = cpMem[wordAddr];
+        shift = 56;
+        while (count-- > 0)
+            {
+            *bp++  = (u8)(word >> shift);
+            shift -= 8;
+            }
+        }
     }
 
 /*--------------------------------------------------------------------------
@@ -3788,36 +4034,33 @@ static bool cpu180GetBdpDescriptor(Cpu180Context *ctx, u64 pva, u8 aRegNum, u8 x
 **------------------------------------------------------------------------*/
 static bool cpu180GetBytes(Cpu180Context *ctx, u64 pva, u8 count, u8 ring, Cpu180AccessMode access, u64 *word)
     {
+    u8               bytes[8];
     MonitorCondition cond;
     u8               i;
     u32              rma;
-    u32              rmas[8];
-    u8               shift;
 
     if ((pva & Mask3) == 0) // optimization: word-aligned load
         {
-        if (cpu180TranslatePvaSequence(ctx, pva, 1, count, ring, access, rmas, &cond) == FALSE)
+        if (cpu180TranslatePvaSequence(ctx, pva, 1, count, ring, access, &rma, &cond) == FALSE)
             {
             cpu180SetMonitorCondition(ctx, cond);
             return FALSE;
             }
         if (count < 8)
             {
-            *word = cpMem[rmas[0] >> 3] >> ((8 - count) << 3);
+            *word = cpMem[rma >> 3] >> ((8 - count) << 3);
             }
         else
             {
-            *word = cpMem[rmas[0] >> 3];
+            *word = cpMem[rma >> 3];
             }
         }
-    else if (cpu180TranslatePvaSequence(ctx, pva, count, 1, ring, access, rmas, &cond))
+    else if (cpu180ReadBytes(ctx, pva, count, ring, access, bytes, &cond))
         {
         *word = 0;
         for (i = 0; i < count; i++)
             {
-            rma   = rmas[i];
-            shift = (u8)(56 - ((rma & Mask3) << 3));
-            *word = (*word << 8) | ((cpMem[rma >> 3] >> shift) & Mask8);
+            *word = (*word << 8) | bytes[i];
             }
         }
     else
@@ -4282,7 +4525,8 @@ static bool cpu180MulInt32(Cpu180Context *ctx, u32 mltand, u32 mltier, u32 *prod
             cpu180SetUserCondition(ctx, UCR57);
             return FALSE;
             }
-        ctx->regUcr |= mask;
+        ctx->regUcr            |= mask;
+        ctx->isConditionPending = TRUE;
         }
     *product = (u32)(p64 & Mask32);
 
@@ -4341,7 +4585,8 @@ static bool cpu180MulInt64(Cpu180Context *ctx, u64 mltand, u64 mltier, u64 *prod
                 cpu180SetUserCondition(ctx, UCR57);
                 return FALSE;
                 }
-            ctx->regUcr |= mask;
+            ctx->regUcr            |= mask;
+            ctx->isConditionPending = TRUE;
             }
         }
 
@@ -4445,13 +4690,10 @@ static bool cpu180PushFrame(Cpu180Context *ctx, u8 at, u8 xs, u8 xt, bool doSave
 **------------------------------------------------------------------------*/
 static bool cpu180PutBytes(Cpu180Context *ctx, u64 pva, u8 ring, u64 word, u8 count)
     {
-    u64              byte;
-    u8               byteShift;
+    u8               bytes[8];
     MonitorCondition cond;
     u8               i;
-    u64              mask;
     u32              rma;
-    u32              rmas[8];
     u32              wordAddr;
     u8               wordShift;
 
@@ -4473,9 +4715,9 @@ static bool cpu180PutBytes(Cpu180Context *ctx, u64 pva, u8 ring, u64 word, u8 co
 
     if ((pva & Mask3) == 0) // optimization: word-aligned store
         {
-        if (cpu180TranslatePvaSequence(ctx, pva, 1, count, ring, AccessModeWrite, rmas, &cond))
+        if (cpu180TranslatePvaSequence(ctx, pva, 1, count, ring, AccessModeWrite, &rma, &cond))
             {
-            wordAddr = rmas[0] >> 3;
+            wordAddr = rma >> 3;
             if (count < 8)
                 {
                 wordShift = (u8)((8 - count) << 3);
@@ -4489,25 +4731,18 @@ static bool cpu180PutBytes(Cpu180Context *ctx, u64 pva, u8 ring, u64 word, u8 co
             return FALSE;
             }
         }
-    else if (cpu180TranslatePvaSequence(ctx, pva, count, 1, ring, AccessModeWrite, rmas, &cond))
+    else
         {
-        i         = 0;
-        wordShift = (u8)((count - 1) << 3);
-        while (count-- > 0)
+        for (i = count; i > 0; i--)
             {
-            rma             = rmas[i++];
-            wordAddr        = rma >> 3;
-            byte            = (word >> wordShift) & Mask8;
-            byteShift       = (u8)(56 - ((rma & Mask3) << 3));
-            mask            = ~((u64)0xff << byteShift);
-            cpMem[wordAddr] = (cpMem[wordAddr] & mask) | (byte << byteShift);
-            wordShift      -= 8;
+            bytes[i - 1] = (u8)word;
+            word       >>= 8;
+            }
+        if (cpu180WriteBytes(ctx, pva, count, ring, bytes, &cond) == FALSE)
+            {
+            cpu180SetMonitorCondition(ctx, cond);
+            return FALSE;
             }
-        }
-    else
-        {
-        cpu180SetMonitorCondition(ctx, cond);
-        return FALSE;
         }
 
     return TRUE;
@@ -4590,9 +4825,10 @@ static void cpu180SetRingZeroCondition(Cpu180Context *ctx, u64 pva)
 
     if ((features & HasRingZeroTest) != 0)
         {
-        defn         = &mcrDefns[MCR60];
-        ctx->regMcr |= defn->bitMask;
-        ctx->regUtp  = pva;
+        defn                    = &mcrDefns[MCR60];
+        ctx->regMcr            |= defn->bitMask;
+        ctx->isConditionPending = TRUE;
+        ctx->regUtp             = pva;
 
         if ((ctx->regMmr & defn->bitMask) == 0)
             {
@@ -4723,7 +4959,8 @@ static bool cpu180SubInt32(Cpu180Context *ctx, u32 minend, u32 subend, u32 *diff
             cpu180SetUserCondition(ctx, UCR57);
             return FALSE;
             }
-        ctx->regUcr |= mask;
+        ctx->regUcr            |= mask;
+        ctx->isConditionPending = TRUE;
         }
 
     return TRUE;
@@ -4756,12 +4993,66 @@ static bool cpu180SubInt64(Cpu180Context *ctx, u64 minend, u64 subend, u64 *diff
             cpu180SetUserCondition(ctx, UCR57);
             return FALSE;
             }
-        ctx->regUcr |= mask;
+        ctx->regUcr            |= mask;
+        ctx->isConditionPending = TRUE;
         }
 
     return TRUE;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Translate the PVA's of a byte string to RMA's, one per
+**                  page spanned by the string.
+**
+**  Parameters:     Name        Description.
+**                  ctx         pointer to CPU context
+**                  pva         PVA of the first byte
+**                  count       number of bytes
+**                  ring        ring for which to validate access
+**                  access      mode of access (execute, read, write)
+**                  rmas        (out) RMA of the first byte in each page
+**                  lengths     (out) number of bytes in each page
+**                  cond        (out) monitor condition if error condition detected
+**
+**  Returns:        Number of pages, -1 if a PVA could not be translated.
+**
+**------------------------------------------------------------------------*/
+static int cpu180TranslateByteString(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, Cpu180AccessMode access, u32 *rmas, u16 *lengths, MonitorCondition *cond)
+    {
+    u32 n;
+    u32 pageSize;
+    int pages;
+    u32 pti;
+
+    if (count == 0)
+        {
+        return 0;
+        }
+    if (cpu180ValidateAccess(ctx, pva, ring, access, cond) == FALSE)
+        {
+        return -1;
+        }
+    pageSize = (u32)1 << ctx->pageNumShift;
+    pages    = 0;
+    while (count > 0)
+        {
+        if (cpu180PvaToRma(ctx, pva, access, &rmas[pages], &pti, cond) == FALSE)
+            {
+            return -1;
+            }
+        n = pageSize - ((u32)pva & (pageSize - 1));
+        if (n > count)
+            {
+            n = count;
+            }
+        lengths[pages++] = (u16)n;
+        pva             += n;
+        count           -= (u16)n;
+        }
+
+    return pages;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Update elements related to page size.
 **
@@ -4941,7 +5232,8 @@ static void cp180Op02(Cpu180Context *activeCpu)  // 02  EXCHANGE   MIGDS 2-132
     {
     if (activeCpu->isMonitorMode == FALSE)
         {
-        activeCpu->regMcr |= mcrDefns[MCR58].bitMask; // set System Call status bit
+        activeCpu->regMcr            |= mcrDefns[MCR58].bitMask; // set System Call status bit
+        activeCpu->isConditionPending = TRUE;
         }
     cpu180Exchange(activeCpu);
     }
@@ -5092,6 +5384,7 @@ static void cp180Op04(Cpu180Context *activeCpu)  // 04  RETURN     MIGDS 2-127
         {
         activeCpu->regA[r] = cpMem[wordAddrs[i++]] & Mask48;
         }
+    activeCpu->isConditionPending = TRUE;
     for (r = 0; r <= at; r++)
         {
         if (RingOf(activeCpu->regA[r]) < ringA2)
@@ -7210,9 +7503,10 @@ static void cp180Op9F(Cpu180Context *activeCpu)  // 9F  BRCR       MIGDS 2-142
             }
         if ((activeCpu->regMcr & mask) == 0 && cpu180IsDebugTrap(activeCpu, DM_BI, brExit) == FALSE)
             {
-            activeCpu->regMcr |= mask;
-            activeCpu->regP    = brExit;
-            activeCpu->nextP   = activeCpu->regP;
+            activeCpu->regMcr            |= mask;
+            activeCpu->isConditionPending = TRUE;
+            activeCpu->regP               = brExit;
+            activeCpu->nextP              = activeCpu->regP;
             }
         break;
     case 2:
@@ -7237,9 +7531,10 @@ static void cp180Op9F(Cpu180Context *activeCpu)  // 9F  BRCR       MIGDS 2-142
     case 5:
         if ((activeCpu->regUcr & mask) == 0 && cpu180IsDebugTrap(activeCpu, DM_BI, brExit) == FALSE)
             {
-            activeCpu->regUcr |= mask;
-            activeCpu->regP  = brExit;
-            activeCpu->nextP = activeCpu->regP;
+            activeCpu->regUcr            |= mask;
+            activeCpu->isConditionPending = TRUE;
+            activeCpu->regP               = brExit;
+            activeCpu->nextP              = activeCpu->regP;
             }
         break;
     case 6:
@@ -0,0 +1,1039 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: cpubench.c
+**
+**  Description:
+**      Micro-benchmarks for the CPU instruction implementations. The
+**      CYBER 170 mixes are assembled into central memory and executed by
+**      cpuStep; the CYBER 180 floating point, integer and BDP mixes call
+**      the arithmetic kernels directly. Only the CPU modules are linked,
+**      so the results are not disturbed by PPs, channels or devices.
+**      The charset mixes time the buffer conversion kernels which the
+**      device and network modules use.
+**
+**      Results are written to standard output in JSON, one entry per
+**      mix, giving the best and mean nanoseconds per operation over a
+**      number of repetitions.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+#include "version.h"
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+#define BenchMemory            0400000  /* CM words */
+#define BenchDefaultOps        2000000
+#define BenchRepetitions       5
+#define BenchTextSize          4096     /* characters per conversion pass */
+
+/*
+**  Layout of central memory used by the CYBER 170 mixes.
+*/
+#define BenchUserXp            0100
+#define BenchMonitorXp         0200
+#define BenchUserCode          01000
+#define BenchMonitorCode       02000
+#define BenchSubroutine        03000
+#define BenchData              010000
+#define BenchCmuDest           020000
+
+/*
+**  CYBER 170 instruction fields.
+*/
+#define NO                     046000
+#define CmuLength              100
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+#define I15(fm, i, j, k)    (((u32)(fm) << 9) | ((u32)(i) << 6) | ((u32)(j) << 3) | (u32)(k))
+#define I30(fm, i, j, K)    (((u32)(fm) << 24) | ((u32)(i) << 21) | ((u32)(j) << 18) | ((u32)(K) & Mask18))
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+typedef struct benchMix
+    {
+    char *name;                         /* mix name used in the report */
+    char *description;                  /* what one operation is */
+    u32  divisor;                       /* divides the operation count */
+    void (*setup)(void);                /* prepare the mix, NULL if none */
+    u64 (*run)(u64 ops);                /* execute at least ops operations */
+    } BenchMix;
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void benchAsmAlign(void);
+static void benchAsmStart(u32 address);
+static void benchAsm15(u32 instr);
+static void benchAsm30(u32 instr);
+static void benchAsmWord(CpWord word);
+static u32  benchAsmHere(void);
+static u64  benchBdpDecimal(u64 ops);
+static void benchBdpDigits(BdpOperand *operand, u64 value);
+static void benchCmuSetup(void);
+static void benchCallSetup(void);
+static u64  benchCharsetPack12(u64 ops);
+static void benchCharsetSetup(void);
+static u64  benchCharsetTranslate(u64 ops);
+static u64  benchCharsetUnpack60(u64 ops);
+static void benchCpu170Prepare(u32 monitorP);
+static u64  benchCpu170Run(u64 ops);
+static void benchExchangeSetup(void);
+static u64  benchFloat180Double(u64 ops);
+static u64  benchFloat180Single(u64 ops);
+static void benchFloatSetup(void);
+static void benchIntegerSetup(void);
+static u64  benchInt180Mul(u64 ops);
+static void benchLoadStoreSetup(void);
+static void benchLoopEnd(u32 loop);
+static CpWord benchToCdcFloat(double value);
+static void benchXp(u32 address, u32 p, u32 ma);
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  The CPU modules reference these, they are normally provided by the
+**  rest of the emulator.
+*/
+char          ecsSharedName[64] = "";
+bool          emulationActive   = TRUE;
+ModelFeatures features          = (IsSeries70 | HasInterlockReg | HasCMU);
+bool          isCyber180        = FALSE;
+volatile bool opPaused          = FALSE;
+char          persistDir[256]   = "";
+volatile u64  rtcClock          = 0;
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static BenchMix benchMixes[] =
+    {
+    { "cpu170_integer",     "CYBER 170 instruction", 1,    benchIntegerSetup,   benchCpu170Run      },
+    { "cpu170_float",       "CYBER 170 instruction", 1,    benchFloatSetup,     benchCpu170Run      },
+    { "cpu170_load_store",  "CYBER 170 instruction", 1,    benchLoadStoreSetup, benchCpu170Run      },
+    { "cpu170_cmu",         "CYBER 170 instruction", 10,   benchCmuSetup,       benchCpu170Run      },
+    { "cpu170_exchange",    "CYBER 170 instruction", 1,    benchExchangeSetup,  benchCpu170Run      },
+    { "cpu170_call_return", "CYBER 170 instruction", 1,    benchCallSetup,      benchCpu170Run      },
+    { "float180_single",    "float180 operation",    1,    NULL,                benchFloat180Single },
+    { "float180_double",    "float180 operation",    10,   NULL,                benchFloat180Double },
+    { "int180_mul128",      "64 x 64 bit multiply",  10,   NULL,                benchInt180Mul      },
+    { "bdp180_decimal",     "BDP numeric operation", 1000, NULL,                benchBdpDecimal     },
+    { "charset_translate",  "character",             1,    benchCharsetSetup,   benchCharsetTranslate },
+    { "charset_pack12",     "byte",                  1,    benchCharsetSetup,   benchCharsetPack12  },
+    { "charset_unpack60",   "character",             1,    benchCharsetSetup,   benchCharsetUnpack60 },
+    };
+
+static u32           benchAsmAddr;
+static int           benchAsmOffset;
+static CpWord        benchAsmBuf;
+static Cpu180Context benchCtx180;
+static u8            benchText[BenchTextSize];
+static u8            benchTextOut[BenchTextSize];
+static PpWord        benchPpWords[BenchTextSize];
+static CpWord        benchCmWords[BenchTextSize / 10];
+static volatile u64  benchSink;
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Run the micro-benchmarks.
+**
+**  Parameters:     Name        Description.
+**                  argc        argument count
+**                  argv        argument list
+**
+**  Returns:        Exit status.
+**
+**------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+    {
+    double   best;
+    int      count;
+    u64      done;
+    u64      elapsed;
+    int      i;
+    int      j;
+    BenchMix *mp;
+    double   nsPerOp;
+    u64      ops;
+    u64      opsMix;
+    int      rep;
+    u64      start;
+    double   total;
+
+    ops = BenchDefaultOps;
+    if ((argc > 2) && (strcmp(argv[1], "-n") == 0))
+        {
+        ops   = strtoull(argv[2], NULL, 0);
+        argv += 2;
+        argc -= 2;
+        }
+    if ((ops == 0) || ((argc > 1) && ((strcmp(argv[1], "-?") == 0) || (strcmp(argv[1], "/?") == 0))))
+        {
+        fprintf(stderr, "Usage: cpubench [-n <ops>] [<mix> ...]\n");
+        fprintf(stderr, "  mixes:");
+        for (i = 0; i < (int)(sizeof(benchMixes) / sizeof(benchMixes[0])); i++)
+            {
+            fprintf(stderr, " %s", benchMixes[i].name);
+            }
+        fprintf(stderr, "\n");
+
+        return 1;
+        }
+
+    /*
+    **  Set up a single CYBER 170 CPU without the rest of the machine.
+    */
+    cpMem        = calloc(BenchMemory, sizeof(CpWord));
+    cpus170      = calloc(1, sizeof(Cpu170Context));
+    if ((cpMem == NULL) || (cpus170 == NULL))
+        {
+        fputs("(cpubench) Failed to allocate CPU memory\n", stderr);
+        exit(1);
+        }
+    cpuMaxMemory = BenchMemory;
+    cpuReset(cpus170);
+
+    printf("{\n");
+    printf("  \"version\": \"%s\",\n", DtCyberVersion);
+    printf("  \"repetitions\": %d,\n", BenchRepetitions);
+    printf("  \"benchmarks\": [");
+
+    count = 0;
+    for (i = 0; i < (int)(sizeof(benchMixes) / sizeof(benchMixes[0])); i++)
+        {
+        mp = benchMixes + i;
+        if (argc > 1)
+            {
+            for (j = 1; j < argc; j++)
+                {
+                if (strcmp(argv[j], mp->name) == 0)
+                    {
+                    break;
+                    }
+                }
+            if (j >= argc)
+                {
+                continue;
+                }
+            }
+
+        /*
+        **  One untimed pass to warm caches, then the timed repetitions.
+        */
+        opsMix = (ops + mp->divisor - 1) / mp->divisor;
+        if (mp->setup != NULL)
+            {
+            mp->setup();
+            }
+        mp->run((opsMix + 9) / 10);
+
+        best  = 0.0;
+        total = 0.0;
+        for (rep = 0; rep < BenchRepetitions; rep++)
+            {
+            start   = getMicroseconds();
+            done    = mp->run(opsMix);
+            elapsed = getMicroseconds() - start;
+            nsPerOp = ((double)elapsed * 1000.0) / (double)done;
+            if ((rep == 0) || (nsPerOp < best))
+                {
+                best = nsPerOp;
+                }
+            total += nsPerOp;
+            }
+
+        printf("%s\n    { \"name\": \"%s\", \"op\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, \"ns_per_op_mean\": %.3f }",
+               count > 0 ? "," : "", mp->name, mp->description, (unsigned long long)done, best, total / BenchRepetitions);
+        fflush(stdout);
+        count += 1;
+        }
+
+    printf("\n  ]\n");
+    printf("}\n");
+
+    return 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stubs for functions the CPU modules reference.
+**
+**------------------------------------------------------------------------*/
+void idleThrottle(Cpu170Context *ctx)
+    {
+    }
+
+void logDtError(char *file, int line, char *fmt, ...)
+    {
+    va_list param;
+
+    va_start(param, fmt);
+    fprintf(stderr, "(%s:%d) ", file, line);
+    vfprintf(stderr, fmt, param);
+    va_end(param);
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Pad the current instruction word with pass
+**                  instructions and store it, so that the next
+**                  instruction starts a new word.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchAsmAlign(void)
+    {
+    while (benchAsmOffset != 60)
+        {
+        benchAsm15(NO);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Start assembling at an address.
+**
+**  Parameters:     Name        Description.
+**                  address     CM address
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchAsmStart(u32 address)
+    {
+    benchAsmAddr   = address;
+    benchAsmOffset = 60;
+    benchAsmBuf    = 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Assemble a 15 bit instruction.
+**
+**  Parameters:     Name        Description.
+**                  instr       instruction
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchAsm15(u32 instr)
+    {
+    benchAsmOffset -= 15;
+    benchAsmBuf    |= (CpWord)(instr & Mask15) << benchAsmOffset;
+    if (benchAsmOffset == 0)
+        {
+        cpMem[benchAsmAddr++] = benchAsmBuf;
+        benchAsmOffset        = 60;
+        benchAsmBuf           = 0;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Assemble a 30 bit instruction. An instruction which
+**                  would straddle a word boundary starts a new word.
+**
+**  Parameters:     Name        Description.
+**                  instr       instruction
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchAsm30(u32 instr)
+    {
+    if (benchAsmOffset < 30)
+        {
+        benchAsmAlign();
+        }
+    benchAsmOffset -= 30;
+    benchAsmBuf    |= (CpWord)(instr & Mask30) << benchAsmOffset;
+    if (benchAsmOffset == 0)
+        {
+        cpMem[benchAsmAddr++] = benchAsmBuf;
+        benchAsmOffset        = 60;
+        benchAsmBuf           = 0;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Assemble a data word.
+**
+**  Parameters:     Name        Description.
+**                  word        data
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchAsmWord(CpWord word)
+    {
+    benchAsmAlign();
+    cpMem[benchAsmAddr++] = word & Mask60;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Get the address of the next instruction word, for use
+**                  as a branch target.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        CM address.
+**
+**------------------------------------------------------------------------*/
+static u32 benchAsmHere(void)
+    {
+    benchAsmAlign();
+
+    return benchAsmAddr;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        BDP numeric mix. One operation decodes two 18 digit
+**                  operands, adds, subtracts, multiplies or divides
+**                  them, and encodes the result, as the CYBER 180 BDP
+**                  numeric instructions do.
+**
+**  Parameters:     Name        Description.
+**                  ops         number of operations
+**
+**  Returns:        Number of operations executed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchBdpDecimal(u64 ops)
+    {
+    BdpOperand    a;
+    BdpOperand    b;
+    UserCondition cond;
+    u64           n;
+    BdpOperand    r;
+    u8            digit;
+
+    for (n = 0; n < ops; n++)
+        {
+        benchBdpDigits(&a, 123456789012345678ULL + n);
+        benchBdpDigits(&b, 987654321 + (n & 0xffff));
+        switch (n & 3)
+            {
+        case 0:
+            bdp180Add(&a, &b, &r, &cond);
+            break;
+
+        case 1:
+            bdp180Sub(&a, &b, &r, &cond);
+            break;
+
+        case 2:
+            bdp180Mul(&a, &b, &r, &cond);
+            break;
+
+        case 3:
+            bdp180Div(&a, &b, &r, &cond);
+            break;
+            }
+        while ((r.value[0] | r.value[1] | r.value[2] | r.value[3]) != 0)
+            {
+            bdp180Div10(&r, &digit);
+            benchSink += digit;
+            }
+        }
+
+    return ops;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Build a BDP operand from the decimal digits of a
+**                  value, most significant digit first.
+**
+**  Parameters:     Name        Description.
+**                  operand     operand to build
+**                  value       binary value
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchBdpDigits(BdpOperand *operand, u64 value)
+    {
+    u8  digits[20];
+    int i;
+
+    for (i = 0; i < 18; i++)
+        {
+        digits[i] = value % 10;
+        value    /= 10;
+        }
+    memset(operand, 0, sizeof(BdpOperand));
+    for (i = 17; i >= 0; i--)
+        {
+        bdp180Mul10(operand);
+        bdp180AddDigit(operand, digits[i]);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Call/return mix. A return jump to a subroutine which
+**                  returns through its entry word.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchCallSetup(void)
+    {
+    u32 loop;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    benchAsmStart(BenchUserCode);
+    loop = benchAsmHere();
+    benchAsm15(I15(036, 6, 6, 1));              /* IX6 X6+X1 */
+    benchAsm30(I30(001, 0, 0, BenchSubroutine)); /* RJ  SUB */
+    benchAsmAlign();
+    benchLoopEnd(loop);
+
+    benchAsmStart(BenchSubroutine);
+    benchAsmWord(0);                            /* SUB entry/exit */
+    benchAsm15(I15(036, 7, 7, 1));              /* IX7 X7+X1 */
+    benchAsm30(I30(002, 0, 0, BenchSubroutine)); /* JP  SUB */
+    benchAsmAlign();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Pack bytes into PP words, as the tape and disk drivers
+**                  do for packed channel transfers.
+**
+**  Parameters:     Name        Description.
+**                  ops         minimum number of bytes to pack
+**
+**  Returns:        Number of bytes packed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchCharsetPack12(u64 ops)
+    {
+    u64 n;
+
+    for (n = 0; n < ops; n += BenchTextSize)
+        {
+        benchSink += charsetPack8To12(benchPpWords, benchText, BenchTextSize);
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Fill the conversion buffers with printable text.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchCharsetSetup(void)
+    {
+    int i;
+
+    for (i = 0; i < BenchTextSize; i++)
+        {
+        benchText[i] = (u8)(' ' + (i * 7) % 95);
+        }
+    for (i = 0; i < BenchTextSize / 10; i++)
+        {
+        benchCmWords[i] = ((CpWord)0x0123456789abcdefULL * (i + 1)) & Mask60;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Translate ASCII to EBCDIC, as the HASP and NJE TIPs do.
+**
+**  Parameters:     Name        Description.
+**                  ops         minimum number of characters to translate
+**
+**  Returns:        Number of characters translated.
+**
+**------------------------------------------------------------------------*/
+static u64 benchCharsetTranslate(u64 ops)
+    {
+    u64 n;
+
+    for (n = 0; n < ops; n += BenchTextSize)
+        {
+        charsetTranslate(benchTextOut, benchText, BenchTextSize, asciiToEbcdic);
+        benchSink += benchTextOut[n & (BenchTextSize - 1)];
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Unpack 60 bit words into display code characters.
+**
+**  Parameters:     Name        Description.
+**                  ops         minimum number of characters to unpack
+**
+**  Returns:        Number of characters unpacked.
+**
+**------------------------------------------------------------------------*/
+static u64 benchCharsetUnpack60(u64 ops)
+    {
+    u64 n;
+
+    for (n = 0; n < ops; n += (BenchTextSize / 10) * 10)
+        {
+        charsetUnpack60To6(benchTextOut, benchCmWords, BenchTextSize / 10);
+        benchSink += benchTextOut[n % BenchTextSize];
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CMU mix. Indirect moves of 100 characters between
+**                  word aligned fields.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchCmuSetup(void)
+    {
+    CpWord desc;
+    int    i;
+    u32    loop;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    for (i = 0; i < (CmuLength + 9) / 10; i++)
+        {
+        cpMem[BenchData + i] = 0010203040506071011ULL + i;
+        }
+    desc = ((CpWord)(CmuLength >> 4) << 48) | ((CpWord)BenchData << 30)
+           | ((CpWord)(CmuLength & Mask4) << 26) | (CpWord)BenchCmuDest;
+    benchAsmStart(BenchData - 1);
+    benchAsmWord(desc);
+
+    benchAsmStart(BenchUserCode);
+    loop = benchAsmHere();
+    benchAsm30(I30(046, 4, 0, BenchData - 1));  /* IM  DESC */
+    benchAsmAlign();
+    benchAsm15(I15(036, 6, 6, 1));              /* IX6 X6+X1 */
+    benchLoopEnd(loop);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Clear CM and set up the user and monitor exchange
+**                  packages for a CYBER 170 mix. The monitor program
+**                  is a loop which exchanges back to the user program.
+**
+**  Parameters:     Name        Description.
+**                  monitorP    P of the monitor program
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchCpu170Prepare(u32 monitorP)
+    {
+    u32 loop;
+
+    memset((void *)cpMem, 0, BenchMemory * sizeof(CpWord));
+    cpuReset(cpus170);
+
+    benchXp(BenchUserXp, BenchUserCode, BenchMonitorXp);
+    benchXp(BenchMonitorXp, monitorP, 0);
+
+    benchAsmStart(BenchMonitorCode);
+    loop = benchAsmHere();
+    benchAsm30(I30(001, 3, 0, BenchMonitorXp)); /* XJ  B0+MXP */
+    benchAsmAlign();
+    benchLoopEnd(loop);
+
+    /*
+    **  Start the user program the way a PP would, by an exchange jump.
+    */
+    cpus170->ppRequestingExchange = 0;
+    cpus170->ppExchangeAddress    = BenchUserXp;
+    cpus170->doChangeMode         = FALSE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Execute a CYBER 170 mix.
+**
+**  Parameters:     Name        Description.
+**                  ops         minimum number of instructions
+**
+**  Returns:        Number of instructions executed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchCpu170Run(u64 ops)
+    {
+    u64 start;
+
+    start = cpus170->instructionCount;
+    while (cpus170->instructionCount - start < ops)
+        {
+        cpuStep(cpus170);
+        if (cpus170->isStopped)
+            {
+            fputs("(cpubench) CPU stopped unexpectedly\n", stderr);
+            exit(1);
+            }
+        }
+
+    return cpus170->instructionCount - start;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Exchange mix. The user program exchanges to the
+**                  monitor program, which exchanges straight back.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchExchangeSetup(void)
+    {
+    u32 loop;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    benchAsmStart(BenchUserCode);
+    loop = benchAsmHere();
+    benchAsm30(I30(001, 3, 0, 0));              /* XJ */
+    benchAsmAlign();
+    benchLoopEnd(loop);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 180 double precision floating point mix,
+**                  cycling through add, subtract, multiply and divide.
+**
+**  Parameters:     Name        Description.
+**                  ops         number of operations
+**
+**  Returns:        Number of operations executed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchFloat180Double(u64 ops)
+    {
+    Cpu180Double a;
+    Cpu180Double b;
+    u64          n;
+    Cpu180Double r;
+
+    a.leftPart  = float180ConvertIntToFloat(1234567);
+    a.rightPart = 0;
+    b.leftPart  = float180ConvertIntToFloat(89);
+    b.rightPart = 0;
+    for (n = 0; n < ops; n += 4)
+        {
+        float180AddDouble(&benchCtx180, &a, &b, &r);
+        benchSink += r.rightPart;
+        float180SubDouble(&benchCtx180, &a, &b, &r);
+        benchSink += r.rightPart;
+        float180MulDouble(&benchCtx180, &a, &b, &r);
+        benchSink += r.rightPart;
+        float180DivDouble(&benchCtx180, &a, &b, &r);
+        benchSink += r.rightPart;
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 180 single precision floating point mix,
+**                  cycling through add, subtract, multiply, divide,
+**                  compare and conversion to integer.
+**
+**  Parameters:     Name        Description.
+**                  ops         number of operations
+**
+**  Returns:        Number of operations executed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchFloat180Single(u64 ops)
+    {
+    u64 a;
+    u64 b;
+    u64 n;
+    u64 r;
+    int valence;
+
+    a = float180ConvertIntToFloat(1234567);
+    b = float180ConvertIntToFloat(89);
+    for (n = 0; n < ops; n += 6)
+        {
+        float180AddFloat(&benchCtx180, a, b, &r);
+        benchSink += r;
+        float180SubFloat(&benchCtx180, a, b, &r);
+        benchSink += r;
+        float180MulFloat(&benchCtx180, a, b, &r);
+        benchSink += r;
+        float180DivFloat(&benchCtx180, a, b, &r);
+        benchSink += r;
+        float180CompareFloat(&benchCtx180, a, r, &valence);
+        benchSink += valence;
+        float180ConvertFloatToInt(&benchCtx180, r, &r);
+        benchSink += r;
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 170 floating point mix.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchFloatSetup(void)
+    {
+    u32 loop;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    /*
+    **  X1 - X4 hold the operands.
+    */
+    benchAsmStart(BenchData);
+    benchAsmWord(benchToCdcFloat(1.5));
+    benchAsmWord(benchToCdcFloat(2.25));
+    benchAsmWord(benchToCdcFloat(1000.125));
+    benchAsmWord(benchToCdcFloat(3.0));
+
+    benchAsmStart(BenchUserCode);
+    benchAsm30(I30(051, 1, 0, BenchData));      /* SA1 BDATA */
+    benchAsm15(I15(054, 2, 1, 1));              /* SA2 A1+B1 */
+    benchAsm15(I15(054, 3, 2, 1));              /* SA3 A2+B1 */
+    benchAsm15(I15(054, 4, 3, 1));              /* SA4 A3+B1 */
+    loop = benchAsmHere();
+    benchAsm15(I15(030, 6, 1, 2));              /* FX6 X1+X2 */
+    benchAsm15(I15(031, 7, 3, 4));              /* FX7 X3-X4 */
+    benchAsm15(I15(040, 0, 6, 7));              /* FX0 X6*X7 */
+    benchAsm15(I15(044, 5, 3, 2));              /* FX5 X3/X2 */
+    benchAsm15(I15(034, 6, 1, 3));              /* RX6 X1+X3 */
+    benchAsm15(I15(041, 7, 2, 4));              /* RX7 X2*X4 */
+    benchAsm15(I15(042, 0, 1, 2));              /* DX0 X1*X2 */
+    benchAsm15(I15(045, 5, 4, 1));              /* RX5 X4/X1 */
+    benchAsm15(I15(024, 6, 0, 5));              /* NX6 B0,X5 */
+    benchAsm15(I15(026, 7, 0, 3));              /* UX7 B0,X3 */
+    benchAsm15(I15(027, 6, 0, 7));              /* PX6 B0,X7 */
+    benchLoopEnd(loop);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 180 64 x 64 bit integer multiply, as used by
+**                  the integer and floating point multiply instructions.
+**
+**  Parameters:     Name        Description.
+**                  ops         number of operations
+**
+**  Returns:        Number of operations executed.
+**
+**------------------------------------------------------------------------*/
+static u64 benchInt180Mul(u64 ops)
+    {
+    u64 a;
+    u64 n;
+    u64 upper;
+
+    a = 0x0123456789abcdefULL;
+    for (n = 0; n < ops; n++)
+        {
+        benchSink += float180MulLong128(a + n, 0xfedcba9876543210ULL - n, &upper);
+        benchSink += upper;
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 170 integer and logical mix.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchIntegerSetup(void)
+    {
+    u32 loop;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    benchAsmStart(BenchUserCode);
+    benchAsm30(I30(071, 1, 0, 0123456));        /* SX1 123456B */
+    benchAsm30(I30(071, 2, 0, 0765432));        /* SX2 765432B */
+    benchAsm30(I30(071, 3, 0, 0177));           /* SX3 177B */
+    loop = benchAsmHere();
+    benchAsm15(I15(036, 6, 1, 2));              /* IX6 X1+X2 */
+    benchAsm15(I15(037, 7, 6, 3));              /* IX7 X6-X3 */
+    benchAsm15(I15(011, 6, 1, 2));              /* BX6 X1*X2 */
+    benchAsm15(I15(012, 7, 6, 3));              /* BX7 X6+X3 */
+    benchAsm15(I15(013, 6, 7, 1));              /* BX6 X7-X1 */
+    benchAsm15(I15(020, 7, 0, 7));              /* LX7 7 */
+    benchAsm15(I15(021, 6, 0, 3));              /* AX6 3 */
+    benchAsm15(I15(047, 0, 0, 7));              /* CX0 X7 */
+    benchAsm15(I15(042, 5, 1, 3));              /* IX5 X1*X3 */
+    benchAsm15(I15(043, 4, 1, 4));              /* MX4 14B */
+    benchAsm15(I15(066, 3, 6, 1));              /* SB3 B6+B1 */
+    benchAsm15(I15(067, 6, 3, 1));              /* SB6 B3-B1 */
+    benchLoopEnd(loop);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        CYBER 170 load and store mix, walking through a
+**                  table of 1000 words.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchLoadStoreSetup(void)
+    {
+    int i;
+    u32 loop;
+    u32 outer;
+
+    benchCpu170Prepare(BenchMonitorCode);
+
+    for (i = 1; i <= 01000; i++)
+        {
+        cpMem[BenchData + i] = i;
+        }
+
+    benchAsmStart(BenchUserCode);
+    outer = benchAsmHere();
+    benchAsm30(I30(061, 2, 0, 01000));          /* SB2 1000B */
+    benchAsm30(I30(051, 1, 0, BenchData));      /* SA1 BDATA */
+    benchAsm30(I30(051, 6, 0, BenchCmuDest));   /* SA6 BDEST */
+    loop = benchAsmHere();
+    benchAsm15(I15(054, 1, 1, 1));              /* SA1 A1+B1 */
+    benchAsm15(I15(036, 6, 1, 6));              /* IX6 X1+X6 */
+    benchAsm15(I15(054, 6, 6, 1));              /* SA6 A6+B1 */
+    benchAsm15(I15(067, 2, 2, 1));              /* SB2 B2-B1 */
+    benchAsm30(I30(005, 2, 0, loop));           /* NE  B2,B0,LOOP */
+    benchAsm30(I30(004, 0, 0, outer));          /* EQ  OUTER */
+    benchAsmAlign();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Assemble the branch back to the top of a loop.
+**
+**  Parameters:     Name        Description.
+**                  loop        address of the loop
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchLoopEnd(u32 loop)
+    {
+    benchAsm30(I30(004, 0, 0, loop));           /* EQ  LOOP */
+    benchAsmAlign();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Convert a positive host value to CYBER 170 single
+**                  precision floating point.
+**
+**  Parameters:     Name        Description.
+**                  value       value to convert
+**
+**  Returns:        CYBER 170 floating point word.
+**
+**------------------------------------------------------------------------*/
+static CpWord benchToCdcFloat(double value)
+    {
+    int    exponent;
+    double fraction;
+
+    fraction = frexp(value, &exponent);
+
+    return ((CpWord)((exponent - 48 + 02000) & Mask11) << 48) | ((CpWord)ldexp(fraction, 48) & Mask48);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Build an exchange package for a program with RA 0,
+**                  FL covering the benchmark memory and B1 = 1.
+**
+**  Parameters:     Name        Description.
+**                  address     package address
+**                  p           program address
+**                  ma          monitor address
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void benchXp(u32 address, u32 p, u32 ma)
+    {
+    volatile CpWord *xp;
+
+    xp    = cpMem + address;
+    xp[0] = (CpWord)p << 36;
+    xp[1] = 1;
+    xp[2] = (CpWord)BenchMemory << 36;
+    xp[6] = (CpWord)ma << 36;
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
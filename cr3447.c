@@ -496,6 +496,32 @@ void cr3447Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     lastCr3447 = cc;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Determine whether the input tray of a 3447 card
+**                  reader is full.
+**
+**  Parameters:     Name        Description.
+**                  channelNo   Channel number of card reader
+**                  equipmentNo Equipment number of card reader
+**
+**  Returns:        TRUE if no further deck can be loaded.
+**
+**------------------------------------------------------------------------*/
+bool cr3447IsTrayFull(int channelNo, int equipmentNo)
+    {
+    CrContext *cc;
+    DevSlot   *dp;
+
+    dp = dcc6681FindDevice((u8)channelNo, (u8)equipmentNo, DtCr3447);
+    if (dp == NULL)
+        {
+        return FALSE;
+        }
+    cc = (CrContext *)(dp->context[0]);
+
+    return ((cc->inDeck + 1) % Cr3447MaxDecks) == cc->outDeck;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Load cards on 3447 card reader.
 **
@@ -555,18 +581,19 @@ void cr3447LoadCards(char *fname, int channelNo, int equipmentNo, char *params)
     cc->decks[cc->inDeck] = sp;
     cc->inDeck            = (cc->inDeck + 1) % Cr3447MaxDecks;
 
+    //  A reader which is still reading an earlier deck takes this one
+    //  up when that deck ends
+
     if (dp->fcb[0] == NULL)
         {
-        if (cr3447StartNextDeck(dp, cc))
+        if (!cr3447StartNextDeck(dp, cc))
             {
-            return;
+            //  Starting the next deck was not possible
+
+            dp->fcb[0] = NULL;
+            cc->status = StCr3447Eof;
             }
         }
-
-    //  Starting the next deck was not possible
-
-    dp->fcb[0] = NULL;
-    cc->status = StCr3447Eof;
     }
 
 /*--------------------------------------------------------------------------
@@ -652,6 +679,26 @@ void cr3447GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params
         return;
         }
 
+    /*
+    **  A watched input directory keeps its own queue of decks in
+    **  arrival order, so there is no need to scan the directory.
+    */
+    if (cc->isWatched)
+        {
+        if (fsDequeueDeck(cc->channelNo, cc->eqNo, DtCr3447, fOldest, sizeof(fOldest)))
+            {
+            opDisplay("(cr3447 ) Dequeueing unprocessed file '%s' from '%s'.\n", fOldest, cc->dirInput);
+            strcpy(fname, fOldest);
+            cr3447SwapInOut(cc, fname);
+            }
+        else
+            {
+            opDisplay("(cr3447 ) No files found in '%s'.\n", cc->dirInput);
+            }
+
+        return;
+        }
+
     curDir = opendir(cc->dirInput);
     if (curDir == NULL)
         {
@@ -686,17 +733,18 @@ void cr3447GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params
         if (fOldest[0] == '\0')
             {
             strcpy(fOldest, strWork);
-            tOldest = s.st_ctime;
+            tOldest = s.st_mtime;
             }
         else
             {
-            if (s.st_ctime > tOldest)
+            if (s.st_mtime < tOldest)
                 {
                 strcpy(fOldest, strWork);
-                tOldest = s.st_ctime;
+                tOldest = s.st_mtime;
                 }
             }
         } while (curDirEntry != NULL);
+    closedir(curDir);
 
     if (fOldest[0] != '\0')
         {
@@ -861,8 +909,10 @@ void cr3447ShowStatus()
             opDisplay(", raw");
             }
         opDisplay(", seq %d", cp->seqNum);
+        opDisplay(", tray %d", (cp->inDeck - cp->outDeck + Cr3447MaxDecks) % Cr3447MaxDecks);
         if (cp->isWatched)
             {
+            opDisplay(", queued %d", fsQueueDepth(cp->channelNo, cp->eqNo, DtCr3447));
             opDisplay(", in %s/", cp->dirInput);
             if (cp->dirOutput != NULL)
                 {
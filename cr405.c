@@ -498,6 +498,32 @@ void cr405Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     lastCr405 = cc;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Determine whether the input tray of a 405 card
+**                  reader is full.
+**
+**  Parameters:     Name        Description.
+**                  channelNo   Channel number of card reader
+**                  equipmentNo Equipment number of card reader
+**
+**  Returns:        TRUE if no further deck can be loaded.
+**
+**------------------------------------------------------------------------*/
+bool cr405IsTrayFull(int channelNo, int equipmentNo)
+    {
+    Cr405Context *cc;
+    DevSlot      *dp;
+
+    dp = channelFindDevice((u8)channelNo, DtCr405);
+    if (dp == NULL)
+        {
+        return FALSE;
+        }
+    cc = (Cr405Context *)(dp->context[0]);
+
+    return ((cc->inDeck + 1) % Cr405MaxDecks) == cc->outDeck;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Load cards on 405 card reader.
 **
@@ -557,17 +583,18 @@ void cr405LoadCards(char *fname, int channelNo, int equipmentNo, char *params)
     cc->decks[cc->inDeck] = sp;
     cc->inDeck            = (cc->inDeck + 1) % Cr405MaxDecks;
 
+    //  A reader which is still reading an earlier deck takes this one
+    //  up when that deck ends
+
     if (dp->fcb[0] == NULL)
         {
-        if (cr405StartNextDeck(dp, cc))
+        if (!cr405StartNextDeck(dp, cc))
             {
-            return;
+            //  Starting the next deck was not possible
+
+            dp->fcb[0] = NULL;
             }
         }
-
-    //  Starting the next deck was not possible
-
-    dp->fcb[0] = NULL;
     }
 
 /*--------------------------------------------------------------------------
@@ -652,7 +679,33 @@ void cr405GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params)
         return;
         }
 
+    /*
+    **  A watched input directory keeps its own queue of decks in
+    **  arrival order, so there is no need to scan the directory.
+    */
+    if (cc->isWatched)
+        {
+        if (fsDequeueDeck(cc->channelNo, cc->eqNo, DtCr405, fOldest, sizeof(fOldest)))
+            {
+            opDisplay("(cr405  ) Dequeueing unprocessed file '%s' from '%s'.\n", fOldest, cc->dirInput);
+            strcpy(fname, fOldest);
+            cr405SwapInOut(cc, fname);
+            }
+        else
+            {
+            opDisplay("(cr405  ) No files found in '%s'.\n", cc->dirInput);
+            }
+
+        return;
+        }
+
     curDir = opendir(cc->dirInput);
+    if (curDir == NULL)
+        {
+        opDisplay("(cr405  ) Failed to open card reader directory '%s'.\n", cc->dirInput);
+
+        return;
+        }
 
     /*
     **  Scan the input directory (if specified)
@@ -680,17 +733,18 @@ void cr405GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params)
         if (fOldest[0] == '\0')
             {
             strcpy(fOldest, strWork);
-            tOldest = s.st_ctime;
+            tOldest = s.st_mtime;
             }
         else
             {
-            if (s.st_ctime > tOldest)
+            if (s.st_mtime < tOldest)
                 {
                 strcpy(fOldest, strWork);
-                tOldest = s.st_ctime;
+                tOldest = s.st_mtime;
                 }
             }
         } while (curDirEntry != NULL);
+    closedir(curDir);
 
     if (fOldest[0] != '\0')
         {
@@ -850,8 +904,10 @@ void cr405ShowStatus()
         {
         opDisplay("    >   %-8s C%02o E%02o U%02o", "405", cp->channelNo, cp->eqNo, cp->unitNo);
         opDisplay("   %-20s  (seq %d", cp->curFileName != NULL ? cp->curFileName : "", cp->seqNum);
+        opDisplay(", tray %d", (cp->inDeck - cp->outDeck + Cr405MaxDecks) % Cr405MaxDecks);
         if (cp->isWatched)
             {
+            opDisplay(", queued %d", fsQueueDepth(cp->channelNo, cp->eqNo, DtCr405));
             opDisplay(", in %s/", cp->dirInput);
             if (cp->dirOutput != NULL)
                 {
@@ -202,6 +202,7 @@ typedef struct feiParam
 #else
     int                fd;
 #endif
+    NetPollEntry       poll;
     FeiLcpParams       lcpParams;
     u32                subsegSize;
     FeiBuffer          inputBuffer;
@@ -478,11 +479,6 @@ static void csFeiActivate(void)
 **------------------------------------------------------------------------*/
 static void csFeiCheckStatus(FeiParam *feip)
     {
-    fd_set         readFds;
-    int            readySockets;
-    struct timeval timeout;
-    fd_set         writeFds;
-
     /*
     **  First, process possible connection in progress
     */
@@ -492,12 +488,7 @@ static void csFeiCheckStatus(FeiParam *feip)
         }
     else if ((feip->fd > 0) && (feip->state == StCsFeiConnecting))
         {
-        FD_ZERO(&writeFds);
-        FD_SET(feip->fd, &writeFds);
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 0;
-        readySockets    = select((int)(feip->fd + 1), NULL, &writeFds, NULL, &timeout);
-        if ((readySockets > 0) && FD_ISSET(feip->fd, &writeFds))
+        if (netPollTake(&feip->poll, NetPollOut))
             {
             csFeiReset(feip);
             if (csFeiSetupConnection(feip))
@@ -512,26 +503,21 @@ static void csFeiCheckStatus(FeiParam *feip)
     */
     if ((feip->fd > 0) && (feip->state > StCsFeiConnecting))
         {
-        FD_ZERO(&readFds);
-        FD_ZERO(&writeFds);
-        FD_SET(feip->fd, &readFds);
         if (feip->outputBuffer.out < feip->outputBuffer.in)
             {
-            FD_SET(feip->fd, &writeFds);
+            netPollWant(&feip->poll, NetPollIn | NetPollOut);
             }
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 0;
-        readySockets    = select((int)(feip->fd + 1), &readFds, &writeFds, NULL, &timeout);
-        if (readySockets > 0)
+        else
             {
-            if (FD_ISSET(feip->fd, &readFds))
-                {
-                csFeiReceiveData(feip);
-                }
-            if ((feip->fd > 0) && FD_ISSET(feip->fd, &writeFds))
-                {
-                csFeiSendData(feip);
-                }
+            netPollWant(&feip->poll, NetPollIn);
+            }
+        if (netPollTake(&feip->poll, NetPollIn))
+            {
+            csFeiReceiveData(feip);
+            }
+        if ((feip->fd > 0) && netPollTake(&feip->poll, NetPollOut))
+            {
+            csFeiSendData(feip);
             }
         }
     }
@@ -551,6 +537,7 @@ static void csFeiCloseConnection(FeiParam *feip)
     fprintf(csFeiLog, "\n%010u Close connection on socket %d to %s:%u", traceSequenceNo,
             feip->fd, feip->serverName, ntohs(feip->serverAddr.sin_port));
 #endif
+    netPollRemove(&feip->poll);
     netCloseConnection(feip->fd);
     feip->fd    = 0;
     feip->state = StCsFeiDisconnected;
@@ -690,6 +677,7 @@ static void csFeiInitiateConnection(FeiParam *feip)
         {
         feip->fd    = fd;
         feip->state = StCsFeiConnecting;
+        netPollAdd(&feip->poll, fd, NetPollOut);
 #if DEBUG
         fprintf(csFeiLog, "\n%010u Initiated connection on socket %d to %s:%u", traceSequenceNo,
                 feip->fd, feip->serverName, ntohs(feip->serverAddr.sin_port));
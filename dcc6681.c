@@ -191,6 +191,10 @@ void dcc6681Terminate(DevSlot *dp)
             {
             if (cp->device3000[i] != NULL)
                 {
+                if (cp->device3000[i]->devType == DtLp5xx)
+                    {
+                    lp3000Terminate(cp->device3000[i]);
+                    }
                 for (j = 0; j < MaxEquipment; j++)
                     {
                     if (cp->device3000[i]->context[j] != NULL)
@@ -118,6 +118,7 @@ typedef struct diskParam
     i32              sector;
     i32              track;
     i32              head;
+    MetricsUnit      *stats;
     } DiskParam;
 
 /*
@@ -275,6 +276,8 @@ void dd6603Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
         exit(1);
         }
 
+    diskP->stats = metricsRegisterUnit(DtDd6603, channelNo, eqNo, unitNo);
+
     if (deviceName == NULL)
         {
         sprintf(fname, "DD6603_C%02oU%1o", channelNo, unitNo);
@@ -342,6 +345,7 @@ static FcStatus dd6603Func(PpWord funcCode)
     FILE      *fcb = activeDevice->fcb[activeDevice->selectedUnit];
     DiskParam *dp  = (DiskParam *)activeDevice->context[activeDevice->selectedUnit];
     i32       pos;
+    u64       start;
 
 #if DEBUG
     dd6603LogFlush();
@@ -366,7 +370,9 @@ static FcStatus dd6603Func(PpWord funcCode)
             {
             return (FcDeclined);
             }
+        start = getMicroseconds();
         fseek(fcb, pos, SEEK_SET);
+        metricsCountUnitIo(dp->stats, MetricsIoPosition, 0, start);
         logColumn = 0;
         break;
 
@@ -378,7 +384,9 @@ static FcStatus dd6603Func(PpWord funcCode)
             {
             return (FcDeclined);
             }
+        start = getMicroseconds();
         fseek(fcb, pos, SEEK_SET);
+        metricsCountUnitIo(dp->stats, MetricsIoPosition, 0, start);
         logColumn = 0;
         break;
 
@@ -426,7 +434,12 @@ static FcStatus dd6603Func(PpWord funcCode)
 static void dd6603Io(void)
     {
     FILE      *fcb = activeDevice->fcb[activeDevice->selectedUnit];
+    DiskParam *dp  = (DiskParam *)activeDevice->context[activeDevice->selectedUnit];
 
+    /*
+    **  Words are transferred through the stream buffer, so only the
+    **  sector seek in dd6603Func is timed.
+    */
     switch (activeDevice->fcode & Fc6603CodeMask)
         {
     default:
@@ -440,6 +453,7 @@ static void dd6603Io(void)
         if (!activeChannel->full)
             {
             fread(&activeChannel->data, 2, 1, fcb);
+            metricsCountUnitOps(dp->stats, MetricsIoRead, 2);
             activeChannel->full = TRUE;
 
 #if DEBUG
@@ -452,6 +466,7 @@ static void dd6603Io(void)
         if (activeChannel->full)
             {
             fwrite(&activeChannel->data, 2, 1, fcb);
+            metricsCountUnitOps(dp->stats, MetricsIoWrite, 2);
             activeChannel->full = FALSE;
 
 #if DEBUG
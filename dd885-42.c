@@ -140,6 +140,8 @@ typedef struct diskParam
     PpWord           emAddress[2];
     PpWord           writeParams[4];
     Sector           buffer;
+    bool             isRamDisk;
+    MetricsUnit      *stats;
     } DiskParam;
 
 /*
@@ -269,8 +271,11 @@ void dd885_42Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     time_t    mTime;
     struct tm *lTime;
     u8        yy, mm, dd;
+    bool      isNew;
+    bool      isRamSaved;
 
     char *opt = NULL;
+    char *token;
 
     if (extMaxMemory == 0)
         {
@@ -312,6 +317,7 @@ void dd885_42Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
         }
 
     dp->unitNo = unitNo;
+    dp->stats  = metricsRegisterUnit(DtDd885_42, channelNo, eqNo, unitNo);
 
     /*
     **  Determine if any options have been specified.
@@ -321,14 +327,35 @@ void dd885_42Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
         opt = strchr(deviceName, ',');
         }
 
+    isRamSaved = FALSE;
     if (opt != NULL)
         {
         /*
         **  Process options.
         */
         *opt++ = '\0';
-        logDtError(LogErrorLocation, "Unrecognized option name %s\n", opt);
-        exit(1);
+
+        for (token = strtok(opt, ","); token != NULL; token = strtok(NULL, ","))
+            {
+            if (strcmp(token, "ram") == 0)
+                {
+                dp->isRamDisk = TRUE;
+                }
+            else if (strcmp(token, "save") == 0)
+                {
+                isRamSaved = TRUE;
+                }
+            else
+                {
+                logDtError(LogErrorLocation, "Unrecognized option name %s\n", token);
+                exit(1);
+                }
+            }
+        if (isRamSaved && !dp->isRamDisk)
+            {
+            logDtError(LogErrorLocation, "Option 'save' requires option 'ram'\n");
+            exit(1);
+            }
         }
 
     /*
@@ -390,23 +417,39 @@ void dd885_42Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
         }
 
     /*
-    **  Try to open existing disk image.
+    **  Try to open existing disk image. A RAM disk is loaded from the
+    **  image if it exists and is otherwise manufactured in memory.
     */
-    fcb = fopen(fname, "r+b");
-    if (fcb == NULL)
+    isNew = FALSE;
+    if (dp->isRamDisk)
         {
-        /*
-        **  Disk does not yet exist - manufacture one.
-        */
-        fcb = fopen(fname, "w+b");
+        fcb = ramDiskOpen(fname, (long)MaxCylinders * MaxTracks * MaxSectors * sizeof(Sector), isRamSaved, &isNew);
         if (fcb == NULL)
             {
-            logDtError(LogErrorLocation, "Failed to open %s\n", fname);
+            logDtError(LogErrorLocation, "Failed to create RAM disk %s\n", fname);
             exit(1);
             }
+        }
+    else
+        {
+        fcb = fopen(fname, "r+b");
+        if (fcb == NULL)
+            {
+            fcb = fopen(fname, "w+b");
+            if (fcb == NULL)
+                {
+                logDtError(LogErrorLocation, "Failed to open %s\n", fname);
+                exit(1);
+                }
+            isNew = TRUE;
+            }
+        }
 
+    if (isNew)
+        {
         /*
-        **  Write last disk sector to reserve the space.
+        **  Disk does not yet exist - manufacture one. Write last disk
+        **  sector to reserve the space.
         */
         memset(&dp->buffer, 0, sizeof dp->buffer);
         dp->cylinder = MaxCylinders - 1;
@@ -480,8 +523,8 @@ void dd885_42Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     /*
     **  Print a friendly message.
     */
-    printf("(dd885-42) Disk with %d cylinders initialised on channel %o unit %o\n",
-           MaxCylinders, channelNo, unitNo);
+    printf("(dd885-42) %s with %d cylinders initialised on channel %o unit %o\n",
+           dp->isRamDisk ? "RAM disk" : "Disk", MaxCylinders, channelNo, unitNo);
     }
 
 /*
@@ -685,6 +728,7 @@ static void dd885_42Io(void)
     FILE      *fcb;
     i32       pos;
     u16       shiftCount;
+    u64       start;
     i8        unitNo;
     u16       wordIndex;
 
@@ -751,7 +795,9 @@ static void dd885_42Io(void)
                     pos        = dd885_42Seek(dp);
                     if ((pos >= 0) && (fcb != NULL))
                         {
+                        start = getMicroseconds();
                         fseek(fcb, pos, SEEK_SET);
+                        metricsCountUnitIo(dp->stats, MetricsIoPosition, 0, start);
                         }
                     }
                 else
@@ -1132,11 +1178,14 @@ static bool dd885_42Read(DiskParam *dp, FILE *fcb)
     CpWord *data;
     u32    emAddress;
     int    i;
+    u64    start;
 
     activeDevice->status  = 0;
     dp->detailedStatus[2] = Fc885_42Read << 4;
 
+    start = getMicroseconds();
     fread(&dp->buffer, sizeof dp->buffer, 1, fcb);
+    metricsCountUnitIo(dp->stats, MetricsIoRead, sizeof dp->buffer, start);
     activeDevice->status = 0;
     dp->generalStatus[3] = dp->buffer.control[0];
     dp->generalStatus[4] = dp->buffer.control[1];
@@ -1190,6 +1239,7 @@ static bool dd885_42Write(DiskParam *dp, FILE *fcb)
     CpWord *data;
     u32    emAddress;
     int    i;
+    u64    start;
 
     activeDevice->status  = 0;
     dp->detailedStatus[2] = Fc885_42Write << 4;
@@ -1231,7 +1281,9 @@ static bool dd885_42Write(DiskParam *dp, FILE *fcb)
         return FALSE;
         }
 
+    start = getMicroseconds();
     fwrite(&dp->buffer, sizeof dp->buffer, 1, fcb);
+    metricsCountUnitIo(dp->stats, MetricsIoWrite, sizeof dp->buffer, start);
 
     return TRUE;
     }
@@ -1315,14 +1367,15 @@ void dd885_42ShowDiskStatus()
 
     while (dp)
         {
-        opDisplay("    >   %-8s C%02o E%02o U%02o   %-20s (cyl 0x%06x trk 0x%06o)\n",
+        opDisplay("    >   %-8s C%02o E%02o U%02o   %-20s (cyl 0x%06x trk 0x%06o)%s\n",
                   "885-42",
                   dp->channelNo,
                   dp->eqNo,
                   dp->unitNo,
                   dp->fileName,
                   dp->cylinder,
-                  dp->track);
+                  dp->track,
+                  dp->isRamDisk ? " RAM" : "");
         dp = dp->nextDisk;
         }
     }
@@ -48,6 +48,12 @@
 #include "types.h"
 #include "proto.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 /*
 **  -----------------
 **  Private Constants
@@ -183,6 +189,23 @@
 #define CtClassic            1
 #define CtPacked             2
 
+/*
+**  Sequential read prefetching. Once a unit has read PrefetchThreshold
+**  sectors in ascending track order, the next PrefetchDepth tracks are
+**  read into its cache by the prefetch thread.
+*/
+#define PrefetchSlots        8
+#define PrefetchDepth        2
+#define PrefetchThreshold    4
+
+/*
+**  Prefetch cache slot states.
+*/
+#define TrackEmpty           0
+#define TrackPending         1
+#define TrackValid           2
+#define TrackCancelled       3
+
 /*
 **  -----------------------
 **  Private Macro Functions
@@ -208,6 +231,16 @@ typedef struct diskSize
     i32 maxSectors;
     } DiskSize;
 
+typedef struct diskTrack
+    {
+    struct diskTrack *nextRequest;      /* prefetch request queue link */
+    struct diskParam *dp;               /* owning unit */
+    u8               *data;             /* track contents */
+    i32              trackNo;           /* cylinder * maxTracks + track */
+    u32              lastUse;           /* for least recently used replacement */
+    u8               state;             /* TrackEmpty, TrackPending, ... */
+    } DiskTrack;
+
 typedef struct diskParam
     {
     /*
@@ -234,9 +267,26 @@ typedef struct diskParam
     u8               unitNo;
     u8               diskType;
     bool             isLargeSectorMode;
+    bool             isRamDisk;
+    bool             isRamSaved;
+    MetricsUnit      *stats;
     PpWord           *buffer;
     PpWord           *bufLimit;
     PpWord           *bufPtr;
+
+    /*
+    **  Sequential read prefetching.
+    */
+    i32              position;          /* container offset of current sector */
+    i32              streamPos;         /* container offset the stream is at, -1 if unknown */
+    bool             isStreamWrite;     /* last transfer through the stream was a write */
+    bool             isDirty;           /* written since the stream was last flushed */
+    FILE             *prefetchFcb;      /* stream used by the prefetch thread */
+    i32              trackBytes;
+    i32              lastTrackNo;
+    u32              sequentialReads;
+    u32              useCount;
+    DiskTrack        tracks[PrefetchSlots];
     } DiskParam;
 
 /*
@@ -249,15 +299,33 @@ static void     dd8xxDisconnect(void);
 static FcStatus dd8xxFunc(PpWord funcCode);
 static void     dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSize *size, u8 diskType);
 static void     dd8xxIo(void);
+static void     dd8xxAttach(DiskParam *dp, FILE *fcb, FILE *prefetchFcb, char *fname);
+static void     dd8xxFormat(DiskParam *dp, FILE *fcb);
+static void     dd8xxFormatSector(DiskParam *dp, FILE *fcb, i32 cylinder, i32 track, i32 sector, PpWord *data);
+static void     dd8xxInstallDisk(MediaMount *mp);
 static FILE    *dd8xxMount(char *deviceName, DiskParam *dp);
+static FILE    *dd8xxOpenContainer(char *fname, DiskParam *dp, FILE **prefetchFcb);
+static void     dd8xxLockPrefetch(void);
+static void     dd8xxPrefetch(DiskParam *dp, FILE *fcb, i32 trackNo);
+static void     dd8xxPrefetchStart(DiskParam *dp, FILE *prefetchFcb);
+static void     dd8xxPrefetchStop(DiskParam *dp);
+#if defined(_WIN32)
+static void     dd8xxPrefetchThread(void *param);
+#else
+static void     *dd8xxPrefetchThread(void *param);
+#endif
+static void     dd8xxStartPrefetcher(void);
 static PpWord   dd8xxReadClassic(DiskParam *dp, FILE *fcb);
 static PpWord   dd8xxReadPacked(DiskParam *dp, FILE *fcb);
+static void     dd8xxReadSector(DiskParam *dp, FILE *fcb, u8 *data, i32 len);
 static void     dd8xxSectorWrite(DiskParam *dp, FILE *fcb, PpWord *sector);
 static i32      dd8xxSeek(DiskParam *dp);
 static i32      dd8xxSeekNextSector(DiskParam *dp);
 static void     dd844SetClearFlaw(DiskParam *dp, PpWord flawState);
+static void     dd8xxUnlockPrefetch(void);
 static void     dd8xxWriteClassic(DiskParam *dp, FILE *fcb, PpWord data);
 static void     dd8xxWritePacked(DiskParam *dp, FILE *fcb, PpWord data);
+static void     dd8xxWriteSector(DiskParam *dp, FILE *fcb, u8 *data, i32 len);
 
 #if DEBUG
 static char    *dd8xxFunc2String(PpWord funcCode);
@@ -281,6 +349,22 @@ static PpWord mySector[LargeSectorSize];
 static DiskParam *firstDisk = NULL;
 static DiskParam *lastDisk  = NULL;
 
+/*
+**  Prefetch thread and its request queue.
+*/
+static bool      prefetchStarted = FALSE;
+static DiskTrack *prefetchFirst  = NULL;
+static DiskTrack *prefetchLast   = NULL;
+static DiskTrack *prefetchBusy   = NULL;
+#if defined(_WIN32)
+static HANDLE prefetchMutex;
+static HANDLE prefetchEvent;
+static HANDLE prefetchIdleEvent;
+#else
+static pthread_mutex_t prefetchMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  prefetchCond  = PTHREAD_COND_INITIALIZER;
+#endif
+
 static DiskSize sizeDd844_2 = { MaxCylinders844_2, MaxTracks844, MaxSectors844 };
 static DiskSize sizeDd844_4 = { MaxCylinders844_4, MaxTracks844, MaxSectors844 };
 static DiskSize sizeDd885_1 = { MaxCylinders885_1, MaxTracks885, MaxSectors885 };
@@ -390,15 +474,22 @@ void dd885InitLs(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Load a new disk (operator interface).
+**  Purpose:        Open or create the container of a disk to be loaded
+**                  (operator interface).
+**
+**                  This is called on the operator thread and does all of
+**                  the file I/O of the mount.  The opened container is
+**                  installed on the unit by the emulation thread through
+**                  mp->install.
 **
 **  Parameters:     Name        Description.
 **                  params      parameters
+**                  mp          (out) opened medium
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if the container was opened.
 **
 **------------------------------------------------------------------------*/
-void dd8xxLoadDisk(char *params)
+bool dd8xxOpenDisk(char *params, MediaMount *mp)
     {
     static char str[200];
     DiskParam   *dp;
@@ -408,6 +499,7 @@ void dd8xxLoadDisk(char *params)
     int         equipmentNo;
     int         unitNo;
     FILE        *fcb;
+    FILE        *prefetchFcb;
 
     /*
     **  Operator mounted a new disk.
@@ -421,28 +513,28 @@ void dd8xxLoadDisk(char *params)
         {
         opDisplay("(dd8xx  ) Not enough or invalid parameters\n");
 
-        return;
+        return FALSE;
         }
 
     if ((channelNo < 0) || (channelNo >= MaxChannels))
         {
         opDisplay("(dd8xx  ) Invalid channel no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitNo < 0) || (unitNo >= MaxUnits))
         {
         opDisplay("(dd8xx  ) Invalid unit no\n");
 
-        return;
+        return FALSE;
         }
 
     if (str[0] == 0)
         {
         opDisplay("(dd8xx  ) Invalid file name\n");
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -451,7 +543,7 @@ void dd8xxLoadDisk(char *params)
     ds = channelFindDevice((u8)channelNo, DtDd8xx);
     if (ds == NULL)
         {
-        return;
+        return FALSE;
         }
 
     /*
@@ -462,7 +554,7 @@ void dd8xxLoadDisk(char *params)
         {
         opDisplay("(dd8xx  ) Unit %d not allocated\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -472,10 +564,10 @@ void dd8xxLoadDisk(char *params)
         {
         opDisplay("(dd8xx  ) Unit %d not unloaded\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
-    fcb = dd8xxMount(str, dp);
+    fcb = dd8xxOpenContainer(str, dp, &prefetchFcb);
 
     /*
     **  Check if the open succeeded.
@@ -484,17 +576,17 @@ void dd8xxLoadDisk(char *params)
         {
         opDisplay("(dd8xx  ) Failed to open %s\n", str);
 
-        return;
+        return FALSE;
         }
 
-    ds->fcb[unitNo] = fcb;
+    mp->install = dd8xxInstallDisk;
+    mp->dp      = ds;
+    mp->unitNo  = unitNo;
+    mp->fcb     = fcb;
+    mp->auxFcb  = prefetchFcb;
+    strcpy(mp->fileName, str);
 
-    /*
-    **  Setup show_disk path name.
-    */
-    strcpy(dp->fileName, str);
-
-    opDisplay("(dd8xx  ) Successfully loaded %s\n", str);
+    return TRUE;
     }
 
 /*--------------------------------------------------------------------------
@@ -577,7 +669,8 @@ void dd8xxUnloadDisk(char *params)
     /*
     **  Close the file.
     */
-    fclose(ds->fcb[unitNo]);
+    dd8xxPrefetchStop(dp);
+    ramDiskClose(ds->fcb[unitNo]);
     ds->fcb[unitNo] = NULL;
 
     /*
@@ -625,7 +718,14 @@ void dd8xxShowDiskStatus()
         opDisplay("    >   %-8s C%02o E%02o U%02o", dt, dp->channelNo, dp->eqNo, dp->unitNo);
         if (*dp->fileName != '\0')
             {
-            opDisplay("   %-20s (cyl 0x%06x trk 0x%06o)\n", dp->fileName, dp->cylinder, dp->track);
+            opDisplay("   %-20s (cyl 0x%06x trk 0x%06o)%s", dp->fileName, dp->cylinder, dp->track,
+                      dp->isRamDisk ? " RAM" : "");
+            if (dp->stats->cacheHits + dp->stats->cacheMisses > 0)
+                {
+                opDisplay(" prefetch hits %.1f%%", 100.0 * (double)dp->stats->cacheHits
+                          / (double)(dp->stats->cacheHits + dp->stats->cacheMisses));
+                }
+            opDisplay("\n");
             }
         else
             {
@@ -635,6 +735,29 @@ void dd8xxShowDiskStatus()
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Stop prefetching on all units of a controller before
+**                  their contexts are freed.
+**
+**  Parameters:     Name        Description.
+**                  ds          Device slot.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void dd8xxTerminate(DevSlot *ds)
+    {
+    int i;
+
+    for (i = 0; i < MaxUnits; i++)
+        {
+        if (ds->context[i] != NULL)
+            {
+            dd8xxPrefetchStop((DiskParam *)ds->context[i]);
+            }
+        }
+    }
+
 /*
  **--------------------------------------------------------------------------
  **
@@ -664,6 +787,7 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
     DiskParam *dp;
     u8        containerType;
     char      *opt = NULL;
+    char      *token;
 
     (void)eqNo;
 
@@ -712,6 +836,7 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
     dp->unitNo    = unitNo;
     dp->eqNo      = eqNo;
     dp->channelNo = channelNo;
+    dp->stats     = metricsRegisterUnit(DtDd8xx, channelNo, eqNo, unitNo);
 
     /*
     **  Determine if any options have been specified.
@@ -721,6 +846,11 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
         opt = strchr(deviceName, ',');
         }
 
+    /*
+    **  Default container type.
+    */
+    containerType = CtUndefined;
+
     if (opt != NULL)
         {
         /*
@@ -728,26 +858,43 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
         */
         *opt++ = '\0';
 
-        if ((strcmp(opt, "old") == 0)
-            || (strcmp(opt, "classic") == 0))
+        for (token = strtok(opt, ","); token != NULL; token = strtok(NULL, ","))
             {
-            containerType = CtClassic;
-            }
-        else if ((strcmp(opt, "new") == 0)
-                 || (strcmp(opt, "packed") == 0))
-            {
-            containerType = CtPacked;
+            if ((strcmp(token, "old") == 0)
+                || (strcmp(token, "classic") == 0))
+                {
+                containerType = CtClassic;
+                }
+            else if ((strcmp(token, "new") == 0)
+                     || (strcmp(token, "packed") == 0))
+                {
+                containerType = CtPacked;
+                }
+            else if (strcmp(token, "ram") == 0)
+                {
+                dp->isRamDisk = TRUE;
+                }
+            else if (strcmp(token, "save") == 0)
+                {
+                dp->isRamSaved = TRUE;
+                }
+            else
+                {
+                logDtError(LogErrorLocation, "Unrecognized option name %s\n", token);
+                exit(1);
+                }
             }
-        else
+        if (dp->isRamSaved && !dp->isRamDisk)
             {
-            logDtError(LogErrorLocation, "Unrecognized option name %s\n", opt);
+            logDtError(LogErrorLocation, "Option 'save' requires option 'ram'\n");
             exit(1);
             }
         }
-    else
+
+    if (containerType == CtUndefined)
         {
         /*
-        **  No options specified - use default values.
+        **  No container type specified - use default values.
         */
         switch (diskType)
             {
@@ -847,8 +994,8 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
             exit(1);
             }
         ds->fcb[unitNo] = fcb;
-        printf("(dd8xx  ) Disk with %d cylinders initialised on channel %o equip %o unit %o filename '%s'\n",
-               dp->size.maxCylinders, channelNo, eqNo, unitNo, dp->fileName);
+        printf("(dd8xx  ) Disk with %d cylinders initialised on channel %o equip %o unit %o %s '%s'\n",
+               dp->size.maxCylinders, channelNo, eqNo, unitNo, dp->isRamDisk ? "RAM disk" : "filename", dp->fileName);
         }
     }
 
@@ -864,11 +1011,9 @@ static void dd8xxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, DiskSi
 **------------------------------------------------------------------------*/
 static FILE *dd8xxMount(char *deviceName, DiskParam *dp)
     {
-    FILE      *fcb;
-    char      fname[MaxFSPath];
-    time_t    mTime;
-    struct tm *lTime;
-    u8        yy, mm, dd;
+    FILE *fcb;
+    char fname[MaxFSPath];
+    FILE *prefetchFcb;
 
     /*
     **  Open or create disk image.
@@ -895,87 +1040,202 @@ static FILE *dd8xxMount(char *deviceName, DiskParam *dp)
         strcpy(fname, deviceName);
         }
 
+    fcb = dd8xxOpenContainer(fname, dp, &prefetchFcb);
+    if (fcb != NULL)
+        {
+        dd8xxAttach(dp, fcb, prefetchFcb, fname);
+        }
+
+    return fcb;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Open an 8xx disk container, manufacturing a new disk
+**                  if the container does not yet exist.
+**
+**                  Only the unit's fixed parameters are used, so this may
+**                  be called on a thread other than the emulation thread
+**                  while the unit is unloaded.
+**
+**  Parameters:     Name        Description.
+**                  fname       pathname of disk container file
+**                  dp          pointer to disk parameters
+**                  prefetchFcb (out) stream for the prefetch thread, or
+**                              NULL if the unit is not prefetched
+**
+**  Returns:        Pointer to FILE, or NULL if the container could not
+**                  be opened.
+**
+**------------------------------------------------------------------------*/
+static FILE *dd8xxOpenContainer(char *fname, DiskParam *dp, FILE **prefetchFcb)
+    {
+    FILE *fcb;
+    bool isNew;
+
+    *prefetchFcb = NULL;
+
     /*
-    **  Try to open existing disk image.
+    **  Try to open existing disk image. A RAM disk is loaded from the
+    **  image if it exists and is otherwise manufactured in memory.
     */
-    fcb = fopen(fname, "r+b");
-    if (fcb == NULL)
+    isNew = FALSE;
+    if (dp->isRamDisk)
         {
-        /*
-        **  Disk does not yet exist - manufacture one.
-        */
-        fcb = fopen(fname, "w+b");
+        fcb = ramDiskOpen(fname, (long)dp->size.maxCylinders * dp->size.maxTracks * dp->size.maxSectors * dp->sectorSize,
+                          dp->isRamSaved, &isNew);
         if (fcb == NULL)
             {
-            opDisplay("(dd8xx  ) Failed to open %s\n", fname);
+            opDisplay("(dd8xx  ) Failed to create RAM disk %s\n", fname);
 
             return NULL;
             }
-
-        /*
-        **  Write last disk sector to reserve the space.
-        */
-        memset(mySector, 0, LargeSectorSize * 2);
-        dp->cylinder = dp->size.maxCylinders - 1;
-        dp->track    = dp->size.maxTracks - 1;
-        dp->sector   = dp->size.maxSectors - 1;
-        fseek(fcb, dd8xxSeek(dp), SEEK_SET);
-        dd8xxSectorWrite(dp, fcb, mySector);
-
-        /*
-        **  Position to cylinder with the disk's factory and utility
-        **  data areas.
-        */
-        switch (dp->diskType)
+        }
+    else
+        {
+        fcb = fopen(fname, "r+b");
+        if (fcb == NULL)
             {
-        case DiskType885:
-        case DiskType885Ls:
-            dp->cylinder = dp->size.maxCylinders - 2;
-            break;
+            fcb = fopen(fname, "w+b");
+            if (fcb == NULL)
+                {
+                opDisplay("(dd8xx  ) Failed to open %s\n", fname);
 
-        case DiskType844:
-            dp->cylinder = dp->size.maxCylinders - 1;
-            break;
+                return NULL;
+                }
+            isNew = TRUE;
             }
+        }
 
-        /*
-        **  Zero entire cylinder containing factory and utility data areas.
-        */
-        memset(mySector, 0, LargeSectorSize * 2);
-        for (dp->track = 0; dp->track < dp->size.maxTracks; dp->track++)
+    if (isNew)
+        {
+        dd8xxFormat(dp, fcb);
+        }
+
+    fflush(fcb);
+    fseek(fcb, 0, SEEK_SET);
+
+    if (!dp->isRamDisk)
+        {
+        *prefetchFcb = fopen(fname, "rb");
+        }
+
+    return fcb;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Manufacture a new disk in an empty container.
+**
+**  Parameters:     Name        Description.
+**                  dp          pointer to disk parameters
+**                  fcb         File control block.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxFormat(DiskParam *dp, FILE *fcb)
+    {
+    i32       cylinder;
+    i32       sector;
+    i32       track;
+    PpWord    data[LargeSectorSize];
+    time_t    mTime;
+    struct tm *lTime;
+    u8        yy, mm, dd;
+
+    /*
+    **  Write last disk sector to reserve the space.
+    */
+    memset(data, 0, sizeof(data));
+    dd8xxFormatSector(dp, fcb, dp->size.maxCylinders - 1, dp->size.maxTracks - 1, dp->size.maxSectors - 1, data);
+
+    /*
+    **  Locate the cylinder with the disk's factory and utility data areas.
+    */
+    cylinder = (dp->diskType == DiskType844) ? dp->size.maxCylinders - 1 : dp->size.maxCylinders - 2;
+
+    /*
+    **  Zero entire cylinder containing factory and utility data areas.
+    */
+    for (track = 0; track < dp->size.maxTracks; track++)
+        {
+        for (sector = 0; sector < dp->size.maxSectors; sector++)
             {
-            for (dp->sector = 0; dp->sector < dp->size.maxSectors; dp->sector++)
-                {
-                fseek(fcb, dd8xxSeek(dp), SEEK_SET);
-                dd8xxSectorWrite(dp, fcb, mySector);
-                }
+            dd8xxFormatSector(dp, fcb, cylinder, track, sector, data);
             }
+        }
 
-        /*
-        **  Write serial number and date of manufacture.
-        */
-        mySector[0]  = (PpWord)((dp->channelNo & 070) << (8 - 3));
-        mySector[0] |= (dp->channelNo & 007) << (4 - 0);
-        mySector[0] |= (dp->unitNo & 070) >> (3 - 0);
-        mySector[1]  = (PpWord)((dp->unitNo & 007) << (8 - 0));
-        mySector[1] |= (dp->diskType & 070) << (4 - 3);
-        mySector[1] |= (dp->diskType & 007) << (0 - 0);
-
-        time(&mTime);
-        lTime = localtime(&mTime);
-        yy    = (u8)(lTime->tm_year % 100);
-        mm    = (u8)(lTime->tm_mon + 1);
-        dd    = (u8)(lTime->tm_mday);
+    /*
+    **  Write serial number and date of manufacture.
+    */
+    data[0]  = (PpWord)((dp->channelNo & 070) << (8 - 3));
+    data[0] |= (dp->channelNo & 007) << (4 - 0);
+    data[0] |= (dp->unitNo & 070) >> (3 - 0);
+    data[1]  = (PpWord)((dp->unitNo & 007) << (8 - 0));
+    data[1] |= (dp->diskType & 070) << (4 - 3);
+    data[1] |= (dp->diskType & 007) << (0 - 0);
+
+    time(&mTime);
+    lTime = localtime(&mTime);
+    yy    = (u8)(lTime->tm_year % 100);
+    mm    = (u8)(lTime->tm_mon + 1);
+    dd    = (u8)(lTime->tm_mday);
+
+    data[2] = (PpWord)((dd / 10) << 8 | (dd % 10) << 4 | mm / 10);
+    data[3] = (PpWord)((mm % 10) << 8 | (yy / 10) << 4 | yy % 10);
+
+    dd8xxFormatSector(dp, fcb, cylinder, 0, 0, data);
+    }
 
-        mySector[2] = (PpWord)((dd / 10) << 8 | (dd % 10) << 4 | mm / 10);
-        mySector[3] = (PpWord)((mm % 10) << 8 | (yy / 10) << 4 | yy % 10);
+/*--------------------------------------------------------------------------
+**  Purpose:        Write one sector of a new disk directly to its
+**                  container, in the container's format.
+**
+**  Parameters:     Name        Description.
+**                  dp          pointer to disk parameters
+**                  fcb         File control block.
+**                  cylinder    cylinder number
+**                  track       track number
+**                  sector      sector number
+**                  data        sector of PP words
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxFormatSector(DiskParam *dp, FILE *fcb, i32 cylinder, i32 track, i32 sector, PpWord *data)
+    {
+    u8  bytes[LargeSectorSize * 2];
+    i32 len;
+    int words;
 
-        dp->track  = 0;
-        dp->sector = 0;
-        fseek(fcb, dd8xxSeek(dp), SEEK_SET);
-        dd8xxSectorWrite(dp, fcb, mySector);
+    words = (dp->diskType == DiskType885Ls) ? LargeSectorSize : SectorSize;
+    if (dp->write == dd8xxWritePacked)
+        {
+        len = charsetUnpack12To8(bytes, data, words);
+        }
+    else
+        {
+        len = words * 2;
+        memcpy(bytes, data, len);
         }
 
+    fseek(fcb, ((cylinder * dp->size.maxTracks + track) * dp->size.maxSectors + sector) * dp->sectorSize, SEEK_SET);
+    fwrite(bytes, 1, len, fcb);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Attach an opened container to its unit.
+**
+**  Parameters:     Name        Description.
+**                  dp          pointer to disk parameters
+**                  fcb         File control block.
+**                  prefetchFcb stream for the prefetch thread, or NULL
+**                  fname       pathname of disk container file
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxAttach(DiskParam *dp, FILE *fcb, FILE *prefetchFcb, char *fname)
+    {
     /*
     **  For Operator Show Status Command
     */
@@ -990,7 +1250,46 @@ static FILE *dd8xxMount(char *deviceName, DiskParam *dp)
     dp->interlace = 1;
     fseek(fcb, dd8xxSeek(dp), SEEK_SET);
 
-    return fcb;
+    if (prefetchFcb != NULL)
+        {
+        dd8xxPrefetchStart(dp, prefetchFcb);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Install a container opened by dd8xxOpenDisk on its
+**                  unit.  Called on the emulation thread.
+**
+**  Parameters:     Name        Description.
+**                  mp          opened medium
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxInstallDisk(MediaMount *mp)
+    {
+    DiskParam *dp;
+
+    /*
+    **  Another disk may have been loaded while this one was opened.
+    */
+    if (mp->dp->fcb[mp->unitNo] != NULL)
+        {
+        opDisplay("(dd8xx  ) Unit %d not unloaded\n", mp->unitNo);
+        if (mp->auxFcb != NULL)
+            {
+            fclose(mp->auxFcb);
+            }
+        ramDiskClose(mp->fcb);
+
+        return;
+        }
+
+    dp                      = (DiskParam *)mp->dp->context[mp->unitNo];
+    mp->dp->fcb[mp->unitNo] = mp->fcb;
+    dd8xxAttach(dp, mp->fcb, mp->auxFcb, mp->fileName);
+
+    opDisplay("(dd8xx  ) Successfully loaded %s\n", mp->fileName);
     }
 
 /*--------------------------------------------------------------------------
@@ -1264,7 +1563,8 @@ static FcStatus dd8xxFunc(PpWord funcCode)
             break;
             }
 
-        fseek(fcb, dd8xxSeek(dp), SEEK_SET);
+        dp->streamPos = dd8xxSeek(dp);
+        fseek(fcb, dp->streamPos, SEEK_SET);
         dp->isLargeSectorMode      = FALSE;
         activeDevice->recordLength = SectorSize;
         dp->bufLimit               = dp->buffer + activeDevice->recordLength;
@@ -1349,6 +1649,7 @@ static void dd8xxIo(void)
     FILE      *fcb;
     DiskParam *dp;
     i32       pos;
+    u64       start;
 
     unitNo = activeDevice->selectedUnit;
     if (unitNo != -1)
@@ -1481,7 +1782,10 @@ static void dd8xxIo(void)
                     pos        = dd8xxSeek(dp);
                     if ((pos >= 0) && (fcb != NULL))
                         {
+                        start = getMicroseconds();
                         fseek(fcb, pos, SEEK_SET);
+                        dp->streamPos = pos;
+                        metricsCountUnitIo(dp->stats, MetricsIoPosition, 0, start);
                         }
 #if DEBUG
                     if (IS_DBG_DEV(dp))
@@ -1536,7 +1840,7 @@ static void dd8xxIo(void)
                 {
                 activeChannel->discAfterInput = TRUE;
                 pos = dd8xxSeekNextSector(dp);
-                if (pos >= 0)
+                if ((pos >= 0) && (dp->prefetchFcb == NULL))
                     {
                     fseek(fcb, pos, SEEK_SET);
                     }
@@ -1565,7 +1869,12 @@ static void dd8xxIo(void)
                     {
                     pos = dd8xxSeekNextSector(dp);
                     }
-                if (pos >= 0)
+
+                /*
+                **  A unit with a prefetch cache is positioned by the next
+                **  sector read or write which misses the cache.
+                */
+                if ((pos >= 0) && (dp->prefetchFcb == NULL))
                     {
                     fseek(fcb, pos, SEEK_SET);
                     }
@@ -1590,7 +1899,7 @@ static void dd8xxIo(void)
             if (--activeDevice->recordLength == 0)
                 {
                 pos = dd8xxSeekNextSector(dp);
-                if (pos >= 0)
+                if ((pos >= 0) && (dp->prefetchFcb == NULL))
                     {
                     fseek(fcb, pos, SEEK_SET);
                     }
@@ -1903,6 +2212,11 @@ static i32 dd8xxSeek(DiskParam *dp)
     result += dp->sector;
     result *= dp->sectorSize;
 
+    /*
+    **  The caller positions the stream to the new sector.
+    */
+    dp->position = result;
+
     return result;
     }
 
@@ -1989,7 +2303,7 @@ static PpWord dd8xxReadClassic(DiskParam *dp, FILE *fcb)
     if (dp->bufPtr == NULL)
         {
         dp->bufPtr = dp->buffer;
-        fread(dp->buffer, 1, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize, fcb);
+        dd8xxReadSector(dp, fcb, (u8 *)dp->buffer, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize);
         }
 
     /*
@@ -2039,7 +2353,7 @@ static void dd8xxWriteClassic(DiskParam *dp, FILE *fcb, PpWord data)
     */
     if (dp->bufPtr == dp->bufLimit)
         {
-        fwrite(dp->buffer, 1, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize, fcb);
+        dd8xxWriteSector(dp, fcb, (u8 *)dp->buffer, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize);
         }
     }
 
@@ -2056,8 +2370,6 @@ static void dd8xxWriteClassic(DiskParam *dp, FILE *fcb, PpWord data)
 static PpWord dd8xxReadPacked(DiskParam *dp, FILE *fcb)
     {
     static u8 sector[516*4];
-    u8        *sp;
-    PpWord    *pp;
 
     /*
     **  Read an entire sector if the current buffer is empty.
@@ -2065,19 +2377,12 @@ static PpWord dd8xxReadPacked(DiskParam *dp, FILE *fcb)
     if (dp->bufPtr == NULL)
         {
         dp->bufPtr = dp->buffer;
-        fread(sector, 1, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize, fcb);
+        dd8xxReadSector(dp, fcb, sector, dp->isLargeSectorMode ? dp->sectorSize * 4 : dp->sectorSize);
 
         /*
         **  Unpack the sector into the buffer.
         */
-        sp = sector;
-        pp = dp->buffer;
-        while (pp < dp->bufLimit)
-            {
-            *pp++ = (PpWord)((sp[0] << 4) | (sp[1] >> 4));
-            *pp++ = (PpWord)((sp[1] << 8) | sp[2]);
-            sp   += 3;
-            }
+        charsetPack8To12(dp->buffer, sector, (int)(dp->bufLimit - dp->buffer) * 3 / 2);
         }
 
     /*
@@ -2108,8 +2413,7 @@ static PpWord dd8xxReadPacked(DiskParam *dp, FILE *fcb)
 static void dd8xxWritePacked(DiskParam *dp, FILE *fcb, PpWord data)
     {
     static u8 sector[516*4];
-    u8        *sp;
-    PpWord    *pp;
+    int       len;
 
     /*
     **  Reset pointer if the current buffer is empty.
@@ -2137,22 +2441,535 @@ static void dd8xxWritePacked(DiskParam *dp, FILE *fcb, PpWord data)
         /*
         **  Pack the buffer into a sector.
         */
-        sp = sector;
-        pp = dp->buffer;
-        while (pp < dp->bufLimit)
+        len = charsetUnpack12To8(sector, dp->buffer, (int)(dp->bufLimit - dp->buffer));
+
+        /*
+        **  Write the sector.
+        */
+        dd8xxWriteSector(dp, fcb, sector, len);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Read a sector from a disk container, from the prefetch
+**                  cache when possible, and prefetch ahead of a unit which
+**                  is being read sequentially.
+**
+**  Parameters:     Name        Description.
+**                  dp          Disk parameters (context).
+**                  fcb         File control block.
+**                  data        buffer receiving the sector
+**                  len         number of bytes to read
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxReadSector(DiskParam *dp, FILE *fcb, u8 *data, i32 len)
+    {
+    int       i;
+    i32       offset;
+    u64       start;
+    DiskTrack *tp;
+    i32       trackNo;
+
+    start = getMicroseconds();
+    if (dp->prefetchFcb == NULL)
+        {
+        fread(data, 1, len, fcb);
+        metricsCountUnitIo(dp->stats, MetricsIoRead, len, start);
+
+        return;
+        }
+
+    trackNo = dp->position / dp->trackBytes;
+    offset  = dp->position - (trackNo * dp->trackBytes);
+
+    /*
+    **  Look for the sector in the cache. Valid slots are changed only by
+    **  this thread, so the data may be copied once the lock is released.
+    */
+    tp = NULL;
+    if (offset + len <= dp->trackBytes)
+        {
+        dd8xxLockPrefetch();
+        for (i = 0; i < PrefetchSlots; i++)
+            {
+            if ((dp->tracks[i].state == TrackValid) && (dp->tracks[i].trackNo == trackNo))
+                {
+                tp = &dp->tracks[i];
+                break;
+                }
+            }
+        dd8xxUnlockPrefetch();
+        }
+
+    if (tp != NULL)
+        {
+        memcpy(data, tp->data + offset, len);
+        tp->lastUse = ++dp->useCount;
+        dp->stats->cacheHits += 1;
+        }
+    else
+        {
+        /*
+        **  Cache hits leave the stream behind, and C requires a seek
+        **  when switching between writing and reading.
+        */
+        if ((dp->streamPos != dp->position) || dp->isStreamWrite)
+            {
+            fseek(fcb, dp->position, SEEK_SET);
+            }
+        fread(data, 1, len, fcb);
+        dp->streamPos     = dp->position + len;
+        dp->isStreamWrite = FALSE;
+        dp->stats->cacheMisses += 1;
+        }
+    metricsCountUnitIo(dp->stats, MetricsIoRead, len, start);
+
+    /*
+    **  Track the access pattern. Reads within the current track or from
+    **  the next one count as sequential.
+    */
+    if ((trackNo == dp->lastTrackNo) || (trackNo == dp->lastTrackNo + 1))
+        {
+        dp->sequentialReads += 1;
+        }
+    else
+        {
+        dp->sequentialReads = 0;
+        }
+    dp->lastTrackNo = trackNo;
+
+    if (dp->sequentialReads >= PrefetchThreshold)
+        {
+        for (i = 1; i <= PrefetchDepth; i++)
+            {
+            dd8xxPrefetch(dp, fcb, trackNo + i);
+            }
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Write a sector to a disk container and drop any
+**                  prefetched copy of it.
+**
+**  Parameters:     Name        Description.
+**                  dp          Disk parameters (context).
+**                  fcb         File control block.
+**                  data        sector data
+**                  len         number of bytes to write
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxWriteSector(DiskParam *dp, FILE *fcb, u8 *data, i32 len)
+    {
+    i32       first;
+    int       i;
+    i32       last;
+    u64       start;
+    DiskTrack *tp;
+
+    start = getMicroseconds();
+    if (dp->prefetchFcb == NULL)
+        {
+        fwrite(data, 1, len, fcb);
+        metricsCountUnitIo(dp->stats, MetricsIoWrite, len, start);
+
+        return;
+        }
+
+    if ((dp->streamPos != dp->position) || !dp->isStreamWrite)
+        {
+        fseek(fcb, dp->position, SEEK_SET);
+        }
+    fwrite(data, 1, len, fcb);
+    dp->streamPos     = dp->position + len;
+    dp->isStreamWrite = TRUE;
+    metricsCountUnitIo(dp->stats, MetricsIoWrite, len, start);
+
+    dp->isDirty = TRUE;
+    first       = dp->position / dp->trackBytes;
+    last        = (dp->position + len - 1) / dp->trackBytes;
+
+    dd8xxLockPrefetch();
+    for (i = 0; i < PrefetchSlots; i++)
+        {
+        tp = &dp->tracks[i];
+        if ((tp->trackNo < first) || (tp->trackNo > last))
+            {
+            continue;
+            }
+        if (tp->state == TrackValid)
+            {
+            tp->state = TrackEmpty;
+            }
+        else if (tp->state == TrackPending)
+            {
+            tp->state = TrackCancelled;
+            }
+        }
+    dd8xxUnlockPrefetch();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Queue a track to be read into the prefetch cache
+**                  unless it is already cached or being read.
+**
+**  Parameters:     Name        Description.
+**                  dp          Disk parameters (context).
+**                  fcb         File control block.
+**                  trackNo     track to read
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxPrefetch(DiskParam *dp, FILE *fcb, i32 trackNo)
+    {
+    int       i;
+    DiskTrack *tp;
+    DiskTrack *victim;
+
+    if (trackNo >= dp->size.maxCylinders * dp->size.maxTracks)
+        {
+        return;
+        }
+
+    dd8xxLockPrefetch();
+    victim = NULL;
+    for (i = 0; i < PrefetchSlots; i++)
+        {
+        tp = &dp->tracks[i];
+        if ((tp->trackNo == trackNo) && (tp->state != TrackEmpty))
             {
-            *sp++  = (u8)(pp[0] >> 4);
-            *sp    = (u8)(pp[0] << 4);
-            *sp++ |= (u8)(pp[1] >> 8);
-            *sp++  = (u8)(pp[1] >> 0);
-            pp    += 2;
+            dd8xxUnlockPrefetch();
+
+            return;
             }
 
         /*
-        **  Write the sector.
+        **  Prefer an empty slot, otherwise replace the least recently
+        **  used valid one. Slots being read are left alone.
+        */
+        if (tp->state == TrackEmpty)
+            {
+            if ((victim == NULL) || (victim->state != TrackEmpty))
+                {
+                victim = tp;
+                }
+            }
+        else if (tp->state == TrackValid)
+            {
+            if ((victim == NULL) || ((victim->state == TrackValid) && (tp->lastUse < victim->lastUse)))
+                {
+                victim = tp;
+                }
+            }
+        }
+
+    if (victim == NULL)
+        {
+        dd8xxUnlockPrefetch();
+
+        return;
+        }
+
+    /*
+    **  The prefetch thread reads through its own stream, so data written
+    **  through the unit's stream must reach the container first.
+    */
+    if (dp->isDirty)
+        {
+        fflush(fcb);
+        dp->isDirty = FALSE;
+        }
+
+    victim->trackNo     = trackNo;
+    victim->state       = TrackPending;
+    victim->lastUse     = ++dp->useCount;
+    victim->nextRequest = NULL;
+    if (prefetchLast == NULL)
+        {
+        prefetchFirst = victim;
+        }
+    else
+        {
+        prefetchLast->nextRequest = victim;
+        }
+    prefetchLast = victim;
+
+#if defined(_WIN32)
+    ReleaseMutex(prefetchMutex);
+    SetEvent(prefetchEvent);
+#else
+    pthread_cond_broadcast(&prefetchCond);
+    pthread_mutex_unlock(&prefetchMutex);
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Enable prefetching on a newly mounted container and
+**                  create the prefetch thread if it is not yet running.
+**
+**  Parameters:     Name        Description.
+**                  dp          Disk parameters (context).
+**                  prefetchFcb Stream opened on the container for the
+**                              prefetch thread.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxPrefetchStart(DiskParam *dp, FILE *prefetchFcb)
+    {
+    int i;
+
+    dp->prefetchFcb = prefetchFcb;
+
+    dp->trackBytes      = dp->size.maxSectors * dp->sectorSize;
+    dp->lastTrackNo     = -2;
+    dp->sequentialReads = 0;
+    dp->isDirty         = FALSE;
+    dp->streamPos       = -1;
+    for (i = 0; i < PrefetchSlots; i++)
+        {
+        dp->tracks[i].dp    = dp;
+        dp->tracks[i].state = TrackEmpty;
+        if (dp->tracks[i].data == NULL)
+            {
+            dp->tracks[i].data = (u8 *)malloc(dp->trackBytes);
+            if (dp->tracks[i].data == NULL)
+                {
+                logDtError(LogErrorLocation, "Failed to allocate dd8xx prefetch buffer\n");
+                exit(1);
+                }
+            }
+        }
+
+    if (!prefetchStarted)
+        {
+        dd8xxStartPrefetcher();
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Create the prefetch thread.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxStartPrefetcher(void)
+    {
+#if defined(_WIN32)
+    DWORD  dwThreadId;
+    HANDLE hThread;
+
+    prefetchMutex = CreateMutex(NULL, FALSE, NULL);
+    prefetchEvent     = CreateEvent(NULL, FALSE, FALSE, NULL);
+    prefetchIdleEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    hThread           = CreateThread(
+        NULL,                                       // no security attribute
+        0,                                          // default stack size
+        (LPTHREAD_START_ROUTINE)dd8xxPrefetchThread,
+        (LPVOID)NULL,                               // thread parameter
+        0,                                          // not suspended
+        &dwThreadId);                               // returns thread ID
+
+    if (hThread == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to create dd8xx prefetch thread\n");
+        exit(1);
+        }
+#else
+    int            rc;
+    pthread_t      thread;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&thread, &attr, dd8xxPrefetchThread, NULL);
+    if (rc != 0)
+        {
+        logDtError(LogErrorLocation, "Failed to create dd8xx prefetch thread\n");
+        exit(1);
+        }
+#endif
+    prefetchStarted = TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Disable prefetching on a unit whose container is
+**                  being closed, waiting for any read in progress.
+**
+**  Parameters:     Name        Description.
+**                  dp          Disk parameters (context).
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxPrefetchStop(DiskParam *dp)
+    {
+    int       i;
+    DiskTrack **tpp;
+
+    if (dp->prefetchFcb == NULL)
+        {
+        return;
+        }
+
+    dd8xxLockPrefetch();
+    tpp          = &prefetchFirst;
+    prefetchLast = NULL;
+    while (*tpp != NULL)
+        {
+        if ((*tpp)->dp == dp)
+            {
+            *tpp = (*tpp)->nextRequest;
+            }
+        else
+            {
+            prefetchLast = *tpp;
+            tpp          = &(*tpp)->nextRequest;
+            }
+        }
+    while ((prefetchBusy != NULL) && (prefetchBusy->dp == dp))
+        {
+#if defined(_WIN32)
+        ResetEvent(prefetchIdleEvent);
+        ReleaseMutex(prefetchMutex);
+        WaitForSingleObject(prefetchIdleEvent, INFINITE);
+        WaitForSingleObject(prefetchMutex, INFINITE);
+#else
+        pthread_cond_wait(&prefetchCond, &prefetchMutex);
+#endif
+        }
+    for (i = 0; i < PrefetchSlots; i++)
+        {
+        dp->tracks[i].state = TrackEmpty;
+        }
+    dd8xxUnlockPrefetch();
+
+    fclose(dp->prefetchFcb);
+    dp->prefetchFcb = NULL;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Prefetch thread. Reads queued tracks into the caches
+**                  of their units, so that the emulation thread finds
+**                  sequentially read sectors already in memory.
+**
+**  Parameters:     Name        Description.
+**                  param       Thread parameter (unused)
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+#if defined(_WIN32)
+static void dd8xxPrefetchThread(void *param)
+#else
+static void *dd8xxPrefetchThread(void *param)
+#endif
+    {
+    DiskParam *dp;
+    size_t    len;
+    DiskTrack *tp;
+
+    for (;;)
+        {
+#if defined(_WIN32)
+        WaitForSingleObject(prefetchMutex, INFINITE);
+        while (prefetchFirst == NULL)
+            {
+            ReleaseMutex(prefetchMutex);
+            WaitForSingleObject(prefetchEvent, INFINITE);
+            WaitForSingleObject(prefetchMutex, INFINITE);
+            }
+#else
+        pthread_mutex_lock(&prefetchMutex);
+        while (prefetchFirst == NULL)
+            {
+            pthread_cond_wait(&prefetchCond, &prefetchMutex);
+            }
+#endif
+        tp            = prefetchFirst;
+        prefetchFirst = tp->nextRequest;
+        if (prefetchFirst == NULL)
+            {
+            prefetchLast = NULL;
+            }
+        prefetchBusy = tp;
+        dd8xxUnlockPrefetch();
+
+        dp  = tp->dp;
+        len = 0;
+        if (fseek(dp->prefetchFcb, (long)tp->trackNo * dp->trackBytes, SEEK_SET) == 0)
+            {
+            len = fread(tp->data, 1, dp->trackBytes, dp->prefetchFcb);
+            }
+
+        /*
+        **  A short read leaves the track to be read directly.
         */
-        fwrite(sector, 1, sp - sector, fcb);
+        dd8xxLockPrefetch();
+        if ((tp->state == TrackPending) && (len == (size_t)dp->trackBytes))
+            {
+            tp->state = TrackValid;
+            }
+        else
+            {
+            tp->state = TrackEmpty;
+            }
+        prefetchBusy = NULL;
+
+        /*
+        **  Wake a unit being closed which waits for this read.
+        */
+#if defined(_WIN32)
+        SetEvent(prefetchIdleEvent);
+#else
+        pthread_cond_broadcast(&prefetchCond);
+#endif
+        dd8xxUnlockPrefetch();
         }
+
+#if !defined(_WIN32)
+    return NULL;
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Acquire the prefetch queue and cache state lock.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxLockPrefetch(void)
+    {
+#if defined(_WIN32)
+    WaitForSingleObject(prefetchMutex, INFINITE);
+#else
+    pthread_mutex_lock(&prefetchMutex);
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Release the prefetch queue and cache state lock.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void dd8xxUnlockPrefetch(void)
+    {
+#if defined(_WIN32)
+    ReleaseMutex(prefetchMutex);
+#else
+    pthread_mutex_unlock(&prefetchMutex);
+#endif
     }
 
 /*--------------------------------------------------------------------------
@@ -2232,6 +3049,7 @@ static void dd844SetClearFlaw(DiskParam *dp, PpWord flawState)
     dp->sector   = 2;
     fseek(fcb, dd8xxSeek(dp), SEEK_SET);
     fread(mySector, 2, SectorSize, fcb);
+    dp->streamPos = -1;
 
     /*
     **  Process request.
@@ -2290,7 +3108,8 @@ static void dd844SetClearFlaw(DiskParam *dp, PpWord flawState)
     /*
     **  Update the 844 utility map sector.
     */
-    fseek(fcb, dd8xxSeek(dp), SEEK_SET);
+    dp->streamPos = dd8xxSeek(dp);
+    fseek(fcb, dp->streamPos, SEEK_SET);
     dd8xxSectorWrite(dp, fcb, mySector);
     }
 
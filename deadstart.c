@@ -191,6 +191,8 @@ void deadStart(void)
         ppu[pp].isIdle               = FALSE;
         ppu[pp].isDump               = FALSE;
         ppu[pp].isLoad               = FALSE;
+        ppu[pp].isParked             = FALSE;
+        ppu[pp].idleAddress          = 0;
         }
 
     /*
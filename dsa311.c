@@ -165,6 +165,7 @@ typedef struct dsa311Context
 #else
     int                  fd;
 #endif
+    NetPollEntry         poll;
     int                  ioTurns;
     time_t               nextConnectAttempt;
     bool                 isRTS;
@@ -881,17 +882,13 @@ static void dsa311AppendCRC(Dsa311Context *cp)
 **------------------------------------------------------------------------*/
 static void dsa311CheckIo(Dsa311Context *cp)
     {
-    int maxFd;
-    int n;
+    u8  events;
     int optEnable = 1;
 
 #if defined(_WIN32)
     u_long blockEnable = 1;
 #endif
-    int            rc;
-    fd_set         readFds;
-    struct timeval timeout;
-    fd_set         writeFds;
+    int rc;
 
     cp->ioTurns = (cp->ioTurns + 1) % IoTurnsPerPoll;
     if (cp->ioTurns != 0)
@@ -901,23 +898,7 @@ static void dsa311CheckIo(Dsa311Context *cp)
 
     if (cp->majorState == StDsa311MajConnecting)
         {
-        FD_ZERO(&writeFds);
-        FD_SET(cp->fd, &writeFds);
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 0;
-        n = select((int)(cp->fd + 1), NULL, &writeFds, NULL, &timeout);
-        if (n <= 0)
-            {
-#if DEBUG
-            if (n < 0)
-                {
-                fprintf(dsa311Log, "\n%010lu select failed", elapsedTime);
-                }
-#endif
-
-            return;
-            }
-        if (FD_ISSET(cp->fd, &writeFds) == FALSE)
+        if (netPollTake(&cp->poll, NetPollOut) == FALSE)
             {
             return;
             }
@@ -953,45 +934,22 @@ static void dsa311CheckIo(Dsa311Context *cp)
         dsa311Reset(cp);
         }
 
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-    maxFd = 0;
+    events = 0;
     if (cp->sktInBuf.in < SktInBufSize)
         {
-        FD_SET(cp->fd, &readFds);
-        maxFd = (int)cp->fd;
+        events |= NetPollIn;
         }
     if (cp->sktOutBuf.out < cp->sktOutBuf.in)
         {
-        FD_SET(cp->fd, &writeFds);
-        maxFd = (int)cp->fd;
-        }
-    if (maxFd == 0)
-        {
-        return;
+        events |= NetPollOut;
         }
+    netPollWant(&cp->poll, events);
 
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-
-    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
-
-    if (n <= 0)
-        {
-#if DEBUG
-        if (n < 0)
-            {
-            fprintf(dsa311Log, "\n%010lu select failed", elapsedTime);
-            }
-#endif
-
-        return;
-        }
-    if (FD_ISSET(cp->fd, &readFds))
+    if (netPollTake(&cp->poll, NetPollIn))
         {
         dsa311Receive(cp);
         }
-    if (FD_ISSET(cp->fd, &writeFds))
+    if (netPollTake(&cp->poll, NetPollOut))
         {
         dsa311Send(cp);
         }
@@ -1008,6 +966,7 @@ static void dsa311CheckIo(Dsa311Context *cp)
 **------------------------------------------------------------------------*/
 static void dsa311CloseConnection(Dsa311Context *cp)
     {
+    netPollRemove(&cp->poll);
     netCloseConnection(cp->fd);
     cp->fd = 0;
     cp->nextConnectAttempt = time(0) + (time_t)ConnectionRetryInterval;
@@ -1048,6 +1007,7 @@ static void dsa311InitiateConnection(Dsa311Context *cp)
         fprintf(dsa311Log, "\n%u010u connection initiated", elapsedTime);
 #endif
         cp->majorState = StDsa311MajConnecting;
+        netPollAdd(&cp->poll, cp->fd, NetPollOut);
         }
     }
 
@@ -202,6 +202,7 @@ void dumpCpu(void)
     u32              pti;
     u32              rma;
     u8               shiftCount;
+    u8               text[10];
     volatile u64     *tosPtr;
 
     for (cp = 0; cp < cpuCount; cp++)
@@ -371,13 +372,9 @@ void dumpCpu(void)
                     (PpWord)((data >> 24) & Mask12),
                     (PpWord)((data >> 12) & Mask12),
                     (PpWord)((data) & Mask12));
-            shiftCount = 60;
-            for (i = 0; i < 10; i++)
-                {
-                shiftCount -= 6;
-                ch          = (u8)((data >> shiftCount) & Mask6);
-                fprintf(pf, "%c", cdcToAscii[ch]);
-                }
+            charsetUnpack60To6(text, &data, 1);
+            charsetTranslate(text, text, 10, (const u8 *)cdcToAscii);
+            fprintf(pf, "%.10s", (char *)text);
             if (isCyber180)
                 {
                 fprintf(pf, "    %08x  %04x %04x %04x %04x   ",
@@ -145,8 +145,24 @@ static void float180MulLong192(Cpu180Double *mltand, Cpu180Double *mltier, Cpu18
 static void float180NormalizeDouble(u16 *exponent, Cpu180Double *coefficient);
 static void float180NormalizeFloat(u16 *exponent, u64 *coefficient);
 
-#if !defined(_WIN32) && HAS_INT128 == 0
+/*
+**  The bit-serial routines are the reference implementation of the long
+**  arithmetic. They are used when the host has no 128-bit integer type,
+**  and are also compiled when FLOAT180_REFERENCE is defined so that the
+**  float180check program can compare them with the host arithmetic.
+*/
+#if (!defined(_WIN32) && HAS_INT128 == 0) || defined(FLOAT180_REFERENCE)
 static u64 float180DivLong128(u64 highDvdend, u64 lowDvdend, u64 dvisor, u64 *remainder);
+static u64 float180MulLong128Ref(u64 mltand, u64 mltier, u64 *upper64);
+#endif
+
+#if HAS_INT128 == 0 || defined(FLOAT180_REFERENCE)
+static void float180DivLong96Ref(Cpu180Double *dvdend, Cpu180Double *dvisor, Cpu180Double *quotient);
+static void float180MulLong192Ref(Cpu180Double *mltand, Cpu180Double *mltier, Cpu180Double *hiProd, Cpu180Double *loProd);
+#endif
+
+#if HAS_INT128
+static u64 float180DivStep128(u128 *remainder, u128 dvisor, int bits);
 #endif
 
 /*
@@ -992,7 +1008,8 @@ bool float180ConvertFloatToInt(Cpu180Context *ctx, u64 floatValue, u64 *intResul
             cpu180SetUserCondition(ctx, UCR61); // FP indefinite
             return FALSE;
             }
-        ctx->regUcr |= UcrBitMask(UCR61);
+        ctx->regUcr            |= UcrBitMask(UCR61);
+        ctx->isConditionPending = TRUE;
         }
     else if (IsInfinite(exponent))
         {
@@ -1001,7 +1018,8 @@ bool float180ConvertFloatToInt(Cpu180Context *ctx, u64 floatValue, u64 *intResul
             cpu180SetUserCondition(ctx, UCR62); // Arithmetic loss of significance
             return FALSE;
             }
-        ctx->regUcr |= UcrBitMask(UCR62);
+        ctx->regUcr            |= UcrBitMask(UCR62);
+        ctx->isConditionPending = TRUE;
         }
     else if (coefficient != 0)
         {
@@ -1027,7 +1045,8 @@ bool float180ConvertFloatToInt(Cpu180Context *ctx, u64 floatValue, u64 *intResul
                         cpu180SetUserCondition(ctx, UCR62); // Arithmetic loss of significance
                         return FALSE;
                         }
-                    ctx->regUcr |= UcrBitMask(UCR62);
+                    ctx->regUcr            |= UcrBitMask(UCR62);
+                    ctx->isConditionPending = TRUE;
                     if (shift < 64)
                         {
                         *intResult = coefficient << shift;
@@ -1652,39 +1671,18 @@ bool float180MulFloat(Cpu180Context *ctx, u64 mltand, u64 mltier, u64 *product)
 **------------------------------------------------------------------------*/
 u64 float180MulLong128(u64 mltand, u64 mltier, u64 *upper64)
     {
-    u64 carry;
-    u64 lower64;
-    u64 m128[2];
-    u64 t;
+#if defined(_WIN32)
+    return _umul128(mltand, mltier, upper64);
+#elif HAS_INT128
+    u128 p128;
 
-    m128[0]  = 0;
-    m128[1]  = mltand;
-    lower64  = 0;
-    *upper64 = 0;
-    while (mltier != 0)
-        {
-        //
-        //  If the LSB of multiplier is 1, add multiplicand to product
-        //
-        if ((mltier & 1) != 0)
-            {
-            t         = lower64;
-            lower64  += m128[1];
-            carry     = lower64 < t;
-            *upper64 += m128[0] + carry;
-            }
-        //
-        //  Left shift multiplicand (multiply by 2)
-        //
-        m128[0]   = (m128[0] << 1) | (m128[1] >> 63);
-        m128[1] <<= 1;
-        //
-        //  Right shift multiplier (divide by 2)
-        //
-        mltier >>= 1;
-        }
+    p128     = (u128)mltand * mltier;
+    *upper64 = (u64)(p128 >> 64);
 
-    return lower64;
+    return (u64)p128;
+#else
+    return float180MulLong128Ref(mltand, mltier, upper64);
+#endif
     }
 
 /*--------------------------------------------------------------------------
@@ -1809,7 +1807,7 @@ static FloatClass float180FloatClassOf(u64 value)
         }
     }
 
-#if !defined(_WIN32) && HAS_INT128 == 0
+#if (!defined(_WIN32) && HAS_INT128 == 0) || defined(FLOAT180_REFERENCE)
 /*--------------------------------------------------------------------------
 **  Purpose:        Perform long division of a 128-bit unsigned value by
 **                  a 64-bit unsigned value
@@ -1861,6 +1859,55 @@ static u64 float180DivLong128(u64 highDvdend, u64 lowDvdend, u64 dvisor, u64 *re
 
     return quotient;
     }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Multiply two 64-bit unsigned integers to produce a
+**                  128-bit product, one multiplier bit at a time
+**
+**  Parameters:     Name        Description.
+**                  mltand      the 64-bit multiplicand
+**                  mltier      the 64-bit multiplier
+**                  upper64     (out) the upper 64 bits of the product
+**
+**  Returns:        Lower 64 bits of product
+**
+**------------------------------------------------------------------------*/
+static u64 float180MulLong128Ref(u64 mltand, u64 mltier, u64 *upper64)
+    {
+    u64 carry;
+    u64 lower64;
+    u64 m128[2];
+    u64 t;
+
+    m128[0]  = 0;
+    m128[1]  = mltand;
+    lower64  = 0;
+    *upper64 = 0;
+    while (mltier != 0)
+        {
+        //
+        //  If the LSB of multiplier is 1, add multiplicand to product
+        //
+        if ((mltier & 1) != 0)
+            {
+            t         = lower64;
+            lower64  += m128[1];
+            carry     = lower64 < t;
+            *upper64 += m128[0] + carry;
+            }
+        //
+        //  Left shift multiplicand (multiply by 2)
+        //
+        m128[0]   = (m128[0] << 1) | (m128[1] >> 63);
+        m128[1] <<= 1;
+        //
+        //  Right shift multiplier (divide by 2)
+        //
+        mltier >>= 1;
+        }
+
+    return lower64;
+    }
 #endif
 
 /*--------------------------------------------------------------------------
@@ -1874,6 +1921,59 @@ static u64 float180DivLong128(u64 highDvdend, u64 lowDvdend, u64 dvisor, u64 *re
 **------------------------------------------------------------------------*/
 static void float180DivLong96(Cpu180Double *dvdend, Cpu180Double *dvisor, Cpu180Double *quotient)
     {
+#if HAS_INT128
+    u128 d96;
+    u128 q97;
+    u128 v96;
+    int  shift;
+
+    d96 = ((u128)(dvdend->leftPart & Mask48) << 48) | (dvdend->rightPart & Mask48);
+    v96 = ((u128)(dvisor->leftPart & Mask48) << 48) | (dvisor->rightPart & Mask48);
+
+    //
+    //  The quotient has 97 bits. The leading bit is developed by a single
+    //  subtraction, so a dividend of twice the divisor or more (which the
+    //  callers exclude) leaves the remaining 96 bits all ones, as it does
+    //  in the bit-serial version.
+    //
+    q97 = 0;
+    if (d96 >= v96)
+        {
+        q97  = (u128)1 << 96;
+        d96 -= v96;
+        }
+    if (d96 >= v96)
+        {
+        q97 |= ((u128)1 << 96) - 1;
+        }
+    else
+        {
+        shift = ((u64)(v96 >> 64) != 0) ? __builtin_clzll((u64)(v96 >> 64)) : 64 + __builtin_clzll((u64)v96);
+        v96 <<= shift;
+        d96 <<= shift;
+        q97  |= (u128)float180DivStep128(&d96, v96, 64) << 32;
+        q97  |= float180DivStep128(&d96, v96, 32);
+        }
+    quotient->leftPart  = (u64)(q97 >> 48);
+    quotient->rightPart = (u64)q97 & Mask48;
+#else
+    float180DivLong96Ref(dvdend, dvisor, quotient);
+#endif
+    }
+
+#if HAS_INT128 == 0 || defined(FLOAT180_REFERENCE)
+/*--------------------------------------------------------------------------
+**  Purpose:        Perform long division of double precision coefficients,
+**                  one quotient bit at a time
+**
+**  Parameters:     Name         Description.
+**                  dvdend       pointer to 96-bit dividend
+**                  dvisor       pointer to 96-bit divisor
+**                  quotient     pointer to quotient
+**
+**------------------------------------------------------------------------*/
+static void float180DivLong96Ref(Cpu180Double *dvdend, Cpu180Double *dvisor, Cpu180Double *quotient)
+    {
     u64 borrow;
     u64 diff;
     u64 dvdend192[4];
@@ -1936,6 +2036,58 @@ static void float180DivLong96(Cpu180Double *dvdend, Cpu180Double *dvisor, Cpu180
         }
     while (--i >= 0);
     }
+#endif
+
+#if HAS_INT128
+/*--------------------------------------------------------------------------
+**  Purpose:        Develop up to 64 quotient bits of a long division by a
+**                  normalized 128-bit divisor
+**
+**  Parameters:     Name         Description.
+**                  remainder    (in/out) partial remainder, less than divisor
+**                  dvisor       128-bit divisor with its top bit set
+**                  bits         number of quotient bits to develop (1..64)
+**
+**  Returns:        floor((remainder * 2**bits) / dvisor), the new remainder
+**                  is left in remainder.
+**
+**------------------------------------------------------------------------*/
+static u64 float180DivStep128(u128 *remainder, u128 dvisor, int bits)
+    {
+    u64  borrow;
+    u64  lowDvdend;
+    u64  lowProd;
+    u128 highDvdend;
+    u128 highProd;
+    u128 p128;
+    u64  quotient;
+    u64  vh;
+
+    //
+    //  The dividend is (highDvdend:lowDvdend). Estimate the quotient from
+    //  the high divisor digit; the estimate is at most two too large.
+    //
+    highDvdend = (bits == 64) ? *remainder : *remainder >> (64 - bits);
+    lowDvdend  = (bits == 64) ? 0 : (u64)*remainder << bits;
+    vh         = (u64)(dvisor >> 64);
+    quotient   = ((u64)(highDvdend >> 64) >= vh) ? ~(u64)0 : (u64)(highDvdend / vh);
+
+    p128       = (u128)quotient * (u64)dvisor;
+    lowProd    = (u64)p128;
+    highProd   = (u128)quotient * vh + (p128 >> 64);
+    while (highProd > highDvdend || (highProd == highDvdend && lowProd > lowDvdend))
+        {
+        quotient -= 1;
+        borrow    = lowProd < (u64)dvisor;
+        lowProd  -= (u64)dvisor;
+        highProd -= (u128)vh + borrow;
+        }
+
+    *remainder = ((highDvdend - highProd) << 64) + lowDvdend - lowProd;
+
+    return quotient;
+    }
+#endif
 
 /*--------------------------------------------------------------------------
 **  Purpose:        Perform long multiplication of double precision coefficients
@@ -1949,6 +2101,40 @@ static void float180DivLong96(Cpu180Double *dvdend, Cpu180Double *dvisor, Cpu180
 **------------------------------------------------------------------------*/
 static void float180MulLong192(Cpu180Double *mltand, Cpu180Double *mltier, Cpu180Double *hiProd, Cpu180Double *loProd)
     {
+#if HAS_INT128
+    u128 p96;
+
+    //
+    //  Form the product from four 48 x 48 bit partial products, each of
+    //  which fits in 96 bits, propagating carries 48 bits at a time.
+    //
+    p96               = (u128)mltand->rightPart * mltier->rightPart;
+    loProd->rightPart = (u64)p96 & Mask48;
+    p96               = (p96 >> 48) + (u128)mltand->leftPart * mltier->rightPart
+                        + (u128)mltand->rightPart * mltier->leftPart;
+    loProd->leftPart  = (u64)p96 & Mask48;
+    p96               = (p96 >> 48) + (u128)mltand->leftPart * mltier->leftPart;
+    hiProd->rightPart = (u64)p96 & Mask48;
+    hiProd->leftPart  = (u64)(p96 >> 48);
+#else
+    float180MulLong192Ref(mltand, mltier, hiProd, loProd);
+#endif
+    }
+
+#if HAS_INT128 == 0 || defined(FLOAT180_REFERENCE)
+/*--------------------------------------------------------------------------
+**  Purpose:        Perform long multiplication of double precision
+**                  coefficients, one multiplier bit at a time
+**
+**  Parameters:     Name         Description.
+**                  mltand       pointer to 96-bit multiplicand
+**                  mltier       pointer to 96-bit multiplier (consumed)
+**                  hiProd       (out) pointer to high 96 bits of product
+**                  loProd       (out) pointer to low  96 bits of product
+**
+**------------------------------------------------------------------------*/
+static void float180MulLong192Ref(Cpu180Double *mltand, Cpu180Double *mltier, Cpu180Double *hiProd, Cpu180Double *loProd)
+    {
     u64 m192[4];
     u64 p192[4];
 
@@ -1990,6 +2176,7 @@ static void float180MulLong192(Cpu180Double *mltand, Cpu180Double *mltier, Cpu18
     loProd->leftPart  = p192[2];
     loProd->rightPart = p192[3];
     }
+#endif
 
 /*--------------------------------------------------------------------------
 **  Purpose:        Normalize a double precision floating point exponent
@@ -0,0 +1,481 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: float180check.c
+**
+**  Description:
+**      Differential test of the CYBER 180 long multiply and divide
+**      routines. float180.c is compiled here with FLOAT180_REFERENCE
+**      defined, so that its bit-serial reference routines are present
+**      alongside the routines which use host 128-bit arithmetic. Both are
+**      run on edge and random operands and any difference in the results
+**      is reported.
+**
+**      The program exits with status 0 when all results agree and 1 when
+**      any differ.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#define FLOAT180_REFERENCE
+#include "float180.c"
+
+#if HAS_INT128 == 0
+#error "float180check needs a host 128-bit integer type to compare with"
+#endif
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+#define CheckDefaultCases      2000000
+#define CheckMaxReports        10
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void checkDivLong128(u64 highDvdend, u64 lowDvdend, u64 dvisor);
+static void checkDivLong96(Cpu180Double *dvdend, Cpu180Double *dvisor);
+static void checkDividend96(Cpu180Double *dvdend, Cpu180Double *dvisor);
+static void checkMismatch(char *routine, u64 a0, u64 a1, u64 b0, u64 b1);
+static void checkMulLong128(u64 mltand, u64 mltier);
+static void checkMulLong192(Cpu180Double *mltand, Cpu180Double *mltier);
+static u64  checkOperand48(void);
+static u64  checkRandom(void);
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static u64 checkCases      = 0;
+static u64 checkMismatches = 0;
+static u64 checkSeed       = 0x9e3779b97f4a7c15ULL;
+
+/*
+**  Edge values for 48-bit coefficient parts.
+*/
+static const u64 checkEdges48[] =
+    {
+    0x000000000000, 0x000000000001, 0x000000000002, 0x00000000ffff,
+    0x000000010000, 0x0000ffffffff, 0x000100000000, 0x7fffffffffff,
+    0x800000000000, 0x800000000001, 0xaaaaaaaaaaaa, 0x555555555555,
+    0xfffffffffffe, 0xffffffffffff
+    };
+
+#define CheckNumEdges          (sizeof(checkEdges48) / sizeof(checkEdges48[0]))
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Differential test entry point
+**
+**  Parameters:     Name        Description.
+**                  argc        argument count
+**                  argv        "[-n <cases>] [-s <seed>]"
+**
+**  Returns:        0 if all results agree, 1 otherwise.
+**
+**------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+    {
+    Cpu180Double a;
+    Cpu180Double b;
+    u64          cases;
+    int          i;
+    int          j;
+    int          k;
+    int          l;
+    u64          n;
+    u64          x;
+    u64          y;
+
+    cases = CheckDefaultCases;
+    for (i = 1; i < argc; i++)
+        {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            {
+            cases = strtoull(argv[++i], NULL, 0);
+            }
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+            {
+            checkSeed = strtoull(argv[++i], NULL, 0);
+            if (checkSeed == 0)
+                {
+                checkSeed = 1;
+                }
+            }
+        else
+            {
+            fprintf(stderr, "usage: %s [-n <cases>] [-s <seed>]\n", argv[0]);
+
+            return 1;
+            }
+        }
+
+    //
+    //  Every combination of edge values.
+    //
+    for (i = 0; i < (int)CheckNumEdges; i++)
+        {
+        for (j = 0; j < (int)CheckNumEdges; j++)
+            {
+            x = (checkEdges48[i] << 16) | (checkEdges48[j] >> 32);
+            for (k = 0; k < (int)CheckNumEdges; k++)
+                {
+                y = (checkEdges48[k] << 16) | (checkEdges48[k] & Mask16);
+                checkMulLong128(x, y);
+                checkDivLong128(checkEdges48[i] >> 16, checkEdges48[j] << 48, checkEdges48[k]);
+                for (l = 0; l < (int)CheckNumEdges; l++)
+                    {
+                    a.leftPart  = checkEdges48[i];
+                    a.rightPart = checkEdges48[j];
+                    b.leftPart  = checkEdges48[k];
+                    b.rightPart = checkEdges48[l];
+                    checkMulLong192(&a, &b);
+                    checkDivLong96(&a, &b);
+                    }
+                }
+            }
+        }
+
+    //
+    //  Random operands, both full width and shaped like coefficients.
+    //
+    for (n = 0; n < cases; n++)
+        {
+        x = checkRandom();
+        y = checkRandom() >> (checkRandom() & 63);
+        checkMulLong128(x, y);
+        checkMulLong128(checkOperand48(), checkOperand48());
+        checkDivLong128(x, checkRandom(), y);
+        checkDivLong128(checkOperand48() >> 16, checkOperand48() << 48, checkOperand48());
+
+        a.leftPart  = checkOperand48();
+        a.rightPart = checkOperand48();
+        b.leftPart  = checkOperand48();
+        b.rightPart = checkOperand48();
+        checkMulLong192(&a, &b);
+        checkDivLong96(&a, &b);
+        b.leftPart &= 0x7fffffffffff;
+        checkDividend96(&a, &b);
+        checkDivLong96(&a, &b);
+        }
+
+    printf("float180check: %llu cases, %llu mismatches\n",
+           (unsigned long long)checkCases, (unsigned long long)checkMismatches);
+
+    return (checkMismatches == 0) ? 0 : 1;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stubs for functions float180.c references.
+**
+**------------------------------------------------------------------------*/
+void cpu180SetUserCondition(Cpu180Context *ctx, UserCondition cond)
+    {
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Compare the host 128 by 64 bit division which
+**                  float180DivFloat uses with float180DivLong128
+**
+**  Parameters:     Name        Description.
+**                  highDvdend  high 64 bits of dividend
+**                  lowDvdend   low 64 bits of dividend
+**                  dvisor      64-bit divisor
+**
+**  Returns:        Nothing.
+**
+**  Notes:          Operands whose quotient does not fit in 64 bits are
+**                  skipped.
+**
+**------------------------------------------------------------------------*/
+static void checkDivLong128(u64 highDvdend, u64 lowDvdend, u64 dvisor)
+    {
+    u64  fastQuotient;
+    u64  fastRemainder;
+    u128 dvdend;
+    u64  refQuotient;
+    u64  refRemainder;
+
+    if (highDvdend >= dvisor)
+        {
+        return;
+        }
+    dvdend        = ((u128)highDvdend << 64) | lowDvdend;
+    fastQuotient  = (u64)(dvdend / dvisor);
+    fastRemainder = (u64)(dvdend % dvisor);
+    refQuotient   = float180DivLong128(highDvdend, lowDvdend, dvisor, &refRemainder);
+    checkCases   += 1;
+    if ((fastQuotient != refQuotient) || (fastRemainder != refRemainder))
+        {
+        checkMismatch("float180DivLong128", fastQuotient, fastRemainder, refQuotient, refRemainder);
+        fprintf(stderr, "    dividend %016llx %016llx divisor %016llx\n",
+                (unsigned long long)highDvdend, (unsigned long long)lowDvdend, (unsigned long long)dvisor);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Compare float180DivLong96 with its reference
+**
+**  Parameters:     Name        Description.
+**                  dvdend      96-bit dividend
+**                  dvisor      96-bit divisor
+**
+**  Returns:        Nothing.
+**
+**  Notes:          Operands outside the range float180DivDouble passes
+**                  (a zero divisor, or an unnormalized divisor not more
+**                  than half the dividend) are skipped.
+**
+**------------------------------------------------------------------------*/
+static void checkDivLong96(Cpu180Double *dvdend, Cpu180Double *dvisor)
+    {
+    Cpu180Double fast;
+    Cpu180Double ref;
+    Cpu180Double twice;
+
+    if ((dvisor->leftPart | dvisor->rightPart) == 0)
+        {
+        return;
+        }
+    if ((dvisor->leftPart & 0x800000000000) == 0)
+        {
+        twice.leftPart  = (dvisor->leftPart << 1) | (dvisor->rightPart >> 47);
+        twice.rightPart = (dvisor->rightPart << 1) & Mask48;
+        if ((twice.leftPart < dvdend->leftPart)
+            || ((twice.leftPart == dvdend->leftPart) && (twice.rightPart <= dvdend->rightPart)))
+            {
+            return;
+            }
+        }
+    float180DivLong96(dvdend, dvisor, &fast);
+    float180DivLong96Ref(dvdend, dvisor, &ref);
+    checkCases += 1;
+    if ((fast.leftPart != ref.leftPart) || (fast.rightPart != ref.rightPart))
+        {
+        checkMismatch("float180DivLong96", fast.leftPart, fast.rightPart, ref.leftPart, ref.rightPart);
+        fprintf(stderr, "    dividend %012llx %012llx divisor %012llx %012llx\n",
+                (unsigned long long)dvdend->leftPart, (unsigned long long)dvdend->rightPart,
+                (unsigned long long)dvisor->leftPart, (unsigned long long)dvisor->rightPart);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Make a dividend which float180DivDouble would accept
+**                  for an unnormalized divisor
+**
+**  Parameters:     Name        Description.
+**                  dvdend      (out) 96-bit dividend
+**                  dvisor      96-bit divisor
+**
+**  Returns:        Nothing.
+**
+**  Notes:          The dividend is less than twice the divisor, and lies
+**                  either side of it so that the leading quotient bit
+**                  takes both values.
+**
+**------------------------------------------------------------------------*/
+static void checkDividend96(Cpu180Double *dvdend, Cpu180Double *dvisor)
+    {
+    u128 d96;
+    u128 r96;
+    u128 v96;
+
+    v96 = ((u128)dvisor->leftPart << 48) | dvisor->rightPart;
+    r96 = (((u128)checkRandom() << 64) | checkRandom()) & (v96 >> 1);
+    d96 = ((checkRandom() & 1) != 0) ? v96 + r96 : v96 - r96;
+    dvdend->leftPart  = (u64)(d96 >> 48) & Mask48;
+    dvdend->rightPart = (u64)d96 & Mask48;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Report a result which differs from the reference
+**
+**  Parameters:     Name        Description.
+**                  routine     name of routine under test
+**                  a0, a1      result of the routine under test
+**                  b0, b1      result of the reference
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void checkMismatch(char *routine, u64 a0, u64 a1, u64 b0, u64 b1)
+    {
+    checkMismatches += 1;
+    if (checkMismatches <= CheckMaxReports)
+        {
+        fprintf(stderr, "%s: %016llx %016llx, reference %016llx %016llx\n", routine,
+                (unsigned long long)a0, (unsigned long long)a1,
+                (unsigned long long)b0, (unsigned long long)b1);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Compare float180MulLong128 with its reference
+**
+**  Parameters:     Name        Description.
+**                  mltand      64-bit multiplicand
+**                  mltier      64-bit multiplier
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void checkMulLong128(u64 mltand, u64 mltier)
+    {
+    u64 fastLower;
+    u64 fastUpper;
+    u64 refLower;
+    u64 refUpper;
+
+    fastLower   = float180MulLong128(mltand, mltier, &fastUpper);
+    refLower    = float180MulLong128Ref(mltand, mltier, &refUpper);
+    checkCases += 1;
+    if ((fastLower != refLower) || (fastUpper != refUpper))
+        {
+        checkMismatch("float180MulLong128", fastUpper, fastLower, refUpper, refLower);
+        fprintf(stderr, "    multiplicand %016llx multiplier %016llx\n",
+                (unsigned long long)mltand, (unsigned long long)mltier);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Compare float180MulLong192 with its reference
+**
+**  Parameters:     Name        Description.
+**                  mltand      96-bit multiplicand
+**                  mltier      96-bit multiplier
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void checkMulLong192(Cpu180Double *mltand, Cpu180Double *mltier)
+    {
+    Cpu180Double fastHi;
+    Cpu180Double fastLo;
+    Cpu180Double refHi;
+    Cpu180Double refLo;
+    Cpu180Double t;
+
+    t = *mltier;
+    float180MulLong192(mltand, &t, &fastHi, &fastLo);
+    t = *mltier;
+    float180MulLong192Ref(mltand, &t, &refHi, &refLo);
+    checkCases += 1;
+    if ((fastHi.leftPart != refHi.leftPart) || (fastHi.rightPart != refHi.rightPart)
+        || (fastLo.leftPart != refLo.leftPart) || (fastLo.rightPart != refLo.rightPart))
+        {
+        checkMismatch("float180MulLong192 high", fastHi.leftPart, fastHi.rightPart, refHi.leftPart, refHi.rightPart);
+        fprintf(stderr, "    low %012llx %012llx, reference %012llx %012llx\n",
+                (unsigned long long)fastLo.leftPart, (unsigned long long)fastLo.rightPart,
+                (unsigned long long)refLo.leftPart, (unsigned long long)refLo.rightPart);
+        fprintf(stderr, "    multiplicand %012llx %012llx multiplier %012llx %012llx\n",
+                (unsigned long long)mltand->leftPart, (unsigned long long)mltand->rightPart,
+                (unsigned long long)mltier->leftPart, (unsigned long long)mltier->rightPart);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Generate a 48-bit operand
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Random 48-bit value, biased towards the edge values,
+**                  normalized values and short values.
+**
+**------------------------------------------------------------------------*/
+static u64 checkOperand48(void)
+    {
+    u64 r;
+
+    r = checkRandom();
+    switch (r & 7)
+        {
+    case 0:
+        return checkEdges48[(r >> 3) % CheckNumEdges];
+
+    case 1:
+        return (r >> 16) >> ((r >> 3) % 48);
+
+    case 2:
+    case 3:
+        return (r >> 16) | 0x800000000000;
+
+    default:
+        return r >> 16;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Generate a 64-bit pseudo random number (xorshift64*)
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Random value.
+**
+**------------------------------------------------------------------------*/
+static u64 checkRandom(void)
+    {
+    checkSeed ^= checkSeed >> 12;
+    checkSeed ^= checkSeed << 25;
+    checkSeed ^= checkSeed >> 27;
+
+    return checkSeed * 0x2545f4914f6cdd1dULL;
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
@@ -36,6 +36,8 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <time.h>
+#include <sys/stat.h>
 #include "const.h"
 #include "types.h"
 #include "proto.h"
@@ -52,6 +54,10 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <sys/types.h>
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 
 #endif
 
@@ -61,6 +67,11 @@
 **  Private Constants
 **  -----------------
 */
+#define FsMaxWatches        16
+#define FsMaxScanEntries    1024
+#if defined(__linux__)
+#define FsEventBufSize      (16 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+#endif
 
 /*
 **  -----------------------
@@ -74,6 +85,46 @@
 **  -----------------------------------------
 */
 
+/*
+**  Deck waiting in a watched input directory, or handed to the card
+**  reader but not yet removed from the directory.
+*/
+typedef struct fsDeck
+    {
+    struct fsDeck *next;
+    char          *path;
+    time_t        mtime;
+    ino_t         ino;
+    } FsDeck;
+
+/*
+**  Arrival-ordered queue of decks for one watched card reader.
+*/
+typedef struct fsWatch
+    {
+    u8              channelNo;
+    u8              eqNo;
+    int             devType;
+    int             depth;
+    FsDeck          *first;
+    FsDeck          *last;
+    FsDeck          *taken;
+#if defined(_WIN32)
+    HANDLE          mutex;
+#else
+    pthread_mutex_t mutex;
+#endif
+    } FsWatch;
+
+/*
+**  Directory entry collected by a scan, sorted by modification time.
+*/
+typedef struct fsScanEntry
+    {
+    time_t mtime;
+    char   *path;
+    } FsScanEntry;
+
 /*
 **  ---------------------------
 **  Private Function Prototypes
@@ -87,6 +138,20 @@ static void *fsWatchThread(void *parms);
 
 #endif
 
+static void    fsAcquireMutex(FsWatch *wp);
+static int     fsCompareScanEntries(const void *e1, const void *e2);
+static bool    fsEnqueue(FsWatch *wp, char *path, bool isFresh);
+static void    fsFeedReader(FsWatch *wp, char *crDevId);
+static FsWatch *fsFindWatch(u8 channelNo, u8 eqNo, int devType);
+static void    fsPruneTaken(FsWatch *wp);
+static void    fsReleaseMutex(FsWatch *wp);
+static void    fsScanDirectory(FsWatch *wp, char *dirPath);
+
+#if defined(__linux__)
+static bool fsWaitForEvents(FsWatch *wp, int fd, char *dirPath, u32 timeout);
+
+#endif
+
 /*
 **  ----------------
 **  Public Variables
@@ -101,6 +166,8 @@ extern int errno;
 **  Private Variables
 **  -----------------
 */
+static FsWatch watches[FsMaxWatches];
+static int     watchCount = 0;
 
 /*
  **--------------------------------------------------------------------------
@@ -119,15 +186,15 @@ extern int errno;
 **
 **      Ordinarily, the card readers will be enhanced to check the input
 **      directory "CRInput" for any remaining (unprocessed) files.  They
-**      will be processed (in date order), then deposited into the "CROutput"
-**      directory when completed.
-**
-**      When there are no files available in the "CRInput" directory, the card
-**      reader routines (cr405 and cr3447) will cease to auto-load files and
-**      will then need to be kick-started when a new file arrives.
+**      will be processed (in arrival order), then deposited into the
+**      "CROutput" directory when completed.
 **
-**      This routine performs that notification in the form of a simulated
-**      crXXXXLoadCards command dispatched to the appropriate handler.
+**      Each watched directory has a queue of decks kept in the order in
+**      which they arrived.  As soon as a deck is queued, it is fed to the
+**      card reader in the form of a simulated crXXXXLoadCards command
+**      dispatched to the appropriate handler.  The card reader's input
+**      tray holds the preprocessed decks until they are read, so decks
+**      are only held back in the watcher queue while the tray is full.
 **
 **      Limitations:    We prefer to watch directories which are subordinate to the
 **                      .ini file location to prevent a bunch of silliness that
@@ -136,18 +203,18 @@ extern int errno;
 **                      directory can be left "relative" and this will still
 **                      work correctly.
 **
-**      On Windows      Watch for events in identified directory.
+**      On Linux        inotify is used to learn of decks as soon as they
+**                      have been completely written (IN_CLOSE_WRITE) or
+**                      moved into the directory (IN_MOVED_TO).
 **
-**                      When a notification comes in for a given
-**                      card reader, we check the FCB for the device to see
-**                      if it's busy processing and simply exit if so.  We
-**                      can do this because the EOJ processing on the card
-**                      reader will pick up the next file in line.
+**      Elsewhere       The directory is polled every 2/3 of readerScanSecs
+**                      seconds, and decks not yet queued are appended in
+**                      order of modification time.
 **
-**                      If the FCB is NULL then we perform a LOAD CARDS
-**                      call with the string parameter of * (asterisk)
-**                      which tells the enhanced driver to pick up the next
-**                      file in date order from the "CRInput" queue.
+**      A deck stays in the directory until the card reader has finished
+**      with it, so dequeued decks are remembered by path, inode and
+**      modification time and are not queued again until the file is
+**      removed or replaced.
 **
 **  Parameters:     Name        Description.
 **
@@ -161,12 +228,37 @@ extern int errno;
 **  Parameters:     Name        Description.
 **                  parms       Pointer to the Thread Context Block
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if the thread was created.
 **
 **------------------------------------------------------------------------*/
 bool fsCreateThread(fswContext *parms)
     {
-    bool noLaunch = TRUE;
+    bool    noLaunch = TRUE;
+    FsWatch *wp;
+
+    /*
+    **  Register the deck queue for this card reader.  This happens
+    **  during initialisation, so no locking is required here.
+    */
+    wp = fsFindWatch(parms->channelNo, parms->eqNo, parms->devType);
+    if (wp == NULL)
+        {
+        if (watchCount >= FsMaxWatches)
+            {
+            logDtError(LogErrorLocation, "Too many watched card reader directories (max %d)\n", FsMaxWatches);
+
+            return FALSE;
+            }
+        wp            = &watches[watchCount++];
+        wp->channelNo = parms->channelNo;
+        wp->eqNo      = parms->eqNo;
+        wp->devType   = parms->devType;
+#if defined(_WIN32)
+        wp->mutex = CreateMutex(NULL, FALSE, NULL);
+#else
+        pthread_mutex_init(&wp->mutex, NULL);
+#endif
+        }
 
 #if (defined(_WIN32) || defined(__CYGWIN__))
     DWORD  dwThreadId;
@@ -208,6 +300,114 @@ bool fsCreateThread(fswContext *parms)
     return TRUE;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Remove the oldest arrival from the deck queue of a
+**                  watched card reader.
+**
+**  Parameters:     Name        Description.
+**                  channelNo   Channel number of card reader
+**                  eqNo        Equipment number of card reader
+**                  devType     Device type of card reader
+**                  fname       (out) path name of the deck
+**                  size        size of fname buffer
+**
+**  Returns:        TRUE if a deck was dequeued, FALSE if the queue is
+**                  empty or the card reader is not watched.
+**
+**------------------------------------------------------------------------*/
+bool fsDequeueDeck(u8 channelNo, u8 eqNo, int devType, char *fname, int size)
+    {
+    FsDeck      *dp;
+    struct stat s;
+    FsWatch     *wp;
+
+    wp = fsFindWatch(channelNo, eqNo, devType);
+    if (wp == NULL)
+        {
+        return FALSE;
+        }
+
+    fsAcquireMutex(wp);
+    dp = wp->first;
+    if (dp != NULL)
+        {
+        wp->first = dp->next;
+        if (wp->first == NULL)
+            {
+            wp->last = NULL;
+            }
+        wp->depth -= 1;
+        }
+    fsReleaseMutex(wp);
+
+    if (dp == NULL)
+        {
+        return FALSE;
+        }
+
+    strncpy(fname, dp->path, size - 1);
+    fname[size - 1] = '\0';
+
+    /*
+    **  Remember the deck until the card reader disposes of it, so that
+    **  a rescan of the directory does not submit it a second time.
+    */
+    if (stat(dp->path, &s) == 0)
+        {
+        dp->mtime = s.st_mtime;
+        dp->ino   = s.st_ino;
+        fsAcquireMutex(wp);
+        dp->next  = wp->taken;
+        wp->taken = dp;
+        fsReleaseMutex(wp);
+        }
+    else
+        {
+        free(dp->path);
+        free(dp);
+        }
+
+    return TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Report the number of decks waiting in the queue of a
+**                  watched card reader.
+**
+**  Parameters:     Name        Description.
+**                  channelNo   Channel number of card reader
+**                  eqNo        Equipment number of card reader
+**                  devType     Device type of card reader
+**
+**  Returns:        Queue depth, or -1 if the card reader is not watched.
+**
+**------------------------------------------------------------------------*/
+int fsQueueDepth(u8 channelNo, u8 eqNo, int devType)
+    {
+    FsWatch *wp;
+
+    wp = fsFindWatch(channelNo, eqNo, devType);
+
+    return (wp != NULL) ? wp->depth : -1;
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Filesystem watcher thread.
+**
+**  Parameters:     Name        Description.
+**                  parms       Pointer to the Thread Context Block
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
 #if defined(_WIN32)
 static void fsWatchThread(void *parms)
 #define fsReturn
@@ -223,19 +423,25 @@ static void *fsWatchThread(void * parms)
     **
     **  So we ensure that it does.
     */
-    fswContext    *lparms = (fswContext *)parms;
-    DevSlot       *dp = NULL;
-    char          *retPath;
-    char          lpDir[MaxFSPath] = { "" };
-    char          crDevId[16] = ""; // Just needs to be large enough to hold the unit spec
-    struct dirent *curDirEntry;
-    DIR           *curDir;
+    fswContext *lparms = (fswContext *)parms;
+    DevSlot    *dp = NULL;
+    char       *retPath;
+    char       lpDir[MaxFSPath] = { "" };
+    char       crDevId[16] = ""; // Just needs to be large enough to hold the unit spec
+    u32        waitTimeout;
+    FsWatch    *wp;
+
+#if defined(__linux__)
+    int fd;
+#endif
 
     //  Bring the Parameter List into the thread context
     sprintf(crDevId, "%02o,%02o,*",
             lparms->channelNo,
             lparms->eqNo);
 
+    wp = fsFindWatch(lparms->channelNo, lparms->eqNo, lparms->devType);
+
     // Retrieve the full path name.
     retPath = realpath(lparms->inWatchDir, lpDir);
 
@@ -265,7 +471,7 @@ static void *fsWatchThread(void * parms)
         break;
         }
 
-    if (dp == NULL)
+    if ((dp == NULL) || (wp == NULL))
         {
         printf("\n(fsmon  ) Cannot find device in Equipment Table"
                " Channel %o Equipment %o DeviceType %o"
@@ -278,55 +484,60 @@ static void *fsWatchThread(void * parms)
         }
 
     /*
-    **  After exploring Operating System specific APIs for
-    **  various filesystem watch strategies, Polling proved
-    **  to be the most effective AND the most portable.
-    **
-    **  ALL of the OS-Specific APIs had serious draw-backs.
+    **  Decks already waiting in the directory are queued first,
+    **  oldest first.
+    */
+    fsScanDirectory(wp, lparms->inWatchDir);
+
+    /*
+    **  The wait timeout bounds both the latency of noticing emulation
+    **  termination and the interval at which decks held back by a full
+    **  input tray are retried.
     */
+    waitTimeout = readerScanSecs * 1000 * 2 / 3;
+
+#if defined(__linux__)
+    fd = inotify_init();
+    if ((fd >= 0) && (inotify_add_watch(fd, lparms->inWatchDir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0))
+        {
+        close(fd);
+        fd = -1;
+        }
+    if (fd < 0)
+        {
+        printf("(fsmon  ) inotify unavailable for '%s' (%s), polling instead\n", lpDir, strerror(errno));
+        }
+#endif
 
     printf("(fsmon  ) Waiting ...\n");
 
     while (emulationActive)
         {
-        u32 waitTimeout = readerScanSecs * 1000 * 2 / 3;
-        sleepMsec(waitTimeout);
+        fsPruneTaken(wp);
+        fsFeedReader(wp, crDevId);
 
-        /*
-        **  Ensure the tray is empty/card reader isn't busy
-        */
-        if (dp->fcb[0] != NULL)
+#if defined(__linux__)
+        if (fd >= 0)
             {
+            if (!fsWaitForEvents(wp, fd, lparms->inWatchDir, waitTimeout))
+                {
+                close(fd);
+                fd = -1;
+                }
             continue;
             }
+#endif
 
-        curDir = opendir(lparms->inWatchDir);
-        do
-            {
-            //  See if there are files in the directory
-            curDirEntry = readdir(curDir);
-            if (curDirEntry == NULL)
-                {
-                break;
-                }
-            //  Pop over the dot (.) directories
-            if (curDirEntry->d_name[0] == '.')
-                {
-                continue;
-                }
-            else
-                {
-                /*
-                **  We have found at least ONE unprocessed file
-                **  Therefore we invoke the card load command
-                **  to pre-process and queue the deck.
-                */
-                opCmdLoadCards(FALSE, crDevId);
-                break;
-                }
-            } while (curDirEntry != NULL);
-        closedir(curDir);
+        sleepMsec(waitTimeout);
+        fsScanDirectory(wp, lparms->inWatchDir);
+        }
+
+#if defined(__linux__)
+    if (fd >= 0)
+        {
+        close(fd);
         }
+#endif
 
     /*
     **  The expectation is that we were passed a "calloc"ed
@@ -339,3 +550,375 @@ static void *fsWatchThread(void * parms)
 
     return fsReturn;
     }
+
+#if defined(__linux__)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Wait for inotify events on a watched directory and
+**                  queue the decks they announce.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**                  fd          inotify file descriptor
+**                  dirPath     Watched directory
+**                  timeout     Maximum wait in milliseconds
+**
+**  Returns:        FALSE if inotify failed and polling must be used.
+**
+**------------------------------------------------------------------------*/
+static bool fsWaitForEvents(FsWatch *wp, int fd, char *dirPath, u32 timeout)
+    {
+    char                 buf[FsEventBufSize] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    char                 *cp;
+    struct inotify_event *ep;
+    ssize_t              len;
+    char                 path[MaxFSPath * 2 + 2];
+    struct pollfd        pfd;
+    int                  rc;
+
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    rc         = poll(&pfd, 1, (int)timeout);
+    if (rc <= 0)
+        {
+        return (rc == 0) || (errno == EINTR);
+        }
+
+    len = read(fd, buf, sizeof(buf));
+    if (len <= 0)
+        {
+        return (len < 0) && (errno == EINTR);
+        }
+
+    for (cp = buf; cp < buf + len; cp += sizeof(struct inotify_event) + ep->len)
+        {
+        ep = (struct inotify_event *)cp;
+        if (ep->mask & IN_Q_OVERFLOW)
+            {
+            /*
+            **  Events were lost, so pick up whatever is in the directory.
+            */
+            fsScanDirectory(wp, dirPath);
+            continue;
+            }
+        if ((ep->len == 0) || (ep->name[0] == '.') || (ep->mask & IN_ISDIR))
+            {
+            continue;
+            }
+        sprintf(path, "%s/%s", dirPath, ep->name);
+        fsEnqueue(wp, path, TRUE);
+        }
+
+    return TRUE;
+    }
+
+#endif
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Scan a watched directory and queue any decks not yet
+**                  queued, in order of modification time.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**                  dirPath     Watched directory
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void fsScanDirectory(FsWatch *wp, char *dirPath)
+    {
+    int           count;
+    DIR           *curDir;
+    struct dirent *curDirEntry;
+    FsScanEntry   *entries;
+    int           i;
+    struct stat   s;
+    char          strWork[MaxFSPath * 2 + 2];
+
+    curDir = opendir(dirPath);
+    if (curDir == NULL)
+        {
+        return;
+        }
+
+    entries = (FsScanEntry *)calloc(FsMaxScanEntries, sizeof(FsScanEntry));
+    if (entries == NULL)
+        {
+        closedir(curDir);
+
+        return;
+        }
+
+    count = 0;
+    while (count < FsMaxScanEntries && (curDirEntry = readdir(curDir)) != NULL)
+        {
+        //  Pop over the dot (.) files and directories
+        if (curDirEntry->d_name[0] == '.')
+            {
+            continue;
+            }
+        sprintf(strWork, "%s/%s", dirPath, curDirEntry->d_name);
+        if ((stat(strWork, &s) != 0) || ((s.st_mode & S_IFDIR) != 0))
+            {
+            continue;
+            }
+        entries[count].mtime = s.st_mtime;
+        entries[count].path  = strdup(strWork);
+        if (entries[count].path != NULL)
+            {
+            count += 1;
+            }
+        }
+    closedir(curDir);
+
+    qsort(entries, count, sizeof(FsScanEntry), fsCompareScanEntries);
+
+    for (i = 0; i < count; i++)
+        {
+        fsEnqueue(wp, entries[i].path, FALSE);
+        free(entries[i].path);
+        }
+    free(entries);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Order directory scan entries by modification time.
+**
+**  Parameters:     Name        Description.
+**                  e1          Pointer to first entry
+**                  e2          Pointer to second entry
+**
+**  Returns:        <0, 0, >0 as for qsort.
+**
+**------------------------------------------------------------------------*/
+static int fsCompareScanEntries(const void *e1, const void *e2)
+    {
+    const FsScanEntry *s1 = (const FsScanEntry *)e1;
+    const FsScanEntry *s2 = (const FsScanEntry *)e2;
+
+    if (s1->mtime != s2->mtime)
+        {
+        return (s1->mtime < s2->mtime) ? -1 : 1;
+        }
+
+    return strcmp(s1->path, s2->path);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append a deck to a queue unless it is already queued
+**                  or has already been handed to the card reader.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**                  path        Path name of deck
+**                  isFresh     TRUE if the file has just been written or
+**                              moved into the directory
+**
+**  Returns:        TRUE if the deck was appended.
+**
+**------------------------------------------------------------------------*/
+static bool fsEnqueue(FsWatch *wp, char *path, bool isFresh)
+    {
+    FsDeck      *dp;
+    FsDeck      **link;
+    struct stat s;
+
+    if (stat(path, &s) != 0)
+        {
+        return FALSE;
+        }
+
+    fsAcquireMutex(wp);
+    for (dp = wp->first; dp != NULL; dp = dp->next)
+        {
+        if (strcmp(dp->path, path) == 0)
+            {
+            fsReleaseMutex(wp);
+
+            return FALSE;
+            }
+        }
+
+    for (link = &wp->taken; (dp = *link) != NULL; link = &dp->next)
+        {
+        if (strcmp(dp->path, path) != 0)
+            {
+            continue;
+            }
+        if (!isFresh && (dp->mtime == s.st_mtime) && (dp->ino == s.st_ino))
+            {
+            fsReleaseMutex(wp);
+
+            return FALSE;
+            }
+
+        /*
+        **  A new deck has replaced the one the card reader took.
+        */
+        *link = dp->next;
+        free(dp->path);
+        free(dp);
+        break;
+        }
+
+    dp = (FsDeck *)calloc(1, sizeof(FsDeck));
+    if (dp != NULL)
+        {
+        dp->path = strdup(path);
+        }
+    if ((dp == NULL) || (dp->path == NULL))
+        {
+        fsReleaseMutex(wp);
+        free(dp);
+        logDtError(LogErrorLocation, "Failed to allocate queue entry for deck '%s'\n", path);
+
+        return FALSE;
+        }
+
+    if (wp->last == NULL)
+        {
+        wp->first = dp;
+        }
+    else
+        {
+        wp->last->next = dp;
+        }
+    wp->last   = dp;
+    wp->depth += 1;
+    fsReleaseMutex(wp);
+
+    return TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Feed queued decks into a card reader until either the
+**                  queue is empty or the reader's input tray is full.
+**                  A full tray is retried quietly on the next call.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**                  crDevId     Load cards command parameters for the reader
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void fsFeedReader(FsWatch *wp, char *crDevId)
+    {
+    char params[16];
+    int  depth;
+    bool isFull;
+
+    while (emulationActive && wp->depth > 0)
+        {
+        isFull = (wp->devType == DtCr3447) ? cr3447IsTrayFull(wp->channelNo, wp->eqNo)
+                                           : cr405IsTrayFull(wp->channelNo, wp->eqNo);
+        if (isFull)
+            {
+            break;
+            }
+        depth = wp->depth;
+
+        /*
+        **  opCmdLoadCards may modify its parameter string.
+        */
+        strcpy(params, crDevId);
+        opCmdLoadCards(FALSE, params);
+        idleWake();
+        if (wp->depth >= depth)
+            {
+            /*
+            **  The deck was not taken.  Retry later.
+            */
+            break;
+            }
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Find the deck queue of a watched card reader.
+**
+**  Parameters:     Name        Description.
+**                  channelNo   Channel number of card reader
+**                  eqNo        Equipment number of card reader
+**                  devType     Device type of card reader
+**
+**  Returns:        Pointer to deck queue, or NULL if not watched.
+**
+**------------------------------------------------------------------------*/
+static FsWatch *fsFindWatch(u8 channelNo, u8 eqNo, int devType)
+    {
+    int i;
+
+    for (i = 0; i < watchCount; i++)
+        {
+        if ((watches[i].channelNo == channelNo)
+            && (watches[i].eqNo == eqNo)
+            && (watches[i].devType == devType))
+            {
+            return &watches[i];
+            }
+        }
+
+    return NULL;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Forget decks handed to the card reader which have since
+**                  been removed from, or replaced in, the input directory.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void fsPruneTaken(FsWatch *wp)
+    {
+    FsDeck      *dp;
+    FsDeck      **link;
+    struct stat s;
+
+    fsAcquireMutex(wp);
+    link = &wp->taken;
+    while ((dp = *link) != NULL)
+        {
+        if ((stat(dp->path, &s) == 0) && (dp->mtime == s.st_mtime) && (dp->ino == s.st_ino))
+            {
+            link = &dp->next;
+            continue;
+            }
+        *link = dp->next;
+        free(dp->path);
+        free(dp);
+        }
+    fsReleaseMutex(wp);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Acquire / release lock on a deck queue.
+**
+**  Parameters:     Name        Description.
+**                  wp          Pointer to deck queue
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void fsAcquireMutex(FsWatch *wp)
+    {
+#if defined(_WIN32)
+    WaitForSingleObject(wp->mutex, INFINITE);
+#else
+    pthread_mutex_lock(&wp->mutex);
+#endif
+    }
+
+static void fsReleaseMutex(FsWatch *wp)
+    {
+#if defined(_WIN32)
+    ReleaseMutex(wp->mutex);
+#else
+    pthread_mutex_unlock(&wp->mutex);
+#endif
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
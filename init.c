@@ -167,6 +167,7 @@ bool          bigEndian;
 extern u16    deadstartPanel[];
 extern u8     deadstartCount;
 char          displayName[32];
+char          ecsSharedName[64];
 ModelFeatures features;
 bool          isCyber180;
 ModelType     modelType;
@@ -250,6 +251,7 @@ static InitVal sectVals[] =
     { "displayName",                   "cyber",   "Valid"      },
     { "ecsBanks",                      "cyber",   "Valid"      },
     { "ecsFile",                       "cyber",   "Deprecated" },
+    { "ecsShared",                     "cyber",   "Valid"      },
     { "equipment",                     "cyber",   "Valid"      },
     { "esmBanks",                      "cyber",   "Valid"      },
     { "helpers",                       "cyber",   "Valid"      },
@@ -266,6 +268,8 @@ static InitVal sectVals[] =
     { "persistDir",                    "cyber",   "Valid"      },
     { "platoConns",                    "cyber",   "Deprecated" },
     { "platoPort",                     "cyber",   "Deprecated" },
+    { "ppCmBurst",                     "cyber",   "Valid"      },
+    { "ppIdle",                        "cyber",   "Valid"      },
     { "pps",                           "cyber",   "Valid"      },
     { "setMhz",                        "cyber",   "Valid"      },
     { "telnetConns",                   "cyber",   "Deprecated" },
@@ -279,6 +283,7 @@ static InitVal sectVals[] =
     { "hostID",                        "npu",     "Valid"      },
     { "hostIP",                        "npu",     "Deprecated" },
     { "idleNetBufs",                   "npu",     "Valid"      },
+    { "maxNetBufs",                    "npu",     "Valid"      },
     { "npuNode",                       "npu",     "Valid"      },
     { "terminals",                     "npu",     "Valid"      },
 
@@ -951,6 +956,28 @@ static void initCyber(char *config)
         exit(1);
         }
 
+    /*
+    **  Optionally share ECS/ESM with other emulators on this host. The
+    **  value names a POSIX shared memory object, e.g. /mmf.
+    */
+    if (initGetString("ecsShared", "", ecsSharedName, sizeof(ecsSharedName)))
+        {
+#if defined(_WIN32)
+        logDtError(LogErrorLocation, "file '%s' section [%s]: Entry 'ecsShared' is not supported on Windows\n", startupFile, config);
+        exit(1);
+#endif
+        if (ecsBanks + esmBanks == 0)
+            {
+            logDtError(LogErrorLocation, "file '%s' section [%s]: Entry 'ecsShared' requires 'ecsbanks' or 'esmbanks'\n", startupFile, config);
+            exit(1);
+            }
+        if ((ecsSharedName[0] != '/') || (ecsSharedName[1] == '\0') || (strchr(ecsSharedName + 1, '/') != NULL))
+            {
+            logDtError(LogErrorLocation, "file '%s' section [%s]: Entry 'ecsShared' invalid - must be of the form /name\n", startupFile, config);
+            exit(1);
+            }
+        }
+
     /*
     **  Determine the number of CPUs to use.
     */
@@ -1288,7 +1315,8 @@ static void initCyber(char *config)
         }
     else if (strcasecmp(osType, "nos") == 0)
         {
-        idleDetector = &idleDetectorNOS;
+        idleDetector   = &idleDetectorNOS;
+        ppIdleDetector = &ppIdleDetectorNOS;
         }
     else if (strcasecmp(osType, "nosbe") == 0)
         {
@@ -1296,7 +1324,8 @@ static void initCyber(char *config)
         }
     else if (strcasecmp(osType, "kronos") == 0)
         {
-        idleDetector = &idleDetectorNOS;
+        idleDetector   = &idleDetectorNOS;
+        ppIdleDetector = &ppIdleDetectorNOS;
         }
     else if (strcasecmp(osType, "mace") == 0)
         {
@@ -1314,6 +1343,51 @@ static void initCyber(char *config)
 
     fprintf(stdout, "(init   ) Operating system type is '%s'.\n", osType);
 
+    /*
+    **  Get optional PP idle loop fast-forward setting. It is off unless
+    **  requested, and takes effect only for operating system types which
+    **  have a PP idle loop detector.
+    */
+    initGetString("ppidle", "off", dummy, sizeof(dummy));
+    if ((strcasecmp(dummy, "off") == 0)
+        || (strcasecmp(dummy, "false") == 0)
+        || (strcasecmp(dummy, "0") == 0))
+        {
+        ppIdleDetector = NULL;
+        }
+    else if ((strcasecmp(dummy, "on") != 0)
+             && (strcasecmp(dummy, "true") != 0)
+             && (strcasecmp(dummy, "1") != 0))
+        {
+        logDtError(LogErrorLocation, "file '%s' section [%s]: Invalid value for 'ppIdle' - must be one of 'on' or 'off'\n", startupFile, config);
+        exit(1);
+        }
+    if (ppIdleDetector != NULL)
+        {
+        fputs("(init   ) PP idle loop fast-forward on.\n", stdout);
+        }
+
+    /*
+    **  Get optional number of CM words moved per PP cycle by the CRM and
+    **  CWM block transfer instructions. 1 preserves instruction timing,
+    **  0 moves the whole block at once.
+    */
+    initGetInteger("ppCmBurst", 1, &dummyInt);
+    if ((dummyInt < 0) || (dummyInt > 010000))
+        {
+        logDtError(LogErrorLocation, "file '%s' section [%s]: Invalid value for 'ppCmBurst' - must be between 0 and 4096\n", startupFile, config);
+        exit(1);
+        }
+    ppCmBurst = (u32)dummyInt;
+    if (ppCmBurst == 0)
+        {
+        fputs("(init   ) PP CM block transfers move whole blocks.\n", stdout);
+        }
+    else if (ppCmBurst > 1)
+        {
+        fprintf(stdout, "(init   ) PP CM block transfers move %u words per cycle.\n", ppCmBurst);
+        }
+
     /*
     **  Get optional Plato port number. If not specified, use default value.
     */
@@ -1636,6 +1710,7 @@ static void initNpuConnections(void)
     u16          destHostPort;
     char         *destHostName;
     u8           destNode;
+    bool         isLocal;
     u32          localHostIP;
     Pcb          *pcbp;
     long         pingInterval;
@@ -1796,6 +1871,20 @@ static void initNpuConnections(void)
     idleNetBufs = (u32)val;
     logDtError(LogErrorLocation, "Idle network buffer threshold is %d\n", idleNetBufs);
 
+    /*
+    **  Get optional number of network buffers in use at which input from network
+    **  connections is deferred until buffers are returned to the pool.
+    */
+    initGetInteger("maxNetBufs", 4000, &val);
+    if (val < 100)
+        {
+        logDtError(LogErrorLocation, "file '%s' section [%s]: Invalid 'maxNetBufs' value %ld - correct values are 100 or greater\n",
+                   startupFile, npuConnections, val);
+        exit(1);
+        }
+    npuBipMaxBufs = (u32)val;
+    logDtError(LogErrorLocation, "Network buffer limit is %d\n", npuBipMaxBufs);
+
     /*
     **  Process all equipment entries.
     */
@@ -1825,13 +1914,14 @@ static void initNpuConnections(void)
             **
             **   terminals=<local-port>,<cla-port>,<connections>,hasp[,B<block-size>]
             **   terminals=<local-port>,<cla-port>,<connections>,nje,<remote-ip>:<remote-port>,<remote-name> ...
-            **       [,<local-ip>][,B<block-size>][,P<ping-interval>]
+            **       [,<local-ip>][,B<block-size>][,P<ping-interval>][,local]
             **   terminals=<local-port>,<cla-port>,<connections>,pterm[,auto|xauto]
             **   terminals=<local-port>,<cla-port>,<connections>,raw[,auto|xauto]
             **   terminals=<local-port>,<cla-port>,<connections>,rhasp,<remote-ip>:<remote-port>[,B<block-size>]
             **   terminals=<local-port>,<cla-port>,<connections>,rs232[,auto|xauto]
             **   terminals=<local-port>,<cla-port>,<connections>,telnet[,auto|xauto]
             **   terminals=<local-port>,<cla-port>,<connections>,trunk,<remote-ip>:<remote-port>,<remote-name>,<coupler-node>
+            **       [,local]
             **
             **     terminal types:
             **       hasp   A TCP connection supporting HASP protocol
@@ -1850,6 +1940,9 @@ static void initNpuConnections(void)
             **     <cla-port>      Starting CLA port number on NPU, in hexadecimal, must match NDL definition
             **     <coupler-node>  Coupler node number of DtCyber host at other end of trunk
             **     <connections>   Maximum number of concurrent connections to accept for port
+            **     local           Optional keyword indicating that an NJE or LIP peer runs on the same host.
+            **                     The connection uses a Unix domain socket named after the port numbers
+            **                     instead of TCP; the peer must specify the keyword too
             **     <local-ip>      IP address to use in NJE connections for local host (value of ipAddress
             **                     config entry used by default)
             **     <local-port>    Local TCP port number on which to listen for connections (0 for no listening
@@ -1893,6 +1986,7 @@ static void initNpuConnections(void)
 
             destHostAddr = NULL;
             blockSize    = DefaultBlockSize;
+            isLocal      = FALSE;
 
             switch (connType)
                 {
@@ -2056,6 +2150,10 @@ static void initNpuConnections(void)
                             exit(1);
                             }
                         }
+                    else if (strcasecmp(token, "local") == 0)
+                        {
+                        isLocal = TRUE;
+                        }
                     else if (initParseIpAddress(token, &localHostIP, NULL) == FALSE)
                         {
                         logDtError(LogErrorLocation, "Invalid local NJE node address %s\n", token);
@@ -2099,7 +2197,7 @@ static void initNpuConnections(void)
                 destHostName = token;
                 initToUpperCase(destHostName);
 
-                token = strtok(NULL, " ");
+                token = strtok(NULL, ", ");
                 if (token == NULL)
                     {
                     logDtError(LogErrorLocation, "Missing coupler node number\n");
@@ -2113,6 +2211,17 @@ static void initNpuConnections(void)
                     exit(1);
                     }
                 destNode = (u8)val;
+
+                token = strtok(NULL, ", ");
+                if (token != NULL)
+                    {
+                    if (strcasecmp(token, "local") != 0)
+                        {
+                        logDtError(LogErrorLocation, "Unrecognized keyword '%s'\n", token);
+                        exit(1);
+                        }
+                    isLocal = TRUE;
+                    }
                 logDtError(LogErrorLocation, "  coupler node %d, destination host %s/%s",
                            destNode, destHostName, destHostAddr);
                 break;
@@ -2135,6 +2244,16 @@ static void initNpuConnections(void)
                 ncbp->hostAddr.sin_family      = AF_INET;
                 ncbp->hostAddr.sin_addr.s_addr = htonl(destHostIP);
                 ncbp->hostAddr.sin_port        = htons(destHostPort);
+                ncbp->isLocal                  = isLocal;
+                if (isLocal)
+                    {
+#if defined(_WIN32)
+                    logDtError(LogErrorLocation, "Keyword 'local' is not supported on Windows\n");
+                    exit(1);
+#else
+                    logDtError(LogErrorLocation, "  using local socket");
+#endif
+                    }
                 if (connType == ConnTypeNje)
                     {
                     pcbp = npuNetFindPcb(claPort);
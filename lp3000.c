@@ -52,6 +52,13 @@
 #include "proto.h"
 #include "dcc6681.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 /*
 **  -----------------
 **  Private Constants
@@ -163,6 +170,19 @@
 */
 #define MaxLineSize              140
 
+/*
+**  Size of the buffers in which printed lines are accumulated before being
+**  handed to the print file writer thread.
+*/
+#define LpBufSize                65536
+
+/*
+**  Print file writer request types
+*/
+#define LpReqWrite               0
+#define LpReqRemovePaper         1
+#define LpReqClose               2
+
 /*
 **      Status reply
 **
@@ -186,6 +206,22 @@
 **  -----------------------------------------
 */
 
+/*
+**  Request to the print file writer thread.  Lines are accumulated by the
+**  emulation thread in a write request until it is full or the printer is
+**  released, and paper removal (closing, renaming, and re-opening the print
+**  file and converting the completed file) is also performed by the writer.
+*/
+typedef struct lpRequest
+    {
+    struct lpRequest *next;
+    struct lpContext *lc;
+    u8               type;
+    int              len;
+    char             *data;
+    char             newName[MaxFSPath + 128];
+    } LpRequest;
+
 typedef struct lpContext
     {
     /*
@@ -212,6 +248,11 @@ typedef struct lpContext
     bool             doBurst;            //  bursting option for forced segmentation at EOJ
     char             path[MaxFSPath];    //  preserve the device folder path
     char             curFileName[MaxFSPath + 128];
+    char             *converter;         //  optional command applied to each completed print file
+
+    LpRequest        *outBuf;            //  buffer being filled by emulation thread
+    u64              bytesPrinted;       //  bytes printed since paper was last removed
+    FILE             *fcb;               //  print file, owned by writer thread
     } LpContext;
 
 
@@ -227,9 +268,24 @@ static FcStatus lp3000Func(PpWord funcCode);
 static void     lp3000Io(void);
 static void     lp3000Activate(void);
 static void     lp3000Disconnect(void);
-static void     lp3000PrintANSI(LpContext *lc, FILE *fcb);
-static void     lp3000PrintASCII(LpContext *lc, FILE *fcb);
-static void     lp3000PrintCDC(LpContext *lc, FILE *fcb);
+static void     lp3000PrintANSI(LpContext *lc);
+static void     lp3000PrintASCII(LpContext *lc);
+static void     lp3000PrintCDC(LpContext *lc);
+static void     lp3000Put(LpContext *lc, char *str);
+static void     lp3000PutChar(LpContext *lc, char c);
+static void     lp3000Submit(LpContext *lc);
+static LpRequest *lp3000AllocRequest(LpContext *lc, u8 type);
+static void     lp3000Enqueue(LpRequest *rp);
+static void     lp3000StartWriter(void);
+static void     lp3000WriterRemovePaper(LpRequest *rp);
+
+#if defined(_WIN32)
+static void lp3000WriterThread(void *param);
+
+#else
+static void *lp3000WriterThread(void *param);
+
+#endif
 
 #if DEBUG
 static void     lp3000DebugData(LpContext *lc);
@@ -252,6 +308,22 @@ static char    *lp3000Func2String(LpContext *lc, PpWord funcCode);
 static LpContext *firstUnit = NULL;
 static LpContext *lastUnit  = NULL;
 
+/*
+**  Print file writer thread and its request queue.
+*/
+static bool      writerStarted = FALSE;
+static bool      writerBusy    = FALSE;
+static LpRequest *firstRequest = NULL;
+static LpRequest *lastRequest  = NULL;
+static u32       queuedBytes   = 0;
+#if defined(_WIN32)
+static HANDLE writerMutex;
+static HANDLE writerEvent;
+#else
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  writerCond  = PTHREAD_COND_INITIALIZER;
+#endif
+
 static char *postPrintCdcEffectors[] =
     {
     "H", // advance to channel 1
@@ -385,6 +457,7 @@ void lp512Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceParams)
 static void lp3000Init(u16 lpType, u8 eqNo, u8 unitNo, u8 channelNo, char *deviceParams)
     {
     char      *burstMode;
+    char      *converter;
     char      *deviceMode;
     char      *devicePath;
     char      *deviceType;
@@ -418,12 +491,16 @@ static void lp3000Init(u16 lpType, u8 eqNo, u8 unitNo, u8 channelNo, char *devic
     **      <devicePath>
     **      <OutputMode>   ("CDC"|"ANSI"|"ASCII")
     **      <BurstingMode> ("Burst"|"NoBurst")
+    **      <Converter>    (optional command applied to each completed
+    **                      print file, e.g. "gzip" or a PDF converter,
+    **                      run by the print file writer thread)
     **
     */
     deviceType = strtok(deviceParams, ", "); //  "3555" | "3152"
     devicePath = strtok(NULL, ", ");         //  Get the Path (subdirectory)
     deviceMode = strtok(NULL, ", ");         //  pick up "cdc", "ansi", or "ascii"
     burstMode  = strtok(NULL, ", ");         //  Indication for bursting
+    converter  = strtok(NULL, ", ");         //  Optional print file converter
 
     mode = ModeCDC;
     if (deviceMode != NULL)
@@ -530,6 +607,14 @@ static void lp3000Init(u16 lpType, u8 eqNo, u8 unitNo, u8 channelNo, char *devic
     lc->unitNo        = unitNo;
     lc->eqNo          = eqNo;
     lc->path[0]       = '\0';
+    lc->converter     = NULL;
+    lc->outBuf        = lp3000AllocRequest(lc, LpReqWrite);
+
+    if ((converter != NULL) && (strcmp(converter, "*") != 0))
+        {
+        lc->converter = strdup(converter);
+        fprintf(stdout, "(lp3000 ) %s Completed print files converted by '%s'\n", lpTypeName, converter);
+        }
 
     /*
     **  Remember the device Path for future fopen calls
@@ -552,12 +637,22 @@ static void lp3000Init(u16 lpType, u8 eqNo, u8 unitNo, u8 channelNo, char *devic
     */
     sprintf(lc->curFileName, "%sLP5xx_C%02o_E%o", lc->path, channelNo, eqNo);
 
-    up->fcb[0] = fopen(lc->curFileName, "w");
-    if (up->fcb[0] == NULL)
+    lc->fcb = fopen(lc->curFileName, "w");
+    if (lc->fcb == NULL)
         {
         logDtError(LogErrorLocation, "Failed to open %s\n", lc->curFileName);
         exit(1);
         }
+    setvbuf(lc->fcb, NULL, _IOFBF, LpBufSize);
+
+    /*
+    **  The print file is written by a background thread shared by all
+    **  3000 series printers.
+    */
+    if (!writerStarted)
+        {
+        lp3000StartWriter();
+        }
 
     /*
     **  Print a friendly message.
@@ -595,6 +690,11 @@ void lp3000ShowStatus()
     LpContext *lc;
     char      lpType[10];
 
+    if (writerStarted)
+        {
+        opDisplay("    >   LP5xx print file writer: %u bytes queued\n", queuedBytes);
+        }
+
     for (lc = firstUnit; lc != NULL; lc = lc->nextUnit)
         {
         sprintf(lpType, "%s/%s", (lc->flags & Lp3000Type3555) ? "3555" : "3152", (lc->flags & Lp3000Type501) ? "501" : "512");
@@ -606,6 +706,11 @@ void lp3000ShowStatus()
             {
             opDisplay(", burst");
             }
+        if (lc->converter != NULL)
+            {
+            opDisplay(", convert %s", lc->converter);
+            }
+        opDisplay(", %llu bytes", (unsigned long long)lc->bytesPrinted);
         opDisplay(")\n");
         }
     }
@@ -613,6 +718,10 @@ void lp3000ShowStatus()
 /*--------------------------------------------------------------------------
 **  Purpose:        Remove the paper (operator interface).
 **
+**                  The print file is closed, renamed, and re-opened by the
+**                  print file writer thread once all output printed so far
+**                  has been written.
+**
 **  Parameters:     Name        Description.
 **                  params      parameters
 **
@@ -622,15 +731,12 @@ void lp3000ShowStatus()
 void lp3000RemovePaper(char *params)
     {
     int       channelNo;
-    time_t    currentTime;
     DevSlot   *dp;
     int       equipmentNo;
     char      fNameNew[MaxFSPath + 128];
-    int       iSuffix;
     LpContext *lc;
     int       numParam;
-    bool      renameOK;
-    struct tm t;
+    LpRequest *rp;
 
     /*
     **  Operator wants to remove paper.
@@ -672,101 +778,75 @@ void lp3000RemovePaper(char *params)
         return;
         }
 
-    lc       = (LpContext *)dp->context[0];
-    renameOK = FALSE;
+    lc = (LpContext *)dp->context[0];
 
-    //
-    //  This can happen if something goes wrong in the open and the file fails
-    //  to be properly re-opened.
-    //
-    if (dp->fcb[0] == NULL)
+    if (lc->bytesPrinted == 0)
         {
-        logDtError(LogErrorLocation, "lp3000RemovePaper: FCB is null on channel %o equipment %o\n",
-                   dp->channel->id,
-                   dp->eqNo);
-        //  proceed to attempt to open a new FCB
-        }
-    else
-        {
-        fflush(dp->fcb[0]);
+        opDisplay("(lp3000 ) No output has been written on channel %o and equipment %o\n", channelNo, equipmentNo);
 
-        if (ftell(dp->fcb[0]) == 0)
-            {
-            opDisplay("(lp3000 ) No output has been written on channel %o and equipment %o\n", channelNo, equipmentNo);
-
-            return;
-            }
-
-        /*
-        **  Close the old device file.
-        */
-        fclose(dp->fcb[0]);
-        dp->fcb[0] = NULL;
-
-        if (numParam > 2)
-            {
-            if (rename(lc->curFileName, fNameNew) == 0)
-                {
-                renameOK = TRUE;
-                }
-            else
-                {
-                opDisplay("(lp3000 ) Rename Failure '%s' to '%s' - (%s).\n", lc->curFileName, fNameNew, strerror(errno));
-                }
-            }
-        else
-            {
-            /*
-            **  Rename the device file to the format "LP5xx_yyyymmdd_hhmmss_nn.txt".
-            */
-            for (iSuffix = 0; iSuffix < 100; iSuffix++)
-                {
-                time(&currentTime);
-                t = *localtime(&currentTime);
-                sprintf(fNameNew, "%sLP5xx_%04d%02d%02d_%02d%02d%02d_%02d.txt",
-                        lc->path,
-                        t.tm_year + 1900,
-                        t.tm_mon + 1,
-                        t.tm_mday,
-                        t.tm_hour,
-                        t.tm_min,
-                        t.tm_sec,
-                        iSuffix);
-
-                if (rename(lc->curFileName, fNameNew) == 0)
-                    {
-                    renameOK = TRUE;
-                    break;
-                    }
-                logDtError(LogErrorLocation, "Rename Failure '%s' to '%s' - (%s). Retrying (%d)...\n",
-                           lc->curFileName,
-                           fNameNew,
-                           strerror(errno),
-                           iSuffix);
-                }
-            }
+        return;
         }
 
     /*
-    **  Open the device file.
+    **  Hand the remaining output and the paper removal to the writer.
     */
+    lp3000Submit(lc);
+    rp = lp3000AllocRequest(lc, LpReqRemovePaper);
+    if (numParam > 2)
+        {
+        strcpy(rp->newName, fNameNew);
+        }
+    lp3000Enqueue(rp);
+    lc->bytesPrinted = 0;
+    }
 
-    //  Just append to the old file if the rename didn't happen correctly
-    dp->fcb[0] = fopen(lc->curFileName, renameOK ? "w" : "a");
+/*--------------------------------------------------------------------------
+**  Purpose:        Flush pending output of a printer and close its print
+**                  file when the emulation terminates.
+**
+**  Parameters:     Name        Description.
+**                  dp          Device slot of the printer
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void lp3000Terminate(DevSlot *dp)
+    {
+    LpContext *lc = (LpContext *)dp->context[0];
+    bool      isDrained;
 
-    /*
-    **  Check if the open succeeded.
-    */
-    if (dp->fcb[0] == NULL)
+    if ((lc == NULL) || !writerStarted)
         {
-        logDtError(LogErrorLocation, "Failed to open %s\n", lc->curFileName);
-
         return;
         }
-    if (renameOK)
+
+    lp3000Submit(lc);
+    lp3000Enqueue(lp3000AllocRequest(lc, LpReqClose));
+
+    /*
+    **  Wait for the writer to complete all outstanding requests, because
+    **  the context is freed once this returns.
+    */
+    do
         {
-        opDisplay("(lp3000 ) Paper removed from 5xx printer and available on '%s'\n", fNameNew);
-        }
+#if defined(_WIN32)
+        WaitForSingleObject(writerMutex, INFINITE);
+        isDrained = (firstRequest == NULL) && !writerBusy;
+        ReleaseMutex(writerMutex);
+#else
+        pthread_mutex_lock(&writerMutex);
+        isDrained = (firstRequest == NULL) && !writerBusy;
+        pthread_mutex_unlock(&writerMutex);
+#endif
+        if (!isDrained)
+            {
+            sleepMsec(10);
+            }
+        } while (!isDrained);
+
+    free(lc->outBuf->data);
+    free(lc->outBuf);
+    lc->outBuf = NULL;
     }
 
 /*--------------------------------------------------------------------------
@@ -780,28 +860,13 @@ void lp3000RemovePaper(char *params)
 **------------------------------------------------------------------------*/
 static FcStatus lp3000Func(PpWord funcCode)
     {
-    FILE      *fcb;
     LpContext *lc;
 
     char         dispLpDevId[16];       //  Used for automatically removing printouts at EOJ
     unsigned int channelId;
     unsigned int deviceId;
 
-    fcb = active3000Device->fcb[0];
-    lc  = (LpContext *)active3000Device->context[0];
-
-    /*
-    **  This can happen if something goes wrong in the open and the file fails
-    **  to be properly re-opened.
-    */
-    if (fcb == NULL)
-        {
-        logDtError(LogErrorLocation, "lp3000Func: FCB is null on channel %o equipment %o\n",
-                   active3000Device->channel->id,
-                   active3000Device->eqNo);
-
-        return FcProcessed;
-        }
+    lc = (LpContext *)active3000Device->context[0];
 
 #if DEBUG
     fprintf(lp3000Log, "\n%06d PP:%02o CH:%02o f:%04o T:%-25s  >   ",
@@ -824,7 +889,7 @@ static FcStatus lp3000Func(PpWord funcCode)
     case FcPrintAutoEject:
         if ((lc->renderingMode != ModeASCII) && (lc->doAutoEject == FALSE))
             {
-            fputs("R\n", fcb);
+            lp3000Put(lc, "R\n");
             }
         lc->doAutoEject = TRUE;
 
@@ -844,7 +909,7 @@ static FcStatus lp3000Func(PpWord funcCode)
     case FcPrintRelease:
         // clear all interrupt conditions
         lc->flags &= ~(StPrintIntReady | StPrintIntEnd);
-        fflush(fcb);
+        lp3000Submit(lc);
 
         // Release is sent at end of job, so flush the print file
         if (lc->isPrinted && lc->doBurst)
@@ -864,8 +929,8 @@ static FcStatus lp3000Func(PpWord funcCode)
     case FcPrintEject:
         if ((lc->prePrintFunc != 0) && (lc->prePrintFunc != FcPrintNoSpace))
             {
-            fputs(lp3000FeForPrePrint(lc, lc->prePrintFunc), fcb);
-            fputc('\n', fcb);
+            lp3000Put(lc, lp3000FeForPrePrint(lc, lc->prePrintFunc));
+            lp3000PutChar(lc, '\n');
             }
         lc->prePrintFunc = (u8)funcCode;
 
@@ -918,7 +983,7 @@ static FcStatus lp3000Func(PpWord funcCode)
         case Fc3555Sel8Lpi:
             if ((lc->renderingMode != ModeASCII) && (lc->lpi != 8))
                 {
-                fputs("T\n", fcb);
+                lp3000Put(lc, "T\n");
                 }
             lc->lpi = 8;
 
@@ -927,7 +992,7 @@ static FcStatus lp3000Func(PpWord funcCode)
         case Fc3555Sel6Lpi:
             if ((lc->renderingMode != ModeASCII) && (lc->lpi != 6))
                 {
-                fputs("S\n", fcb);
+                lp3000Put(lc, "S\n");
                 }
             lc->lpi = 6;
 
@@ -937,7 +1002,7 @@ static FcStatus lp3000Func(PpWord funcCode)
             if ((lc->renderingMode != ModeASCII)
                 && ((lc->lpi != 6) || lc->doAutoEject))
                 {
-                fputs("Q\n", fcb);
+                lp3000Put(lc, "Q\n");
                 }
             // fall through
         case Fc3555CondClearFormat:
@@ -1081,7 +1146,7 @@ static FcStatus lp3000Func(PpWord funcCode)
         case Fc3152ClearFormat:
             if ((lc->renderingMode != ModeASCII) && lc->doAutoEject)
                 {
-                fputs("Q\n", fcb);
+                lp3000Put(lc, "Q\n");
                 }
             lc->postPrintFunc = 0;
             lc->lpi           = 6;
@@ -1262,21 +1327,7 @@ static void lp3000Activate(void)
 **------------------------------------------------------------------------*/
 static void lp3000Disconnect(void)
     {
-    FILE      *fcb = active3000Device->fcb[0];
-    LpContext *lc  = (LpContext *)active3000Device->context[0];
-
-    //
-    //  This can happen if something goes wrong in the open and the file fails
-    //  to be properly re-opened.
-    //
-    if (fcb == NULL)
-        {
-        logDtError(LogErrorLocation, "lp3000Disconnect: FCB is null on channel %o equipment %o\n",
-                   active3000Device->channel->id,
-                   active3000Device->eqNo);
-
-        return;
-        }
+    LpContext *lc = (LpContext *)active3000Device->context[0];
 
     if (active3000Device->fcode == Fc6681Output)
         {
@@ -1287,15 +1338,15 @@ static void lp3000Disconnect(void)
             {
         default:
         case ModeCDC:
-            lp3000PrintCDC(lc, fcb);
+            lp3000PrintCDC(lc);
             break;
 
         case ModeANSI:
-            lp3000PrintANSI(lc, fcb);
+            lp3000PrintANSI(lc);
             break;
 
         case ModeASCII:
-            lp3000PrintASCII(lc, fcb);
+            lp3000PrintASCII(lc);
             break;
             }
         lc->linePos             = 0;
@@ -1308,12 +1359,11 @@ static void lp3000Disconnect(void)
 **
 **  Parameters:     Name        Description.
 **                  lc          pointer to line printer context
-**                  fcb         pointer to printer file descriptor
 **
 **  Returns:        Nothing.
 **
 **------------------------------------------------------------------------*/
-static void lp3000PrintANSI(LpContext *lc, FILE *fcb)
+static void lp3000PrintANSI(LpContext *lc)
     {
     char *fe;
     u8   i;
@@ -1340,12 +1390,12 @@ static void lp3000PrintANSI(LpContext *lc, FILE *fcb)
     lc->doSuppress = FALSE;
     if ((fe == NULL) || (*fe != '+') || (lc->linePos > 0))
         {
-        fputs(fe != NULL ? fe : " ", fcb);
+        lp3000Put(lc, fe != NULL ? fe : " ");
         for (i = 0; i < lc->linePos; i++)
             {
-            fputc(lc->line[i], fcb);
+            lp3000PutChar(lc, (char)lc->line[i]);
             }
-        fputc('\n', fcb);
+        lp3000PutChar(lc, '\n');
         }
     }
 
@@ -1354,32 +1404,31 @@ static void lp3000PrintANSI(LpContext *lc, FILE *fcb)
 **
 **  Parameters:     Name        Description.
 **                  lc          pointer to line printer context
-**                  fcb         pointer to printer file descriptor
 **
 **  Returns:        Nothing.
 **
 **------------------------------------------------------------------------*/
-static void lp3000PrintASCII(LpContext *lc, FILE *fcb)
+static void lp3000PrintASCII(LpContext *lc)
     {
     int i;
 
     if (lc->prePrintFunc != 0)
         {
-        fputs(lp3000FeForPrePrint(lc, lc->prePrintFunc), fcb);
+        lp3000Put(lc, lp3000FeForPrePrint(lc, lc->prePrintFunc));
         lc->prePrintFunc = 0;
         }
     for (i = 0; i < lc->linePos; i++)
         {
-        fputc(lc->line[i], fcb);
+        lp3000PutChar(lc, (char)lc->line[i]);
         }
     if (lc->doSuppress)
         {
-        fputc('\r', fcb);
+        lp3000PutChar(lc, '\r');
         lc->doSuppress = FALSE;
         }
     else
         {
-        fputc('\n', fcb);
+        lp3000PutChar(lc, '\n');
         }
     }
 
@@ -1388,12 +1437,11 @@ static void lp3000PrintASCII(LpContext *lc, FILE *fcb)
 **
 **  Parameters:     Name        Description.
 **                  lc          pointer to line printer context
-**                  fcb         pointer to printer file descriptor
 **
 **  Returns:        Nothing.
 **
 **------------------------------------------------------------------------*/
-static void lp3000PrintCDC(LpContext *lc, FILE *fcb)
+static void lp3000PrintCDC(LpContext *lc)
     {
     u8   i;
     char *postFE;
@@ -1424,19 +1472,19 @@ static void lp3000PrintCDC(LpContext *lc, FILE *fcb)
             {
             return;
             }
-        fputs(preFE, fcb);
+        lp3000Put(lc, preFE);
         if (postFE != NULL)
             {
-            fputc('\n', fcb);
+            lp3000PutChar(lc, '\n');
             }
         }
     if (postFE != NULL)
         {
-        fputs(postFE, fcb);
+        lp3000Put(lc, postFE);
         }
     if ((preFE == NULL) && (postFE == NULL))
         {
-        fputc(' ', fcb);
+        lp3000PutChar(lc, ' ');
         if (lc->doSuppress)
             {
             lc->prePrintFunc = FcPrintNoSpace;
@@ -1444,9 +1492,403 @@ static void lp3000PrintCDC(LpContext *lc, FILE *fcb)
         }
     for (i = 0; i < lc->linePos; i++)
         {
-        fputc(lc->line[i], fcb);
+        lp3000PutChar(lc, (char)lc->line[i]);
+        }
+    lp3000PutChar(lc, '\n');
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append a string to the printer's output buffer.
+**
+**  Parameters:     Name        Description.
+**                  lc          pointer to line printer context
+**                  str         string to append
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000Put(LpContext *lc, char *str)
+    {
+    while (*str != '\0')
+        {
+        lp3000PutChar(lc, *str++);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append a character to the printer's output buffer and
+**                  hand the buffer to the writer when it is full.
+**
+**  Parameters:     Name        Description.
+**                  lc          pointer to line printer context
+**                  c           character to append
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000PutChar(LpContext *lc, char c)
+    {
+    lc->outBuf->data[lc->outBuf->len++] = c;
+    lc->bytesPrinted += 1;
+    if (lc->outBuf->len >= LpBufSize)
+        {
+        lp3000Submit(lc);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Hand the printer's output buffer (if not empty) to the
+**                  writer and start a new one.
+**
+**  Parameters:     Name        Description.
+**                  lc          pointer to line printer context
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000Submit(LpContext *lc)
+    {
+    if ((lc->outBuf == NULL) || (lc->outBuf->len == 0))
+        {
+        return;
+        }
+    lp3000Enqueue(lc->outBuf);
+    lc->outBuf = lp3000AllocRequest(lc, LpReqWrite);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Allocate a print file writer request.
+**
+**  Parameters:     Name        Description.
+**                  lc          pointer to line printer context
+**                  type        request type
+**
+**  Returns:        Pointer to request.
+**
+**------------------------------------------------------------------------*/
+static LpRequest *lp3000AllocRequest(LpContext *lc, u8 type)
+    {
+    LpRequest *rp;
+
+    rp = (LpRequest *)calloc(1, sizeof(LpRequest));
+    if ((rp != NULL) && (type == LpReqWrite))
+        {
+        rp->data = (char *)malloc(LpBufSize);
+        }
+    if ((rp == NULL) || ((type == LpReqWrite) && (rp->data == NULL)))
+        {
+        logDtError(LogErrorLocation, "Failed to allocate printer output buffer\n");
+        exit(1);
+        }
+    rp->lc   = lc;
+    rp->type = type;
+
+    return rp;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Queue a request to the print file writer.
+**
+**  Parameters:     Name        Description.
+**                  rp          pointer to request
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000Enqueue(LpRequest *rp)
+    {
+#if defined(_WIN32)
+    WaitForSingleObject(writerMutex, INFINITE);
+#else
+    pthread_mutex_lock(&writerMutex);
+#endif
+    if (lastRequest == NULL)
+        {
+        firstRequest = rp;
+        }
+    else
+        {
+        lastRequest->next = rp;
+        }
+    lastRequest  = rp;
+    queuedBytes += rp->len;
+#if defined(_WIN32)
+    ReleaseMutex(writerMutex);
+    SetEvent(writerEvent);
+#else
+    pthread_cond_signal(&writerCond);
+    pthread_mutex_unlock(&writerMutex);
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Create the print file writer thread.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000StartWriter(void)
+    {
+#if defined(_WIN32)
+    DWORD  dwThreadId;
+    HANDLE hThread;
+
+    writerMutex = CreateMutex(NULL, FALSE, NULL);
+    writerEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    hThread     = CreateThread(
+        NULL,                                       // no security attribute
+        0,                                          // default stack size
+        (LPTHREAD_START_ROUTINE)lp3000WriterThread,
+        (LPVOID)NULL,                               // thread parameter
+        0,                                          // not suspended
+        &dwThreadId);                               // returns thread ID
+
+    if (hThread == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to create print file writer thread\n");
+        exit(1);
+        }
+#else
+    int            rc;
+    pthread_t      thread;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&thread, &attr, lp3000WriterThread, NULL);
+    if (rc != 0)
+        {
+        logDtError(LogErrorLocation, "Failed to create print file writer thread\n");
+        exit(1);
+        }
+#endif
+    writerStarted = TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Print file writer thread.  Writes buffered output to the
+**                  print files and performs paper removal, so that the
+**                  emulation thread never waits for file I/O.
+**
+**  Parameters:     Name        Description.
+**                  param       Thread parameter (unused)
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+#if defined(_WIN32)
+static void lp3000WriterThread(void *param)
+#else
+static void *lp3000WriterThread(void *param)
+#endif
+    {
+    LpContext *lc;
+    LpRequest *rp;
+
+    for (;;)
+        {
+#if defined(_WIN32)
+        WaitForSingleObject(writerMutex, INFINITE);
+        while (firstRequest == NULL)
+            {
+            writerBusy = FALSE;
+            ReleaseMutex(writerMutex);
+            WaitForSingleObject(writerEvent, INFINITE);
+            WaitForSingleObject(writerMutex, INFINITE);
+            }
+#else
+        pthread_mutex_lock(&writerMutex);
+        while (firstRequest == NULL)
+            {
+            writerBusy = FALSE;
+            pthread_cond_wait(&writerCond, &writerMutex);
+            }
+#endif
+        rp           = firstRequest;
+        firstRequest = rp->next;
+        if (firstRequest == NULL)
+            {
+            lastRequest = NULL;
+            }
+        queuedBytes -= rp->len;
+        writerBusy   = TRUE;
+#if defined(_WIN32)
+        ReleaseMutex(writerMutex);
+#else
+        pthread_mutex_unlock(&writerMutex);
+#endif
+
+        lc = rp->lc;
+        switch (rp->type)
+            {
+        case LpReqWrite:
+            if ((lc->fcb != NULL) && (fwrite(rp->data, 1, rp->len, lc->fcb) != (size_t)rp->len))
+                {
+                logDtError(LogErrorLocation, "Failed to write %s - (%s)\n", lc->curFileName, strerror(errno));
+                }
+            break;
+
+        case LpReqRemovePaper:
+            lp3000WriterRemovePaper(rp);
+            break;
+
+        case LpReqClose:
+            if (lc->fcb != NULL)
+                {
+                fclose(lc->fcb);
+                lc->fcb = NULL;
+                }
+            break;
+            }
+
+        /*
+        **  Keep the print files current whenever there is nothing more to do.
+        */
+        if ((firstRequest == NULL) && (lc->fcb != NULL))
+            {
+            fflush(lc->fcb);
+            }
+
+        if (rp->data != NULL)
+            {
+            free(rp->data);
+            }
+        free(rp);
+        }
+
+#if !defined(_WIN32)
+    return (NULL);
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Remove the paper on behalf of the writer thread: close
+**                  the print file, rename it, re-open it, and convert the
+**                  completed file if a converter is configured.
+**
+**  Parameters:     Name        Description.
+**                  rp          pointer to paper removal request
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void lp3000WriterRemovePaper(LpRequest *rp)
+    {
+    char      command[2 * MaxFSPath + 256];
+    time_t    currentTime;
+    char      *fNameNew;
+    int       iSuffix;
+    LpContext *lc;
+    int       rc;
+    bool      renameOK;
+    struct tm t;
+
+    lc       = rp->lc;
+    fNameNew = rp->newName;
+    renameOK = FALSE;
+
+    //
+    //  This can happen if something goes wrong in the open and the file fails
+    //  to be properly re-opened.
+    //
+    if (lc->fcb == NULL)
+        {
+        logDtError(LogErrorLocation, "lp3000RemovePaper: FCB is null on channel %o equipment %o\n",
+                   lc->channelNo,
+                   lc->eqNo);
+        //  proceed to attempt to open a new FCB
+        }
+    else
+        {
+        /*
+        **  Close the old device file.
+        */
+        fclose(lc->fcb);
+        lc->fcb = NULL;
+
+        if (*fNameNew != '\0')
+            {
+            if (rename(lc->curFileName, fNameNew) == 0)
+                {
+                renameOK = TRUE;
+                }
+            else
+                {
+                opDisplay("(lp3000 ) Rename Failure '%s' to '%s' - (%s).\n", lc->curFileName, fNameNew, strerror(errno));
+                }
+            }
+        else
+            {
+            /*
+            **  Rename the device file to the format "LP5xx_yyyymmdd_hhmmss_nn.txt".
+            */
+            for (iSuffix = 0; iSuffix < 100; iSuffix++)
+                {
+                time(&currentTime);
+                t = *localtime(&currentTime);
+                sprintf(fNameNew, "%sLP5xx_%04d%02d%02d_%02d%02d%02d_%02d.txt",
+                        lc->path,
+                        t.tm_year + 1900,
+                        t.tm_mon + 1,
+                        t.tm_mday,
+                        t.tm_hour,
+                        t.tm_min,
+                        t.tm_sec,
+                        iSuffix);
+
+                if (rename(lc->curFileName, fNameNew) == 0)
+                    {
+                    renameOK = TRUE;
+                    break;
+                    }
+                logDtError(LogErrorLocation, "Rename Failure '%s' to '%s' - (%s). Retrying (%d)...\n",
+                           lc->curFileName,
+                           fNameNew,
+                           strerror(errno),
+                           iSuffix);
+                }
+            }
+        }
+
+    /*
+    **  Open the device file.
+    */
+
+    //  Just append to the old file if the rename didn't happen correctly
+    lc->fcb = fopen(lc->curFileName, renameOK ? "w" : "a");
+
+    /*
+    **  Check if the open succeeded.
+    */
+    if (lc->fcb == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to open %s\n", lc->curFileName);
+
+        return;
+        }
+    setvbuf(lc->fcb, NULL, _IOFBF, LpBufSize);
+
+    if (!renameOK)
+        {
+        return;
+        }
+
+    opDisplay("(lp3000 ) Paper removed from 5xx printer and available on '%s'\n", fNameNew);
+
+    /*
+    **  Apply the optional conversion to the completed print file.
+    */
+    if (lc->converter != NULL)
+        {
+        sprintf(command, "%s \"%s\"", lc->converter, fNameNew);
+        rc = system(command);
+        if (rc != 0)
+            {
+            logDtError(LogErrorLocation, "Print file conversion '%s' failed, rc = %d\n", command, rc);
+            }
         }
-    fputc('\n', fcb);
     }
 
 /*--------------------------------------------------------------------------
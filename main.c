@@ -42,6 +42,7 @@
 #include "const.h"
 #include "types.h"
 #include "proto.h"
+#include "npu.h"
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -50,6 +51,8 @@
 #else
 #include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/select.h>
 #endif
 
 #if defined(_WIN32)
@@ -86,6 +89,8 @@ extern int _isatty(int fd);
 **  ---------------------------
 */
 static void emulate(void);
+static u64 idleDeadline(void);
+static void idleWait(u64 usec);
 static void INThandler(int);
 static void waitTerminationMessage(void);
 
@@ -100,6 +105,7 @@ static void opExit(void);
 */
 char ppKeyIn         = 0;
 bool emulationActive = TRUE;
+bool benchmarkMode   = FALSE;
 u32  cycles;
 u32  readerScanSecs = 3;
 
@@ -122,7 +128,15 @@ double cycleTime;
 **  Private Variables
 **  -----------------
 */
-
+#if defined(_WIN32)
+static HANDLE        idleWakeEvent = NULL;
+#else
+static int           idleWakePipe[2] = { -1, -1 };
+#endif
+static volatile bool idleWakePending = FALSE;
+static volatile u64  idleWakeTime    = 0;
+static u64           idleStartTime   = 0;
+static char          *benchmarkReport = NULL;
 
 
 /*
@@ -192,9 +206,34 @@ int main(int argc, char **argv)
 
     atexit(waitTerminationMessage);
 
+    /*
+    **  Setup the wait primitive used by the idle throttle before any
+    **  thread which may wake it is started.
+    */
+    idleInit();
+
     //  Don't let the user press Ctrl-C by accident.
     signal(SIGINT, INThandler);
 
+    /*
+    **  Allow optional benchmark mode, which runs without windows, takes
+    **  operator input only from the operator script and writes a report
+    **  when the script completes.
+    */
+    if ((argc > 2) && (strcmp(argv[1], "-b") == 0))
+        {
+        benchmarkMode   = TRUE;
+        benchmarkReport = argv[2];
+        argv[2]         = argv[0];
+        argv           += 2;
+        argc           -= 2;
+        if (!metricsOpenReport(benchmarkReport))
+            {
+            logDtError(LogErrorLocation, "Failed to open benchmark report %s\n", benchmarkReport);
+            exit(1);
+            }
+        }
+
     /*
     **  Allow optional command line parameter to specify section to run in "cyber.ini".
     */
@@ -211,8 +250,10 @@ int main(int argc, char **argv)
             printf("    <parameters> can be either:\n");
             printf("        ( /? | -? ) displays command format\n");
             printf("      or:\n");
-            printf("        ( <section> ( <filename> ) )\n\n");
+            printf("        ( -b <report> ) ( <section> ( <filename> ) )\n\n");
             printf("    where:\n");
+            printf("      <report>   benchmark report file, '-' for standard output (other output\n");
+            printf("                 then goes to standard error)\n");
             printf("      <section>  identifier of section within configuration file [default 'cyber']\n");
             printf("      <filename> file name of configuration file                 [default 'cyber.ini']\n");
             printf("\n      > Values for <section> and <filename> must not contain spaces.");
@@ -253,8 +294,17 @@ int main(int argc, char **argv)
     /*
     **  Emulation loop.
     */
+    if (benchmarkMode)
+        {
+        metricsStartReport();
+        }
     emulate();
 
+    if (benchmarkMode && !metricsWriteReport())
+        {
+        logDtError(LogErrorLocation, "Failed to write benchmark report %s\n", benchmarkReport);
+        }
+
 #if CcDebug == 1
     /*
     **  Post-mortem dumps.
@@ -287,6 +337,70 @@ int main(int argc, char **argv)
     exit(0);
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Create the primitive on which the idle throttle waits.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void idleInit(void)
+    {
+#if defined(_WIN32)
+    idleWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (idleWakeEvent == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to create idle wake event\n");
+        exit(1);
+        }
+#else
+    if (pipe(idleWakePipe) != 0)
+        {
+        logDtError(LogErrorLocation, "Failed to create idle wake pipe\n");
+        exit(1);
+        }
+    fcntl(idleWakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(idleWakePipe[1], F_SETFL, O_NONBLOCK);
+#endif
+    idleStartTime = getMicroseconds();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Display idle throttle statistics (operator interface).
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void idleShowStatus(void)
+    {
+    u64 elapsed;
+    int i;
+    int parked;
+
+    elapsed = getMicroseconds() - idleStartTime;
+    opDisplay("    > %llu idle waits, host CPU given up %.1f%% of elapsed time\n",
+              (unsigned long long)metrics.idleSleeps,
+              elapsed > 0 ? (double)metrics.idleSleepUsec * 100.0 / (double)elapsed : 0.0);
+    opDisplay("    > %llu waits ended early by events, average wake latency %llu usec\n",
+              (unsigned long long)metrics.idleWakeups,
+              metrics.idleWakeups > 0 ? (unsigned long long)(metrics.idleWakeLatencyUsec / metrics.idleWakeups) : 0ULL);
+    if (ppIdleDetector != NULL)
+        {
+        parked = 0;
+        for (i = 0; i < ppuCount; i++)
+            {
+            if (ppu[i].isParked)
+                {
+                parked += 1;
+                }
+            }
+        opDisplay("    > %d PPs parked in their idle loops, %llu parks so far\n", parked, (unsigned long long)metrics.ppIdleParks);
+        }
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Return CPU cycles to host if idle package is seen
 **                  and the trigger conditions are met.
@@ -314,12 +428,48 @@ void idleThrottle(Cpu170Context *ctx)
                         return;
                         }
                     }
-                sleepUsec(idleTime);
+                if (ctx->id == 0)
+                    {
+                    idleWait(idleDeadline());
+                    }
+                else
+                    {
+                    sleepUsec(idleDeadline());
+                    }
                 }
             }
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Wake the emulation thread if it is waiting in the idle
+**                  throttle. Called by threads which hand work to the
+**                  emulation, e.g. operator commands and card reader
+**                  hot folders.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void idleWake(void)
+    {
+    if (idleWakePending)
+        {
+        return;
+        }
+    idleWakeTime    = getMicroseconds();
+    idleWakePending = TRUE;
+#if defined(_WIN32)
+    SetEvent(idleWakeEvent);
+#else
+    if (write(idleWakePipe[1], "", 1) < 0)
+        {
+        // pipe is full, so a wake up is pending anyway
+        }
+#endif
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Check for busy PPs for idle throttle.
 **
@@ -635,11 +785,12 @@ static void emulate(void)
         **  Count major cycles.
         */
         cycles++;
+        metrics.majorCycles += 1;
 
         /*
         **  Deal with operator interface requests.
         */
-        if (opActive)
+        if (opActive || opHandoffActive)
             {
             opRequest();
             }
@@ -683,7 +834,7 @@ static void emulate(void)
         cpuStep(cpus170);
         cpuStep(cpus170);
 
-        channelStep();
+        schedRun();
 
         idleThrottle(cpus170);
 
@@ -693,6 +844,112 @@ static void emulate(void)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Compute how long the idle throttle may wait. This is
+**                  the configured idle time, shortened so that a CYBER 180
+**                  system or process interval timer expiring in the
+**                  meantime is not delayed.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Number of microseconds to wait.
+**
+**------------------------------------------------------------------------*/
+static u64 idleDeadline(void)
+    {
+    Cpu180Context *ctx;
+    int           i;
+    u64           usec;
+
+    usec = idleTime;
+    if (isCyber180)
+        {
+        for (i = 0; i < cpuCount; i++)
+            {
+            ctx = cpus180 + i;
+            if (ctx->isStopped)
+                {
+                continue;
+                }
+            if ((ctx->regSit > 0) && (ctx->regSit < usec))
+                {
+                usec = ctx->regSit;
+                }
+            if ((ctx->regPit > 0) && (ctx->regPit < usec))
+                {
+                usec = ctx->regPit;
+                }
+            }
+        }
+
+    return usec;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Give up the host CPU until the deadline passes or an
+**                  event which needs the emulation arrives: an operator
+**                  command, a card deck, a new network connection or
+**                  input on a connected NPU/MDI terminal.
+**
+**  Parameters:     Name        Description.
+**                  usec        maximum number of microseconds to wait
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void idleWait(u64 usec)
+    {
+    u64            end;
+    u64            start;
+#if defined(_WIN32)
+    DWORD          msec;
+#else
+    u8             buf[16];
+    int            maxFd;
+    fd_set         readFds;
+    struct timeval timeout;
+#endif
+
+    start = getMicroseconds();
+    if (idleWakePending == FALSE)
+        {
+#if defined(_WIN32)
+        msec = (DWORD)(usec / 1000);
+        if (msec < 1)
+            {
+            msec = 1;
+            }
+        WaitForSingleObject(idleWakeEvent, msec);
+#else
+        FD_ZERO(&readFds);
+        FD_SET(idleWakePipe[0], &readFds);
+        maxFd           = netPollAddIdleFds(&readFds, npuNetAddIdleFds(&readFds, idleWakePipe[0]));
+        timeout.tv_sec  = (long)(usec / 1000000);
+        timeout.tv_usec = (long)(usec % 1000000);
+        select(maxFd + 1, &readFds, NULL, NULL, &timeout);
+#endif
+        }
+    end = getMicroseconds();
+
+    /*
+    **  Consume the wake up, if any. The flag is cleared first so that a
+    **  wake up racing with this leaves its token for the next wait.
+    */
+    if (idleWakePending)
+        {
+        idleWakePending              = FALSE;
+        metrics.idleWakeups         += 1;
+        metrics.idleWakeLatencyUsec += end > idleWakeTime ? end - idleWakeTime : 0;
+#if !defined(_WIN32)
+        while (read(idleWakePipe[0], buf, sizeof(buf)) > 0)
+            {
+            }
+#endif
+        }
+    metrics.idleSleeps    += 1;
+    metrics.idleSleepUsec += end - start;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Wait to display shutdown message.
 **
@@ -0,0 +1,1099 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: metrics.c
+**
+**  Description:
+**      Collect emulator performance counters and serve them in the
+**      Prometheus text exposition format on an optional TCP port.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <winsock.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+#define MetricsBufSize        524288
+#define MetricsPollMsec       250
+#define MetricsRequestMsec    2000
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+typedef struct metricsDevName
+    {
+    u8   devType;
+    char *name;
+    } MetricsDevName;
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void metricsAppend(char *fmt, ...);
+static void metricsCreateThread(void);
+static char *metricsDevName(u8 devType);
+static void metricsFormat(void);
+static void metricsHeader(char *name, char *type, char *help);
+static void metricsHostCpuTime(double *user, double *system);
+static void metricsReportTotals(u64 *cpuInstr, u64 *ppInstr, u64 *chWords);
+static void metricsShowLatency(u64 *histogram);
+#if defined(_WIN32)
+static void metricsServe(SOCKET fd);
+static void metricsThread(void *param);
+#else
+static void metricsServe(int fd);
+static void *metricsThread(void *param);
+#endif
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+Metrics metrics;
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static MetricsDevName metricsDevNames[] =
+    {
+    { DtDd6603,   "dd6603"   },
+    { DtDd8xx,    "dd8xx"    },
+    { DtDd885_42, "dd885_42" },
+    { DtMt607,    "mt607"    },
+    { DtMt669,    "mt669"    },
+    { DtMt679,    "mt679"    },
+    { DtMt362x,   "mt362x"   },
+    { DtMt5744,   "mt5744"   },
+    };
+
+#if defined(_WIN32)
+static volatile SOCKET metricsListenHandle = 0;
+#else
+static volatile int metricsListenHandle = 0;
+#endif
+static bool   metricsThreadActive = FALSE;
+static MetricsUnit *metricsFirstUnit = NULL;
+static MetricsUnit *metricsLastUnit  = NULL;
+static char   *metricsIoKindNames[MetricsIoKinds] = { "read", "write", "position" };
+static char   metricsBuf[MetricsBufSize];
+static int    metricsBufLen;
+static time_t metricsStartTime;
+
+/*
+**  Counters at the start of a benchmark run. PP and CPU contexts may be
+**  restored from persistent storage, so their counts do not start at 0,
+**  and the emulator's own counters include the warm-up before the run.
+*/
+static FILE    *reportFcb = NULL;
+static Metrics reportStart;
+static u64    reportStartTime;
+static u64    reportStartCpuInstr;
+static u64    reportStartPpInstr;
+static u64    reportStartChWords;
+static double reportStartUserSecs;
+static double reportStartSysSecs;
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Count a disk or tape I/O operation.
+**
+**  Parameters:     Name        Description.
+**                  devType     device type performing the operation
+**                  isWrite     TRUE if data was written to host storage
+**                  bytes       number of bytes transferred
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsCountIo(u8 devType, bool isWrite, u32 bytes)
+    {
+    MetricsIo *mp;
+
+    if (devType >= MaxDevTypes)
+        {
+        return;
+        }
+
+    mp = &metrics.io[devType];
+    if (isWrite)
+        {
+        mp->writeOps     += 1;
+        mp->bytesWritten += bytes;
+        }
+    else
+        {
+        mp->readOps   += 1;
+        mp->bytesRead += bytes;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Count a disk or tape operation on a unit and the host
+**                  time it took.
+**
+**  Parameters:     Name        Description.
+**                  up          unit statistics
+**                  kind        MetricsIoRead, MetricsIoWrite or
+**                              MetricsIoPosition
+**                  bytes       number of bytes transferred
+**                  startUsec   host time at which the operation started
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsCountUnitIo(MetricsUnit *up, int kind, u32 bytes, u64 startUsec)
+    {
+    int bucket;
+    u64 usec;
+
+    usec = getMicroseconds() - startUsec;
+    if (kind != MetricsIoPosition)
+        {
+        metricsCountIo(up->devType, kind == MetricsIoWrite, bytes);
+        }
+
+    for (bucket = 0; bucket < MetricsLatencyBuckets - 1 && usec > ((u64)1 << bucket); bucket++)
+        {
+        }
+
+    up->ops[kind]             += 1;
+    up->bytes[kind]           += bytes;
+    up->usec[kind]            += usec;
+    up->latency[kind][bucket] += 1;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Count a disk or tape operation on a unit whose host
+**                  time is not known, e.g. one carried out by a remote
+**                  tape server. The latency histogram is left alone.
+**
+**  Parameters:     Name        Description.
+**                  up          unit statistics
+**                  kind        MetricsIoRead, MetricsIoWrite or
+**                              MetricsIoPosition
+**                  bytes       number of bytes transferred
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsCountUnitOps(MetricsUnit *up, int kind, u32 bytes)
+    {
+    if (kind != MetricsIoPosition)
+        {
+        metricsCountIo(up->devType, kind == MetricsIoWrite, bytes);
+        }
+
+    up->ops[kind]   += 1;
+    up->bytes[kind] += bytes;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Allocate the statistics of a disk or tape unit.
+**
+**  Parameters:     Name        Description.
+**                  devType     device type
+**                  channelNo   channel number
+**                  eqNo        equipment number
+**                  unitNo      unit number
+**
+**  Returns:        Pointer to unit statistics.
+**
+**------------------------------------------------------------------------*/
+MetricsUnit *metricsRegisterUnit(u8 devType, u8 channelNo, u8 eqNo, u8 unitNo)
+    {
+    MetricsUnit *up;
+
+    up = (MetricsUnit *)calloc(1, sizeof(MetricsUnit));
+    if (up == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to allocate unit statistics\n");
+        exit(1);
+        }
+    up->devType   = devType;
+    up->channelNo = channelNo;
+    up->eqNo      = eqNo;
+    up->unitNo    = unitNo;
+
+    if (metricsLastUnit == NULL)
+        {
+        metricsFirstUnit = up;
+        }
+    else
+        {
+        metricsLastUnit->next = up;
+        }
+    metricsLastUnit = up;
+
+    return up;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Display disk and tape statistics (operator interface).
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsShowIoStatus(void)
+    {
+    u64         histogram[MetricsLatencyBuckets];
+    int         i;
+    char        unit[16];
+    MetricsUnit *up;
+
+    if (metricsFirstUnit == NULL)
+        {
+        opDisplay("    > No disk or tape units configured\n");
+
+        return;
+        }
+
+    opDisplay("    > %-8s %-11s %9s %9s %9s %9s %9s %9s %8s %7s %7s\n",
+              "Device", "Unit", "Reads", "Writes", "Positions", "MB read", "MB write", "Xfer sec", "Pos sec", "p50 us", "p99 us");
+    for (up = metricsFirstUnit; up != NULL; up = up->next)
+        {
+        sprintf(unit, "C%02o E%02o U%o", up->channelNo, up->eqNo, up->unitNo);
+        opDisplay("    > %-8s %-11s %9llu %9llu %9llu %9.1f %9.1f %9.3f %8.3f",
+                  metricsDevName(up->devType), unit,
+                  (unsigned long long)up->ops[MetricsIoRead],
+                  (unsigned long long)up->ops[MetricsIoWrite],
+                  (unsigned long long)up->ops[MetricsIoPosition],
+                  (double)up->bytes[MetricsIoRead] / 1048576.0,
+                  (double)up->bytes[MetricsIoWrite] / 1048576.0,
+                  (double)(up->usec[MetricsIoRead] + up->usec[MetricsIoWrite]) / 1000000.0,
+                  (double)up->usec[MetricsIoPosition] / 1000000.0);
+        for (i = 0; i < MetricsLatencyBuckets; i++)
+            {
+            histogram[i] = up->latency[MetricsIoRead][i] + up->latency[MetricsIoWrite][i];
+            }
+        metricsShowLatency(histogram);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Start listening for metrics scrape requests.
+**
+**  Parameters:     Name        Description.
+**                  port        TCP port number on which to listen
+**
+**  Returns:        TRUE  if success
+**                  FALSE if failure
+**
+**------------------------------------------------------------------------*/
+bool metricsStartListening(int port)
+    {
+#if defined(_WIN32)
+    SOCKET sd;
+#else
+    int sd;
+#endif
+
+    if (port <= 0)
+        {
+        return FALSE;
+        }
+
+    metricsStopListening();
+
+    sd = netCreateListener(port);
+#if defined(_WIN32)
+    if (sd == INVALID_SOCKET)
+#else
+    if (sd == -1)
+#endif
+        {
+        return FALSE;
+        }
+
+    metricsListenHandle = sd;
+    if (!metricsThreadActive)
+        {
+        metricsStartTime    = time(NULL);
+        metricsThreadActive = TRUE;
+        metricsCreateThread();
+        }
+
+    return TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stop listening for metrics scrape requests.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsStopListening(void)
+    {
+    if (metricsListenHandle != 0)
+        {
+        netCloseConnection(metricsListenHandle);
+        metricsListenHandle = 0;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Open the benchmark report before initialisation, so
+**                  that a bad path is reported at once.  When the report
+**                  goes to standard output, all other output of the run
+**                  is sent to standard error instead, so that the report
+**                  can be parsed.
+**
+**  Parameters:     Name        Description.
+**                  path        report file path, "-" for standard output
+**
+**  Returns:        TRUE if the report was opened.
+**
+**------------------------------------------------------------------------*/
+bool metricsOpenReport(char *path)
+    {
+    int fd;
+
+    if (strcmp(path, "-") != 0)
+        {
+        reportFcb = fopen(path, "w");
+
+        return reportFcb != NULL;
+        }
+
+    fflush(stdout);
+#if defined(_WIN32)
+    fd = _dup(_fileno(stdout));
+    if ((fd < 0) || (_dup2(_fileno(stderr), _fileno(stdout)) != 0))
+        {
+        return FALSE;
+        }
+    reportFcb = _fdopen(fd, "w");
+#else
+    fd = dup(STDOUT_FILENO);
+    if ((fd < 0) || (dup2(STDERR_FILENO, STDOUT_FILENO) < 0))
+        {
+        return FALSE;
+        }
+    reportFcb = fdopen(fd, "w");
+#endif
+
+    return reportFcb != NULL;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Mark the start of a benchmark run.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void metricsStartReport(void)
+    {
+    reportStart = metrics;
+    metricsReportTotals(&reportStartCpuInstr, &reportStartPpInstr, &reportStartChWords);
+    metricsHostCpuTime(&reportStartUserSecs, &reportStartSysSecs);
+    reportStartTime = getMicroseconds();
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Write a benchmark report in JSON covering the run
+**                  since metricsStartReport was called, and close it.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        TRUE if the report was written.
+**
+**------------------------------------------------------------------------*/
+bool metricsWriteReport(void)
+    {
+    u64       chWords;
+    u64       cpuInstr;
+    FILE      *fcb;
+    int       i;
+    MetricsIo *mp;
+    u64       ppInstr;
+    MetricsIo *sp;
+    double    sysSecs;
+    double    userSecs;
+    int       versionLen;
+    double    wallSecs;
+    u64       wallUsec;
+
+    fcb = reportFcb;
+    if (fcb == NULL)
+        {
+        return FALSE;
+        }
+    reportFcb = NULL;
+
+    wallUsec = getMicroseconds() - reportStartTime;
+    wallSecs = wallUsec > 0 ? (double)wallUsec / 1000000.0 : 1e-6;
+    metricsHostCpuTime(&userSecs, &sysSecs);
+    userSecs -= reportStartUserSecs;
+    sysSecs  -= reportStartSysSecs;
+
+    metricsReportTotals(&cpuInstr, &ppInstr, &chWords);
+    cpuInstr -= reportStartCpuInstr;
+    ppInstr  -= reportStartPpInstr;
+    chWords  -= reportStartChWords;
+
+    fprintf(fcb, "{\n");
+    versionLen = (int)strcspn(DtCyberVersion, "(");
+    while ((versionLen > 0) && (DtCyberVersion[versionLen - 1] == ' '))
+        {
+        versionLen -= 1;
+        }
+    fprintf(fcb, "  \"version\": \"%.*s\",\n", versionLen, DtCyberVersion);
+    fprintf(fcb, "  \"os_type\": \"%s\",\n", osType);
+    fprintf(fcb, "  \"wall_seconds\": %.6f,\n", wallSecs);
+    fprintf(fcb, "  \"host_cpu_user_seconds\": %.6f,\n", userSecs);
+    fprintf(fcb, "  \"host_cpu_system_seconds\": %.6f,\n", sysSecs);
+    fprintf(fcb, "  \"host_cpu_utilisation\": %.4f,\n", (userSecs + sysSecs) / wallSecs);
+    fprintf(fcb, "  \"idle_seconds\": %.6f,\n", (double)(metrics.idleSleepUsec - reportStart.idleSleepUsec) / 1000000.0);
+    fprintf(fcb, "  \"major_cycles\": %llu,\n", (unsigned long long)(metrics.majorCycles - reportStart.majorCycles));
+    fprintf(fcb, "  \"cpu_instructions\": %llu,\n", (unsigned long long)cpuInstr);
+    fprintf(fcb, "  \"cpu_mips\": %.3f,\n", (double)cpuInstr / wallSecs / 1000000.0);
+    fprintf(fcb, "  \"pp_instructions\": %llu,\n", (unsigned long long)ppInstr);
+    fprintf(fcb, "  \"pp_mips\": %.3f,\n", (double)ppInstr / wallSecs / 1000000.0);
+    fprintf(fcb, "  \"channel_words\": %llu,\n", (unsigned long long)chWords);
+    fprintf(fcb, "  \"npu_upline_bytes\": %llu,\n", (unsigned long long)(metrics.npuUplineBytes - reportStart.npuUplineBytes));
+    fprintf(fcb, "  \"npu_downline_bytes\": %llu,\n", (unsigned long long)(metrics.npuDownlineBytes - reportStart.npuDownlineBytes));
+    fprintf(fcb, "  \"device_io\": {");
+    for (i = 0; i < (int)(sizeof(metricsDevNames) / sizeof(metricsDevNames[0])); i++)
+        {
+        mp = &metrics.io[metricsDevNames[i].devType];
+        sp = &reportStart.io[metricsDevNames[i].devType];
+        fprintf(fcb, "%s\n    \"%s\": { \"read_ops\": %llu, \"write_ops\": %llu, \"bytes_read\": %llu, \"bytes_written\": %llu }",
+                i > 0 ? "," : "", metricsDevNames[i].name,
+                (unsigned long long)(mp->readOps - sp->readOps), (unsigned long long)(mp->writeOps - sp->writeOps),
+                (unsigned long long)(mp->bytesRead - sp->bytesRead), (unsigned long long)(mp->bytesWritten - sp->bytesWritten));
+        }
+    fprintf(fcb, "\n  }\n");
+    fprintf(fcb, "}\n");
+
+    return fclose(fcb) == 0;
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append formatted text to the response buffer.
+**
+**  Parameters:     Name        Description.
+**                  fmt         format string
+**                  ...         variable arguments
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsAppend(char *fmt, ...)
+    {
+    va_list ap;
+    int     n;
+
+    if (metricsBufLen >= MetricsBufSize - 1)
+        {
+        return;
+        }
+
+    va_start(ap, fmt);
+    n = vsnprintf(metricsBuf + metricsBufLen, MetricsBufSize - metricsBufLen, fmt, ap);
+    va_end(ap);
+
+    if (n > 0)
+        {
+        metricsBufLen += n;
+        if (metricsBufLen >= MetricsBufSize)
+            {
+            metricsBufLen = MetricsBufSize - 1;
+            }
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Create the metrics listener thread.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsCreateThread(void)
+    {
+#if defined(_WIN32)
+    DWORD  dwThreadId;
+    HANDLE hThread;
+
+    hThread = CreateThread(
+        NULL,                                       // no security attribute
+        0,                                          // default stack size
+        (LPTHREAD_START_ROUTINE)metricsThread,
+        (LPVOID)NULL,                               // thread parameter
+        0,                                          // not suspended
+        &dwThreadId);                               // returns thread ID
+
+    if (hThread == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to create metrics thread\n");
+        exit(1);
+        }
+#else
+    int            rc;
+    pthread_t      thread;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&thread, &attr, metricsThread, NULL);
+    if (rc < 0)
+        {
+        logDtError(LogErrorLocation, "Failed to create metrics thread\n");
+        exit(1);
+        }
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Get the metric label name of a device type.
+**
+**  Parameters:     Name        Description.
+**                  devType     device type
+**
+**  Returns:        Device name.
+**
+**------------------------------------------------------------------------*/
+static char *metricsDevName(u8 devType)
+    {
+    int i;
+
+    for (i = 0; i < (int)(sizeof(metricsDevNames) / sizeof(metricsDevNames[0])); i++)
+        {
+        if (metricsDevNames[i].devType == devType)
+            {
+            return metricsDevNames[i].name;
+            }
+        }
+
+    return "unknown";
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Format all metrics into the response buffer.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsFormat(void)
+    {
+    u64         count;
+    int         i;
+    int         kind;
+    char        labels[80];
+    MetricsIo   *mp;
+    MetricsUnit *up;
+
+    metricsBufLen = 0;
+
+    metricsHeader("dtcyber_uptime_seconds", "gauge", "Seconds since metrics collection started.");
+    metricsAppend("dtcyber_uptime_seconds %ld\n", (long)(time(NULL) - metricsStartTime));
+
+    metricsHeader("dtcyber_major_cycles_total", "counter", "Iterations of the main emulation loop.");
+    metricsAppend("dtcyber_major_cycles_total %llu\n", (unsigned long long)metrics.majorCycles);
+
+    metricsHeader("dtcyber_cpu_instructions_total", "counter", "CPU instructions executed.");
+    for (i = 0; i < cpuCount; i++)
+        {
+        metricsAppend("dtcyber_cpu_instructions_total{cpu=\"%d\",state=\"170\"} %llu\n",
+                      i, (unsigned long long)cpus170[i].instructionCount);
+        if (isCyber180)
+            {
+            metricsAppend("dtcyber_cpu_instructions_total{cpu=\"%d\",state=\"180\"} %llu\n",
+                          i, (unsigned long long)cpus180[i].instructionCount);
+            }
+        }
+
+    metricsHeader("dtcyber_pp_instructions_total", "counter", "PP instructions executed.");
+    for (i = 0; i < ppuCount; i++)
+        {
+        metricsAppend("dtcyber_pp_instructions_total{pp=\"%02o\"} %llu\n",
+                      ppu[i].id, (unsigned long long)ppu[i].instructionCount);
+        }
+
+    metricsHeader("dtcyber_channel_words_total", "counter", "PP words transferred on each channel.");
+    for (i = 0; i < channelCount; i++)
+        {
+        metricsAppend("dtcyber_channel_words_total{channel=\"%02o\"} %llu\n",
+                      channel[i].id, (unsigned long long)channel[i].wordCount);
+        }
+
+    metricsHeader("dtcyber_device_io_operations_total", "counter", "Disk and tape sector or record transfers.");
+    for (i = 0; i < (int)(sizeof(metricsDevNames) / sizeof(metricsDevNames[0])); i++)
+        {
+        mp = &metrics.io[metricsDevNames[i].devType];
+        metricsAppend("dtcyber_device_io_operations_total{device=\"%s\",direction=\"read\"} %llu\n",
+                      metricsDevNames[i].name, (unsigned long long)mp->readOps);
+        metricsAppend("dtcyber_device_io_operations_total{device=\"%s\",direction=\"write\"} %llu\n",
+                      metricsDevNames[i].name, (unsigned long long)mp->writeOps);
+        }
+
+    metricsHeader("dtcyber_device_io_bytes_total", "counter", "Disk and tape bytes transferred to or from host storage.");
+    for (i = 0; i < (int)(sizeof(metricsDevNames) / sizeof(metricsDevNames[0])); i++)
+        {
+        mp = &metrics.io[metricsDevNames[i].devType];
+        metricsAppend("dtcyber_device_io_bytes_total{device=\"%s\",direction=\"read\"} %llu\n",
+                      metricsDevNames[i].name, (unsigned long long)mp->bytesRead);
+        metricsAppend("dtcyber_device_io_bytes_total{device=\"%s\",direction=\"write\"} %llu\n",
+                      metricsDevNames[i].name, (unsigned long long)mp->bytesWritten);
+        }
+
+    metricsHeader("dtcyber_unit_io_operations_total", "counter", "Disk and tape operations by unit.");
+    for (up = metricsFirstUnit; up != NULL; up = up->next)
+        {
+        sprintf(labels, "device=\"%s\",channel=\"%02o\",equipment=\"%o\",unit=\"%o\"",
+                metricsDevName(up->devType), up->channelNo, up->eqNo, up->unitNo);
+        for (kind = 0; kind < MetricsIoKinds; kind++)
+            {
+            metricsAppend("dtcyber_unit_io_operations_total{%s,op=\"%s\"} %llu\n",
+                          labels, metricsIoKindNames[kind], (unsigned long long)up->ops[kind]);
+            }
+        }
+
+    metricsHeader("dtcyber_unit_io_bytes_total", "counter", "Disk and tape bytes transferred to or from host storage by unit.");
+    for (up = metricsFirstUnit; up != NULL; up = up->next)
+        {
+        sprintf(labels, "device=\"%s\",channel=\"%02o\",equipment=\"%o\",unit=\"%o\"",
+                metricsDevName(up->devType), up->channelNo, up->eqNo, up->unitNo);
+        metricsAppend("dtcyber_unit_io_bytes_total{%s,direction=\"read\"} %llu\n",
+                      labels, (unsigned long long)up->bytes[MetricsIoRead]);
+        metricsAppend("dtcyber_unit_io_bytes_total{%s,direction=\"write\"} %llu\n",
+                      labels, (unsigned long long)up->bytes[MetricsIoWrite]);
+        }
+
+    metricsHeader("dtcyber_unit_cache_reads_total", "counter", "Disk reads by prefetch cache result by unit.");
+    for (up = metricsFirstUnit; up != NULL; up = up->next)
+        {
+        if (up->cacheHits + up->cacheMisses == 0)
+            {
+            continue;
+            }
+        sprintf(labels, "device=\"%s\",channel=\"%02o\",equipment=\"%o\",unit=\"%o\"",
+                metricsDevName(up->devType), up->channelNo, up->eqNo, up->unitNo);
+        metricsAppend("dtcyber_unit_cache_reads_total{%s,result=\"hit\"} %llu\n",
+                      labels, (unsigned long long)up->cacheHits);
+        metricsAppend("dtcyber_unit_cache_reads_total{%s,result=\"miss\"} %llu\n",
+                      labels, (unsigned long long)up->cacheMisses);
+        }
+
+    metricsHeader("dtcyber_unit_io_latency_seconds", "histogram", "Host time taken by disk and tape operations by unit.");
+    for (up = metricsFirstUnit; up != NULL; up = up->next)
+        {
+        sprintf(labels, "device=\"%s\",channel=\"%02o\",equipment=\"%o\",unit=\"%o\"",
+                metricsDevName(up->devType), up->channelNo, up->eqNo, up->unitNo);
+        for (kind = 0; kind < MetricsIoKinds; kind++)
+            {
+            count = 0;
+            for (i = 0; i < MetricsLatencyBuckets - 1; i++)
+                {
+                count += up->latency[kind][i];
+                metricsAppend("dtcyber_unit_io_latency_seconds_bucket{%s,op=\"%s\",le=\"%g\"} %llu\n",
+                              labels, metricsIoKindNames[kind], (double)((u64)1 << i) / 1000000.0, (unsigned long long)count);
+                }
+            count += up->latency[kind][MetricsLatencyBuckets - 1];
+            metricsAppend("dtcyber_unit_io_latency_seconds_bucket{%s,op=\"%s\",le=\"+Inf\"} %llu\n",
+                          labels, metricsIoKindNames[kind], (unsigned long long)count);
+            metricsAppend("dtcyber_unit_io_latency_seconds_sum{%s,op=\"%s\"} %.6f\n",
+                          labels, metricsIoKindNames[kind], (double)up->usec[kind] / 1000000.0);
+            metricsAppend("dtcyber_unit_io_latency_seconds_count{%s,op=\"%s\"} %llu\n",
+                          labels, metricsIoKindNames[kind], (unsigned long long)count);
+            }
+        }
+
+    metricsHeader("dtcyber_npu_blocks_total", "counter", "NPU blocks exchanged with the host.");
+    metricsAppend("dtcyber_npu_blocks_total{direction=\"upline\"} %llu\n", (unsigned long long)metrics.npuUplineBlocks);
+    metricsAppend("dtcyber_npu_blocks_total{direction=\"downline\"} %llu\n", (unsigned long long)metrics.npuDownlineBlocks);
+
+    metricsHeader("dtcyber_npu_bytes_total", "counter", "NPU block bytes exchanged with the host.");
+    metricsAppend("dtcyber_npu_bytes_total{direction=\"upline\"} %llu\n", (unsigned long long)metrics.npuUplineBytes);
+    metricsAppend("dtcyber_npu_bytes_total{direction=\"downline\"} %llu\n", (unsigned long long)metrics.npuDownlineBytes);
+
+    metricsHeader("dtcyber_idle_sleeps_total", "counter", "Idle throttle sleeps.");
+    metricsAppend("dtcyber_idle_sleeps_total %llu\n", (unsigned long long)metrics.idleSleeps);
+
+    metricsHeader("dtcyber_idle_sleep_seconds_total", "counter", "Host time given up by idle waits.");
+    metricsAppend("dtcyber_idle_sleep_seconds_total %.6f\n", (double)metrics.idleSleepUsec / 1000000.0);
+
+    metricsHeader("dtcyber_idle_wakeups_total", "counter", "Idle waits ended early by network, operator or card reader events.");
+    metricsAppend("dtcyber_idle_wakeups_total %llu\n", (unsigned long long)metrics.idleWakeups);
+
+    metricsHeader("dtcyber_idle_wake_latency_seconds_total", "counter", "Time from wake events to resumption of emulation.");
+    metricsAppend("dtcyber_idle_wake_latency_seconds_total %.6f\n", (double)metrics.idleWakeLatencyUsec / 1000000.0);
+
+    metricsHeader("dtcyber_pp_idle_parks_total", "counter", "PPs parked in their idle loops until their input registers were written.");
+    metricsAppend("dtcyber_pp_idle_parks_total %llu\n", (unsigned long long)metrics.ppIdleParks);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append HELP and TYPE lines for a metric.
+**
+**  Parameters:     Name        Description.
+**                  name        metric name
+**                  type        metric type
+**                  help        metric description
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsHeader(char *name, char *type, char *help)
+    {
+    metricsAppend("# HELP %s %s\n", name, help);
+    metricsAppend("# TYPE %s %s\n", name, type);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Get the host CPU time used by this process.
+**
+**  Parameters:     Name        Description.
+**                  user        returns seconds of user mode time
+**                  system      returns seconds of kernel mode time
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsHostCpuTime(double *user, double *system)
+    {
+#if defined(_WIN32)
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+
+    *user   = 0.0;
+    *system = 0.0;
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        {
+        *user   = (double)(((u64)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime) / 10000000.0;
+        *system = (double)(((u64)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime) / 10000000.0;
+        }
+#else
+    struct rusage usage;
+
+    *user   = 0.0;
+    *system = 0.0;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+        *user   = (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1000000.0;
+        *system = (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1000000.0;
+        }
+#endif
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Sum the instruction and channel word counters.
+**
+**  Parameters:     Name        Description.
+**                  cpuInstr    returns CPU instructions executed
+**                  ppInstr     returns PP instructions executed
+**                  chWords     returns channel words transferred
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsReportTotals(u64 *cpuInstr, u64 *ppInstr, u64 *chWords)
+    {
+    int i;
+
+    *cpuInstr = 0;
+    for (i = 0; i < cpuCount; i++)
+        {
+        *cpuInstr += cpus170[i].instructionCount;
+        if (isCyber180)
+            {
+            *cpuInstr += cpus180[i].instructionCount;
+            }
+        }
+    *ppInstr = 0;
+    for (i = 0; i < ppuCount; i++)
+        {
+        *ppInstr += ppu[i].instructionCount;
+        }
+    *chWords = 0;
+    for (i = 0; i < channelCount; i++)
+        {
+        *chWords += channel[i].wordCount;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Read a scrape request and send the current metrics.
+**
+**  Parameters:     Name        Description.
+**                  fd          connected socket
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+#if defined(_WIN32)
+static void metricsServe(SOCKET fd)
+#else
+static void metricsServe(int fd)
+#endif
+    {
+    char           header[128];
+    int            headerLen;
+    char           *hp;
+    int            n;
+    char           request[1024];
+    int            requestLen;
+    fd_set         readFds;
+    struct timeval timeout;
+
+    /*
+    **  Consume the request up to the end of its header. Its content is
+    **  irrelevant because every path returns the same document.
+    */
+    requestLen = 0;
+    while (requestLen < (int)sizeof(request) - 1)
+        {
+        FD_ZERO(&readFds);
+        FD_SET(fd, &readFds);
+        timeout.tv_sec  = MetricsRequestMsec / 1000;
+        timeout.tv_usec = (MetricsRequestMsec % 1000) * 1000;
+        if (select((int)(fd + 1), &readFds, NULL, NULL, &timeout) <= 0)
+            {
+            return;
+            }
+        n = recv(fd, request + requestLen, sizeof(request) - 1 - requestLen, 0);
+        if (n <= 0)
+            {
+            return;
+            }
+        requestLen         += n;
+        request[requestLen] = '\0';
+        if ((strstr(request, "\r\n\r\n") != NULL) || (strstr(request, "\n\n") != NULL))
+            {
+            break;
+            }
+        }
+
+    metricsFormat();
+    headerLen = sprintf(header,
+                        "HTTP/1.0 200 OK\r\n"
+                        "Content-Type: text/plain; version=0.0.4\r\n"
+                        "Content-Length: %d\r\n"
+                        "Connection: close\r\n\r\n",
+                        metricsBufLen);
+    send(fd, header, headerLen, 0);
+
+    hp = metricsBuf;
+    while (hp < metricsBuf + metricsBufLen)
+        {
+        n = send(fd, hp, (int)(metricsBuf + metricsBufLen - hp), 0);
+        if (n <= 0)
+            {
+            return;
+            }
+        hp += n;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Display the median and 99th percentile of a latency
+**                  histogram, completing the current operator line.
+**
+**  Parameters:     Name        Description.
+**                  histogram   operation counts by latency bucket
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void metricsShowLatency(u64 *histogram)
+    {
+    int  bucket;
+    u64  count;
+    char field[2][16];
+    int  i;
+    u64  sum;
+    u64  total;
+    static double quantiles[2] = { 0.50, 0.99 };
+
+    total = 0;
+    for (bucket = 0; bucket < MetricsLatencyBuckets; bucket++)
+        {
+        total += histogram[bucket];
+        }
+
+    for (i = 0; i < 2; i++)
+        {
+        if (total == 0)
+            {
+            strcpy(field[i], "-");
+            continue;
+            }
+        count = (u64)(quantiles[i] * (double)total + 0.5);
+        if (count == 0)
+            {
+            count = 1;
+            }
+        sum = 0;
+        for (bucket = 0; bucket < MetricsLatencyBuckets - 1; bucket++)
+            {
+            sum += histogram[bucket];
+            if (sum >= count)
+                {
+                break;
+                }
+            }
+        if (bucket < MetricsLatencyBuckets - 1)
+            {
+            sprintf(field[i], "%llu", (unsigned long long)1 << bucket);
+            }
+        else
+            {
+            sprintf(field[i], ">%llu", (unsigned long long)1 << (bucket - 1));
+            }
+        }
+
+    opDisplay(" %7s %7s\n", field[0], field[1]);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Accept and serve metrics scrape connections.
+**
+**  Parameters:     Name        Description.
+**                  param       unused
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+#if defined(_WIN32)
+static void metricsThread(void *param)
+#else
+static void *metricsThread(void *param)
+#endif
+    {
+    fd_set         acceptFds;
+    int            n;
+    struct timeval timeout;
+
+#if defined(_WIN32)
+    SOCKET         acceptFd;
+    SOCKET         listenFd;
+    u_long         blockDisable = 0;
+#else
+    int            acceptFd;
+    int            listenFd;
+#endif
+
+    while (emulationActive)
+        {
+        listenFd = metricsListenHandle;
+        if (listenFd == 0)
+            {
+            sleepMsec(MetricsPollMsec);
+            continue;
+            }
+
+        FD_ZERO(&acceptFds);
+        FD_SET(listenFd, &acceptFds);
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = MetricsPollMsec * 1000;
+        n = select((int)(listenFd + 1), &acceptFds, NULL, NULL, &timeout);
+        if ((n <= 0) || !FD_ISSET(listenFd, &acceptFds) || (listenFd != metricsListenHandle))
+            {
+            continue;
+            }
+
+        acceptFd = accept(listenFd, NULL, NULL);
+#if defined(_WIN32)
+        if (acceptFd == INVALID_SOCKET)
+            {
+            continue;
+            }
+        ioctlsocket(acceptFd, FIONBIO, &blockDisable);
+#else
+        if (acceptFd < 0)
+            {
+            continue;
+            }
+        fcntl(acceptFd, F_SETFL, fcntl(acceptFd, F_GETFL) & ~O_NONBLOCK);
+#endif
+        metricsServe(acceptFd);
+        netCloseConnection(acceptFd);
+        }
+
+#if !defined(_WIN32)
+    return NULL;
+#endif
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
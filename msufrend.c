@@ -178,6 +178,7 @@ typedef struct portContext
     struct frendContext *frend;      /* pointer to supporting FREND context */
     bool                active;      /* TRUE if port is connected and active */
     SOCKET              fd;          /* TCP socket descriptor */
+    NetPollEntry        poll;        /* readiness of fd */
     TelnetState         telnetState; /* telnet state */
     bool                EOLL;        /* TRUE if last line ended in end of line */
     PendingBuffer       pbuf;        /* chars pending output.  Normally, this is 0 */
@@ -191,6 +192,7 @@ typedef struct frendContext
     struct frendContext *next;
     int                 listenPort;
     SOCKET              listenFd;
+    NetPollEntry        listenPoll;
     int                 portCount;
     bool                doesTelnet;           /* TRUE if Telnet protocol enabled */
     int                 ioTurns;
@@ -422,6 +424,7 @@ void msufrendInit(u8 eqNo, u8 unitNo, u8 channelNo, char *params)
         logDtError(LogErrorLocation, "Can't create socket on port %d\n", activeFrend->listenPort);
         exit(1);
         }
+    netPollAdd(&activeFrend->listenPoll, activeFrend->listenFd, NetPollIn);
 
     /*
     **  Print a friendly message.
@@ -828,18 +831,6 @@ static int getLastOSError()
 #endif
     }
 
-/*--- function getLastSocketError ---------------------
- *  Socket-specific version of getLastOSError().
- */
-static int getLastSocketError()
-    {
-#if defined(_WIN32)
-    return WSAGetLastError();
-#else
-    return errno;
-#endif
-    }
-
 /*--- function addrFrendTo1FP ----------------------
  *  Convert an address from FREND to 1FP format.
  *  This means dividing by 2, and ORing in the magic value
@@ -2336,6 +2327,7 @@ static void DRPCON(HalfWord callingConn, u8 connType, HalfWord numPortOrSock)
     pp = activeFrend->ports + (callingConn - 1);
     if (pp != NULL)
         {
+        netPollRemove(&pp->poll);
         netCloseConnection(pp->fd);
         pp->active = FALSE;
         }
@@ -3067,6 +3059,7 @@ static void processIncomingConnection()
             pp->active      = TRUE;
             pp->telnetState = TELST_NORMAL;
             pp->fd          = fd;
+            netPollAdd(&pp->poll, fd, 0);
             break;
             }
         }
@@ -3173,14 +3166,10 @@ static void writeNowAvailable(PortContext *pp)
  */
 static void msufrendCheckIo()
     {
-    unsigned char  buf[256];
-    int            i;
-    int            maxFd;
-    int            n;
-    PortContext    *pp;
-    fd_set         readFds;
-    struct timeval timeout;
-    fd_set         writeFds;
+    unsigned char buf[256];
+    u8            events;
+    int           i;
+    PortContext   *pp;
 
     activeFrend->ioTurns = (activeFrend->ioTurns + 1) % IoTurnsPerPoll;
     if (activeFrend->ioTurns != 0)
@@ -3188,16 +3177,12 @@ static void msufrendCheckIo()
         return;
         }
 
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-
-    FD_SET(activeFrend->listenFd, &readFds);
-    maxFd = (int)activeFrend->listenFd;
-
     for (i = FIRSTUSERPORT, pp = activeFrend->ports + (FIRSTUSERPORT - 1); i <= activeFrend->portCount; i++, pp++)
         {
         if (pp->active)
             {
+            events = 0;
+
             /*
              * Don't read from this socket unless the associated port
              * has a few free buffers.  Because each byte read could be
@@ -3211,11 +3196,7 @@ static void msufrendCheckIo()
             FrendAddr fwaList     = getFullWord(fwaMyPort + W_PTINCL);
             if (getListFreeEntries(fwaList) > MIN_FREE_PORT_BUFFERS)
                 {
-                FD_SET(pp->fd, &readFds);
-                if ((int)pp->fd > maxFd)
-                    {
-                    maxFd = (int)pp->fd;
-                    }
+                events |= NetPollIn;
                 }
 
             /*
@@ -3224,53 +3205,43 @@ static void msufrendCheckIo()
              */
             if (pp->pbuf.charsLeft > 0)
                 {
-                FD_SET(pp->fd, &writeFds);
-                if ((int)pp->fd > maxFd)
-                    {
-                    maxFd = (int)pp->fd;
-                    }
+                events |= NetPollOut;
                 }
+            netPollWant(&pp->poll, events);
             }
         }
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
-    if (n > 0)
+
+    /*
+    **  Act on the readiness found by the network poller.
+    */
+    if (netPollTake(&activeFrend->listenPoll, NetPollIn))
         {
-        if (FD_ISSET(activeFrend->listenFd, &readFds))
-            {
-            /* A terminal user is trying to connect. */
-            processIncomingConnection();
-            }
-        for (i = 0, pp = activeFrend->ports; i < activeFrend->portCount; i++, pp++)
+        /* A terminal user is trying to connect. */
+        processIncomingConnection();
+        }
+    for (i = 0, pp = activeFrend->ports; i < activeFrend->portCount; i++, pp++)
+        {
+        if (pp->active)
             {
-            if (pp->active)
+            if (netPollTake(&pp->poll, NetPollIn))
                 {
-                if (FD_ISSET(pp->fd, &readFds))
+                ssize_t nbytes = recv(pp->fd, (char *)buf, MIN_FREE_PORT_BUFFERS, 0);
+                if (nbytes > 0)
                     {
-                    ssize_t nbytes = recv(pp->fd, (char *)buf, MIN_FREE_PORT_BUFFERS, 0);
-                    if (nbytes > 0)
-                        {
-                        processInboundTelnet(pp, buf, (int)nbytes);
-                        }
-                    else
-                        {
-                        FrendAddr fwaMySocket = sockNumToFwa(pp->id);
-                        taskCLOFSK((HalfWord)pp->id, fwaMySocket);
-                        }
+                    processInboundTelnet(pp, buf, (int)nbytes);
                     }
-                if (FD_ISSET(pp->fd, &writeFds))
+                else
                     {
-                    writeNowAvailable(pp);
+                    FrendAddr fwaMySocket = sockNumToFwa(pp->id);
+                    taskCLOFSK((HalfWord)pp->id, fwaMySocket);
                     }
                 }
+            if (netPollTake(&pp->poll, NetPollOut))
+                {
+                writeNowAvailable(pp);
+                }
             }
         }
-    else if (n < 0)
-        {
-        logDtError(LogErrorLocation, "Error %d from select\n", getLastSocketError());
-        sleepMsec(500);
-        }
     dropInterlock(activeFrend->fwaFPCOM + H_FEDEAD); /* Clear "front-end dead" flag */
     }
 
@@ -175,6 +175,7 @@ typedef struct tapeParam
     PpWord           recordLength;
     PpWord           ioBuffer[MaxPpBuf];
     PpWord           *bp;
+    MetricsUnit      *stats;
     } TapeParam;
 
 /*
@@ -183,6 +184,7 @@ typedef struct tapeParam
 **  ---------------------------
 */
 static void mt362xInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, u8 tracks);
+static void mt362xInstallTape(MediaMount *mp);
 static void mt362xInitStatus(TapeParam *tp);
 static void mt362xResetStatus(TapeParam *tp);
 static void mt362xSetupStatus(TapeParam *tp);
@@ -409,6 +411,7 @@ static void mt362xInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, u8 tr
     tp->channelNo = channelNo;
     tp->eqNo      = eqNo;
     tp->unitNo    = unitNo;
+    tp->stats     = metricsRegisterUnit(DtMt362x, channelNo, eqNo, unitNo);
 
     /*
     **  All initially mounted tapes are read only.
@@ -422,15 +425,21 @@ static void mt362xInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName, u8 tr
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Load a new tape (operator interface).
+**  Purpose:        Open the image of a tape to be loaded (operator
+**                  interface).
+**
+**                  This is called on the operator thread.  The opened
+**                  image is installed on the unit by the emulation thread
+**                  through mp->install.
 **
 **  Parameters:     Name        Description.
 **                  params      parameters
+**                  mp          (out) opened medium
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if the image was opened.
 **
 **------------------------------------------------------------------------*/
-void mt362xLoadTape(char *params)
+bool mt362xOpenTape(char *params, MediaMount *mp)
     {
     int         channelNo;
     DevSlot     *dp;
@@ -454,35 +463,35 @@ void mt362xLoadTape(char *params)
         {
         opDisplay("(mt362x ) Not enough or invalid parameters\n");
 
-        return;
+        return FALSE;
         }
 
     if ((channelNo < 0) || (channelNo >= MaxChannels))
         {
         opDisplay("(mt362x ) Invalid channel no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitNo < 0) || (unitNo >= MaxUnits2))
         {
         opDisplay("(mt362x ) Invalid unit no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitMode != 'w') && (unitMode != 'r'))
         {
         opDisplay("(mt362x ) Invalid ring mode (r/w)\n");
 
-        return;
+        return FALSE;
         }
 
     if (str[0] == 0)
         {
         opDisplay("(mt362x ) Invalid file name\n");
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -491,7 +500,7 @@ void mt362xLoadTape(char *params)
     dp = dcc6681FindDevice((u8)channelNo, (u8)equipmentNo, DtMt362x);
     if (dp == NULL)
         {
-        return;
+        return FALSE;
         }
 
     /*
@@ -502,7 +511,7 @@ void mt362xLoadTape(char *params)
         {
         opDisplay("(mt362x ) Unit %d not allocated\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -512,7 +521,7 @@ void mt362xLoadTape(char *params)
         {
         opDisplay("(mt362x ) Unit %d not unloaded\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -531,8 +540,6 @@ void mt362xLoadTape(char *params)
         fcb = fopen(str, "rb");
         }
 
-    dp->fcb[unitNo] = fcb;
-
     /*
     **  Check if the open succeeded.
     */
@@ -540,22 +547,18 @@ void mt362xLoadTape(char *params)
         {
         opDisplay("(mt362x ) Failed to open %s\n", str);
 
-        return;
+        return FALSE;
         }
 
-    /*
-    **  Setup show_tape path name.
-    */
-    strcpy(tp->fileName, str);
-
-    /*
-    **  Setup status.
-    */
-    mt362xInitStatus(tp);
-    tp->unitReady = TRUE;
-    tp->ringIn    = unitMode == 'w';
+    mp->install = mt362xInstallTape;
+    mp->dp      = dp;
+    mp->unitNo  = unitNo;
+    mp->fcb     = fcb;
+    mp->auxFcb  = NULL;
+    mp->ringIn  = unitMode == 'w';
+    strcpy(mp->fileName, str);
 
-    opDisplay("(mt362x ) Successfully loaded %s\n", str);
+    return TRUE;
     }
 
 /*--------------------------------------------------------------------------
@@ -685,6 +688,49 @@ void mt362xShowTapeStatus()
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Install a tape image opened by mt362xOpenTape on its
+**                  unit.  Called on the emulation thread.
+**
+**  Parameters:     Name        Description.
+**                  mp          opened medium
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt362xInstallTape(MediaMount *mp)
+    {
+    TapeParam *tp;
+
+    /*
+    **  Another tape may have been loaded while this one was opened.
+    */
+    if (mp->dp->fcb[mp->unitNo] != NULL)
+        {
+        opDisplay("(mt362x ) Unit %d not unloaded\n", mp->unitNo);
+        fclose(mp->fcb);
+
+        return;
+        }
+
+    tp                      = (TapeParam *)mp->dp->context[mp->unitNo];
+    mp->dp->fcb[mp->unitNo] = mp->fcb;
+
+    /*
+    **  Setup show_tape path name.
+    */
+    strcpy(tp->fileName, mp->fileName);
+
+    /*
+    **  Setup status.
+    */
+    mt362xInitStatus(tp);
+    tp->unitReady = TRUE;
+    tp->ringIn    = mp->ringIn;
+
+    opDisplay("(mt362x ) Successfully loaded %s\n", mp->fileName);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Reset device status at start of new function.
 **
@@ -856,6 +902,7 @@ static void mt362xSetupStatus(TapeParam *tp)
 static FcStatus mt362xFunc(PpWord funcCode)
     {
     u32       recLen1;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     FcStatus  st;
@@ -928,7 +975,9 @@ static FcStatus mt362xFunc(PpWord funcCode)
         if (tp->unitReady)
             {
             mt362xResetStatus(tp);
+            start = getMicroseconds();
             fseek(active3000Device->fcb[unitNo], 0, SEEK_SET);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             if (tp->blockNo != 0)
                 {
                 if (!tp->rewinding)
@@ -963,6 +1012,7 @@ static FcStatus mt362xFunc(PpWord funcCode)
     case Fc362xBackspace:
         if (tp->unitReady)
             {
+            start = getMicroseconds();
             if (tp->reverseRead)
                 {
                 mt362xFuncForespace();
@@ -971,6 +1021,7 @@ static FcStatus mt362xFunc(PpWord funcCode)
                 {
                 mt362xFuncBackspace();
                 }
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
 
             tp->endOfOperation = TRUE;
             tp->intStatus     |= Int362xEndOfOp;
@@ -983,10 +1034,12 @@ static FcStatus mt362xFunc(PpWord funcCode)
         if (tp->unitReady)
             {
             mt362xResetStatus(tp);
+            start = getMicroseconds();
             do
                 {
                 mt362xFuncForespace();
                 } while (!tp->fileMark && !tp->endOfTape && !tp->parityError);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
 
             tp->endOfOperation = TRUE;
             tp->intStatus     |= Int362xEndOfOp;
@@ -999,10 +1052,12 @@ static FcStatus mt362xFunc(PpWord funcCode)
         if (tp->unitReady)
             {
             mt362xResetStatus(tp);
+            start = getMicroseconds();
             do
                 {
                 mt362xFuncBackspace();
                 } while (!tp->fileMark && tp->blockNo != 0 && !tp->parityError);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
 
             if (tp->blockNo == 0)
                 {
@@ -1329,7 +1384,7 @@ static void mt362xIo(void)
 **------------------------------------------------------------------------*/
 static void mt362xActivate(void)
     {
-    activeChannel->delayStatus = 5;
+    channelDelayStatus(activeChannel, 5);
     }
 
 /*--------------------------------------------------------------------------
@@ -1349,6 +1404,7 @@ static void mt362xDisconnect(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     PpWord    *ip;
     u8        *rp;
 
@@ -1475,6 +1531,8 @@ static void mt362xDisconnect(void)
             recLen1 = recLen0;
             }
 
+        start = getMicroseconds();
+
         /*
         **  The following fseek makes fwrite behave as desired after an fread.
         */
@@ -1486,6 +1544,7 @@ static void mt362xDisconnect(void)
         fwrite(&recLen1, sizeof(recLen1), 1, fcb);
         fwrite(&rawBuffer, 1, recLen0, fcb);
         fwrite(&recLen1, sizeof(recLen1), 1, fcb);
+        metricsCountUnitIo(tp->stats, MetricsIoWrite, recLen0, start);
 
         /*
         **  The following fseek prepares for any subsequent fread.
@@ -1522,11 +1581,13 @@ static void mt362xFuncRead(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
 
     unitNo = active3000Device->selectedUnit;
     tp     = (TapeParam *)active3000Device->context[unitNo];
+    start  = getMicroseconds();
 
     active3000Device->recordLength = 0;
     tp->recordLength = 0;
@@ -1595,6 +1656,7 @@ static void mt362xFuncRead(void)
     **  Read and verify the actual raw data.
     */
     len = (u32)fread(rawBuffer, 1, recLen1, active3000Device->fcb[unitNo]);
+    metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
     if (recLen1 != (u32)len)
         {
@@ -1682,12 +1744,14 @@ static void mt362xFuncReadBkw(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     long      position;
 
     unitNo = active3000Device->selectedUnit;
     tp     = (TapeParam *)active3000Device->context[unitNo];
+    start  = getMicroseconds();
 
     active3000Device->recordLength = 0;
     tp->recordLength = 0;
@@ -1797,6 +1861,7 @@ static void mt362xFuncReadBkw(void)
         **  Read and verify the actual raw data.
         */
         len = (u32)fread(rawBuffer, 1, recLen1, active3000Device->fcb[unitNo]);
+        metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
         if (recLen1 != (u32)len)
             {
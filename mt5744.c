@@ -159,6 +159,15 @@
 #define MaxByteBuf                           60000
 #define VolumeNameSize                       6
 
+/*
+**  Protocol extensions requested from the tape server at registration.
+**  READAHEAD is the number of READFWD requests kept in flight beyond the
+**  one the PP is waiting for, WRITEBATCH the number of WRITE requests
+**  which may be outstanding before the server must acknowledge them.
+*/
+#define ReadAheadDepth                       8
+#define WriteBatchSize                       16
+
 /*
 **  -----------------------
 **  Private Macro Functions
@@ -188,15 +197,23 @@ typedef enum
     } AcsState;
 
 /*
-**  Tape Server I/O buffer
+**  Tape Server I/O buffers. The input buffer is large enough to hold the
+**  responses to all read-ahead requests plus a following event line.
 */
 typedef struct tapeBuffer
     {
     u32 in;
     u32 out;
-    u8  data[MaxByteBuf + 16];
+    u8  data[MaxByteBuf + 256];
     } TapeBuffer;
 
+typedef struct tapeInputBuffer
+    {
+    u32 in;
+    u32 out;
+    u8  data[(ReadAheadDepth + 2) * (MaxByteBuf + 256)];
+    } TapeInputBuffer;
+
 /*
 **  ACS controller.
 */
@@ -236,7 +253,7 @@ typedef struct tapeParam
 #else
     int                fd;
 #endif
-    TapeBuffer         inputBuffer;
+    TapeInputBuffer    inputBuffer;
     TapeBuffer         outputBuffer;
     bool               isAlert;
     bool               isBlockNotFound;
@@ -247,10 +264,21 @@ typedef struct tapeParam
     bool               isReady;
     bool               isTapeMark;
     bool               isWriteEnabled;
+    bool               isWritePending;
     PpWord             errorCode;
     u32                recordLength;
     PpWord             ioBuffer[MaxPpBuf];
     PpWord             *bp;
+    u32                readAhead;
+    u32                writeBatch;
+    u32                raPending;
+    u32                discardCount;
+    u32                writesUnacked;
+    u64                byteCount;
+    u64                rateByteCount;
+    u64                rateStartTime;
+    u64                requestTime;
+    MetricsUnit        *stats;
     } TapeParam;
 
 /*
@@ -262,24 +290,32 @@ static void mt5744Activate(void);
 static void mt5744CalculateBufferedLog(TapeParam *tp);
 static void mt5744CalculateDetailedStatus(TapeParam *tp);
 static void mt5744CalculateGeneralStatus(TapeParam *tp);
+static void mt5744CancelReadAhead(TapeParam *tp);
 static void mt5744CheckTapeServer(void);
 static void mt5744CloseTapeServerConnection(TapeParam *tp);
 static void mt5744ConnectCallback(TapeParam *tp);
 static FcStatus mt5744Func(PpWord funcCode);
+static void mt5744DiscardResponse(TapeParam *tp);
 static void mt5744Disconnect(void);
+static void mt5744FeaturesRequestCallback(TapeParam *tp);
 static void mt5744FlushWrite(void);
 static void mt5744Io(void);
 static void mt5744InitiateConnection(TapeParam *tp);
+static void mt5744IssueReadRequest(TapeParam *tp);
 static void mt5744IssueTapeServerRequest(TapeParam *tp, char *request, void (*callback)(struct tapeParam *tp));
+static bool mt5744IsEventHeld(TapeParam *tp);
 void mt5744LoadTape(TapeParam *tp, bool writeEnable);
 static void mt5744LocateBlockRequestCallback(TapeParam *tp);
 static int mt5744PackBytes(TapeParam *tp, u8 *rp, int recLen);
 static char *mt5744ParseTapeServerResponse(TapeParam *tp, int *status);
+static void mt5744ProcessTapeServerInput(TapeParam *tp);
+static bool mt5744QueueTapeServerRequest(TapeParam *tp, char *request);
 static void mt5744ReadBlockIdRequestCallback(TapeParam *tp);
 static void mt5744ReadRequestCallback(TapeParam *tp);
 static void mt5744ReceiveTapeServerResponse(TapeParam *tp);
 static void mt5744RegisterUnit(TapeParam *tp);
 static void mt5744RegisterUnitRequestCallback(TapeParam *tp);
+static void mt5744ReleaseWrite(TapeParam *tp);
 static void mt5744ResetInputBuffer(TapeParam *tp, u8 *eor);
 static void mt5744ResetStatus(TapeParam *tp);
 static void mt5744ResetUnit(TapeParam *tp);
@@ -471,6 +507,7 @@ void mt5744Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     tp->channelNo = channelNo;
     tp->eqNo      = eqNo;
     tp->unitNo    = unitNo;
+    tp->stats     = metricsRegisterUnit(DtMt5744, channelNo, eqNo, unitNo);
 
     /*
     **  Print a friendly message.
@@ -490,8 +527,13 @@ void mt5744Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
 **------------------------------------------------------------------------*/
 void mt5744ShowTapeStatus()
     {
+    u64       currentTime;
+    u32       depth;
+    double    rate;
     TapeParam *tp = firstTape;
 
+    currentTime = getMilliseconds();
+
     while (tp)
         {
         opDisplay("    >   %-8s C%02o E%02o U%02o", "5744", tp->channelNo, tp->eqNo, tp->unitNo);
@@ -512,7 +554,24 @@ void mt5744ShowTapeStatus()
         case StAcsReady:
             if (tp->volumeName[0])
                 {
-                opDisplay(" %s %s\n", tp->isWriteEnabled ? "w" : "r", tp->volumeName);
+                /*
+                **  Rate is measured since the previous display, or since
+                **  the volume was mounted. Queue depth counts all requests
+                **  on the server link which have not been answered yet.
+                */
+                rate = 0.0;
+                if (currentTime > tp->rateStartTime)
+                    {
+                    rate = (double)(tp->byteCount - tp->rateByteCount) / (double)(currentTime - tp->rateStartTime) / 1000.0;
+                    }
+                tp->rateByteCount = tp->byteCount;
+                tp->rateStartTime = currentTime;
+                depth             = tp->raPending + tp->writesUnacked + tp->discardCount;
+                if (tp->isBusy && !tp->isWritePending)
+                    {
+                    depth += 1;
+                    }
+                opDisplay(" %s %-6s %8.2f MB/s  queue %u\n", tp->isWriteEnabled ? "w" : "r", tp->volumeName, rate, depth);
                 }
             else
                 {
@@ -556,7 +615,7 @@ static void mt5744Activate(void)
             activePpu->regP);
     cp->isJustActivated = TRUE;
 #endif
-    activeChannel->delayStatus = 5;
+    channelDelayStatus(activeChannel, 5);
     }
 
 /*--------------------------------------------------------------------------
@@ -669,6 +728,35 @@ static void mt5744CalculateGeneralStatus(TapeParam *tp)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Cancel outstanding read-ahead before issuing a request
+**                  which depends on the tape position seen by the PP.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744CancelReadAhead(TapeParam *tp)
+    {
+    char request[32];
+
+    if (tp->raPending == 0)
+        {
+        return;
+        }
+
+    /*
+    **  The server backs up over the blocks it read ahead. The responses to
+    **  the read-ahead requests and to the UNREAD itself are discarded.
+    */
+    sprintf(request, "UNREAD %u", tp->raPending);
+    mt5744QueueTapeServerRequest(tp, request);
+    tp->discardCount += tp->raPending + 1;
+    tp->raPending     = 0;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Process tape server I/O and state transitions.
 **
@@ -745,7 +833,14 @@ static void mt5744CheckTapeServer(void)
         {
         if ((tp->fd > 0) && (tp->state > StAcsConnecting))
             {
-            FD_SET(tp->fd, &readFds);
+            /*
+            **  Stop reading when the input buffer is full of read-ahead
+            **  responses, the server is throttled by TCP flow control.
+            */
+            if (tp->inputBuffer.in < sizeof(tp->inputBuffer.data))
+                {
+                FD_SET(tp->fd, &readFds);
+                }
             if (tp->outputBuffer.out < tp->outputBuffer.in)
                 {
                 FD_SET(tp->fd, &writeFds);
@@ -805,8 +900,16 @@ static void mt5744CloseTapeServerConnection(TapeParam *tp)
 #endif
     netCloseConnection(tp->fd);
     tp->fd                    = 0;
+    tp->inputBuffer.out       = tp->inputBuffer.in = 0;
+    tp->outputBuffer.out      = tp->outputBuffer.in = 0;
     tp->isReady               = FALSE;
     tp->isBusy                = FALSE;
+    tp->isWritePending        = FALSE;
+    tp->readAhead             = 0;
+    tp->writeBatch            = 0;
+    tp->raPending             = 0;
+    tp->discardCount          = 0;
+    tp->writesUnacked         = 0;
     tp->errorCode             = EcTranportNotOnline;
     tp->state                 = StAcsDisconnected;
     tp->nextConnectionAttempt = getSeconds() + (time_t)ConnectionRetryInterval;
@@ -844,6 +947,41 @@ static void mt5744ConnectCallback(TapeParam *tp)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Discard a response to a cancelled read-ahead request.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744DiscardResponse(TapeParam *tp)
+    {
+    int  dataIdx;
+    char *eor;
+    long len;
+    int  status;
+
+    eor = mt5744ParseTapeServerResponse(tp, &status);
+    if (eor == NULL)
+        {
+        return;
+        }
+    if (status == 201)
+        {
+        len     = strtol((char *)&tp->inputBuffer.data[4], NULL, 10);
+        dataIdx = (int)(eor - (char *)tp->inputBuffer.data);
+        if ((long)(tp->inputBuffer.in - dataIdx) < len)
+            {
+            return;
+            }
+        eor += len;
+        }
+    tp->discardCount -= 1;
+    mt5744ResetInputBuffer(tp, (u8 *)eor);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Handle disconnecting of channel.
 **
@@ -869,6 +1007,62 @@ static void mt5744Disconnect(void)
     activeChannel->discAfterInput  = FALSE;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Handles a response to a FEATURES request. Servers which
+**                  do not recognise the request reject it, and the unit
+**                  then uses one request at a time.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744FeaturesRequestCallback(TapeParam *tp)
+    {
+    char *eor;
+    char *sp;
+    int  status;
+    long value;
+
+    eor = mt5744ParseTapeServerResponse(tp, &status);
+    if (eor == NULL)
+        {
+        return;
+        }
+    tp->readAhead  = 0;
+    tp->writeBatch = 0;
+    if (status == 200)
+        {
+        eor[-1] = '\0';
+        sp      = strstr((char *)tp->inputBuffer.data, " READAHEAD ");
+        if (sp != NULL)
+            {
+            value = strtol(sp + 11, NULL, 10);
+            if ((value > 0) && (value <= ReadAheadDepth))
+                {
+                tp->readAhead = (u32)value;
+                }
+            }
+        sp = strstr((char *)tp->inputBuffer.data, " WRITEBATCH ");
+        if (sp != NULL)
+            {
+            value = strtol(sp + 12, NULL, 10);
+            if ((value > 0) && (value <= WriteBatchSize))
+                {
+                tp->writeBatch = (u32)value;
+                }
+            }
+        eor[-1] = '\n';
+        }
+#if DEBUG
+    fprintf(mt5744Log, "\n%010u Tape server for CH:%02o u:%d grants read-ahead %u, write batch %u", traceSequenceNo,
+            tp->channelNo, tp->unitNo, tp->readAhead, tp->writeBatch);
+#endif
+    tp->state = StAcsReady;
+    mt5744ResetInputBuffer(tp, (u8 *)eor);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Flush accumulated write data.
 **
@@ -882,6 +1076,7 @@ static void mt5744FlushWrite(void)
     char      buffer[10];
     CtrlParam *cp = activeDevice->controllerContext;
     u8        *dataStart;
+    u8        *hp;
     u32       i;
     PpWord    *ip;
     int       len;
@@ -899,12 +1094,18 @@ static void mt5744FlushWrite(void)
         return;
         }
 
+    mt5744CancelReadAhead(tp);
+
+    /*
+    **  The request is appended to anything not yet sent to the server.
+    */
     tp->bp  = tp->ioBuffer;
     recLen0 = 0;
     recLen2 = tp->recordLength;
     ip      = tp->ioBuffer;
-    memcpy(&tp->outputBuffer.data[0], "WRITE          \n", 16);
-    rp = dataStart = &tp->outputBuffer.data[16];
+    hp      = &tp->outputBuffer.data[tp->outputBuffer.in];
+    memcpy(hp, "WRITE          \n", 16);
+    rp = dataStart = hp + 16;
 
     for (i = 0; i < recLen2; i += 2)
         {
@@ -926,13 +1127,27 @@ static void mt5744FlushWrite(void)
         }
 
     len = sprintf(buffer, "%d", recLen0);
-    memcpy(&tp->outputBuffer.data[6], buffer, len);
-    tp->outputBuffer.out = 0;
-    tp->outputBuffer.in  = recLen0 + 16;
-    tp->callback         = mt5744WriteRequestCallback;
-    tp->isBusy           = TRUE;
-    cp->isWriting        = FALSE;
-    cp->isOddFrameCount  = FALSE;
+    memcpy(hp + 6, buffer, len);
+    metricsCountUnitOps(tp->stats, MetricsIoWrite, recLen0);
+    tp->byteCount          += recLen0;
+    tp->outputBuffer.in    += recLen0 + 16;
+    tp->isBusy              = TRUE;
+    cp->isWriting           = FALSE;
+    cp->isOddFrameCount     = FALSE;
+
+    /*
+    **  With batched acknowledgements the PP may continue as soon as the
+    **  request has been sent, unless the server owes a full batch.
+    */
+    if (tp->writeBatch > 0)
+        {
+        tp->writesUnacked  += 1;
+        tp->isWritePending  = TRUE;
+        }
+    else
+        {
+        tp->callback = mt5744WriteRequestCallback;
+        }
 #if DEBUG
     fprintf(mt5744Log, "\n%010u PP:%02o CH:%02o P:%04o Write %d PP words",
             traceSequenceNo,
@@ -1105,7 +1320,7 @@ static FcStatus mt5744Func(PpWord funcCode)
             mt5744ResetStatus(tp);
             if (tp->isReady)
                 {
-                mt5744IssueTapeServerRequest(tp, "READFWD", mt5744ReadRequestCallback);
+                mt5744IssueReadRequest(tp);
                 }
             break;
             }
@@ -1275,7 +1490,7 @@ static void mt5744Io(void)
         {
         return;
         }
-    activeChannel->delayStatus = 3;
+    channelDelayStatus(activeChannel, 3);
 
     /*
     **  Handle tape server events and I/O
@@ -1599,6 +1814,45 @@ static void mt5744Io(void)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Set up for a READFWD request. When the server supports
+**                  read-ahead, further READFWD requests are kept in flight
+**                  and their responses are held until the PP asks for them.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744IssueReadRequest(TapeParam *tp)
+    {
+    if (tp->raPending > 0)
+        {
+        tp->raPending -= 1;
+        }
+    else
+        {
+        mt5744QueueTapeServerRequest(tp, "READFWD");
+        }
+    while ((tp->raPending < tp->readAhead) && mt5744QueueTapeServerRequest(tp, "READFWD"))
+        {
+        tp->raPending += 1;
+        }
+    tp->callback = mt5744ReadRequestCallback;
+    tp->isBusy   = TRUE;
+    tp->isAlert  = FALSE;
+    if (tp->outputBuffer.out < tp->outputBuffer.in)
+        {
+        mt5744SendTapeServerRequest(tp);
+        }
+
+    /*
+    **  The response may already be buffered.
+    */
+    mt5744ProcessTapeServerInput(tp);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Set up for sending a request to the StorageTek simulator.
 **
@@ -1612,22 +1866,53 @@ static void mt5744Io(void)
 **------------------------------------------------------------------------*/
 static void mt5744IssueTapeServerRequest(TapeParam *tp, char *request, void (*callback)(struct tapeParam *tp))
     {
-    u8   *bp;
-    char *sp;
+    mt5744CancelReadAhead(tp);
+    mt5744QueueTapeServerRequest(tp, request);
+    tp->callback    = callback;
+    tp->isBusy      = TRUE;
+    tp->isAlert     = FALSE;
+    tp->requestTime = getMicroseconds();
+    mt5744SendTapeServerRequest(tp);
+    }
 
-    bp = &tp->outputBuffer.data[0];
-    sp = request;
-    while (*sp && *sp != '\n')
+/*--------------------------------------------------------------------------
+**  Purpose:        Check whether an event line follows the read-ahead
+**                  responses held in the input buffer.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        TRUE if an event is held.
+**
+**------------------------------------------------------------------------*/
+static bool mt5744IsEventHeld(TapeParam *tp)
+    {
+    u32  i;
+    u8   *limit;
+    u8   *lp;
+    u8   *sp;
+
+    sp    = tp->inputBuffer.data;
+    limit = &tp->inputBuffer.data[tp->inputBuffer.in];
+    for (i = 0; i <= tp->raPending && sp < limit; i++)
         {
-        *bp++ = (u8) * sp++;
+        if (*sp == '1')
+            {
+            return TRUE;
+            }
+        lp = memchr(sp, '\n', limit - sp);
+        if (lp == NULL)
+            {
+            break;
+            }
+        if ((lp - sp > 4) && (memcmp(sp, "201 ", 4) == 0))
+            {
+            lp += strtol((char *)sp + 4, NULL, 10);
+            }
+        sp = lp + 1;
         }
-    *bp++ = '\n';
-    tp->outputBuffer.out = 0;
-    tp->outputBuffer.in  = (u32)(bp - &tp->outputBuffer.data[0]);
-    tp->callback         = callback;
-    tp->isBusy           = TRUE;
-    tp->isAlert          = FALSE;
-    mt5744SendTapeServerRequest(tp);
+
+    return FALSE;
     }
 
 /*--------------------------------------------------------------------------
@@ -1741,13 +2026,7 @@ static int mt5744PackBytes(TapeParam *tp, u8 *rp, int recLen)
     */
     op = tp->ioBuffer;
 
-    /*
-    **  Fill the last few bytes with zeroes.
-    */
-    rp[recLen + 0] = 0;
-    rp[recLen + 1] = 0;
-
-    for (i = 0; i < recLen; i += 3)
+    for (i = 0; i + 3 <= recLen; i += 3)
         {
         c1 = *rp++;
         c2 = *rp++;
@@ -1757,6 +2036,19 @@ static int mt5744PackBytes(TapeParam *tp, u8 *rp, int recLen)
         *op++ = ((c2 << 8) | (c3 >> 0)) & Mask12;
         }
 
+    /*
+    **  Pad the last frames with zeroes. The input buffer is not touched
+    **  because the next response may follow the record.
+    */
+    if (i < recLen)
+        {
+        c1 = rp[0];
+        c2 = (i + 1 < recLen) ? rp[1] : 0;
+
+        *op++ = ((c1 << 4) | (c2 >> 4)) & Mask12;
+        *op++ = (c2 << 8) & Mask12;
+        }
+
     ppWords             = (int)(op - tp->ioBuffer);
     tp->isCharacterFill = FALSE;
 
@@ -1829,6 +2121,126 @@ static char *mt5744ParseTapeServerResponse(TapeParam *tp, int *status)
     return sp + 1;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Dispatch the complete responses held in the input buffer.
+**                  Responses arrive in the order the requests were sent, so
+**                  responses to cancelled read-ahead come first, followed by
+**                  write acknowledgements, followed by the response to the
+**                  request the PP is waiting for. Read-ahead responses stay
+**                  buffered until the PP issues the corresponding READFWD.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744ProcessTapeServerInput(TapeParam *tp)
+    {
+    char *eor;
+    u32  in;
+    int  status;
+
+    while ((tp->fd > 0) && (tp->inputBuffer.in > 0))
+        {
+        in = tp->inputBuffer.in;
+        if (tp->inputBuffer.data[0] == '1') // mount/dismount event
+            {
+            if (in <= 3)
+                {
+                break;
+                }
+            eor = mt5744ParseTapeServerResponse(tp, &status);
+            if (eor == NULL)
+                {
+                break;
+                }
+            switch (status)
+                {
+            case 101:
+            case 102:
+                mt5744LoadTape(tp, status == 102);
+                break;
+
+            case 103:
+                mt5744UnloadTape(tp);
+                break;
+
+            default:
+                logDtError(LogErrorLocation, "Unrecognized event indication %.3s from %s:%u for CH:%02o u:%d",
+                           &tp->inputBuffer.data[0], tp->serverName, ntohs(tp->serverAddr.sin_port), tp->channelNo, tp->unitNo);
+                mt5744CloseTapeServerConnection(tp);
+                break;
+                }
+            mt5744ResetInputBuffer(tp, (u8 *)eor);
+            }
+        else if (tp->discardCount > 0)
+            {
+            mt5744DiscardResponse(tp);
+            }
+        else if (tp->writesUnacked > 0)
+            {
+            mt5744WriteRequestCallback(tp);
+            }
+        else if ((tp->raPending > 0) && !tp->isBusy)
+            {
+            if (!mt5744IsEventHeld(tp))
+                {
+                break;
+                }
+
+            /*
+            **  A mount or dismount event is queued behind read-ahead data,
+            **  the data is no longer wanted.
+            */
+            tp->discardCount += tp->raPending;
+            tp->raPending     = 0;
+            continue;
+            }
+        else
+            {
+            tp->callback(tp);
+            }
+        if (tp->inputBuffer.in == in)
+            {
+            break;
+            }
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Append a request line to the output buffer.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**                  request     the request to send
+**
+**  Returns:        TRUE if the request fitted into the buffer.
+**
+**------------------------------------------------------------------------*/
+static bool mt5744QueueTapeServerRequest(TapeParam *tp, char *request)
+    {
+    u8   *bp;
+    u8   *limit;
+    char *sp;
+
+    bp    = &tp->outputBuffer.data[tp->outputBuffer.in];
+    limit = &tp->outputBuffer.data[sizeof(tp->outputBuffer.data) - 1];
+    sp    = request;
+    while (*sp && *sp != '\n')
+        {
+        if (bp >= limit)
+            {
+            return FALSE;
+            }
+        *bp++ = (u8) * sp++;
+        }
+    *bp++ = '\n';
+    tp->outputBuffer.in = (u32)(bp - &tp->outputBuffer.data[0]);
+
+    return TRUE;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Process a response from the StorageTek simulator to a
 **                  READBLOCKID request.
@@ -1889,9 +2301,7 @@ static void mt5744ReadBlockIdRequestCallback(TapeParam *tp)
 **------------------------------------------------------------------------*/
 static void mt5744ReceiveTapeServerResponse(TapeParam *tp)
     {
-    char    *eor;
     ssize_t n;
-    int     status;
 
     n = recv(tp->fd, &tp->inputBuffer.data[tp->inputBuffer.in], sizeof(tp->inputBuffer.data) - tp->inputBuffer.in, 0);
     if (n <= 0)
@@ -1912,39 +2322,7 @@ static void mt5744ReceiveTapeServerResponse(TapeParam *tp)
         mt5744LogFlush();
 #endif
         tp->inputBuffer.in += (u32)n;
-        if (tp->inputBuffer.data[0] == '1') // mount/dismount event
-            {
-            if (tp->inputBuffer.in > 3)
-                {
-                eor = mt5744ParseTapeServerResponse(tp, &status);
-                if (eor == NULL)
-                    {
-                    return;
-                    }
-                switch (status)
-                    {
-                case 101:
-                case 102:
-                    mt5744LoadTape(tp, status == 102);
-                    break;
-
-                case 103:
-                    mt5744UnloadTape(tp);
-                    break;
-
-                default:
-                    logDtError(LogErrorLocation, "Unrecognized event indication %.3s from %s:%u for CH:%02o u:%d",
-                               &tp->inputBuffer.data[0], tp->serverName, ntohs(tp->serverAddr.sin_port), tp->channelNo, tp->unitNo);
-                    mt5744CloseTapeServerConnection(tp);
-                    break;
-                    }
-                mt5744ResetInputBuffer(tp, (u8 *)eor);
-                }
-            }
-        else
-            {
-            tp->callback(tp);
-            }
+        mt5744ProcessTapeServerInput(tp);
         }
     }
 
@@ -1984,7 +2362,9 @@ static void mt5744ReadRequestCallback(TapeParam *tp)
             return;
             }
         tp->recordLength = mt5744PackBytes(tp, (u8 *)eor, (int)len);
-        eor      += len;
+        metricsCountUnitOps(tp->stats, MetricsIoRead, (u32)len);
+        tp->byteCount += len;
+        eor           += len;
         tp->isBOT = FALSE;
         break;
 
@@ -2056,6 +2436,7 @@ static void mt5744RegisterUnit(TapeParam *tp)
 static void mt5744RegisterUnitRequestCallback(TapeParam *tp)
     {
     char *eor;
+    char request[64];
     int  status;
 
     eor = mt5744ParseTapeServerResponse(tp, &status);
@@ -2065,8 +2446,15 @@ static void mt5744RegisterUnitRequestCallback(TapeParam *tp)
         }
     if ((status >= 200) && (status < 300))
         {
+        /*
+        **  Negotiate protocol extensions. The unit becomes ready when the
+        **  server has answered.
+        */
         mt5744ResetUnit(tp);
-        tp->state = StAcsReady;
+        sprintf(request, "FEATURES READAHEAD %d WRITEBATCH %d", ReadAheadDepth, WriteBatchSize);
+        mt5744QueueTapeServerRequest(tp, request);
+        tp->callback = mt5744FeaturesRequestCallback;
+        mt5744SendTapeServerRequest(tp);
         }
     else
         {
@@ -2076,6 +2464,26 @@ static void mt5744RegisterUnitRequestCallback(TapeParam *tp)
     mt5744ResetInputBuffer(tp, (u8 *)eor);
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Let the PP continue after a batched WRITE once the
+**                  request has been sent and the server does not owe a
+**                  full batch of acknowledgements.
+**
+**  Parameters:     Name        Description.
+**                  tp          pointer to tape unit parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt5744ReleaseWrite(TapeParam *tp)
+    {
+    if (tp->isWritePending && (tp->outputBuffer.in == 0) && (tp->writesUnacked < tp->writeBatch))
+        {
+        tp->isWritePending = FALSE;
+        tp->isBusy         = FALSE;
+        }
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Reset input buffer indices to prepare for processing
 **                  next available input.
@@ -2138,13 +2546,15 @@ static void mt5744ResetStatus(TapeParam *tp)
 **------------------------------------------------------------------------*/
 static void mt5744ResetUnit(TapeParam *tp)
     {
-    tp->inputBuffer.out  = tp->inputBuffer.in = 0;
-    tp->outputBuffer.out = tp->outputBuffer.in = 0;
     mt5744ResetStatus(tp);
     tp->isBusy         = FALSE;
     tp->isReady        = FALSE;
     tp->isWriteEnabled = FALSE;
+    tp->isWritePending = FALSE;
     tp->volumeName[0]  = '\0';
+    tp->byteCount      = 0;
+    tp->rateByteCount  = 0;
+    tp->rateStartTime  = getMilliseconds();
     }
 
 /*--------------------------------------------------------------------------
@@ -2167,6 +2577,7 @@ static void mt5744RewindRequestCallback(TapeParam *tp)
         {
         return;
         }
+    metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, tp->requestTime);
     tp->isBusy = FALSE;
     if (status == 203)
         {
@@ -2237,6 +2648,7 @@ static void mt5744SendTapeServerRequest(TapeParam *tp)
         if (tp->outputBuffer.out >= tp->outputBuffer.in)
             {
             tp->outputBuffer.out = tp->outputBuffer.in = 0;
+            mt5744ReleaseWrite(tp);
             }
         }
     }
@@ -2261,6 +2673,7 @@ static void mt5744SpaceRequestCallback(TapeParam *tp)
         {
         return;
         }
+    metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, tp->requestTime);
     tp->isBusy = FALSE;
     tp->isEOT  = FALSE;
     tp->isBOT  = FALSE;
@@ -2303,6 +2716,11 @@ static void mt5744SpaceRequestCallback(TapeParam *tp)
 **------------------------------------------------------------------------*/
 void mt5744UnloadTape(TapeParam *tp)
     {
+    /*
+    **  Responses to outstanding read-ahead requests are still on their way.
+    */
+    tp->discardCount += tp->raPending;
+    tp->raPending     = 0;
     mt5744ResetUnit(tp);
 #if DEBUG
     fprintf(mt5744Log, "\n%010u Dismount CH:%02o u%d", traceSequenceNo, tp->channelNo, tp->unitNo);
@@ -2321,6 +2739,7 @@ void mt5744UnloadTape(TapeParam *tp)
 **------------------------------------------------------------------------*/
 static void mt5744WriteRequestCallback(TapeParam *tp)
     {
+    long count;
     char *eor;
     int  status;
 
@@ -2329,10 +2748,30 @@ static void mt5744WriteRequestCallback(TapeParam *tp)
         {
         return;
         }
-    tp->isBusy = FALSE;
     if (status == 200)
         {
         tp->isBOT = FALSE;
+        if (tp->writesUnacked > 0)
+            {
+            /*
+            **  A batched acknowledgement: "200 <count> written".
+            */
+            count = strtol((char *)&tp->inputBuffer.data[4], NULL, 10);
+            if (count < 1)
+                {
+                count = 1;
+                }
+            else if (count > (long)tp->writesUnacked)
+                {
+                count = tp->writesUnacked;
+                }
+            tp->writesUnacked -= (u32)count;
+            mt5744ReleaseWrite(tp);
+            }
+        else
+            {
+            tp->isBusy = FALSE;
+            }
         }
     else
         {
@@ -363,6 +363,7 @@ static FcStatus mt607Func(PpWord funcCode)
         **  Read and verify the actual raw data.
         */
         len = (u32)fread(rawBuffer, 1, recLen1, activeDevice->fcb[activeDevice->selectedUnit]);
+        metricsCountIo(DtMt607, FALSE, len);
 
         if (recLen1 != (u32)len)
             {
@@ -31,6 +31,7 @@
 **  Include Files
 **  -------------
 */
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #ifndef WIN32
@@ -273,6 +274,7 @@ typedef struct tapeParam
     PpWord           recordLength;
     PpWord           ioBuffer[MaxPpBuf];
     PpWord           *bp;
+    MetricsUnit      *stats;
     } TapeParam;
 
 /*
@@ -280,6 +282,7 @@ typedef struct tapeParam
 **  Private Function Prototypes
 **  ---------------------------
 */
+static void mt669InstallTape(MediaMount *mp);
 static void mt669ResetStatus(TapeParam *tp);
 static void mt669SetupGeneralStatus(TapeParam *tp);
 static void mt669SetupDetailedStatus(TapeParam *tp);
@@ -445,7 +448,7 @@ void mt669Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     if (deviceName != NULL)
         {
         strcpy(tp->fileName, deviceName);
-        fcb = fopen(deviceName, "rb");
+        fcb = tapeImageOpen(deviceName, "rb");
         if (fcb == NULL)
             {
             logDtError(LogErrorLocation, "Failed to open %s\n", deviceName);
@@ -469,6 +472,7 @@ void mt669Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     tp->channelNo = channelNo;
     tp->eqNo      = eqNo;
     tp->unitNo    = unitNo;
+    tp->stats     = metricsRegisterUnit(DtMt669, channelNo, eqNo, unitNo);
 
     /*
     **  All initially mounted tapes are read only.
@@ -513,15 +517,21 @@ void mt669Terminate(DevSlot *dp)
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Load a new tape (operator interface).
+**  Purpose:        Open the image of a tape to be loaded (operator
+**                  interface).
+**
+**                  This is called on the operator thread.  The opened
+**                  image is installed on the unit by the emulation thread
+**                  through mp->install.
 **
 **  Parameters:     Name        Description.
 **                  params      parameters
+**                  mp          (out) opened medium
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if the image was opened.
 **
 **------------------------------------------------------------------------*/
-void mt669LoadTape(char *params)
+bool mt669OpenTape(char *params, MediaMount *mp)
     {
     static char str[200];
     DevSlot     *dp;
@@ -545,35 +555,35 @@ void mt669LoadTape(char *params)
         {
         opDisplay("(mt669  ) Not enough or invalid parameters\n");
 
-        return;
+        return FALSE;
         }
 
     if ((channelNo < 0) || (channelNo >= MaxChannels))
         {
         opDisplay("(mt669  ) Invalid channel no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitNo < 0) || (unitNo >= MaxUnits))
         {
         opDisplay("(mt669  ) Invalid unit no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitMode != 'w') && (unitMode != 'r'))
         {
         opDisplay("(mt669  ) Invalid ring mode (r/w)\n");
 
-        return;
+        return FALSE;
         }
 
     if (str[0] == 0)
         {
         opDisplay("(mt669  ) Invalid file name\n");
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -582,7 +592,7 @@ void mt669LoadTape(char *params)
     dp = channelFindDevice((u8)channelNo, DtMt669);
     if (dp == NULL)
         {
-        return;
+        return FALSE;
         }
 
     /*
@@ -593,7 +603,7 @@ void mt669LoadTape(char *params)
         {
         opDisplay("(mt669  ) Unit %d not allocated\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -603,7 +613,7 @@ void mt669LoadTape(char *params)
         {
         opDisplay("(mt669  ) Unit %d not unloaded\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -611,19 +621,17 @@ void mt669LoadTape(char *params)
     */
     if (unitMode == 'w')
         {
-        fcb = fopen(str, "r+b");
-        if (fcb == NULL)
+        fcb = tapeImageOpen(str, "r+b");
+        if ((fcb == NULL) && (errno == ENOENT))
             {
             fcb = fopen(str, "w+b");
             }
         }
     else
         {
-        fcb = fopen(str, "rb");
+        fcb = tapeImageOpen(str, "rb");
         }
 
-    dp->fcb[unitNo] = fcb;
-
     /*
     **  Check if the open succeeded.
     */
@@ -631,23 +639,18 @@ void mt669LoadTape(char *params)
         {
         opDisplay("(mt669  ) Failed to open %s\n", str);
 
-        return;
+        return FALSE;
         }
 
-    /*
-    **  Setup show_tape path name.
-    */
-    strcpy(tp->fileName, str);
-
-    /*
-    **  Setup status.
-    */
-    mt669ResetStatus(tp);
-    tp->ringIn    = unitMode == 'w';
-    tp->blockNo   = 0;
-    tp->unitReady = TRUE;
+    mp->install = mt669InstallTape;
+    mp->dp      = dp;
+    mp->unitNo  = unitNo;
+    mp->fcb     = fcb;
+    mp->auxFcb  = NULL;
+    mp->ringIn  = unitMode == 'w';
+    strcpy(mp->fileName, str);
 
-    opDisplay("(mt669  ) Successfully loaded %s\n", str);
+    return TRUE;
     }
 
 /*--------------------------------------------------------------------------
@@ -789,6 +792,50 @@ void mt669ShowTapeStatus()
  **--------------------------------------------------------------------------
  */
 /*--------------------------------------------------------------------------
+**  Purpose:        Install a tape image opened by mt669OpenTape on its
+**                  unit.  Called on the emulation thread.
+**
+**  Parameters:     Name        Description.
+**                  mp          opened medium
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt669InstallTape(MediaMount *mp)
+    {
+    TapeParam *tp;
+
+    /*
+    **  Another tape may have been loaded while this one was opened.
+    */
+    if (mp->dp->fcb[mp->unitNo] != NULL)
+        {
+        opDisplay("(mt669  ) Unit %d not unloaded\n", mp->unitNo);
+        fclose(mp->fcb);
+
+        return;
+        }
+
+    tp                      = (TapeParam *)mp->dp->context[mp->unitNo];
+    mp->dp->fcb[mp->unitNo] = mp->fcb;
+
+    /*
+    **  Setup show_tape path name.
+    */
+    strcpy(tp->fileName, mp->fileName);
+
+    /*
+    **  Setup status.
+    */
+    mt669ResetStatus(tp);
+    tp->ringIn    = mp->ringIn;
+    tp->blockNo   = 0;
+    tp->unitReady = TRUE;
+
+    opDisplay("(mt669  ) Successfully loaded %s\n", mp->fileName);
+    }
+
+/*--------------------------------------------------------------------------
 **  Purpose:        Reset device status at start of new function.
 **
 **  Parameters:     Name        Description.
@@ -1042,6 +1089,7 @@ static void mt669SetupUnitReadyStatus(void)
 static FcStatus mt669Func(PpWord funcCode)
     {
     u32       recLen1;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     CtrlParam *cp = activeDevice->controllerContext;
@@ -1155,7 +1203,9 @@ static FcStatus mt669Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt669ResetStatus(tp);
+            start = getMicroseconds();
             fseek(activeDevice->fcb[unitNo], 0, SEEK_SET);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             if (tp->blockNo != 0)
                 {
                 if (!tp->rewinding)
@@ -1186,10 +1236,12 @@ static FcStatus mt669Func(PpWord funcCode)
             {
             mt669ResetStatus(tp);
 
+            start = getMicroseconds();
             do
                 {
                 mt669FuncForespace();
                 } while (!tp->fileMark && !tp->endOfTape && !tp->alert);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1199,10 +1251,12 @@ static FcStatus mt669Func(PpWord funcCode)
             {
             mt669ResetStatus(tp);
 
+            start = getMicroseconds();
             do
                 {
                 mt669FuncBackspace();
                 } while (!tp->fileMark && tp->blockNo != 0 && !tp->alert);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         if (tp->blockNo == 0)
@@ -1231,7 +1285,9 @@ static FcStatus mt669Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt669ResetStatus(tp);
+            start = getMicroseconds();
             mt669FuncForespace();
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1240,7 +1296,9 @@ static FcStatus mt669Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt669ResetStatus(tp);
+            start = getMicroseconds();
             mt669FuncBackspace();
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1518,7 +1576,7 @@ static void mt669Io(void)
         return;
         }
 
-    activeChannel->delayStatus = 5;
+    channelDelayStatus(activeChannel, 5);
 
     /*
     **  Setup selected unit context.
@@ -1749,7 +1807,7 @@ static void mt669Io(void)
                     */
                     activeDevice->fcode            = 0;
                     activeChannel->discAfterInput  = TRUE;
-                    activeChannel->delayDisconnect = 50;
+                    channelDelayDisconnect(activeChannel, 50);
                     }
                 else
                     {
@@ -1757,7 +1815,7 @@ static void mt669Io(void)
                     **  Force a disconnect if the PP didn't read the status for too many cycles.
                     **  This is needed for SMM/KRONOS which expect only one status word.
                     */
-                    activeChannel->delayDisconnect = 50;
+                    channelDelayDisconnect(activeChannel, 50);
                     }
                 }
             }
@@ -1858,7 +1916,7 @@ static void mt669Io(void)
 **------------------------------------------------------------------------*/
 static void mt669Activate(void)
     {
-    activeChannel->delayStatus = 5;
+    channelDelayStatus(activeChannel, 5);
     }
 
 /*--------------------------------------------------------------------------
@@ -1879,6 +1937,7 @@ static void mt669Disconnect(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     PpWord    *ip;
     u8        *rp;
     u8        *writeConv;
@@ -1923,13 +1982,7 @@ static void mt669Disconnect(void)
         /*
         **  No conversion, just unpack.
         */
-        for (i = 0; i < recLen2; i += 2)
-            {
-            *rp++ = ((ip[0] >> 4) & 0xFF);
-            *rp++ = ((ip[0] << 4) & 0xF0) | ((ip[1] >> 8) & 0x0F);
-            *rp++ = ((ip[1] >> 0) & 0xFF);
-            ip   += 2;
-            }
+        charsetUnpack12To8(rawBuffer, ip, recLen2);
 
         /*
         **  Now implement the Mode 1 Write table on page B-6 of the
@@ -1997,6 +2050,8 @@ static void mt669Disconnect(void)
         recLen1 = recLen0;
         }
 
+    start = getMicroseconds();
+
     /*
     **  The following fseek makes fwrite behave as desired after an fread.
     */
@@ -2008,6 +2063,7 @@ static void mt669Disconnect(void)
     fwrite(&recLen1, sizeof(recLen1), 1, fcb);
     fwrite(&rawBuffer, 1, recLen0, fcb);
     fwrite(&recLen1, sizeof(recLen1), 1, fcb);
+    metricsCountUnitIo(tp->stats, MetricsIoWrite, recLen0, start);
 
     /*
     **  The following fseek prepares for any subsequent fread.
@@ -2040,7 +2096,7 @@ static void mt669PackAndConvert(u32 recLen)
     TapeParam *tp    = activeDevice->context[unitNo];
     CtrlParam *cp    = activeDevice->controllerContext;
     u32       i;
-    u16       c1, c2, c3;
+    u16       c1;
     u16       *op;
     u8        *rp;
     u8        *readConv;
@@ -2075,30 +2131,11 @@ static void mt669PackAndConvert(u32 recLen)
             }
 
         /*
-        **  Convert the raw data into PP Word data.
-        */
-        for (i = 0; i < recLen; i += 3)
-            {
-            c1 = *rp++;
-            c2 = *rp++;
-            c3 = *rp++;
-
-            *op++ = ((c1 << 4) | (c2 >> 4)) & Mask12;
-            *op++ = ((c2 << 8) | (c3 >> 0)) & Mask12;
-            }
-
-        /*
-        **  Now calculate the number of PP words taking into account the
-        **  16 bit TCU words. This seems strange at first, but the table
-        **  referenced above illustrates it clearly.
+        **  Convert the raw data into PP Word data. The number of PP words
+        **  takes the 16 bit TCU words into account. This seems strange at
+        **  first, but the table referenced above illustrates it clearly.
         */
-        recLen *= 8;
-        activeDevice->recordLength = (PpWord)(recLen / 12);
-        if (recLen % 12 != 0)
-            {
-            activeDevice->recordLength += 1;
-            }
-
+        activeDevice->recordLength = (PpWord)charsetPack8To12(tp->ioBuffer, rawBuffer, recLen);
         break;
 
     case 1:
@@ -2154,12 +2191,14 @@ static void mt669FuncRead(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     long      position;
 
     unitNo = activeDevice->selectedUnit;
     tp     = (TapeParam *)activeDevice->context[unitNo];
+    start  = getMicroseconds();
 
     activeDevice->recordLength = 0;
     tp->recordLength           = 0;
@@ -2235,6 +2274,7 @@ static void mt669FuncRead(void)
     **  Read and verify the actual raw data.
     */
     len = (u32)fread(rawBuffer, 1, recLen1, activeDevice->fcb[unitNo]);
+    metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
     if (recLen1 != (u32)len)
         {
@@ -2320,12 +2360,14 @@ static void mt669FuncReadBkw(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     long      position;
 
     unitNo = activeDevice->selectedUnit;
     tp     = (TapeParam *)activeDevice->context[unitNo];
+    start  = getMicroseconds();
 
     activeDevice->recordLength = 0;
     tp->recordLength           = 0;
@@ -2430,6 +2472,7 @@ static void mt669FuncReadBkw(void)
         **  Read and verify the actual raw data.
         */
         len = (u32)fread(rawBuffer, 1, recLen1, activeDevice->fcb[unitNo]);
+        metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
         if (recLen1 != (u32)len)
             {
@@ -31,6 +31,7 @@
 **  Include Files
 **  -------------
 */
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #ifndef WIN32
@@ -202,6 +203,7 @@ typedef struct tapeParam
     PpWord           deviceStatus[17]; // first element not used
     PpWord           ioBuffer[MaxPpBuf];
     PpWord           *bp;
+    MetricsUnit      *stats;
     } TapeParam;
 
 /*
@@ -209,6 +211,7 @@ typedef struct tapeParam
 **  Private Function Prototypes
 **  ---------------------------
 */
+static void mt679InstallTape(MediaMount *mp);
 static void mt679ResetStatus(TapeParam *tp);
 static void mt679SetupStatus(TapeParam *tp);
 static void mt679PackConversionTable(u8 *convTable);
@@ -375,7 +378,7 @@ void mt679Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     if (deviceName != NULL)
         {
         strcpy(tp->fileName, deviceName);
-        fcb = fopen(deviceName, "rb");
+        fcb = tapeImageOpen(deviceName, "rb");
         if (fcb == NULL)
             {
             logDtError(LogErrorLocation, "Failed to open %s\n", deviceName);
@@ -399,6 +402,7 @@ void mt679Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName)
     tp->channelNo = channelNo;
     tp->eqNo      = eqNo;
     tp->unitNo    = unitNo;
+    tp->stats     = metricsRegisterUnit(DtMt679, channelNo, eqNo, unitNo);
 
     /*
     **  All initially mounted tapes are read only.
@@ -443,15 +447,21 @@ void mt679Terminate(DevSlot *dp)
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Load a new tape (operator interface).
+**  Purpose:        Open the image of a tape to be loaded (operator
+**                  interface).
+**
+**                  This is called on the operator thread.  The opened
+**                  image is installed on the unit by the emulation thread
+**                  through mp->install.
 **
 **  Parameters:     Name        Description.
 **                  params      parameters
+**                  mp          (out) opened medium
 **
-**  Returns:        Nothing.
+**  Returns:        TRUE if the image was opened.
 **
 **------------------------------------------------------------------------*/
-void mt679LoadTape(char *params)
+bool mt679OpenTape(char *params, MediaMount *mp)
     {
     static char str[200];
     DevSlot     *dp;
@@ -475,35 +485,35 @@ void mt679LoadTape(char *params)
         {
         opDisplay("(mt679  ) Not enough or invalid parameters\n");
 
-        return;
+        return FALSE;
         }
 
     if ((channelNo < 0) || (channelNo >= MaxChannels))
         {
         opDisplay("(mt679  ) Invalid channel no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitNo < 0) || (unitNo >= MaxUnits))
         {
         opDisplay("(mt679  ) Invalid unit no\n");
 
-        return;
+        return FALSE;
         }
 
     if ((unitMode != 'w') && (unitMode != 'r'))
         {
         opDisplay("(mt679  ) Invalid ring mode (r/w)\n");
 
-        return;
+        return FALSE;
         }
 
     if (str[0] == 0)
         {
         opDisplay("(mt679  ) Invalid file name\n");
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -512,7 +522,7 @@ void mt679LoadTape(char *params)
     dp = channelFindDevice((u8)channelNo, DtMt679);
     if (dp == NULL)
         {
-        return;
+        return FALSE;
         }
 
     /*
@@ -523,7 +533,7 @@ void mt679LoadTape(char *params)
         {
         opDisplay("(mt679  ) Unit %d not allocated\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -533,7 +543,7 @@ void mt679LoadTape(char *params)
         {
         opDisplay("(mt679  ) Unit %d not unloaded\n", unitNo);
 
-        return;
+        return FALSE;
         }
 
     /*
@@ -541,19 +551,17 @@ void mt679LoadTape(char *params)
     */
     if (unitMode == 'w')
         {
-        fcb = fopen(str, "r+b");
-        if (fcb == NULL)
+        fcb = tapeImageOpen(str, "r+b");
+        if ((fcb == NULL) && (errno == ENOENT))
             {
             fcb = fopen(str, "w+b");
             }
         }
     else
         {
-        fcb = fopen(str, "rb");
+        fcb = tapeImageOpen(str, "rb");
         }
 
-    dp->fcb[unitNo] = fcb;
-
     /*
     **  Check if the open succeeded.
     */
@@ -561,23 +569,18 @@ void mt679LoadTape(char *params)
         {
         opDisplay("(mt679  ) Failed to open %s\n", str);
 
-        return;
+        return FALSE;
         }
 
-    /*
-    **  Setup show_tape path name.
-    */
-    strcpy(tp->fileName, str);
+    mp->install = mt679InstallTape;
+    mp->dp      = dp;
+    mp->unitNo  = unitNo;
+    mp->fcb     = fcb;
+    mp->auxFcb  = NULL;
+    mp->ringIn  = unitMode == 'w';
+    strcpy(mp->fileName, str);
 
-    /*
-    **  Setup status.
-    */
-    mt679ResetStatus(tp);
-    tp->ringIn    = unitMode == 'w';
-    tp->blockNo   = 0;
-    tp->unitReady = TRUE;
-
-    opDisplay("(mt679  ) Successfully loaded %s\n", str);
+    return TRUE;
     }
 
 /*--------------------------------------------------------------------------
@@ -719,6 +722,50 @@ void mt679ShowTapeStatus()
  **--------------------------------------------------------------------------
  */
 /*--------------------------------------------------------------------------
+**  Purpose:        Install a tape image opened by mt679OpenTape on its
+**                  unit.  Called on the emulation thread.
+**
+**  Parameters:     Name        Description.
+**                  mp          opened medium
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void mt679InstallTape(MediaMount *mp)
+    {
+    TapeParam *tp;
+
+    /*
+    **  Another tape may have been loaded while this one was opened.
+    */
+    if (mp->dp->fcb[mp->unitNo] != NULL)
+        {
+        opDisplay("(mt679  ) Unit %d not unloaded\n", mp->unitNo);
+        fclose(mp->fcb);
+
+        return;
+        }
+
+    tp                      = (TapeParam *)mp->dp->context[mp->unitNo];
+    mp->dp->fcb[mp->unitNo] = mp->fcb;
+
+    /*
+    **  Setup show_tape path name.
+    */
+    strcpy(tp->fileName, mp->fileName);
+
+    /*
+    **  Setup status.
+    */
+    mt679ResetStatus(tp);
+    tp->ringIn    = mp->ringIn;
+    tp->blockNo   = 0;
+    tp->unitReady = TRUE;
+
+    opDisplay("(mt679  ) Successfully loaded %s\n", mp->fileName);
+    }
+
+/*--------------------------------------------------------------------------
 **  Purpose:        Reset device status at start of new function.
 **
 **  Parameters:     Name        Description.
@@ -1051,6 +1098,7 @@ static void mt679Unpack6BitTable(u8 *convTable)
 static FcStatus mt679Func(PpWord funcCode)
     {
     u32       recLen1;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     CtrlParam *cp = activeDevice->controllerContext;
@@ -1166,7 +1214,9 @@ static FcStatus mt679Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt679ResetStatus(tp);
+            start = getMicroseconds();
             fseek(activeDevice->fcb[unitNo], 0, SEEK_SET);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             if (tp->blockNo != 0)
                 {
                 if (!tp->rewinding)
@@ -1217,7 +1267,9 @@ static FcStatus mt679Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt679ResetStatus(tp);
+            start = getMicroseconds();
             mt679FuncForespace();
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1226,7 +1278,9 @@ static FcStatus mt679Func(PpWord funcCode)
         if ((unitNo != -1) && tp->unitReady)
             {
             mt679ResetStatus(tp);
+            start = getMicroseconds();
             mt679FuncBackspace();
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1241,10 +1295,12 @@ static FcStatus mt679Func(PpWord funcCode)
             {
             mt679ResetStatus(tp);
 
+            start = getMicroseconds();
             do
                 {
                 mt679FuncForespace();
                 } while (!tp->fileMark && !tp->endOfTape && !tp->alert);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         return (FcProcessed);
@@ -1254,10 +1310,12 @@ static FcStatus mt679Func(PpWord funcCode)
             {
             mt679ResetStatus(tp);
 
+            start = getMicroseconds();
             do
                 {
                 mt679FuncBackspace();
                 } while (!tp->fileMark && tp->blockNo != 0 && !tp->alert);
+            metricsCountUnitIo(tp->stats, MetricsIoPosition, 0, start);
             }
 
         if (tp->blockNo == 0)
@@ -1556,7 +1614,7 @@ static void mt679Io(void)
         return;
         }
 
-    activeChannel->delayStatus = 3;
+    channelDelayStatus(activeChannel, 3);
 
     /*
     **  Setup selected unit context.
@@ -1715,7 +1773,7 @@ static void mt679Io(void)
                 /*
                 **  It appears that NOS/BE relies on the disconnect to happen delayed.
                 */
-                activeChannel->delayDisconnect = 10;
+                channelDelayDisconnect(activeChannel, 10);
                 }
             }
         break;
@@ -1821,7 +1879,7 @@ static void mt679Activate(void)
             activePpu->id,
             activeDevice->channel->id);
 #endif
-    activeChannel->delayStatus = 5;
+    channelDelayStatus(activeChannel, 5);
     }
 
 /*--------------------------------------------------------------------------
@@ -1909,6 +1967,7 @@ static void mt679FlushWrite(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     PpWord    *ip;
     u8        *rp;
     u8        *writeConv;
@@ -1943,21 +2002,12 @@ static void mt679FlushWrite(void)
         /*
         **  No conversion, just unpack.
         */
-        for (i = 0; i < recLen2; i += 2)
-            {
-            *rp++ = ((ip[0] >> 4) & 0xFF);
-            *rp++ = ((ip[0] << 4) & 0xF0) | ((ip[1] >> 8) & 0x0F);
-            *rp++ = ((ip[1] >> 0) & 0xFF);
-            ip   += 2;
-            }
+        recLen0 = (u32)charsetUnpack12To8(rawBuffer, ip, recLen2);
 
-        recLen0 = (u32)(rp - rawBuffer);
-
-        if ((recLen2 & 1) != 0)
-            {
-            recLen0 -= 2;
-            }
-        else if (cp->oddFrameCount)
+        /*
+        **  An odd word count leaves four bits, which are dropped.
+        */
+        if (((recLen2 & 1) != 0) || cp->oddFrameCount)
             {
             recLen0 -= 1;
             }
@@ -1999,6 +2049,8 @@ static void mt679FlushWrite(void)
         recLen1 = recLen0;
         }
 
+    start = getMicroseconds();
+
     /*
     **  The following fseek makes fwrite behave as desired after an fread.
     */
@@ -2010,6 +2062,7 @@ static void mt679FlushWrite(void)
     fwrite(&recLen1, sizeof(recLen1), 1, fcb);
     fwrite(&rawBuffer, 1, recLen0, fcb);
     fwrite(&recLen1, sizeof(recLen1), 1, fcb);
+    metricsCountUnitIo(tp->stats, MetricsIoWrite, recLen0, start);
 
     /*
     **  The following fseek prepares for any subsequent fread.
@@ -2038,7 +2091,7 @@ static void mt679PackAndConvert(u32 recLen)
     TapeParam *tp    = activeDevice->context[unitNo];
     CtrlParam *cp    = activeDevice->controllerContext;
     u32       i;
-    u16       c1, c2, c3;
+    u16       c1;
     u16       *op;
     u8        *rp;
     u8        *readConv;
@@ -2049,12 +2102,6 @@ static void mt679PackAndConvert(u32 recLen)
     op = tp->ioBuffer;
     rp = rawBuffer;
 
-    /*
-    **  Fill the last few bytes with zeroes.
-    */
-    rawBuffer[recLen + 0] = 0;
-    rawBuffer[recLen + 1] = 0;
-
     switch (cp->selectedConversion)
         {
     default:
@@ -2064,30 +2111,10 @@ static void mt679PackAndConvert(u32 recLen)
         /*
         **  Convert the raw data into PP Word data.
         */
-        for (i = 0; i < recLen; i += 3)
+        activeDevice->recordLength = (PpWord)charsetPack8To12(tp->ioBuffer, rawBuffer, recLen);
+        if ((recLen % 3) == 2)
             {
-            c1 = *rp++;
-            c2 = *rp++;
-            c3 = *rp++;
-
-            *op++ = ((c1 << 4) | (c2 >> 4)) & Mask12;
-            *op++ = ((c2 << 8) | (c3 >> 0)) & Mask12;
-            }
-
-        activeDevice->recordLength = (PpWord)(op - tp->ioBuffer);
-
-        switch (recLen % 3)
-            {
-        default:
-            break;
-
-        case 1:     /* 2 words + 8 bits */
-            activeDevice->recordLength -= 1;
-            break;
-
-        case 2:
             tp->characterFill = TRUE;
-            break;
             }
         break;
 
@@ -2146,12 +2173,14 @@ static void mt679FuncRead(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     long      position;
 
     unitNo = activeDevice->selectedUnit;
     tp     = (TapeParam *)activeDevice->context[unitNo];
+    start  = getMicroseconds();
 
     activeDevice->recordLength = 0;
     tp->recordLength           = 0;
@@ -2227,6 +2256,7 @@ static void mt679FuncRead(void)
     **  Read and verify the actual raw data.
     */
     len = (u32)fread(rawBuffer, 1, recLen1, activeDevice->fcb[unitNo]);
+    metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
     if (recLen1 != (u32)len)
         {
@@ -2311,12 +2341,14 @@ static void mt679FuncReadBkw(void)
     u32       recLen0;
     u32       recLen1;
     u32       recLen2;
+    u64       start;
     i8        unitNo;
     TapeParam *tp;
     long      position;
 
     unitNo = activeDevice->selectedUnit;
     tp     = (TapeParam *)activeDevice->context[unitNo];
+    start  = getMicroseconds();
 
     activeDevice->recordLength = 0;
     tp->recordLength           = 0;
@@ -2421,6 +2453,7 @@ static void mt679FuncReadBkw(void)
         **  Read and verify the actual raw data.
         */
         len = (u32)fread(rawBuffer, 1, recLen1, activeDevice->fcb[unitNo]);
+        metricsCountUnitIo(tp->stats, MetricsIoRead, len, start);
 
         if (recLen1 != (u32)len)
             {
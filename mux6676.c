@@ -99,10 +99,11 @@
 
 typedef struct portGroup
     {
-    int       listenFd;
-    int       listenPort;
-    int       portIndex;
-    int       portCount;
+    int          listenFd;
+    NetPollEntry listenPoll;
+    int          listenPort;
+    int          portIndex;
+    int          portCount;
     } PortGroup;
 
 typedef struct portParam
@@ -114,6 +115,7 @@ typedef struct portParam
     bool            enabled;
     bool            carrierOn;
     int             connFd;
+    NetPollEntry    poll;
     int             inInIdx;
     int             inOutIdx;
     u8              inBuffer[InBufSize];
@@ -435,6 +437,7 @@ static void mux667xInit(u8 eqNo, u8 channelNo, u8 muxType, char *params)
                 logDtError(LogErrorLocation, "Can't listen for %s on port %d\n", mts, listenPort);
                 exit(1);
                 }
+            netPollAdd(&gp->listenPoll, gp->listenFd, 0);
             }
 
         /*
@@ -866,17 +869,15 @@ static void mux667xCheckIo(MuxParam *mp)
 #else
     socklen_t fromLen;
 #endif
+    bool           acceptWanted[MaxPortGroups];
+    u8             events;
     int            fd;
     int            g;
     PortGroup      *gp;
     int            i;
-    int            maxFd;
     ssize_t        n;
     int            optEnable = 1;
     PortParam      *pp;
-    fd_set         readFds;
-    struct timeval timeout;
-    fd_set         writeFds;
 
     mp->ioTurns = (mp->ioTurns + 1) % IoTurnsPerPoll;
     if (mp->ioTurns != 0)
@@ -884,62 +885,27 @@ static void mux667xCheckIo(MuxParam *mp)
         return;
         }
 
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-    maxFd = 0;
-
+    /*
+    **  Declare what each port is ready for and act on the readiness found
+    **  by the network poller.
+    */
+    memset(acceptWanted, 0, sizeof(acceptWanted));
     for (i = 0, pp = mp->ports; i < mp->portCount; i++, pp++)
         {
         if (pp->active)
             {
+            events = 0;
             if (pp->inInIdx < InBufSize)
                 {
-                FD_SET(pp->connFd, &readFds);
-                if (pp->connFd > maxFd)
-                    {
-                    maxFd = pp->connFd;
-                    }
-                }
-            if (pp->carrierOn)
-                {
-                if (pp->outInIdx > pp->outOutIdx)
-                    {
-                    FD_SET(pp->connFd, &writeFds);
-                    if (pp->connFd > maxFd)
-                        {
-                        maxFd = pp->connFd;
-                        }
-                    }
+                events |= NetPollIn;
                 }
-            }
-        else if (pp->enabled && (pp->group->listenFd != 0) && !FD_ISSET(pp->group->listenFd, &readFds))
-            {
-            FD_SET(pp->group->listenFd, &readFds);
-            if (pp->group->listenFd > maxFd)
+            if (pp->carrierOn && (pp->outInIdx > pp->outOutIdx))
                 {
-                maxFd = pp->group->listenFd;
+                events |= NetPollOut;
                 }
-            }
-        }
+            netPollWant(&pp->poll, events);
 
-    if (maxFd < 1)
-        {
-        return;
-        }
-
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
-    if (n < 1)
-        {
-        return;
-        }
-
-    for (i = 0, pp = mp->ports; i < mp->portCount; i++, pp++)
-        {
-        if (pp->active)
-            {
-            if (FD_ISSET(pp->connFd, &readFds))
+            if (netPollTake(&pp->poll, NetPollIn))
                 {
                 n = recv(pp->connFd, &pp->inBuffer[pp->inInIdx], InBufSize - pp->inInIdx, 0);
                 if (n > 0)
@@ -969,7 +935,7 @@ static void mux667xCheckIo(MuxParam *mp)
                     mux667xClose(pp);
                     }
                 }
-            if (FD_ISSET(pp->connFd, &writeFds) && (pp->outOutIdx < pp->outInIdx))
+            if (netPollTake(&pp->poll, NetPollOut) && (pp->outOutIdx < pp->outInIdx))
                 {
                 n = send(pp->connFd, &pp->outBuffer[pp->outOutIdx], pp->outInIdx - pp->outOutIdx, 0);
                 if (n >= 0)
@@ -1001,10 +967,19 @@ static void mux667xCheckIo(MuxParam *mp)
                     }
                 }
             }
+        else if (pp->enabled)
+            {
+            acceptWanted[pp->group - mp->portGroups] = TRUE;
+            }
         }
     for (g = 0, gp = &mp->portGroups[0]; g < MaxPortGroups && gp->portCount > 0; g++, gp++)
         {
-        if ((gp->listenFd != 0) && FD_ISSET(gp->listenFd, &readFds))
+        if (gp->listenFd == 0)
+            {
+            continue;
+            }
+        netPollWant(&gp->listenPoll, acceptWanted[g] ? NetPollIn : 0);
+        if (netPollTake(&gp->listenPoll, NetPollIn))
             {
             fromLen = sizeof(from);
             fd      = (int)accept(gp->listenFd, (struct sockaddr *)&from, &fromLen);
@@ -1026,6 +1001,7 @@ static void mux667xCheckIo(MuxParam *mp)
                 {
                 availablePort->active    = TRUE;
                 availablePort->connFd    = fd;
+                netPollAdd(&availablePort->poll, fd, 0);
                 availablePort->inInIdx   = 0;
                 availablePort->inOutIdx  = 0;
                 availablePort->outInIdx  = 0;
@@ -1114,6 +1090,7 @@ static bool mux667xInputRequired(MuxParam *mp)
 **------------------------------------------------------------------------*/
 static void mux667xClose(PortParam *pp)
     {
+    netPollRemove(&pp->poll);
     netCloseConnection(pp->connFd);
     pp->connFd    = 0;
     pp->active    = FALSE;
@@ -6,7 +6,9 @@
 **
 **  Description:
 **      Provides TCP/IP utility functions that are independent of the
-**      underlying host operating system.
+**      underlying host operating system, and a poller which finds the
+**      ready sockets of all registered devices with a single system call
+**      (epoll on Linux, select elsewhere).
 **
 **  This program is free software: you can redistribute it and/or modify
 **  it under the terms of the GNU General Public License version 3 as
@@ -34,6 +36,7 @@
 #include <memory.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #if defined(_WIN32)
@@ -45,6 +48,13 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <sys/select.h>
+#endif
 #endif
 
 #include "proto.h"
@@ -55,6 +65,17 @@
 **  -----------------
 */
 #define MaxListenBacklog    100
+#define NetPollCycles       64
+#define NetPollMaxEvents    64
+
+/*
+**  Room for a dotted IP address and port, or a Unix domain socket path.
+*/
+#if defined(_WIN32)
+#define MaxAddressString    32
+#else
+#define MaxAddressString    (sizeof(((struct sockaddr_un *)0)->sun_path) + 1)
+#endif
 
 /*
 **  -----------------------
@@ -73,6 +94,11 @@
 **  Private Function Prototypes
 **  ---------------------------
 */
+#if defined(__linux__)
+static u32 netPollEpollEvents(u8 events);
+
+#endif
+static void netPollRun(void *arg);
 
 /*
 **  ----------------
@@ -85,6 +111,19 @@
 **  Private Variables
 **  -----------------
 */
+static NetPollEntry **netPollEntries = NULL;
+#if defined(_WIN32)
+static SOCKET       *netPollFds      = NULL;
+#else
+static int          *netPollFds      = NULL;
+#endif
+static int          netPollCount     = 0;
+static int          netPollSize      = 0;
+static SchedEvent   netPollEvent;
+static bool         netPollStarted   = FALSE;
+#if defined(__linux__)
+static int          netPollFd        = -1;
+#endif
 
 /*
  **--------------------------------------------------------------------------
@@ -229,6 +268,84 @@ int netCreateListener(int port)
     return sd;
     }
 
+#if !defined(_WIN32)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Create a listening Unix domain socket for connections
+**                  from other emulators on the same host. A stale socket
+**                  left behind by an earlier run is removed, but not one
+**                  on which another process is still listening.
+**
+**  Parameters:     Name        Description.
+**                  path        path name of the socket
+**
+**  Returns:        socket descriptor, or -1 on error
+**
+**------------------------------------------------------------------------*/
+int netCreateLocalListener(char *path)
+    {
+    int                probe;
+    int                rc;
+    int                sd;
+    struct sockaddr_un srcAddr;
+    struct stat        st;
+
+    if (strlen(path) >= sizeof(srcAddr.sun_path))
+        {
+        return -1;
+        }
+
+    memset(&srcAddr, 0, sizeof(srcAddr));
+    srcAddr.sun_family = AF_UNIX;
+    strcpy(srcAddr.sun_path, path);
+
+    if ((lstat(path, &st) == 0) && S_ISSOCK(st.st_mode))
+        {
+        probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe == -1)
+            {
+            return -1;
+            }
+        rc = connect(probe, (struct sockaddr *)&srcAddr, sizeof(srcAddr));
+        close(probe);
+        if ((rc == -1) && (errno == ECONNREFUSED))
+            {
+            unlink(path);
+            }
+        else
+            {
+#if DEBUG
+            fprintf(stderr, "(net_util) %s is in use\n", path);
+#endif
+
+            return -1;
+            }
+        }
+
+    sd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sd == -1)
+        {
+        return sd;
+        }
+
+    if ((bind(sd, (struct sockaddr *)&srcAddr, sizeof(srcAddr)) == -1)
+        || (listen(sd, MaxListenBacklog) == -1))
+        {
+#if DEBUG
+        perror("(net_util) netCreateLocalListener");
+#endif
+        close(sd);
+
+        return -1;
+        }
+
+    fcntl(sd, F_SETFL, O_NONBLOCK);
+
+    return sd;
+    }
+
+#endif
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Create a non-blocking socket bound to a specified port.
 **
@@ -352,7 +469,8 @@ int netGetErrorStatus(int sd)
 **  Parameters:     Name        Description.
 **                  sd          socket descriptor
 **
-**  Returns:        IP address and port number as a string
+**  Returns:        IP address and port number, or Unix domain socket
+**                  path, as a string
 **
 **------------------------------------------------------------------------*/
 #if defined(_WIN32)
@@ -361,11 +479,18 @@ char *netGetLocalTcpAddress(SOCKET sd)
 char *netGetLocalTcpAddress(int sd)
 #endif
     {
-    struct sockaddr_in hostAddr;
-    u32                ipAddr;
-    static char        outBuf[32];
-    u16                port;
-    int                rc;
+    u32         ipAddr;
+    static char outBuf[MaxAddressString];
+    u16         port;
+    int         rc;
+
+    union
+        {
+        struct sockaddr_in in;
+#if !defined(_WIN32)
+        struct sockaddr_un un;
+#endif
+        } hostAddr;
 
 #if defined(_WIN32)
     int addrLen;
@@ -373,12 +498,22 @@ char *netGetLocalTcpAddress(int sd)
     socklen_t addrLen;
 #endif
 
+    memset(&hostAddr, 0, sizeof(hostAddr));
     addrLen = sizeof(hostAddr);
     rc      = getsockname(sd, (struct sockaddr *)&hostAddr, &addrLen);
+#if !defined(_WIN32)
+    if ((rc == 0) && (hostAddr.un.sun_family == AF_UNIX))
+        {
+        snprintf(outBuf, sizeof(outBuf), "%.*s", (int)sizeof(hostAddr.un.sun_path),
+                 (hostAddr.un.sun_path[0] != '\0') ? hostAddr.un.sun_path : "local");
+
+        return outBuf;
+        }
+#endif
     if (rc == 0)
         {
-        ipAddr = ntohl(hostAddr.sin_addr.s_addr);
-        port   = ntohs(hostAddr.sin_port);
+        ipAddr = ntohl(hostAddr.in.sin_addr.s_addr);
+        port   = ntohs(hostAddr.in.sin_port);
         sprintf(outBuf, "%d.%d.%d.%d:%d",
                 (ipAddr >> 24) & 0xff,
                 (ipAddr >> 16) & 0xff,
@@ -400,7 +535,8 @@ char *netGetLocalTcpAddress(int sd)
 **  Parameters:     Name        Description.
 **                  sd          socket descriptor
 **
-**  Returns:        IP address and port number as a string
+**  Returns:        IP address and port number, or Unix domain socket
+**                  path, as a string
 **
 **------------------------------------------------------------------------*/
 #if defined(_WIN32)
@@ -409,11 +545,18 @@ char *netGetPeerTcpAddress(SOCKET sd)
 char *netGetPeerTcpAddress(int sd)
 #endif
     {
-    struct sockaddr_in hostAddr;
-    u32                ipAddr;
-    static char        outBuf[32];
-    u16                port;
-    int                rc;
+    u32         ipAddr;
+    static char outBuf[MaxAddressString];
+    u16         port;
+    int         rc;
+
+    union
+        {
+        struct sockaddr_in in;
+#if !defined(_WIN32)
+        struct sockaddr_un un;
+#endif
+        } hostAddr;
 
 #if defined(_WIN32)
     int addrLen;
@@ -421,12 +564,22 @@ char *netGetPeerTcpAddress(int sd)
     socklen_t addrLen;
 #endif
 
+    memset(&hostAddr, 0, sizeof(hostAddr));
     addrLen = sizeof(hostAddr);
     rc      = getpeername(sd, (struct sockaddr *)&hostAddr, &addrLen);
+#if !defined(_WIN32)
+    if ((rc == 0) && (hostAddr.un.sun_family == AF_UNIX))
+        {
+        snprintf(outBuf, sizeof(outBuf), "%.*s", (int)sizeof(hostAddr.un.sun_path),
+                 (hostAddr.un.sun_path[0] != '\0') ? hostAddr.un.sun_path : "local");
+
+        return outBuf;
+        }
+#endif
     if (rc == 0)
         {
-        ipAddr = ntohl(hostAddr.sin_addr.s_addr);
-        port   = ntohs(hostAddr.sin_port);
+        ipAddr = ntohl(hostAddr.in.sin_addr.s_addr);
+        port   = ntohs(hostAddr.in.sin_port);
         sprintf(outBuf, "%d.%d.%d.%d:%d",
                 (ipAddr >> 24) & 0xff,
                 (ipAddr >> 16) & 0xff,
@@ -511,6 +664,289 @@ int    netInitiateConnection(struct sockaddr *sap)
     return sd;
     }
 
+#if !defined(_WIN32)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Initiate a connection to a Unix domain socket of
+**                  another emulator on the same host.
+**
+**  Parameters:     Name        Description.
+**                  path        path name of the socket
+**
+**  Returns:        socket descriptor, or -1 on error
+**
+**------------------------------------------------------------------------*/
+int netInitiateLocalConnection(char *path)
+    {
+    struct sockaddr_un destAddr;
+    int                rc;
+    int                sd;
+
+    if (strlen(path) >= sizeof(destAddr.sun_path))
+        {
+        return -1;
+        }
+
+    sd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sd == -1)
+        {
+        return sd;
+        }
+    fcntl(sd, F_SETFL, O_NONBLOCK);
+
+    memset(&destAddr, 0, sizeof(destAddr));
+    destAddr.sun_family = AF_UNIX;
+    strcpy(destAddr.sun_path, path);
+    rc = connect(sd, (struct sockaddr *)&destAddr, sizeof(destAddr));
+    if ((rc == -1) && (errno != EINPROGRESS) && (errno != EAGAIN))
+        {
+#if DEBUG
+        perror("(net_util) connect");
+#endif
+        close(sd);
+
+        return -1;
+        }
+
+    return sd;
+    }
+
+#endif
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Register a socket with the network poller. Readiness
+**                  found by the poller is accumulated in the entry until
+**                  taken with netPollTake. A socket must be removed from
+**                  the poller before it is closed.
+**
+**  Parameters:     Name        Description.
+**                  ep          poll entry owned by the caller
+**                  sd          socket descriptor
+**                  events      readiness of interest (NetPollIn, NetPollOut)
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+#if defined(_WIN32)
+void netPollAdd(NetPollEntry *ep, SOCKET sd, u8 events)
+#else
+void netPollAdd(NetPollEntry *ep, int sd, u8 events)
+#endif
+    {
+#if defined(__linux__)
+    struct epoll_event ev;
+#endif
+
+    if (ep->slot != 0)
+        {
+        netPollRemove(ep);
+        }
+
+    if (!netPollStarted)
+        {
+#if defined(__linux__)
+        netPollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (netPollFd < 0)
+            {
+            logDtError(LogErrorLocation, "Failed to create network poller\n");
+            exit(1);
+            }
+#endif
+        schedInitEvent(&netPollEvent, netPollRun, NULL);
+        netPollStarted = TRUE;
+        }
+
+    if (netPollCount >= netPollSize)
+        {
+        netPollSize   += 64;
+        netPollEntries = (NetPollEntry **)realloc(netPollEntries, netPollSize * sizeof(NetPollEntry *));
+        netPollFds     = realloc(netPollFds, netPollSize * sizeof(*netPollFds));
+        if ((netPollEntries == NULL) || (netPollFds == NULL))
+            {
+            logDtError(LogErrorLocation, "Failed to allocate network poller table\n");
+            exit(1);
+            }
+        }
+
+#if defined(__linux__)
+    ev.events   = netPollEpollEvents(events);
+    ev.data.ptr = ep;
+    if ((events != 0) && (epoll_ctl(netPollFd, EPOLL_CTL_ADD, sd, &ev) != 0))
+        {
+        logDtError(LogErrorLocation, "Failed to register socket with network poller, errno=%d\n", errno);
+
+        return;
+        }
+#endif
+
+    ep->events                   = events;
+    ep->revents                  = 0;
+    netPollEntries[netPollCount] = ep;
+    netPollFds[netPollCount]     = sd;
+    netPollCount                += 1;
+    ep->slot                     = netPollCount;
+    if (netPollCount == 1)
+        {
+        schedAfter(&netPollEvent, NetPollCycles);
+        }
+    }
+
+#if !defined(_WIN32)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Add the descriptors which signal network input to a
+**                  descriptor set, so that an idle wait ends when a
+**                  registered socket becomes readable.
+**
+**  Parameters:     Name        Description.
+**                  fds         pointer to descriptor set
+**                  maxFd       highest descriptor already in the set
+**
+**  Returns:        Highest descriptor in the set.
+**
+**------------------------------------------------------------------------*/
+int netPollAddIdleFds(fd_set *fds, int maxFd)
+    {
+#if defined(__linux__)
+    if (netPollCount > 0)
+        {
+        FD_SET(netPollFd, fds);
+        if (netPollFd > maxFd)
+            {
+            maxFd = netPollFd;
+            }
+        }
+#else
+    int i;
+
+    for (i = 0; i < netPollCount; i++)
+        {
+        if ((netPollEntries[i]->events & NetPollIn) != 0)
+            {
+            FD_SET(netPollFds[i], fds);
+            if (netPollFds[i] > maxFd)
+                {
+                maxFd = netPollFds[i];
+                }
+            }
+        }
+#endif
+
+    return maxFd;
+    }
+
+#endif
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Remove a socket from the network poller. Entries which
+**                  are not registered are ignored.
+**
+**  Parameters:     Name        Description.
+**                  ep          poll entry
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void netPollRemove(NetPollEntry *ep)
+    {
+    NetPollEntry *last;
+    int          slot;
+
+    if (ep->slot == 0)
+        {
+        return;
+        }
+    slot = ep->slot - 1;
+#if defined(__linux__)
+    if (ep->events != 0)
+        {
+        epoll_ctl(netPollFd, EPOLL_CTL_DEL, netPollFds[slot], NULL);
+        }
+#endif
+
+    /*
+    **  Fill the hole with the last entry.
+    */
+    netPollCount        -= 1;
+    last                 = netPollEntries[netPollCount];
+    netPollEntries[slot] = last;
+    netPollFds[slot]     = netPollFds[netPollCount];
+    last->slot           = slot + 1;
+    ep->slot             = 0;
+    ep->events           = 0;
+    ep->revents          = 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Take readiness found by the network poller.
+**
+**  Parameters:     Name        Description.
+**                  ep          poll entry
+**                  event       NetPollIn or NetPollOut
+**
+**  Returns:        TRUE if the socket was found ready, in which case the
+**                  readiness is cleared until the next poll finds it.
+**
+**------------------------------------------------------------------------*/
+bool netPollTake(NetPollEntry *ep, u8 event)
+    {
+    if ((ep->revents & event) == 0)
+        {
+        return FALSE;
+        }
+    ep->revents &= ~event;
+
+    return TRUE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Change the readiness of interest of a registered
+**                  socket. The host is only called when it changes.
+**
+**  Parameters:     Name        Description.
+**                  ep          poll entry
+**                  events      readiness of interest (NetPollIn, NetPollOut)
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void netPollWant(NetPollEntry *ep, u8 events)
+    {
+#if defined(__linux__)
+    struct epoll_event ev;
+    int                op;
+#endif
+
+    ep->revents &= events;
+    if ((ep->slot == 0) || (ep->events == events))
+        {
+        return;
+        }
+#if defined(__linux__)
+    /*
+    **  epoll reports hang-up and error conditions even when no events
+    **  are requested, which would keep the idle wait from sleeping, so
+    **  a socket without interest is taken out of the epoll set.
+    */
+    if (events == 0)
+        {
+        op = EPOLL_CTL_DEL;
+        }
+    else if (ep->events == 0)
+        {
+        op = EPOLL_CTL_ADD;
+        }
+    else
+        {
+        op = EPOLL_CTL_MOD;
+        }
+    ev.events   = netPollEpollEvents(events);
+    ev.data.ptr = ep;
+    epoll_ctl(netPollFd, op, netPollFds[ep->slot - 1], &ev);
+#endif
+    ep->events = events;
+    }
+
 /*
  **--------------------------------------------------------------------------
  **
@@ -519,4 +955,126 @@ int    netInitiateConnection(struct sockaddr *sap)
  **--------------------------------------------------------------------------
  */
 
+#if defined(__linux__)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Convert readiness of interest to epoll events.
+**
+**  Parameters:     Name        Description.
+**                  events      readiness of interest (NetPollIn, NetPollOut)
+**
+**  Returns:        epoll event mask.
+**
+**------------------------------------------------------------------------*/
+static u32 netPollEpollEvents(u8 events)
+    {
+    u32 mask;
+
+    mask = 0;
+    if ((events & NetPollIn) != 0)
+        {
+        mask |= EPOLLIN;
+        }
+    if ((events & NetPollOut) != 0)
+        {
+        mask |= EPOLLOUT;
+        }
+
+    return mask;
+    }
+
+#endif
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Poll all registered sockets without waiting and record
+**                  their readiness. Runs every NetPollCycles major cycles
+**                  while any socket is registered.
+**
+**  Parameters:     Name        Description.
+**                  arg         not used
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void netPollRun(void *arg)
+    {
+#if defined(__linux__)
+    struct epoll_event events[NetPollMaxEvents];
+    u8                 ready;
+#else
+    int                maxFd;
+    fd_set             readFds;
+    struct timeval     timeout;
+    fd_set             writeFds;
+#endif
+    NetPollEntry       *ep;
+    int                i;
+    int                n;
+
+    if (netPollCount == 0)
+        {
+        return;
+        }
+    schedAfter(&netPollEvent, NetPollCycles);
+
+#if defined(__linux__)
+    n = epoll_wait(netPollFd, events, NetPollMaxEvents, 0);
+    for (i = 0; i < n; i++)
+        {
+        ep    = (NetPollEntry *)events[i].data.ptr;
+        ready = 0;
+        if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0)
+            {
+            ready |= NetPollIn;
+            }
+        if ((events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0)
+            {
+            ready |= NetPollOut;
+            }
+        ep->revents |= ready & ep->events;
+        }
+#else
+    FD_ZERO(&readFds);
+    FD_ZERO(&writeFds);
+    maxFd = 0;
+    for (i = 0; i < netPollCount; i++)
+        {
+        ep = netPollEntries[i];
+        if ((ep->events & NetPollIn) != 0)
+            {
+            FD_SET(netPollFds[i], &readFds);
+            }
+        if ((ep->events & NetPollOut) != 0)
+            {
+            FD_SET(netPollFds[i], &writeFds);
+            }
+        if ((ep->events != 0) && ((int)netPollFds[i] > maxFd))
+            {
+            maxFd = (int)netPollFds[i];
+            }
+        }
+
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 0;
+    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
+    if (n < 1)
+        {
+        return;
+        }
+
+    for (i = 0; i < netPollCount; i++)
+        {
+        ep = netPollEntries[i];
+        if (FD_ISSET(netPollFds[i], &readFds))
+            {
+            ep->revents |= NetPollIn;
+            }
+        if (FD_ISSET(netPollFds[i], &writeFds))
+            {
+            ep->revents |= NetPollOut;
+            }
+        }
+#endif
+    }
+
 /*---------------------------  End Of File  ------------------------------*/
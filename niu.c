@@ -74,17 +74,18 @@
 */
 typedef struct portParam
     {
-    int  id;
-    int  connFd;
-    u16  currInput;
-    u8   ibytes;             // how many bytes have been assembled into currInput (0..2)
-    bool active;
-    int  inInIdx;
-    int  inOutIdx;
-    u8   inBuffer[InBufSize];
-    int  outInIdx;
-    int  outOutIdx;
-    u8   outBuffer[OutBufSize];
+    int          id;
+    int          connFd;
+    NetPollEntry poll;
+    u16          currInput;
+    u8           ibytes;     // how many bytes have been assembled into currInput (0..2)
+    bool         active;
+    int          inInIdx;
+    int          inOutIdx;
+    u8           inBuffer[InBufSize];
+    int          outInIdx;
+    int          outOutIdx;
+    u8           outBuffer[OutBufSize];
     } PortParam;
 
 typedef struct localRing
@@ -138,6 +139,7 @@ static int              ioTurns = IoTurnsPerPoll - 1;
 static DevSlot          *out    = NULL;
 static int              lastInPort;
 static int              listenFd = 0;
+static NetPollEntry     listenPoll;
 static LocalRing        localInput[NiuLocalStations];
 static int              obytes;
 static niuProcessOutput *outputHandler[NiuLocalStations];
@@ -434,6 +436,7 @@ static void niuInit(void)
         logDtError(LogErrorLocation, "Can't listen for NIU on port %d\n", platoPort);
         exit(1);
         }
+    netPollAdd(&listenPoll, listenFd, 0);
 
     fprintf(stdout, "(niu    ) Listening on port %d (%d connections permitted).\n", platoPort, platoConns);
 
@@ -785,14 +788,11 @@ static void niuCheckIo(void)
 #else
     socklen_t      fromLen;
 #endif
+    u8             events;
     int            i;
-    int            maxFd;
     ssize_t        n;
     int            optEnable = 1;
     PortParam      *pp;
-    fd_set         readFds;
-    struct timeval timeout;
-    fd_set         writeFds;
 
     ioTurns = (ioTurns + 1) % IoTurnsPerPoll;
     if (ioTurns != 0)
@@ -800,61 +800,27 @@ static void niuCheckIo(void)
         return;
         }
 
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-    maxFd         = 0;
+    /*
+    **  Declare what each port is ready for and act on the readiness found
+    **  by the network poller.
+    */
     availablePort = NULL;
-
     for (i = 0, pp = portVector; i < platoConns; i++, pp++)
         {
         if (pp->active)
             {
+            events = 0;
             if (pp->inInIdx < InBufSize)
                 {
-                FD_SET(pp->connFd, &readFds);
-                if (pp->connFd > maxFd)
-                    {
-                    maxFd = pp->connFd;
-                    }
+                events |= NetPollIn;
                 }
             if (pp->outInIdx > pp->outOutIdx)
                 {
-                FD_SET(pp->connFd, &writeFds);
-                if (pp->connFd > maxFd)
-                    {
-                    maxFd = pp->connFd;
-                    }
-                }
-            }
-        else if (availablePort == NULL)
-            {
-            availablePort = pp;
-            FD_SET(listenFd, &readFds);
-            if (listenFd > maxFd)
-                {
-                maxFd = listenFd;
+                events |= NetPollOut;
                 }
-            }
-        }
+            netPollWant(&pp->poll, events);
 
-    if (maxFd < 1)
-        {
-        return;
-        }
-
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
-    if (n < 1)
-        {
-        return;
-        }
-
-    for (i = 0, pp = portVector; i < platoConns; i++, pp++)
-        {
-        if (pp->active)
-            {
-            if (FD_ISSET(pp->connFd, &readFds))
+            if (netPollTake(&pp->poll, NetPollIn))
                 {
                 n = recv(pp->connFd, &pp->inBuffer[pp->inInIdx], InBufSize - pp->inInIdx, 0);
                 if (n > 0)
@@ -871,7 +837,7 @@ static void niuCheckIo(void)
                     niuClose(pp);
                     }
                 }
-            if (FD_ISSET(pp->connFd, &writeFds) && (pp->outOutIdx < pp->outInIdx))
+            if (netPollTake(&pp->poll, NetPollOut) && (pp->outOutIdx < pp->outInIdx))
                 {
                 n = send(pp->connFd, &pp->outBuffer[pp->outOutIdx], pp->outInIdx - pp->outOutIdx, 0);
                 if (n >= 0)
@@ -890,13 +856,19 @@ static void niuCheckIo(void)
                     }
                 }
             }
+        else if (availablePort == NULL)
+            {
+            availablePort = pp;
+            }
         }
-    if ((availablePort != NULL) && FD_ISSET(listenFd, &readFds))
+    netPollWant(&listenPoll, availablePort != NULL ? NetPollIn : 0);
+    if ((availablePort != NULL) && netPollTake(&listenPoll, NetPollIn))
         {
         fromLen = sizeof(from);
         availablePort->connFd = (int)accept(listenFd, (struct sockaddr *)&from, &fromLen);
         if (availablePort->connFd > 0)
             {
+            netPollAdd(&availablePort->poll, availablePort->connFd, 0);
             availablePort->active    = TRUE;
             availablePort->inInIdx   = 0;
             availablePort->inOutIdx  = 0;
@@ -937,6 +909,7 @@ static void niuCheckIo(void)
 **------------------------------------------------------------------------*/
 static void niuClose(PortParam *pp)
     {
+    netPollRemove(&pp->poll);
     netCloseConnection(pp->connFd);
     pp->active = FALSE;
     pp->connFd = 0;
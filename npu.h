@@ -367,6 +367,8 @@ typedef struct npuBuffer
     u16              offset;
     u16              numBytes;
     u8               blockSeqNo;
+    struct pcb       *owner;
+    u32              ownerEpoch;
     u8               data[MaxBuffer];
     } NpuBuffer;
 
@@ -400,6 +402,7 @@ typedef struct ncb
     ConnectionState    state;                  // state of connection
     u8                 connType;               // connection type
     u16                tcpPort;                // TCP port on which to listen or connect
+    bool               isLocal;                // TRUE if connected through a Unix domain socket
     u8                 claPort;                // first CLA port number
     int                numPorts;               // number of CLA ports
     char               *hostName;              // name of remote host to which to connect
@@ -530,6 +533,11 @@ typedef struct scb
     u8              *pruFragment;
     u8              *pruFragment2;
     NpuQueue        uplineQ;
+    u64             recordsSent;
+    u64             charsSent;
+    u64             bytesSent;
+    u64             fileStart;
+    u64             fileLast;
     } Scb;
 
 typedef struct hcb
@@ -623,6 +631,7 @@ typedef struct lcb
     u8       remoteNode;     // remote coupler node number, from this host's perspective
     u16      blockLength;    // length of LIP network protocol block
     int      inputIndex;     // index of next byte in PCB inputData buffer
+    int      lengthSent;     // bytes of first output block's length already sent
     u8       *stagingBuf;    // protocol input staging buffer
     u8       *stagingBufPtr; // pointer to next storage location
     NpuQueue outputQ;
@@ -648,6 +657,8 @@ typedef struct pcb
     Ncb          *ncbp;                   // pointer to network connection control block
     u8           *inputData;              // buffer for data received from network
     int          inputCount;              // number of bytes in buffer
+    int          bufCount;                // number of NPU buffers charged to this port
+    u32          bufEpoch;                // incremented when the port's charges are dropped
     bool         cciIsDisabled;           // line for port is disabled by operator
     bool         cciWaitForTcb;           // wait until terminal is configured
     time_t       cciTcbWaitStart;         // start time to determine timeout for tcb getting ready
@@ -842,6 +853,12 @@ void npuBipInit(void);
 void npuBipReset(void);
 NpuBuffer *npuBipBufGet(void);
 void npuBipBufRelease(NpuBuffer *bp);
+bool npuBipIsCongested(void);
+bool npuBipIsOverQuota(Pcb *pcbp);
+bool npuBipIsThrottled(Pcb *pcbp);
+void npuBipResetOwner(Pcb *pcbp);
+void npuBipSetOwner(Pcb *pcbp);
+void npuBipShowStatus(void);
 void npuBipQueueAppend(NpuBuffer *bp, NpuQueue *queue);
 void npuBipQueuePrepend(NpuBuffer *bp, NpuQueue *queue);
 NpuBuffer *npuBipQueueExtract(NpuQueue *queue);
@@ -898,6 +915,7 @@ void npuNetConnected(Tcb *tp);
 void npuNetDisconnected(Tcb *tp);
 int npuNetRegisterConnType(int tcpPort, int claPort, int numPorts, int connType, Ncb **ncbpp);
 void npuNetSend(Tcb *tp, u8 *data, int len);
+int npuNetAddIdleFds(fd_set *fds, int maxFd);
 void npuNetSetMaxCN(u8 cn);
 void npuNetQueueAck(Tcb *tp, u8 blockSeqNo);
 void npuNetQueueOutput(Tcb *tp, u8 *data, int len);
@@ -938,6 +956,7 @@ void npuHaspPresetPcb(Pcb *pcbp);
 void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last);
 void npuHaspProcessUplineData(Pcb *pcbp);
 void npuHaspResetPcb(Pcb *pcbp);
+void npuHaspShowStatus(Pcb *pcbp);
 void npuHaspTryOutput(Pcb *pcbp);
 
 /*
@@ -974,6 +993,7 @@ void npuLipTryOutput(Pcb *pcbp);
 extern u8  cdcnetNode;
 extern u16 cdcnetPrivilegedTcpPortOffset;
 extern u16 cdcnetPrivilegedUdpPortOffset;
+extern u32 npuBipMaxBufs;
 extern u8  npuLipTrunkCount;
 extern u8  npuNetMaxClaPort;
 extern u8  npuNetMaxCN;
@@ -608,6 +608,7 @@ void npuAsyncResetPcb(Pcb *pcbp)
             }
         pcbp->controls.async.tp = NULL;
         }
+    npuBipResetOwner(pcbp);
 
 #if DEBUG
     fprintf(npuAsyncLog, "Port %02x: reset PCB\n", pcbp->claPort);
@@ -54,7 +54,9 @@
 **  Private Constants
 **  -----------------
 */
-#define NumBuffs    1000
+#define BufsPerSlab      256
+#define MaxSlabs         1024
+#define MaxBufsPerPort   32
 
 /*
 **  -----------------------
@@ -73,21 +75,29 @@
 **  Private Function Prototypes
 **  ---------------------------
 */
+static void npuBipBufGrow(void);
 
 /*
 **  ----------------
 **  Public Variables
 **  ----------------
 */
+u32 npuBipMaxBufs = 4000;
 
 /*
 **  -----------------
 **  Private Variables
 **  -----------------
 */
-static NpuBuffer *buffers = NULL;
-static NpuBuffer *bufPool = NULL;
-static int       bufCount = 0;
+static NpuBuffer *slabs[MaxSlabs];
+static int       slabCount    = 0;
+static NpuBuffer *bufPool     = NULL;
+static int       bufCount     = 0;
+static int       bufTotal     = 0;
+static int       bufInUse     = 0;
+static int       bufPeak      = 0;
+static u64       bufDeferrals = 0;
+static Pcb       *bufOwner    = NULL;
 
 static NpuBuffer *bipUplineBuffer = NULL;
 static NpuQueue  *bipUplineQueue;
@@ -150,37 +160,15 @@ static void (*tipProcessBuffer[])(NpuBuffer *np, int priority) =
 **------------------------------------------------------------------------*/
 void npuBipInit(void)
     {
-    NpuBuffer *bp;
-    NpuBuffer *np;
-    int       count;
-
-    /*
-    **  Allocate data buffer pool.
-    */
-    bufCount = NumBuffs;
-    buffers  = bufPool = calloc(NumBuffs, sizeof(NpuBuffer));
-    if (bufPool == NULL)
-        {
-        logDtError(LogErrorLocation, "Failed to allocate NPU data buffer pool\n");
-        exit(1);
-        }
-
     /*
-    **  Link buffers into pool and link in data.
+    **  Allocate the first slab of the data buffer pool. The pool grows
+    **  on demand.
     */
-    bp = bufPool;
-    for (count = NumBuffs - 1; count > 0; count--)
+    if (slabCount == 0)
         {
-        /*
-        **  Link to next buffer.
-        */
-        np       = bp + 1;
-        bp->next = np;
-        bp       = np;
+        npuBipBufGrow();
         }
 
-    bp->next = NULL;
-
     /*
     **  Allocate upline buffer queue.
     */
@@ -250,77 +238,149 @@ NpuBuffer *npuBipBufGet(void)
     NpuBuffer *bp;
 
     /*
-    **  Allocate buffer from pool.
+    **  Extend the pool by another slab if it is empty.
     */
-    bp = bufPool;
-    if (bp != NULL)
+    if (bufPool == NULL)
         {
-        /*
-        **  Unlink allocated buffer.
-        */
-        bufPool   = bp->next;
-        bufCount -= 1;
+        npuBipBufGrow();
+        }
 
-        /*
-        **  Initialise buffer.
-        */
-        bp->next       = NULL;
-        bp->offset     = 0;
-        bp->numBytes   = 0;
-        bp->blockSeqNo = 0;
-#if DEBUG
-        memset(bp->data, 0, MaxBuffer);
-#endif
+    /*
+    **  Unlink allocated buffer.
+    */
+    bp        = bufPool;
+    bufPool   = bp->next;
+    bufCount -= 1;
+    bufInUse += 1;
+    if (bufInUse > bufPeak)
+        {
+        bufPeak = bufInUse;
         }
-    else
+
+    /*
+    **  Initialise buffer and charge it to the port whose input is
+    **  being processed, if any.
+    */
+    bp->next       = NULL;
+    bp->offset     = 0;
+    bp->numBytes   = 0;
+    bp->blockSeqNo = 0;
+    bp->owner      = bufOwner;
+    if (bufOwner != NULL)
         {
-        npuLogMessage("(npu_bip) Out of buffers");
-        fputs("(npu_bip) Fatal error: Out of buffers\n", stderr);
+        bp->ownerEpoch      = bufOwner->bufEpoch;
+        bufOwner->bufCount += 1;
+        }
 #if DEBUG
-            {
-            /*
-             *  Dump metadata and first 32 bytes of each buffer to stderr
-             */
-            u8  *data;
-            int i, j, k;
-
-            for (i = 1, bp = buffers; i <= NumBuffs; i++, bp++)
-                {
-                logDtError(LogErrorLocation, "\nBuffer %d, offset=%u, numBytes=%u, blockSeqNo=%u\n",
-                           i, bp->offset, bp->numBytes, bp->blockSeqNo);
-                data = bp->data;
-                for (j = 0; j < 2; j++)
-                    {
-                    for (k = 0; k < 16; k++)
-                        {
-                        fprintf(stderr, "%02X ", *data++);
-                        }
-                    data -= 16;
-                    for (k = 0; k < 16; k++)
-                        {
-                        if ((*data >= 0x20) && (*data < 0x7f))
-                            {
-                            fprintf(stderr, "%c", *data);
-                            }
-                        else
-                            {
-                            fputc('.', stderr);
-                            }
-                        data++;
-                        }
-                    fputc('\n', stderr);
-                    }
-                }
-            data  = NULL;
-            *data = 0; // force SEGV to facilitate debugger usage
-            }
+    memset(bp->data, 0, MaxBuffer);
 #endif
-        exit(1);
-        }
 
     return (bp);
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Report whether the buffer pool is congested, i.e. the
+**                  number of buffers in use has reached the configured
+**                  limit.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        TRUE if the pool is congested.
+**
+**------------------------------------------------------------------------*/
+bool npuBipIsCongested(void)
+    {
+    return bufInUse >= (int)npuBipMaxBufs;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Determine whether more input may be accepted from a
+**                  network port. Input is deferred while the pool is
+**                  congested or while the port holds more than its share
+**                  of buffers. Data stays in the host's socket buffer
+**                  in the meantime, so TCP flow control throttles the
+**                  peer.
+**
+**  Parameters:     Name        Description.
+**                  pcbp        PCB pointer
+**
+**  Returns:        TRUE if input from the port must be deferred.
+**
+**------------------------------------------------------------------------*/
+bool npuBipIsOverQuota(Pcb *pcbp)
+    {
+    if (npuBipIsThrottled(pcbp))
+        {
+        bufDeferrals += 1;
+
+        return TRUE;
+        }
+
+    return FALSE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Report whether input from a network port is being
+**                  deferred, without counting a deferral.
+**
+**  Parameters:     Name        Description.
+**                  pcbp        PCB pointer
+**
+**  Returns:        TRUE if input from the port is deferred.
+**
+**------------------------------------------------------------------------*/
+bool npuBipIsThrottled(Pcb *pcbp)
+    {
+    return npuBipIsCongested() || (pcbp->bufCount >= MaxBufsPerPort);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Drop all buffer charges of a port whose connection has
+**                  been reset, so that its next connection starts with
+**                  a full quota. Buffers of the old connection which are
+**                  still queued elsewhere are no longer charged to it.
+**
+**  Parameters:     Name        Description.
+**                  pcbp        PCB pointer
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void npuBipResetOwner(Pcb *pcbp)
+    {
+    pcbp->bufCount  = 0;
+    pcbp->bufEpoch += 1;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Set the port to which subsequently allocated buffers
+**                  are charged.
+**
+**  Parameters:     Name        Description.
+**                  pcbp        PCB pointer, or NULL to stop charging
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void npuBipSetOwner(Pcb *pcbp)
+    {
+    bufOwner = pcbp;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Display buffer pool statistics (operator interface).
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void npuBipShowStatus(void)
+    {
+    opDisplay("    >   Buffers: %d in use, %d high water, %d allocated, limit %u, %llu input deferrals\n",
+              bufInUse, bufPeak, bufTotal, npuBipMaxBufs, (unsigned long long)bufDeferrals);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Report whether the network is busy.
 **
@@ -331,7 +391,7 @@ NpuBuffer *npuBipBufGet(void)
 **------------------------------------------------------------------------*/
 bool npuBipIsBusy(void)
     {
-    return (NumBuffs - bufCount) >= (int)idleNetBufs;
+    return (bufInUse >= (int)idleNetBufs) || npuBipIsCongested();
     }
 
 /*--------------------------------------------------------------------------
@@ -348,11 +408,19 @@ void npuBipBufRelease(NpuBuffer *bp)
     if (bp != NULL)
         {
         /*
-        **  Link buffer back into the pool.
+        **  Release the charge on the owning port, unless the charges were
+        **  dropped when the port was reset, and link buffer back into the
+        **  pool.
         */
+        if ((bp->owner != NULL) && (bp->owner->bufEpoch == bp->ownerEpoch) && (bp->owner->bufCount > 0))
+            {
+            bp->owner->bufCount -= 1;
+            }
+        bp->owner = NULL;
         bp->next  = bufPool;
         bufPool   = bp;
         bufCount += 1;
+        bufInUse -= 1;
         }
     }
 
@@ -546,6 +614,9 @@ void npuBipNotifyDownlineReceived(void)
     bipDownlineBuffer = NULL;
     dn = bp->data[BlkOffDN];
 
+    metrics.npuDownlineBlocks += 1;
+    metrics.npuDownlineBytes  += bp->numBytes;
+
     if (dn == npuSvmNpuNode)
         {
         /*
@@ -679,6 +750,8 @@ void npuBipNotifyUplineSent(void)
     /*
     **  Transfer finished, so release the buffer.
     */
+    metrics.npuUplineBlocks += 1;
+    metrics.npuUplineBytes  += bipUplineBuffer->numBytes;
     npuBipBufRelease(bipUplineBuffer);
 
     /*
@@ -699,4 +772,48 @@ void npuBipNotifyUplineSent(void)
  **--------------------------------------------------------------------------
  */
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Extend the data buffer pool by one slab of buffers.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void npuBipBufGrow(void)
+    {
+    NpuBuffer *bp;
+    int       count;
+
+    if (slabCount >= MaxSlabs)
+        {
+        logDtError(LogErrorLocation, "(npu_bip) NPU data buffer pool exceeds %d buffers\n", MaxSlabs * BufsPerSlab);
+        exit(1);
+        }
+
+    bp = calloc(BufsPerSlab, sizeof(NpuBuffer));
+    if (bp == NULL)
+        {
+        logDtError(LogErrorLocation, "(npu_bip) Failed to allocate NPU data buffer pool\n");
+        exit(1);
+        }
+    slabs[slabCount++] = bp;
+
+    /*
+    **  Link buffers into pool.
+    */
+    for (count = BufsPerSlab; count > 0; count--)
+        {
+        bp->next  = bufPool;
+        bufPool   = bp;
+        bp       += 1;
+        }
+    bufCount += BufsPerSlab;
+    bufTotal += BufsPerSlab;
+    if (slabCount > 1)
+        {
+        npuLogMessage("(npu_bip) Buffer pool extended to %d buffers", bufTotal);
+        }
+    }
+
 /*---------------------------  End Of File  ------------------------------*/
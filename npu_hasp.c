@@ -70,6 +70,7 @@
 */
 
 #define BlockCushion          140
+#define BlockStageSize        (MaxBlockSize + MaxBuffer + 256)
 #define DeadPeerTimeout       15000
 #define HaspPduHdrLen         5
 #define HaspMaxPruDataSize    1280
@@ -95,6 +96,14 @@
 #define DcBlank               055
 #define EbcdicBlank           0x40
 
+/*
+**  String control byte limits. Runs of at least MinDupRun identical
+**  characters in print and punch records are sent as duplicate strings.
+*/
+#define MaxDupRun             0x1f
+#define MaxStringLen          0x3f
+#define MinDupRun             3
+
 #define SRCB_GCR              0
 #define SRCB_RTI              1
 #define SRCB_PTI              2
@@ -166,11 +175,14 @@ typedef enum
 */
 static int  npuHaspAppendOutput(Pcb *pcbp, u8 *data, int len);
 static int  npuHaspAppendRecord(Pcb *pcbp, u8 *data, int len);
+static int  npuHaspConvertPru(Scb *scbp, u8 *data, int len);
 static void npuHaspCloseConnection(Pcb *pcbp);
+static int  npuHaspEncodeStrings(u8 *dp, u8 *data, int len, bool isCompressed);
 static Scb *npuHaspFindStream(Pcb *pcbp, u8 streamId, u8 deviceType);
 static Scb *npuHaspFindStreamWithOutput(Pcb *pcbp);
 static Scb *npuHaspFindStreamWithPendingRTI(Pcb *pcbp);
 static bool npuHaspFlushBuffer(Pcb *pcbp);
+static void npuHaspFlushBlockStage(void);
 static int  npuHaspFlushPruFragment(Tcb *tp);
 static int  npuHaspFlushPruPostPrintFragment(Tcb *tp);
 static int  npuHaspFlushPruPrePrintFragment(Tcb *tp);
@@ -190,6 +202,8 @@ static void npuHaspSendSignonRecord(Tcb *tp, u8 *data, int len);
 static void npuHaspSendUplineData(Tcb *tp, u8 *data, int len);
 static void npuHaspSendUplineEoiAcctg(Tcb *tp, u8 sfc);
 static void npuHaspSendUplineEOS(Tcb *tp);
+static void npuHaspStage(Tcb *tp, u8 *data, int len);
+static u8   *npuHaspStageSpace(Tcb *tp, int len);
 static void npuHaspStageUplineData(Scb *scbp, u8 *data, int len);
 static void npuHaspTransmitQueuedBlocks(Tcb *tp);
 static u8   npuHaspTranslateSrcbToFe(u8 cc);
@@ -225,6 +239,22 @@ static u8 rtiRecord    [] = { 0x90, 0x80, 0x00 };
 static u8 dcEoi        [] = { 050, 047, 005, 017, 011 }; //  /*EOI
 static u8 dcEor        [] = { 050, 047, 005, 017, 022 }; //  /*EOR
 
+/*
+**  Downline HASP blocks are assembled here and queued to the TCB in one
+**  piece when the block trailer is added.
+*/
+static u8  blockStage[BlockStageSize];
+static int blockStageLen = 0;
+static Tcb *blockStageTcb = NULL;
+
+/*
+**  Display Code PRU data to EBCDIC, indexed by the right justified
+**  Display Code byte, and EBCDIC card images to Display Code.
+*/
+static u8   dcToEbcdic[256];
+static u8   ebcdicToDc[256];
+static bool isConvTableReady = FALSE;
+
 #if DEBUG
 static FILE *npuHaspLog = NULL;
 static char npuHaspLogBuf[LogLineLength + 1];
@@ -523,10 +553,10 @@ void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last)
     int blockLen;
     int blocksQueued;
     u8  blockType;
-    u8  c;
     u8  dbc;
-    u8  *fp;
+    u8  *end;
     int len;
+    int n;
     Pcb *pcbp;
     u8  recordLen;
     u8  *recordStart;
@@ -570,6 +600,7 @@ void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last)
         {
         scbp->recordCount = 0;
         scbp->lastSRCB    = 0;
+        scbp->fileStart   = getMilliseconds();
         switch (tp->deviceType)
             {
         case DtCR:
@@ -598,7 +629,7 @@ void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last)
             break;
             }
         blockLen = npuHaspSendBlockHeader(tp);
-        npuNetSend(tp, rtiRecord, sizeof(rtiRecord));
+        npuHaspStage(tp, rtiRecord, sizeof(rtiRecord));
         blockLen   += sizeof(rtiRecord);
         blockLen   += npuHaspSendBlockTrailer(tp);
         scbp->state = StHaspStreamSendRTI;
@@ -671,42 +702,9 @@ void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last)
                     blockLen      = 0;
                     }
                 }
-            if (scbp->params.fvFileType == ASC)
-                {
-                fp = scbp->pruFragment + scbp->pruFragmentSize;
-                while (len-- > 0)
-                    {
-                    c = *blk++;
-                    if (c == 0xff)
-                        {
-                        scbp->isPruFragmentComplete = TRUE;
-                        break;
-                        }
-                    else if (scbp->pruFragmentSize < MaxBuffer)
-                        {
-                        *fp++ = asciiToEbcdic[c];
-                        scbp->pruFragmentSize += 1;
-                        }
-                    }
-                }
-            else // Display Code
-                {
-                fp = scbp->pruFragment + scbp->pruFragmentSize;
-                while (len-- > 0)
-                    {
-                    c = *blk++;
-                    if (c == 0xff)
-                        {
-                        scbp->isPruFragmentComplete = TRUE;
-                        break;
-                        }
-                    else if (scbp->pruFragmentSize < MaxBuffer)
-                        {
-                        *fp++ = asciiToEbcdic[(u8)cdcToAscii[c]];
-                        scbp->pruFragmentSize += 1;
-                        }
-                    }
-                }
+            n    = npuHaspConvertPru(scbp, blk, len);
+            blk += n;
+            len -= n;
             }
         if (scbp->isPruFragmentComplete)
             {
@@ -779,19 +777,11 @@ void npuHaspProcessDownlineData(Tcb *tp, NpuBuffer *bp, bool last)
         while (len > 0)
             {
             recordStart = blk;
-            while (len > 0)
-                {
-                c = *blk;
-                if (c == ChrUS)
-                    {
-                    break;
-                    }
-                else
-                    {
-                    *blk++ = asciiToEbcdic[c];
-                    len   -= 1;
-                    }
-                }
+            end         = (u8 *)memchr(blk, ChrUS, len);
+            n           = (end != NULL) ? (int)(end - blk) : len;
+            charsetTranslate(blk, blk, n, asciiToEbcdic);
+            blk += n;
+            len -= n;
             srcb = 0;
             if (blk > recordStart)
                 {
@@ -2356,6 +2346,16 @@ void npuHaspPresetPcb(Pcb *pcbp)
         }
 #endif
 
+    if (!isConvTableReady)
+        {
+        for (i = 0; i < 256; i++)
+            {
+            dcToEbcdic[i] = asciiToEbcdic[(u8)cdcToAscii[i & Mask6]];
+            ebcdicToDc[i] = asciiToCdc[ebcdicToAscii[i]];
+            }
+        isConvTableReady = TRUE;
+        }
+
     pcbp->controls.hasp.lastBlockSent = NULL;
     pcbp->controls.hasp.retries       = 0;
     pcbp->controls.hasp.outBuf        = NULL;
@@ -2447,6 +2447,56 @@ void npuHaspResetPcb(Pcb *pcbp)
         npuHaspResetScb(&pcbp->controls.hasp.printStreams [i]);
         npuHaspResetScb(&pcbp->controls.hasp.punchStreams [i]);
         }
+    npuBipResetOwner(pcbp);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Show output statistics of the streams of a HASP or
+**                  Reverse HASP connection (operator interface).
+**
+**  Parameters:     Name        Description.
+**                  pcbp        pointer to PCB
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void npuHaspShowStatus(Pcb *pcbp)
+    {
+    int  i;
+    char rate[32];
+    Scb  *scbp;
+    Scb  *streams[1 + 3 * MaxHaspStreams];
+
+    streams[0] = &pcbp->controls.hasp.consoleStream;
+    for (i = 0; i < MaxHaspStreams; i++)
+        {
+        streams[1 + i]                      = &pcbp->controls.hasp.readerStreams[i];
+        streams[1 + MaxHaspStreams + i]     = &pcbp->controls.hasp.printStreams[i];
+        streams[1 + 2 * MaxHaspStreams + i] = &pcbp->controls.hasp.punchStreams[i];
+        }
+
+    for (i = 0; i < 1 + 3 * MaxHaspStreams; i++)
+        {
+        scbp = streams[i];
+        if ((scbp->tp == NULL) || (scbp->recordsSent == 0))
+            {
+            continue;
+            }
+
+        /*
+        **  The rate is that of the current or last file of a print or
+        **  punch stream.
+        */
+        rate[0] = '\0';
+        if ((scbp->recordCount > 0) && (scbp->fileStart != 0) && (scbp->fileLast > scbp->fileStart))
+            {
+            sprintf(rate, ", %.0f records/s", scbp->recordCount * 1000.0 / (scbp->fileLast - scbp->fileStart));
+            }
+        opDisplay("    >     %-7.7s %llu records, %llu chars sent in %llu bytes (%.0f%%)%s\n",
+                  scbp->tp->termName, (unsigned long long)scbp->recordsSent, (unsigned long long)scbp->charsSent,
+                  (unsigned long long)scbp->bytesSent,
+                  scbp->charsSent > 0 ? scbp->bytesSent * 100.0 / scbp->charsSent : 0.0, rate);
+        }
     }
 
 /*
@@ -2481,6 +2531,138 @@ static void npuHaspCloseConnection(Pcb *pcbp)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Convert PRU data to EBCDIC and collect it in the PRU
+**                  fragment buffer, up to the end of the current record.
+**
+**  Parameters:     Name        Description.
+**                  scbp        SCB pointer
+**                  data        PRU data in ASCII or Display Code
+**                  len         length of data
+**
+**  Returns:        Number of bytes consumed, including the record
+**                  terminator if found.
+**
+**------------------------------------------------------------------------*/
+static int npuHaspConvertPru(Scb *scbp, u8 *data, int len)
+    {
+    int      count;
+    u8       *end;
+    int      n;
+    const u8 *table;
+
+    /*
+    **  Records are terminated by 0xff bytes. Characters beyond the size
+    **  of the fragment buffer are discarded.
+    */
+    end   = (u8 *)memchr(data, 0xff, len);
+    n     = (end != NULL) ? (int)(end - data) : len;
+    count = MaxBuffer - scbp->pruFragmentSize;
+    if (count > n)
+        {
+        count = n;
+        }
+
+    table = (scbp->params.fvFileType == ASC) ? asciiToEbcdic : dcToEbcdic;
+    charsetTranslate(scbp->pruFragment + scbp->pruFragmentSize, data, count, table);
+    scbp->pruFragmentSize += count;
+
+    if (end != NULL)
+        {
+        scbp->isPruFragmentComplete = TRUE;
+        n += 1;
+        }
+
+    return n;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Encode a record as HASP strings. When compression is
+**                  requested, runs of identical characters are encoded
+**                  as duplicate strings.
+**
+**  Parameters:     Name        Description.
+**                  dp          buffer receiving the strings
+**                  data        pointer to the content of the record
+**                  len         length of the content
+**                  isCompressed TRUE to compress runs
+**
+**  Returns:        Number of bytes stored, including the end-of-record
+**                  SCB.
+**
+**------------------------------------------------------------------------*/
+static int npuHaspEncodeStrings(u8 *dp, u8 *data, int len, bool isCompressed)
+    {
+    u8 *end;
+    u8 *lit;
+    int n;
+    u8 *rp;
+    u8 *start;
+
+    start = dp;
+    end   = data + len;
+    lit   = data;
+    while (data < end)
+        {
+        rp = data + 1;
+        if (isCompressed)
+            {
+            while ((rp < end) && (*rp == *data) && (rp - data < MaxDupRun))
+                {
+                rp += 1;
+                }
+            }
+        if (rp - data < MinDupRun)
+            {
+            data += 1;
+            continue;
+            }
+
+        /*
+        **  Send the characters preceding the run as non-duplicate strings
+        **  of at most 63 bytes, then the run as a duplicate string.
+        */
+        while (lit < data)
+            {
+            n = (int)(data - lit);
+            if (n > MaxStringLen)
+                {
+                n = MaxStringLen;
+                }
+            *dp++ = (u8)((1 << 7) | (1 << 6) | n); // Non-duplicate string
+            memcpy(dp, lit, n);
+            dp  += n;
+            lit += n;
+            }
+        if (*data == EbcdicBlank)
+            {
+            *dp++ = (u8)((1 << 7) | (0 << 6) | (0 << 5) | (rp - data)); // Duplicate blanks
+            }
+        else
+            {
+            *dp++ = (u8)((1 << 7) | (0 << 6) | (1 << 5) | (rp - data)); // Duplicate character
+            *dp++ = *data;
+            }
+        data = lit = rp;
+        }
+
+    while (lit < end)
+        {
+        n = (int)(end - lit);
+        if (n > MaxStringLen)
+            {
+            n = MaxStringLen;
+            }
+        *dp++ = (u8)((1 << 7) | (1 << 6) | n); // Non-duplicate string
+        memcpy(dp, lit, n);
+        dp  += n;
+        lit += n;
+        }
+    *dp++ = 0; // End of record
+
+    return (int)(dp - start);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Find a stream by stream identifier.
 **
@@ -2685,6 +2867,27 @@ static Scb *npuHaspFindStreamWithPendingRTI(Pcb *pcbp)
     return NULL;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Queue the staged block to its TCB for transmission.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void npuHaspFlushBlockStage(void)
+    {
+    if (blockStageLen > 0)
+        {
+        npuNetSend(blockStageTcb, blockStage, blockStageLen);
+        if (blockStageTcb->scbp != NULL)
+            {
+            blockStageTcb->scbp->fileLast = getMilliseconds();
+            }
+        blockStageLen = 0;
+        }
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Flush a buffered PRU fragment downline.
 **
@@ -3324,6 +3527,11 @@ static void npuHaspResetScb(Scb *scbp)
     scbp->isPruFragmentComplete = FALSE;
     scbp->pruFragment2          = NULL;
     scbp->pruFragmentSize       = 0;
+    scbp->recordsSent           = 0;
+    scbp->charsSent             = 0;
+    scbp->bytesSent             = 0;
+    scbp->fileStart             = 0;
+    scbp->fileLast              = 0;
     }
 
 /*--------------------------------------------------------------------------
@@ -3375,7 +3583,7 @@ static int npuHaspSendBlockHeader(Tcb *tp)
     /*
     **  Send SYN bytes and Bisync start-of-text
     */
-    npuNetSend(tp, blockHeader, sizeof(blockHeader));
+    npuHaspStage(tp, blockHeader, sizeof(blockHeader));
 
     /*
     **  Send BCB byte
@@ -3388,13 +3596,14 @@ static int npuHaspSendBlockHeader(Tcb *tp)
     */
     header[i++] = 0x80 | (0 << 6) | 0x0f; // normal state, all print/punch streams on
     header[i++] = 0x80 | (1 << 6) | 0x0f; // console on, all print/punch streams on
-    npuNetSend(tp, header, i);
+    npuHaspStage(tp, header, i);
 
     return sizeof(blockHeader) + i;
     }
 
 /*--------------------------------------------------------------------------
-**  Purpose:        Send HASP block trailer to peer.
+**  Purpose:        Send HASP block trailer to peer and queue the staged
+**                  block for transmission.
 **
 **  Parameters:     Name        Description.
 **                  tp          TCB pointer
@@ -3418,7 +3627,8 @@ static int npuHaspSendBlockTrailer(Tcb *tp)
     */
     header[i++] = DLE;
     header[i++] = ETB;
-    npuNetSend(tp, header, i);
+    npuHaspStage(tp, header, i);
+    npuHaspFlushBlockStage();
 
     return i;
     }
@@ -3553,7 +3763,7 @@ static int npuHaspSendEofRecord(Tcb *tp)
 
     len     = npuHaspSendRecordHeader(tp, 0);
     data[0] = 0;
-    npuNetSend(tp, data, 1);
+    npuHaspStage(tp, data, 1);
 
     return len + 1;
     }
@@ -3617,7 +3827,7 @@ static int npuHaspSendRecordHeader(Tcb *tp, u8 srcb)
 
         return 0;
         }
-    npuNetSend(tp, header, i);
+    npuHaspStage(tp, header, i);
 
     return i;
     }
@@ -3635,37 +3845,28 @@ static int npuHaspSendRecordHeader(Tcb *tp, u8 srcb)
 **------------------------------------------------------------------------*/
 static int npuHaspSendRecordStrings(Tcb *tp, u8 *data, int len)
     {
-    u8  header[16];
-    int n;
+    bool isCompressed;
+    int  n;
+    Scb  *scbp;
 
     /*
-    **  Send strings comprising of the record. Each string begins with
-    **  an SCB byte definiing the length of the string. The maximum
-    **  length of a string is 63 bytes, so a record longer than 63 bytes
-    **  must be segmented into multiple strings. The record must end with
-    **  an end-of-record SCB.
+    **  The record is encoded straight into the block being staged. The
+    **  encoding is never longer than the record plus one SCB per string
+    **  and the end-of-record SCB.
     */
-    n = 0;
-    while (len > 0x3f)
-        {
-        header[0] = (u8)((1 << 7) | (1 << 6) | 0x3f); // Non-duplicate string, max length
-        npuNetSend(tp, header, 1);
-        npuNetSend(tp, data, 63);
-        data += 63;
-        len  -= 63;
-        n    += 64;
-        }
-    if (len > 0)
+    isCompressed = (tp->deviceType == DtLP) || (tp->deviceType == DtCP);
+    n            = npuHaspEncodeStrings(npuHaspStageSpace(tp, len + (len / MaxStringLen) + 2), data, len, isCompressed);
+    blockStageLen += n;
+
+    scbp = tp->scbp;
+    if (scbp != NULL)
         {
-        header[0] = (u8)((1 << 7) | (1 << 6) | len); // Non-duplicate string, remaining record length
-        npuNetSend(tp, header, 1);
-        npuNetSend(tp, data, len);
-        n += len + 1;
+        scbp->recordsSent += 1;
+        scbp->charsSent   += len;
+        scbp->bytesSent   += n;
         }
-    header[0] = 0;
-    npuNetSend(tp, header, 1);
 
-    return n + 1;
+    return n;
     }
 
 /*--------------------------------------------------------------------------
@@ -3832,6 +4033,46 @@ static void npuHaspSendUplineEOS(Tcb *tp)
 #endif
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Append data to the block being staged for a TCB.
+**
+**  Parameters:     Name        Description.
+**                  tp          TCB pointer
+**                  data        data to be staged
+**                  len         length of data
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void npuHaspStage(Tcb *tp, u8 *data, int len)
+    {
+    memcpy(npuHaspStageSpace(tp, len), data, len);
+    blockStageLen += len;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Make room in the block stage for data to be sent to
+**                  a TCB. Data staged for another TCB, or data which
+**                  would overflow the stage, is queued first.
+**
+**  Parameters:     Name        Description.
+**                  tp          TCB pointer
+**                  len         maximum length of data to be staged
+**
+**  Returns:        Pointer to the free space in the stage.
+**
+**------------------------------------------------------------------------*/
+static u8 *npuHaspStageSpace(Tcb *tp, int len)
+    {
+    if ((tp != blockStageTcb) || (blockStageLen + len > BlockStageSize))
+        {
+        npuHaspFlushBlockStage();
+        blockStageTcb = tp;
+        }
+
+    return blockStage + blockStageLen;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Stage data for sending upline.
 **
@@ -3845,7 +4086,6 @@ static void npuHaspSendUplineEOS(Tcb *tp)
 **------------------------------------------------------------------------*/
 static void npuHaspStageUplineData(Scb *scbp, u8 *data, int len)
     {
-    int i;
     Ncb *ncbp;
     Tcb *tp;
 
@@ -3854,20 +4094,8 @@ static void npuHaspStageUplineData(Scb *scbp, u8 *data, int len)
 
     if (ncbp->connType == ConnTypeHasp)
         {
-        if (tp->deviceType == DtCONSOLE)
-            {
-            for (i = 0; i < len; i++)
-                {
-                *tp->inBufPtr++ = ebcdicToAscii[*data++];
-                }
-            }
-        else
-            {
-            for (i = 0; i < len; i++)
-                {
-                *tp->inBufPtr++ = asciiToCdc[ebcdicToAscii[*data++]];
-                }
-            }
+        charsetTranslate(tp->inBufPtr, data, len, (tp->deviceType == DtCONSOLE) ? ebcdicToAscii : ebcdicToDc);
+        tp->inBufPtr += len;
         }
     else // ncbp->connType == ConnTypeRevHasp
         {
@@ -3875,10 +4103,8 @@ static void npuHaspStageUplineData(Scb *scbp, u8 *data, int len)
             {
             tp->inBufPtr += 1; // reserve byte for transparent record length
             }
-        for (i = 0; i < len; i++)
-            {
-            *tp->inBufPtr++ = *data++;
-            }
+        memcpy(tp->inBufPtr, data, len);
+        tp->inBufPtr += len;
         }
     }
 
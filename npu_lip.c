@@ -68,8 +68,9 @@
 **  Private Constants
 **  -----------------
 */
-#define MaxIdleTime    15
-#define MaxTrunks      16
+#define MaxIdleTime       15
+#define MaxTrunks         16
+#define MaxWriteBlocks    32    // queued blocks gathered into one write
 
 /*
 **  -----------------------
@@ -373,11 +374,13 @@ void npuLipResetPcb(Pcb *pcbp)
     pcbp->controls.lip.lastExchange  = 0;
     pcbp->controls.lip.blockLength   = 0;
     pcbp->controls.lip.inputIndex    = 0;
+    pcbp->controls.lip.lengthSent    = 0;
     pcbp->controls.lip.stagingBufPtr = pcbp->controls.lip.stagingBuf;
     while ((bp = npuBipQueueExtract(&pcbp->controls.lip.outputQ)) != NULL)
         {
         npuBipBufRelease(bp);
         }
+    npuBipResetOwner(pcbp);
 #if DEBUG
     fprintf(npuLipLog, "Port %02x: trunk PCB reset\n", pcbp->claPort);
 #endif
@@ -904,15 +907,25 @@ static bool npuLipDeactivateTrunk(Pcb *pcbp)
 **------------------------------------------------------------------------*/
 static void npuLipSendQueuedData(Pcb *pcbp)
     {
-    u8        blockLen[2];
     NpuBuffer *bp;
     time_t    currentTime;
     ssize_t   n;
     static u8 ping[] = { 0, 0 };
 
-#if !defined(_WIN32)
+#if defined(_WIN32)
+    u8 blockLen[2];
+#else
+    u8           blockLens[MaxWriteBlocks][2];
     int          i;
-    struct iovec vec[2];
+    int          k;
+    int          lengthSent;
+    ssize_t      len;
+    ssize_t      total;
+    struct iovec vec[MaxWriteBlocks * 2];
+    ssize_t      written;
+#if DEBUG
+    int          j;
+#endif
 #endif
 
     currentTime = getSeconds();
@@ -947,9 +960,9 @@ static void npuLipSendQueuedData(Pcb *pcbp)
 
         return;
         }
+#if defined(_WIN32)
     while ((bp = npuBipQueueExtract(&pcbp->controls.lip.outputQ)) != NULL)
         {
-#if defined(_WIN32)
         /*
         **  If the buffer offset is 0, the block length has not been sent yet.
         */
@@ -982,33 +995,6 @@ static void npuLipSendQueuedData(Pcb *pcbp)
                 }
 #endif
             }
-#else
-        /*
-        **  If the buffer offset is 0, the block length has not been sent yet.
-        */
-        i = 0;
-        if (bp->offset < 1)
-            {
-            blockLen[0]      = bp->numBytes >> 8;
-            blockLen[1]      = bp->numBytes & 0xff;
-            vec[i].iov_base  = blockLen;
-            vec[i++].iov_len = 2;
-            }
-        vec[i].iov_base = bp->data + bp->offset;
-        n = bp->numBytes - bp->offset;
-        vec[i++].iov_len = n;
-
-        n = (n > 0) ? writev(pcbp->connFd, vec, i) : 0;
-#if DEBUG
-        if (n > 0)
-            {
-            fprintf(npuLipLog, "Port %02x: sent data to %s\n", pcbp->claPort, pcbp->ncbp->hostName);
-            npuLipLogBytes(blockLen, 2);
-            npuLipLogBytes(vec[1].iov_base, vec[1].iov_len);
-            npuLipLogFlush();
-            }
-#endif
-#endif
         if (n < 0)
             {
             /*
@@ -1021,21 +1007,6 @@ static void npuLipSendQueuedData(Pcb *pcbp)
 
             return;
             }
-#if !defined(_WIN32)
-        if (i > 1)
-            {
-            n -= 2; // deduct block length bytes
-            if (n < 0)
-                {
-                npuBipBufRelease(bp);
-                logDtError(LogErrorLocation, "Failed to send whole block length to %s\n",
-                           pcbp->ncbp->hostName);
-                npuLipNotifyNetDisconnect(pcbp);
-
-                return;
-                }
-            }
-#endif
 
         bp->offset += (u16)n;
 
@@ -1051,6 +1022,97 @@ static void npuLipSendQueuedData(Pcb *pcbp)
             npuBipQueuePrepend(bp, &pcbp->controls.lip.outputQ);
             }
         }
+#else
+    while (npuBipQueueNotEmpty(&pcbp->controls.lip.outputQ))
+        {
+        /*
+        **  Gather the queued blocks, each preceded by its length, into a
+        **  single vectored write so that a burst of blocks costs one system
+        **  call. Only the first block can have been partially sent.
+        */
+        i     = 0;
+        total = 0;
+        bp    = pcbp->controls.lip.outputQ.first;
+        for (k = 0; k < MaxWriteBlocks && bp != NULL; k++)
+            {
+            lengthSent = (k == 0) ? pcbp->controls.lip.lengthSent : 0;
+            if (lengthSent < 2)
+                {
+                blockLens[k][0] = bp->numBytes >> 8;
+                blockLens[k][1] = bp->numBytes & 0xff;
+                vec[i].iov_base = blockLens[k] + lengthSent;
+                vec[i].iov_len  = 2 - lengthSent;
+                total          += vec[i++].iov_len;
+                }
+            if (bp->numBytes > bp->offset)
+                {
+                vec[i].iov_base = bp->data + bp->offset;
+                vec[i].iov_len  = bp->numBytes - bp->offset;
+                total          += vec[i++].iov_len;
+                }
+            bp = bp->next;
+            }
+
+        n = (i > 0) ? writev(pcbp->connFd, vec, i) : 0;
+        if (n < 0)
+            {
+            /*
+            **  Likely this is a "would block" type of error. The select()
+            **  call will later tell us when we can send again. Any
+            **  disconnects or other errors will be handled by the receive
+            **  handler.
+            */
+            return;
+            }
+#if DEBUG
+        fprintf(npuLipLog, "Port %02x: sent %ld bytes in %d blocks to %s\n",
+                pcbp->claPort, (long)n, k, pcbp->ncbp->hostName);
+        for (j = 0, len = n; j < i && len > 0; j++)
+            {
+            npuLipLogBytes(vec[j].iov_base, len < (ssize_t)vec[j].iov_len ? (int)len : (int)vec[j].iov_len);
+            len -= vec[j].iov_len;
+            }
+        npuLipLogFlush();
+#endif
+        written = n;
+
+        /*
+        **  Release the blocks that were sent completely and note how far
+        **  the write got into the first one that was not.
+        */
+        while ((bp = pcbp->controls.lip.outputQ.first) != NULL)
+            {
+            if (pcbp->controls.lip.lengthSent < 2)
+                {
+                len = 2 - pcbp->controls.lip.lengthSent;
+                if (n < len)
+                    {
+                    pcbp->controls.lip.lengthSent += (int)n;
+                    break;
+                    }
+                n -= len;
+                pcbp->controls.lip.lengthSent = 2;
+                }
+            len = bp->numBytes - bp->offset;
+            if (n < len)
+                {
+                bp->offset += (u16)n;
+                break;
+                }
+            n -= len;
+            npuBipBufRelease(npuBipQueueExtract(&pcbp->controls.lip.outputQ));
+            pcbp->controls.lip.lengthSent = 0;
+            }
+
+        if (written < total)
+            {
+            /*
+            **  The socket can take no more for now.
+            */
+            return;
+            }
+        }
+#endif
     }
 
 #if DEBUG
@@ -72,6 +72,13 @@
 #define MaxClaPorts       255
 #define NamStartupTime    30
 
+/*
+**  Trunk and NJE connections between emulators on the same host may use
+**  a Unix domain socket instead of TCP. The socket is named after the
+**  port number that would otherwise be used.
+*/
+#define LocalSocketPath    "/tmp/dtcyber-%u.sock"
+
 /*
 **  -----------------------
 **  Private Macro Functions
@@ -698,10 +705,11 @@ void npuNetCheckStatus(void)
         FD_SET(pcbp->connFd, &readFds);
         readySockets = select((int)(pcbp->connFd + 1), &readFds, NULL, NULL, &timeout);
 
-        if ((readySockets > 0) && FD_ISSET(pcbp->connFd, &readFds))
+        if ((readySockets > 0) && FD_ISSET(pcbp->connFd, &readFds) && !npuBipIsOverQuota(pcbp))
             {
             /*
-            **  Receive a block of data.
+            **  Receive a block of data. Buffers allocated while processing
+            **  it are charged to this port until they are released.
             */
             pcbp->inputCount = (int)recv(pcbp->connFd, pcbp->inputData, MaxBuffer, 0);
             if (pcbp->inputCount <= 0)
@@ -709,7 +717,9 @@ void npuNetCheckStatus(void)
                 notifyNetDisconnect[pcbp->ncbp->connType](pcbp);
                 continue;
                 }
+            npuBipSetOwner(pcbp);
             processUplineData[pcbp->ncbp->connType](pcbp);
+            npuBipSetOwner(NULL);
             }
 
         if (pcbp->connFd > 0)
@@ -736,6 +746,41 @@ void npuNetCheckStatus(void)
     pollIndex = 0;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Add the sockets of connected terminals to a set of
+**                  descriptors on which the idle throttle waits. Ports
+**                  whose input is deferred by the buffer quota are left
+**                  out, since their unread data would end every wait.
+**
+**  Parameters:     Name        Description.
+**                  fds         pointer to descriptor set
+**                  maxFd       highest descriptor already in the set
+**
+**  Returns:        Highest descriptor in the set.
+**
+**------------------------------------------------------------------------*/
+int npuNetAddIdleFds(fd_set *fds, int maxFd)
+    {
+    int i;
+    Pcb *pcbp;
+
+    for (i = 0; i <= npuNetMaxClaPort; i++)
+        {
+        pcbp = &pcbs[i];
+        if ((pcbp->connFd <= 0) || pcbp->cciWaitForTcb || npuBipIsThrottled(pcbp))
+            {
+            continue;
+            }
+        FD_SET(pcbp->connFd, fds);
+        if ((int)pcbp->connFd > maxFd)
+            {
+            maxFd = (int)pcbp->connFd;
+            }
+        }
+
+    return maxFd;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Show status of NPU/MDI data communication  (operator interface).
 **
@@ -840,8 +885,13 @@ void npuNetShowStatus()
             opDisplay("    >   %-8s %-7s P%02x "FMTNETSTATUS "\n", dts, chEqStr, pcbp->claPort, netGetLocalTcpAddress(pcbp->connFd),
                       netGetPeerTcpAddress(pcbp->connFd), connTypes[pcbp->ncbp->connType], connStates[pcbp->ncbp->state]),
             chEqStr[0] = '\0';
+            if ((pcbp->ncbp->connType == ConnTypeHasp) || (pcbp->ncbp->connType == ConnTypeRevHasp))
+                {
+                npuHaspShowStatus(pcbp);
+                }
             }
         }
+    npuBipShowStatus();
     }
 
 /*
@@ -1044,7 +1094,8 @@ static int npuNetCreateConnections(void)
 #if defined(_WIN32)
     SOCKET fd;
 #else
-    int fd;
+    int  fd;
+    char path[64];
 #endif
     int            i;
     int            n;
@@ -1097,7 +1148,19 @@ static int npuNetCreateConnections(void)
                     continue;
                     }
                 ncbp->nextConnectionAttempt = currentTime + (time_t)ConnectionRetryInterval;
+#if defined(_WIN32)
                 fd = netInitiateConnection((struct sockaddr *)&ncbp->hostAddr);
+#else
+                if (ncbp->isLocal)
+                    {
+                    sprintf(path, LocalSocketPath, ntohs(ncbp->hostAddr.sin_port));
+                    fd = netInitiateLocalConnection(path);
+                    }
+                else
+                    {
+                    fd = netInitiateConnection((struct sockaddr *)&ncbp->hostAddr);
+                    }
+#endif
 #if defined(_WIN32)
                 if (fd == INVALID_SOCKET)
 #else
@@ -1195,13 +1258,22 @@ static bool npuNetCreateListeningSocket(Ncb *ncbp)
     sd = netCreateListener(ncbp->tcpPort);
     if (sd == INVALID_SOCKET)
 #else
-    int sd;
+    char path[64];
+    int  sd;
 
-    sd = netCreateListener(ncbp->tcpPort);
+    if (ncbp->isLocal)
+        {
+        sprintf(path, LocalSocketPath, ncbp->tcpPort);
+        sd = netCreateLocalListener(path);
+        }
+    else
+        {
+        sd = netCreateListener(ncbp->tcpPort);
+        }
     if (sd == -1)
 #endif
         {
-        logDtError(LogErrorLocation, "Can't create listener for port %d\n", ncbp->tcpPort);
+        logDtError(LogErrorLocation, "Can't create listener for %sport %d\n", ncbp->isLocal ? "local " : "", ncbp->tcpPort);
 
         return FALSE;
         }
@@ -1322,7 +1394,7 @@ static void *npuNetThread(void *param)
             j = 0;
             while (j < i)
                 {
-                if (ncbs[j].tcpPort == ncbp->tcpPort)
+                if ((ncbs[j].tcpPort == ncbp->tcpPort) && (ncbs[j].isLocal == ncbp->isLocal))
                     {
                     break;
                     }
@@ -1459,7 +1531,7 @@ static bool npuNetProcessNewConnection(int connFd, Ncb *ncbp, bool isPassive)
             pcbp2 = &pcbs[i];
             if ((pcbp2->connFd < 1)
                 && (pcbp2->ncbp != NULL) && (pcbp2->ncbp->connType == ncbp->connType)
-                && (pcbp2->ncbp->tcpPort == ncbp->tcpPort))
+                && (pcbp2->ncbp->tcpPort == ncbp->tcpPort) && (pcbp2->ncbp->isLocal == ncbp->isLocal))
                 {
                 pcbp = pcbp2;
                 break;
@@ -1501,6 +1573,7 @@ static bool npuNetProcessNewConnection(int connFd, Ncb *ncbp, bool isPassive)
         {
         npuNetSendConsoleMsg(connFd, ncbp->connType, connectingMsg);
         pcbp->ncbp->state = StConnConnected;
+        idleWake();
 
         return TRUE;
         }
@@ -1187,6 +1187,7 @@ void npuNjeResetPcb(Pcb *pcbp)
     pcbp->controls.nje.inputBufPtr      = pcbp->controls.nje.inputBuf;
     pcbp->controls.nje.outputBufPtr     = pcbp->controls.nje.outputBuf;
     pcbp->controls.nje.ttrp             = NULL;
+    npuBipResetOwner(pcbp);
 
 #if DEBUG
     fprintf(npuNjeLog, "Port %02x: reset PCB\n", pcbp->claPort);
@@ -1431,10 +1432,7 @@ static int npuNjeAppendRecords(Pcb *pcbp, u8 *bp, int len, u8 blockType)
 **------------------------------------------------------------------------*/
 static void npuNjeAsciiToEbcdic(u8 *ascii, u8 *ebcdic, int len)
     {
-    while (len-- > 0)
-        {
-        *ebcdic++ = asciiToEbcdic[*ascii++];
-        }
+    charsetTranslate(ebcdic, ascii, len, asciiToEbcdic);
     }
 
 /*--------------------------------------------------------------------------
@@ -1631,10 +1629,7 @@ static bool npuNjeConnectTerminal(Pcb *pcbp)
 **------------------------------------------------------------------------*/
 static void npuNjeEbcdicToAscii(u8 *ebcdic, u8 *ascii, int len)
     {
-    while (len-- > 0)
-        {
-        *ascii++ = ebcdicToAscii[*ebcdic++];
-        }
+    charsetTranslate(ascii, ebcdic, len, ebcdicToAscii);
     }
 
 /*--------------------------------------------------------------------------
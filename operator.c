@@ -67,6 +67,7 @@
 #define CwdPathSize      256
 #define MaxCardParams    10
 #define MaxCmdStkSize    10
+#define WaitIdlePollMsec 250
 
 /*
 **  -----------------------
@@ -83,8 +84,30 @@ typedef struct opCmd
     {
     char *name;                          /* command name */
     void (*handler)(bool help, char *cmdParams);
+    bool isWorker;                       /* TRUE if run on operator thread */
     } OpCmd;
 
+/*
+**  Arguments of the emulation thread phase of load_cards.
+*/
+typedef struct opLoadCardsArgs
+    {
+    char *deck;
+    int  channelNo;
+    int  equipmentNo;
+    char *cmdParams;
+    } OpLoadCardsArgs;
+
+/*
+**  Arguments of the emulation thread phase of dump_memory.
+*/
+typedef struct opCopyMemoryArgs
+    {
+    void   *dst;
+    void   *src;
+    size_t size;
+    } OpCopyMemoryArgs;
+
 typedef struct opCmdStackEntry
     {
     int    in;
@@ -109,6 +132,10 @@ typedef struct opNetTypeEntry
 **  ---------------------------
 */
 static void opCreateThread(void);
+static void opHandoff(void (*func)(void *arg), void *arg);
+static void opHandoffCopyMemory(void *arg);
+static void opHandoffLoadCards(void *arg);
+static void opHandoffMount(void *arg);
 
 #if defined(_WIN32)
 static void opThread(void *param);
@@ -144,6 +171,7 @@ static void opCmdDumpMemory(bool help, char *cmdParams);
 static void opCmdDumpCM(int fwa, int count);
 static void opCmdDumpEM(int fwa, int count);
 static void opCmdDumpPP(int pp, int fwa, int count);
+static bool opCopyMemory(void *dst, void *src, size_t size);
 static void opHelpDumpMemory(void);
 
 static void opCmdEnterKeys(bool help, char *cmdParams);
@@ -175,6 +203,8 @@ static void opHelpPause(void);
 
 static void opCmdPrompt(void);
 
+static void opCmdProfile(bool help, char *cmdParams);
+
 static void opCmdRemoveCards(bool help, char *cmdParams);
 static void opHelpRemoveCards(void);
 
@@ -190,6 +220,9 @@ static void opHelpSetKeyWaitInterval(void);
 static void opCmdSetMemory(bool help, char *cmdParams);
 static void opHelpSetMemory(void);
 
+static void opCmdSetMetricsPort(bool help, char *cmdParams);
+static void opHelpSetMetricsPort(void);
+
 static void opCmdSetOperatorPort(bool help, char *cmdParams);
 static void opHelpSetOperatorPort(void);
 
@@ -202,6 +235,9 @@ static void opHelpShowDisk(void);
 static void opCmdShowEquipment(bool help, char *cmdParams);
 static void opHelpShowEquipment(void);
 
+static void opCmdShowIo(bool help, char *cmdParams);
+static void opHelpShowIo(void);
+
 static void opCmdShowNetwork(bool help, char *cmdParams);
 static void opHelpShowNetwork(void);
 
@@ -237,6 +273,9 @@ static void opHelpUnloadDisk(void);
 static void opCmdUnloadTape(bool help, char *cmdParams);
 static void opHelpUnloadTape(void);
 
+static void opCmdWaitIdle(bool help, char *cmdParams);
+static void opHelpWaitIdle(void);
+
 static void opDisplayRma(Cpu180Context *ctx, u64 pva);
 static void opDisplayVersion(void);
 
@@ -245,8 +284,9 @@ static void opDisplayVersion(void);
 **  Public Variables
 **  ----------------
 */
-volatile bool opActive = FALSE;
-volatile bool opPaused = FALSE;
+volatile bool opActive        = FALSE;
+volatile bool opHandoffActive = FALSE;
+volatile bool opPaused        = FALSE;
 
 /*
 **  -----------------
@@ -255,74 +295,81 @@ volatile bool opPaused = FALSE;
 */
 static OpCmd decode[] =
     {
-    { "ccw",                   opCmdCloseConsoleWindow    },
-    { "d",                     opCmdDumpMemory            },
-    { "da",                    opCmdDisassemble           },
-    { "drc",                   opCmdDiscRemoteConsole     },
-    { "dm",                    opCmdDumpMemory            },
-    { "e",                     opCmdEnterKeys             },
-    { "ek",                    opCmdEnterKeys             },
-    { "lc",                    opCmdLoadCards             },
-    { "ld",                    opCmdLoadDisk              },
-    { "lt",                    opCmdLoadTape              },
-    { "ocw",                   opCmdOpenConsoleWindow     },
-    { "p",                     opCmdPause                 },
-    { "rc",                    opCmdRemoveCards           },
-    { "rp",                    opCmdRemovePaper           },
-    { "sa",                    opCmdShowAll               },
-    { "sd",                    opCmdShowDisk              },
-    { "se",                    opCmdShowEquipment         },
-    { "ski",                   opCmdSetKeyInterval        },
-    { "skwi",                  opCmdSetKeyWaitInterval    },
-    { "s",                     opCmdSetMemory             },
-    { "sm",                    opCmdSetMemory             },
-    { "sn",                    opCmdShowNetwork           },
-    { "sop",                   opCmdSetOperatorPort       },
-    { "ss",                    opCmdShowState             },
-    { "st",                    opCmdShowTape              },
-    { "starth",                opCmdStartHelpers          },
-    { "stoph",                 opCmdStopHelpers           },
-    { "sur",                   opCmdShowUnitRecord        },
-    { "sv",                    opCmdShowVersion           },
-    { "ud",                    opCmdUnloadDisk            },
-    { "ut",                    opCmdUnloadTape            },
-    { "close_console_window",  opCmdCloseConsoleWindow    },
-    { "deadstart",             opCmdDeadstart             },
-    { "disassemble",           opCmdDisassemble           },
-    { "disconnect_remote_console", opCmdDiscRemoteConsole },
-    { "dump_memory",           opCmdDumpMemory            },
-    { "enter_keys",            opCmdEnterKeys             },
-    { "load_cards",            opCmdLoadCards             },
-    { "load_disk",             opCmdLoadDisk              },
-    { "load_tape",             opCmdLoadTape              },
-    { "open_console_window",   opCmdOpenConsoleWindow     },
-    { "remove_cards",          opCmdRemoveCards           },
-    { "remove_paper",          opCmdRemovePaper           },
-    { "set_key_interval",      opCmdSetKeyInterval        },
-    { "set_key_wait_interval", opCmdSetKeyWaitInterval    },
-    { "set_memory",            opCmdSetMemory             },
-    { "set_operator_port",     opCmdSetOperatorPort       },
-    { "show_all",              opCmdShowAll               },
-    { "show_disk",             opCmdShowDisk              },
-    { "show_equipment",        opCmdShowEquipment         },
-    { "show_network",          opCmdShowNetwork           },
-    { "show_state",            opCmdShowState             },
-    { "show_tape",             opCmdShowTape              },
-    { "show_unitrecord",       opCmdShowUnitRecord        },
-    { "show_version",          opCmdShowVersion           },
-    { "start_helpers",         opCmdStartHelpers          },
-    { "stop_helpers",          opCmdStopHelpers           },
-    { "unload_disk",           opCmdUnloadDisk            },
-    { "unload_tape",           opCmdUnloadTape            },
-    { "version",               opCmdShowVersion           },
-    { "?",                     opCmdHelp                  },
-    { "help",                  opCmdHelp                  },
-    { "??",                    opCmdHelpAll               },
-    { "help_all",              opCmdHelpAll               },
-    { "shutdown",              opCmdShutdown              },
-    { "pause",                 opCmdPause                 },
-    { "idle",                  opCmdIdle                  },
-    { NULL,                    NULL                       }
+    { "ccw",                       opCmdCloseConsoleWindow,    FALSE },
+    { "d",                         opCmdDumpMemory,            TRUE  },
+    { "da",                        opCmdDisassemble,           FALSE },
+    { "drc",                       opCmdDiscRemoteConsole,     FALSE },
+    { "dm",                        opCmdDumpMemory,            TRUE  },
+    { "e",                         opCmdEnterKeys,             TRUE  },
+    { "ek",                        opCmdEnterKeys,             TRUE  },
+    { "lc",                        opCmdLoadCards,             TRUE  },
+    { "ld",                        opCmdLoadDisk,              TRUE  },
+    { "lt",                        opCmdLoadTape,              TRUE  },
+    { "ocw",                       opCmdOpenConsoleWindow,     FALSE },
+    { "p",                         opCmdPause,                 FALSE },
+    { "rc",                        opCmdRemoveCards,           FALSE },
+    { "rp",                        opCmdRemovePaper,           FALSE },
+    { "sa",                        opCmdShowAll,               FALSE },
+    { "sd",                        opCmdShowDisk,              FALSE },
+    { "se",                        opCmdShowEquipment,         FALSE },
+    { "sio",                       opCmdShowIo,                FALSE },
+    { "ski",                       opCmdSetKeyInterval,        FALSE },
+    { "skwi",                      opCmdSetKeyWaitInterval,    FALSE },
+    { "s",                         opCmdSetMemory,             FALSE },
+    { "sm",                        opCmdSetMemory,             FALSE },
+    { "smp",                       opCmdSetMetricsPort,        FALSE },
+    { "sn",                        opCmdShowNetwork,           FALSE },
+    { "sop",                       opCmdSetOperatorPort,       FALSE },
+    { "ss",                        opCmdShowState,             FALSE },
+    { "st",                        opCmdShowTape,              FALSE },
+    { "starth",                    opCmdStartHelpers,          FALSE },
+    { "stoph",                     opCmdStopHelpers,           FALSE },
+    { "sur",                       opCmdShowUnitRecord,        FALSE },
+    { "sv",                        opCmdShowVersion,           FALSE },
+    { "ud",                        opCmdUnloadDisk,            FALSE },
+    { "ut",                        opCmdUnloadTape,            FALSE },
+    { "wi",                        opCmdWaitIdle,              TRUE  },
+    { "close_console_window",      opCmdCloseConsoleWindow,    FALSE },
+    { "deadstart",                 opCmdDeadstart,             FALSE },
+    { "disassemble",               opCmdDisassemble,           FALSE },
+    { "disconnect_remote_console", opCmdDiscRemoteConsole,     FALSE },
+    { "dump_memory",               opCmdDumpMemory,            TRUE  },
+    { "enter_keys",                opCmdEnterKeys,             TRUE  },
+    { "load_cards",                opCmdLoadCards,             TRUE  },
+    { "load_disk",                 opCmdLoadDisk,              TRUE  },
+    { "load_tape",                 opCmdLoadTape,              TRUE  },
+    { "open_console_window",       opCmdOpenConsoleWindow,     FALSE },
+    { "remove_cards",              opCmdRemoveCards,           FALSE },
+    { "remove_paper",              opCmdRemovePaper,           FALSE },
+    { "set_key_interval",          opCmdSetKeyInterval,        FALSE },
+    { "set_key_wait_interval",     opCmdSetKeyWaitInterval,    FALSE },
+    { "set_memory",                opCmdSetMemory,             FALSE },
+    { "set_metrics_port",          opCmdSetMetricsPort,        FALSE },
+    { "set_operator_port",         opCmdSetOperatorPort,       FALSE },
+    { "show_all",                  opCmdShowAll,               FALSE },
+    { "show_disk",                 opCmdShowDisk,              FALSE },
+    { "show_equipment",            opCmdShowEquipment,         FALSE },
+    { "show_io",                   opCmdShowIo,                FALSE },
+    { "show_network",              opCmdShowNetwork,           FALSE },
+    { "show_state",                opCmdShowState,             FALSE },
+    { "show_tape",                 opCmdShowTape,              FALSE },
+    { "show_unitrecord",           opCmdShowUnitRecord,        FALSE },
+    { "show_version",              opCmdShowVersion,           FALSE },
+    { "start_helpers",             opCmdStartHelpers,          FALSE },
+    { "stop_helpers",              opCmdStopHelpers,           FALSE },
+    { "unload_disk",               opCmdUnloadDisk,            FALSE },
+    { "unload_tape",               opCmdUnloadTape,            FALSE },
+    { "version",                   opCmdShowVersion,           FALSE },
+    { "?",                         opCmdHelp,                  FALSE },
+    { "help",                      opCmdHelp,                  FALSE },
+    { "??",                        opCmdHelpAll,               FALSE },
+    { "help_all",                  opCmdHelpAll,               FALSE },
+    { "shutdown",                  opCmdShutdown,              FALSE },
+    { "pause",                     opCmdPause,                 FALSE },
+    { "idle",                      opCmdIdle,                  FALSE },
+    { "profile",                   opCmdProfile,               FALSE },
+    { "wait_idle",                 opCmdWaitIdle,              TRUE  },
+    { NULL,                        NULL,                       FALSE }
     };
 
 static OpNetTypeEntry netTypes[] =
@@ -341,6 +388,13 @@ static OpNetTypeEntry netTypes[] =
 
 static void            (*opCmdFunction)(bool help, char *cmdParams);
 static char            opCmdParams[256];
+static void            (*opHandoffFunc)(void *arg);
+static void            *opHandoffArg;
+#if defined(_WIN32)
+static HANDLE opHandoffMutex = NULL;
+#else
+static pthread_mutex_t opHandoffMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 static OpCmdStackEntry opCmdStack[MaxCmdStkSize];
 static int             opCmdStackPtr = -1;
 #if defined(_WIN32)
@@ -372,6 +426,10 @@ static int  opOutIdx = 0;
 **------------------------------------------------------------------------*/
 void opInit(void)
     {
+#if defined(_WIN32)
+    opHandoffMutex = CreateMutex(NULL, FALSE, NULL);
+#endif
+
     /*
     **  Create the operator thread which accepts command input.
     */
@@ -468,6 +526,11 @@ bool opIsConsoleInput(void)
 **------------------------------------------------------------------------*/
 void opRequest(void)
     {
+    if (opHandoffActive)
+        {
+        opHandoffFunc(opHandoffArg);
+        opHandoffActive = FALSE;
+        }
     if (opActive)
         {
         opCmdFunction(FALSE, opCmdParams);
@@ -531,6 +594,47 @@ static void opCreateThread(void)
 #endif
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Hand a function off to the main emulation thread and
+**                  wait for it to complete.
+**
+**                  Commands which are run on the operator thread (or
+**                  other background threads such as the filesystem
+**                  watcher) do their file I/O there and use this to make
+**                  the changes to emulation state, so that the emulation
+**                  is stalled only for the duration of those changes.
+**
+**  Parameters:     Name        Description.
+**                  func        function to call on the emulation thread
+**                  arg         argument passed to func
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opHandoff(void (*func)(void *arg), void *arg)
+    {
+#if defined(_WIN32)
+    WaitForSingleObject(opHandoffMutex, INFINITE);
+#else
+    pthread_mutex_lock(&opHandoffMutex);
+#endif
+
+    opHandoffFunc   = func;
+    opHandoffArg    = arg;
+    opHandoffActive = TRUE;
+    idleWake();
+    while (opHandoffActive && emulationActive)
+        {
+        sleepMsec(1);
+        }
+
+#if defined(_WIN32)
+    ReleaseMutex(opHandoffMutex);
+#else
+    pthread_mutex_unlock(&opHandoffMutex);
+#endif
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Operator thread.
 **
@@ -597,6 +701,16 @@ static void *opThread(void *param)
         {
         ep = &opCmdStack[opCmdStackPtr];
 
+        /*
+        **  In benchmark mode the run ends when the operator script does.
+        */
+        if (benchmarkMode && (opCmdStackPtr == 0))
+            {
+            opDisplay("\n    > Benchmark workload complete\n");
+            emulationActive = FALSE;
+            break;
+            }
+
         /*
         **  Wait for command input.
         */
@@ -711,10 +825,14 @@ static void *opThread(void *param)
             {
             if (strcasecmp(cp->name, name) == 0)
                 {
-                if (cp->handler == opCmdEnterKeys)
+                if (cp->isWorker)
                     {
-                    opCmdEnterKeys(FALSE, params);
-                    opActive = FALSE;
+                    /*
+                    **  Execute the command on this thread.  It hands off
+                    **  only its changes to emulation state to the main
+                    **  emulation thread.
+                    */
+                    cp->handler(FALSE, params);
                     break;
                     }
 
@@ -724,6 +842,7 @@ static void *opThread(void *param)
                 strcpy(opCmdParams, params);
                 opCmdFunction = cp->handler;
                 opActive      = TRUE;
+                idleWake();
                 break;
                 }
             }
@@ -1773,9 +1892,10 @@ static void opCmdDumpCM(int fwa, int count)
     char   buf[120];
     char   c;
     char   *cp;
-    int    limit;
+    int    i;
     int    shiftCount;
     CpWord word;
+    CpWord *words;
 
     if ((fwa < 0) || (count < 0) || ((u32)(fwa + count) > cpuMaxMemory))
         {
@@ -1783,15 +1903,20 @@ static void opCmdDumpCM(int fwa, int count)
 
         return;
         }
-    for (limit = fwa + count; fwa < limit; fwa++)
+    words = (CpWord *)malloc(count * sizeof(CpWord) + 1);
+    if ((words == NULL) || !opCopyMemory(words, (void *)(cpMem + fwa), count * sizeof(CpWord)))
+        {
+        free(words);
+
+        return;
+        }
+    for (i = 0; i < count; i++, fwa++)
         {
-        word = cpMem[fwa];
+        word = words[i];
         opDisplay("    > %08o " FMT60_020o " ", fwa, word & Mask60);
-        for (shiftCount = 54, cp = buf; shiftCount >= 0; shiftCount -= 6)
-            {
-            *cp++ = cdcToAscii[(word >> shiftCount) & Mask6];
-            }
-        *cp = '\0';
+        charsetUnpack60To6((u8 *)buf, &word, 1);
+        charsetTranslate((u8 *)buf, (u8 *)buf, 10, (const u8 *)cdcToAscii);
+        buf[10] = '\0';
         opDisplay("%s", buf);
         if (isCyber180)
             {
@@ -1806,15 +1931,15 @@ static void opCmdDumpCM(int fwa, int count)
             }
         opDisplay("\n");
         }
+    free(words);
     }
 
 static void opCmdDumpEM(int fwa, int count)
     {
     char   buf[42];
-    char   *cp;
-    int    limit;
-    int    shiftCount;
+    int    i;
     CpWord word;
+    CpWord *words;
 
     if ((fwa < 0) || (count < 0) || ((u32)(fwa + count) > extMaxMemory))
         {
@@ -1822,17 +1947,23 @@ static void opCmdDumpEM(int fwa, int count)
 
         return;
         }
-    for (limit = fwa + count; fwa < limit; fwa++)
+    words = (CpWord *)malloc(count * sizeof(CpWord) + 1);
+    if ((words == NULL) || !opCopyMemory(words, (void *)(extMem + fwa), count * sizeof(CpWord)))
+        {
+        free(words);
+
+        return;
+        }
+    for (i = 0; i < count; i++, fwa++)
         {
-        word = extMem[fwa];
+        word = words[i];
         opDisplay("%08o " FMT60_020o " ", fwa, word);
-        for (shiftCount = 54, cp = buf; shiftCount >= 0; shiftCount -= 6)
-            {
-            *cp++ = cdcToAscii[(word >> shiftCount) & Mask6];
-            }
-        *cp = '\0';
+        charsetUnpack60To6((u8 *)buf, &word, 1);
+        charsetTranslate((u8 *)buf, (u8 *)buf, 10, (const u8 *)cdcToAscii);
+        buf[10] = '\0';
         opDisplay("%s\n", buf);
         }
+    free(words);
     }
 
 static void opCmdDumpPP(int ppNum, int fwa, int count)
@@ -1840,9 +1971,9 @@ static void opCmdDumpPP(int ppNum, int fwa, int count)
     char   buf[40];
     char   c;
     char   *cp;
-    int    limit;
-    PpSlot *pp;
+    int    i;
     PpWord word;
+    PpWord words[010000];
 
     if ((ppNum >= 020) && (ppNum <= 031))
         {
@@ -1866,10 +1997,13 @@ static void opCmdDumpPP(int ppNum, int fwa, int count)
 
         return;
         }
-    pp = &ppu[ppNum];
-    for (limit = fwa + count; fwa < limit; fwa++)
+    if (!opCopyMemory(words, ppu[ppNum].mem + fwa, count * sizeof(PpWord)))
         {
-        word = pp->mem[fwa];
+        return;
+        }
+    for (i = 0; i < count; i++, fwa++)
+        {
+        word = words[i];
         if (isCyber180)
             {
             opDisplay("%04o %06o ", fwa, word);
@@ -1903,6 +2037,38 @@ static void opHelpDumpMemory(void)
     opDisplay("    > 'dump_memory PP<nn>,<fwa>,<count>' dump <count> words of PP nn's memory starting from octal address <fwa>.\n");
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Take a consistent copy of emulated memory for display
+**                  on the operator thread.
+**
+**  Parameters:     Name        Description.
+**                  dst         buffer receiving the copy
+**                  src         first word of emulated memory to copy
+**                  size        number of bytes to copy
+**
+**  Returns:        TRUE if the copy was made, FALSE if emulation has
+**                  ended.
+**
+**------------------------------------------------------------------------*/
+static bool opCopyMemory(void *dst, void *src, size_t size)
+    {
+    OpCopyMemoryArgs args;
+
+    args.dst  = dst;
+    args.src  = src;
+    args.size = size;
+    opHandoff(opHandoffCopyMemory, &args);
+
+    return emulationActive;
+    }
+
+static void opHandoffCopyMemory(void *arg)
+    {
+    OpCopyMemoryArgs *ap = (OpCopyMemoryArgs *)arg;
+
+    memcpy(ap->dst, ap->src, ap->size);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Enter keys on the system console.
 **
@@ -2367,6 +2533,63 @@ static void opHelpSetOperatorPort(void)
     opDisplay("    > 'set_operator_port <port>' set the TCP port on which to listen for operator connections.\n");
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Set port for performance metrics scrapes
+**
+**  Parameters:     Name        Description.
+**                  help        Request only help on this command.
+**                  cmdParams   Command parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opCmdSetMetricsPort(bool help, char *cmdParams)
+    {
+    int numParam;
+    int port;
+
+    /*
+    **  Process help request.
+    */
+    if (help)
+        {
+        opHelpSetMetricsPort();
+
+        return;
+        }
+    numParam = sscanf(cmdParams, "%d", &port);
+    if (numParam != 1)
+        {
+        opDisplay("    > Missing or invalid parameter\n");
+
+        return;
+        }
+    if ((port < 0) || (port > 65535))
+        {
+        opDisplay("    > Invalid port number\n");
+
+        return;
+        }
+    if (port == 0)
+        {
+        metricsStopListening();
+        opDisplay("    > Metrics port closed\n");
+        }
+    else if (metricsStartListening(port))
+        {
+        opDisplay("    > Serving metrics on port %d\n", port);
+        }
+    else
+        {
+        opDisplay("    > Failed to listen on port %d\n", port);
+        }
+    }
+
+static void opHelpSetMetricsPort(void)
+    {
+    opDisplay("    > 'set_metrics_port <port>' set the TCP port on which to serve performance metrics (0 to close).\n");
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Start listening for operator connections
 **
@@ -2669,15 +2892,16 @@ static void opHelpHelpAll(void)
 **------------------------------------------------------------------------*/
 void opCmdLoadCards(bool help, char *cmdParams)
     {
-    int         channelNo;
-    int         equipmentNo;
-    FILE        *fcb;
-    char        fname[MaxFSPath];
-    char        newDeck[MaxFSPath];
-    int         numParam;
-    int         rc;
-    static int  seqNo = 1;
-    struct stat statBuf;
+    OpLoadCardsArgs args;
+    int             channelNo;
+    int             equipmentNo;
+    FILE            *fcb;
+    char            fname[MaxFSPath];
+    char            newDeck[MaxFSPath];
+    int             numParam;
+    int             rc;
+    static int      seqNo = 1;
+    struct stat     statBuf;
 
     /*
     **  Process help request.
@@ -2796,16 +3020,41 @@ void opCmdLoadCards(bool help, char *cmdParams)
         return;
         }
 
-    cr405PostProcess(fname, channelNo, equipmentNo, cmdParams);
-    cr3447PostProcess(fname, channelNo, equipmentNo, cmdParams);
-
     /*
     **  If an input directory was specified (but there was no
     **  output directory) then we need to give the card reader
     **  a chance to clean up the dedicated input directory.
     */
-    cr405LoadCards(newDeck, channelNo, equipmentNo, cmdParams);
-    cr3447LoadCards(newDeck, channelNo, equipmentNo, cmdParams);
+    cr405PostProcess(fname, channelNo, equipmentNo, cmdParams);
+    cr3447PostProcess(fname, channelNo, equipmentNo, cmdParams);
+
+    /*
+    **  Only queueing the preprocessed deck on the card reader is done
+    **  on the emulation thread.
+    */
+    args.deck        = newDeck;
+    args.channelNo   = channelNo;
+    args.equipmentNo = equipmentNo;
+    args.cmdParams   = cmdParams;
+    opHandoff(opHandoffLoadCards, &args);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Emulation thread phase of load_cards: queue a
+**                  preprocessed deck on the card reader.
+**
+**  Parameters:     Name        Description.
+**                  arg         pointer to OpLoadCardsArgs
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opHandoffLoadCards(void *arg)
+    {
+    OpLoadCardsArgs *ap = (OpLoadCardsArgs *)arg;
+
+    cr405LoadCards(ap->deck, ap->channelNo, ap->equipmentNo, ap->cmdParams);
+    cr3447LoadCards(ap->deck, ap->channelNo, ap->equipmentNo, ap->cmdParams);
     }
 
 static void opHelpLoadCards(void)
@@ -3252,6 +3501,8 @@ static int opPrepCards(char *str, FILE *fcb)
 **------------------------------------------------------------------------*/
 static void opCmdLoadDisk(bool help, char *cmdParams)
     {
+    MediaMount mount;
+
     /*
     **  Process help request.
     */
@@ -3273,7 +3524,14 @@ static void opCmdLoadDisk(bool help, char *cmdParams)
         return;
         }
 
-    dd8xxLoadDisk(cmdParams);
+    /*
+    **  The container is opened, and a new disk manufactured, on this
+    **  thread.  Only installing it on the unit is handed off.
+    */
+    if (dd8xxOpenDisk(cmdParams, &mount))
+        {
+        opHandoff(opHandoffMount, &mount);
+        }
     }
 
 static void opHelpLoadDisk(void)
@@ -3334,6 +3592,8 @@ static void opHelpUnloadDisk(void)
 **------------------------------------------------------------------------*/
 static void opCmdLoadTape(bool help, char *cmdParams)
     {
+    MediaMount mount;
+
     /*
     **  Process help request.
     */
@@ -3355,9 +3615,16 @@ static void opCmdLoadTape(bool help, char *cmdParams)
         return;
         }
 
-    mt669LoadTape(cmdParams);
-    mt679LoadTape(cmdParams);
-    mt362xLoadTape(cmdParams);
+    /*
+    **  The image is opened on this thread.  Only installing it on the
+    **  unit is handed off.
+    */
+    if (mt669OpenTape(cmdParams, &mount)
+        || mt679OpenTape(cmdParams, &mount)
+        || mt362xOpenTape(cmdParams, &mount))
+        {
+        opHandoff(opHandoffMount, &mount);
+        }
     }
 
 static void opHelpLoadTape(void)
@@ -3365,6 +3632,23 @@ static void opHelpLoadTape(void)
     opDisplay("    > 'load_tape <channel>,<equipment>,<unit>,<r|w>,<filename>' load specified tape.\n");
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Emulation thread phase of load_disk and load_tape:
+**                  install an opened medium on its unit.
+**
+**  Parameters:     Name        Description.
+**                  arg         pointer to MediaMount
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opHandoffMount(void *arg)
+    {
+    MediaMount *mp = (MediaMount *)arg;
+
+    mp->install(mp);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Unload a mounted tape
 **
@@ -3408,6 +3692,102 @@ static void opHelpUnloadTape(void)
     opDisplay("    > 'unload_tape <channel>,<equipment>,<unit>' unload specified tape unit.\n");
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Wait until the emulated system has been idle for a
+**                  given time. The system is considered idle while the
+**                  idle throttle is waiting for at least half of the
+**                  elapsed time.
+**
+**  Parameters:     Name        Description.
+**                  help        Request only help on this command.
+**                  cmdParams   Command parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opCmdWaitIdle(bool help, char *cmdParams)
+    {
+    u64 idleUsec;
+    u64 lastIdleUsec;
+    u64 lastTime;
+    u64 now;
+    int numParam;
+    u64 quietUsec;
+    u32 secs;
+    u64 startTime;
+    u32 timeout;
+
+    /*
+    **  Process help request.
+    */
+    if (help)
+        {
+        opHelpWaitIdle();
+
+        return;
+        }
+
+    /*
+    **  Check parameters.
+    */
+    timeout  = 3600;
+    numParam = sscanf(cmdParams, "%u,%u", &secs, &timeout);
+    if ((numParam < 1) || (secs < 1) || (timeout < 1))
+        {
+        opDisplay("    > Missing or invalid parameter\n");
+        opHelpWaitIdle();
+
+        return;
+        }
+    if (!idle)
+        {
+        opDisplay("    > Idle detection is off\n");
+
+        return;
+        }
+
+    /*
+    **  Process command.
+    */
+    quietUsec    = 0;
+    lastIdleUsec = metrics.idleSleepUsec;
+    startTime    = lastTime = getMicroseconds();
+    while (emulationActive)
+        {
+        sleepMsec(WaitIdlePollMsec);
+        now      = getMicroseconds();
+        idleUsec = metrics.idleSleepUsec;
+        if ((idleUsec - lastIdleUsec) * 2 >= now - lastTime)
+            {
+            quietUsec += now - lastTime;
+            if (quietUsec >= (u64)secs * 1000000)
+                {
+                opDisplay("    > System idle after %llu seconds\n", (unsigned long long)((now - startTime) / 1000000));
+
+                return;
+                }
+            }
+        else
+            {
+            quietUsec = 0;
+            }
+        lastIdleUsec = idleUsec;
+        lastTime     = now;
+        if (now - startTime >= (u64)timeout * 1000000)
+            {
+            opDisplay("    > Timed out waiting for system to become idle\n");
+
+            return;
+            }
+        }
+    }
+
+static void opHelpWaitIdle(void)
+    {
+    opDisplay("    > 'wait_idle <secs>[,<timeout>]' wait until the system has been idle for <secs> seconds,\n");
+    opDisplay("    >      or at most <timeout> seconds [default 3600]. Requires idle detection.\n");
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Show status of PP's and/or CPU
 **
@@ -4214,6 +4594,50 @@ static void opHelpShowEquipment(void)
     opDisplay("    > 'show_equipment' show status of all attached equipment.\n");
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Show I/O statistics of all disk and tape units
+**
+**  Parameters:     Name        Description.
+**                  help        Request only help on this command.
+**                  cmdParams   Command parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opCmdShowIo(bool help, char *cmdParams)
+    {
+    /*
+    **  Process help request.
+    */
+    if (help)
+        {
+        opHelpShowIo();
+
+        return;
+        }
+
+    /*
+    **  Check parameters and process command.
+    */
+    if (strlen(cmdParams) != 0)
+        {
+        opDisplay("    > No parameters expected\n");
+        opHelpShowIo();
+
+        return;
+        }
+
+    opDisplay("\n    > Disk and Tape I/O Statistics:");
+    opDisplay("\n    > -----------------------------\n");
+
+    metricsShowIoStatus();
+    }
+
+static void opHelpShowIo(void)
+    {
+    opDisplay("    > 'show_io' show operation counts, data volumes and host latencies of all disk and tape units.\n");
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Show status of data communication interfaces
 **
@@ -4432,6 +4856,7 @@ static void opCmdIdle(bool help, char *cmdParams)
         opDisplay("    > Sleep every %u cycles for %u usec\n", idleTrigger, idleTime);
 #endif
         opDisplay("    > NPU/MDI is busy when %d or more network buffers active\n", idleNetBufs);
+        idleShowStatus();
 
         return;
         }
@@ -4481,6 +4906,90 @@ static void opCmdIdle(bool help, char *cmdParams)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Control the CPU and PP sampling profiler.
+**
+**  Parameters:     Name        Description.
+**                  help        Request only help on this command.
+**                  cmdParams   Command parameters
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void opCmdProfile(bool help, char *cmdParams)
+    {
+    u32  interval;
+    char path[256];
+
+    if (help)
+        {
+        opDisplay("    > CPU and PP Sampling Profiler\n");
+        opDisplay("    > profile                     show profiler status\n");
+        opDisplay("    > profile on[,<num_cycles>]   start sampling, optionally every <num_cycles> major cycles\n");
+        opDisplay("    > profile off                 stop sampling\n");
+        opDisplay("    > profile reset               discard collected samples\n");
+        opDisplay("    > profile write,<path>        write collected samples as folded stacks for flame graphs\n");
+
+        return;
+        }
+
+    if (strlen(cmdParams) == 0)
+        {
+        profileShowStatus();
+
+        return;
+        }
+    if ((strncasecmp("on", cmdParams, 2) == 0) && ((cmdParams[2] == '\0') || (cmdParams[2] == ',')))
+        {
+        interval = 0;
+        if ((cmdParams[2] == ',') && ((sscanf(cmdParams + 3, "%u", &interval) != 1) || (interval < 1)))
+            {
+            opDisplay("    > Invalid sampling interval\n");
+
+            return;
+            }
+        profileStart(interval);
+        profileShowStatus();
+
+        return;
+        }
+    if (strcasecmp("off", cmdParams) == 0)
+        {
+        profileStop();
+        profileShowStatus();
+
+        return;
+        }
+    if (strcasecmp("reset", cmdParams) == 0)
+        {
+        profileReset();
+        profileShowStatus();
+
+        return;
+        }
+    if (strncasecmp("write,", cmdParams, 6) == 0)
+        {
+        if (sscanf(cmdParams + 6, "%255s", path) != 1)
+            {
+            opDisplay("    > Missing report path\n");
+
+            return;
+            }
+        if (profileWrite(path))
+            {
+            opDisplay("    > Profile written to %s\n", path);
+            }
+        else
+            {
+            opDisplay("    > Failed to open %s\n", path);
+            }
+
+        return;
+        }
+
+    opDisplay("    > Unrecognized profile parameter: %s\n", cmdParams);
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Start helper processes
 **
@@ -110,7 +110,9 @@
 **  Private Function Prototypes
 **  ---------------------------
 */
+static void ppCheckIdleLoop(void);
 static bool ppCheckOsBounds(u32 address);
+static u32 ppCmBurstLength(u32 *address);
 
 static void ppOpPSN(void);    // 00
 static void ppOpLJM(void);    // 01
@@ -234,6 +236,8 @@ u32    iouOsBoundary;
 PpSlot *ppu;
 PpSlot *activePpu;
 u8     ppuCount;
+u32    ppCmBurst = 1;
+bool   (*ppIdleDetector)(PpSlot *pp, PpWord loopAddr, PpWord jumpAddr) = NULL;
 
 /*
 **  -----------------
@@ -512,6 +516,8 @@ void ppInit(u8 count)
         ppu[pp].isLoad               = FALSE;
         ppu[pp].osBoundsCheckEnabled = FALSE;
         ppu[pp].isBelowOsBound       = FALSE;
+        ppu[pp].isParked             = FALSE;
+        ppu[pp].idleAddress          = 0;
         }
 
     pp = 0;
@@ -718,9 +724,11 @@ void ppMacSetIouRegister(u8 reg, u64 word)
 
         if ((word & 0x0020) != 0) // load/dump/idle PP
             {
-            pp->isIdle = FALSE;
-            pp->isDump = FALSE;
-            pp->isLoad = FALSE;
+            pp->isIdle      = FALSE;
+            pp->isDump      = FALSE;
+            pp->isLoad      = FALSE;
+            pp->isParked    = FALSE;
+            pp->idleAddress = 0;
 
             if ((word & 0x1000) != 0) // load PP
                 {
@@ -923,7 +931,8 @@ void ppTerminate(void)
 **------------------------------------------------------------------------*/
 void ppStep(void)
     {
-    u8 i;
+    CpWord data;
+    u8     i;
 
     /*
     **  Exercise each PP in the barrel.
@@ -940,6 +949,20 @@ void ppStep(void)
             continue;
             }
 
+        /*
+        **  A PP parked in its idle loop resumes the loop only once the
+        **  input register it polls is no longer zero.
+        */
+        if (activePpu->isParked)
+            {
+            cpuPpReadMem(activePpu->idleAddress, &data);
+            if (((data >> 48) & Mask12) == 0)
+                {
+                continue;
+                }
+            activePpu->isParked = FALSE;
+            }
+
         if (activePpu->exchangingCpu >= 0)
             {
             cpuAcquireExchangeMutex();
@@ -968,7 +991,8 @@ void ppStep(void)
             **  Extract next PPU instruction.
             */
             activePpu->regK = activePpu->mem[activePpu->regP];
- 
+            activePpu->instructionCount += 1;
+
             if (isCyber180)
                 {
                 activePpu->opF = (activePpu->regK >> 6) & 01777;
@@ -1046,6 +1070,78 @@ void ppStep(void)
         }
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Recognise the NOS and KRONOS PP resident idle loop
+**
+**                      L   LDD  IA     or   L   LDD  IA
+**                          CRD  IR              CRD  IR
+**                          LDD  IR              LDD  IR
+**                          ZJN  L               NJN  *+2
+**                                               UJN  L
+**
+**                  which polls the PP's input register in CM until a
+**                  request appears in it.
+**
+**  Parameters:     Name        Description.
+**                  pp          PP context
+**                  loopAddr    address jumped to
+**                  jumpAddr    address of the jump instruction
+**
+**  Returns:        TRUE if the PP is in its idle loop. The CM address
+**                  of the input register is stored in the PP context.
+**
+**------------------------------------------------------------------------*/
+bool ppIdleDetectorNOS(PpSlot *pp, PpWord loopAddr, PpWord jumpAddr)
+    {
+    PpWord ia;
+    PpWord ir;
+    PpWord *mem;
+
+    mem = pp->mem;
+    if ((mem[loopAddr] >> 6) != 030 || (mem[(loopAddr + 1) & Mask12] >> 6) != 060)
+        {
+        return FALSE;
+        }
+    ia = mem[loopAddr] & Mask6;
+    ir = mem[(loopAddr + 1) & Mask12] & Mask6;
+    if (mem[(loopAddr + 2) & Mask12] != (PpWord)(03000 | ir))
+        {
+        return FALSE;
+        }
+    if (jumpAddr == ((loopAddr + 3) & Mask12))
+        {
+        if (mem[jumpAddr] != 00474) // ZJN L
+            {
+            return FALSE;
+            }
+        }
+    else if (jumpAddr == ((loopAddr + 4) & Mask12))
+        {
+        if ((mem[(loopAddr + 3) & Mask12] != 00502) || (mem[jumpAddr] != 00373)) // NJN *+2, UJN L
+            {
+            return FALSE;
+            }
+        }
+    else
+        {
+        return FALSE;
+        }
+
+    /*
+    **  The input register address is loaded with LDD, so it is a positive
+    **  12 bit value which CRD uses as an absolute address without
+    **  relocation. Park only on an address which lies within CM, so that
+    **  the polled word is the one the loop itself reads.
+    */
+    if ((u32)(mem[ia] & Mask12) >= cpuMaxMemory)
+        {
+        return FALSE;
+        }
+    pp->idleAddress = mem[ia] & Mask12;
+
+    return TRUE;
+    }
+
 /*
  **--------------------------------------------------------------------------
  **
@@ -1075,6 +1171,27 @@ static u32 ppAdd18(u32 op1, u32 op2)
     return (acc18 & Mask18);
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Park the active PP if the backward jump it has just
+**                  taken closes its idle loop.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void ppCheckIdleLoop(void)
+    {
+    PpWord jumpAddr;
+
+    jumpAddr = (activePpu->regP + 0100 - 1 - activePpu->opD) & Mask12;
+    if ((*ppIdleDetector)(activePpu, activePpu->regP, jumpAddr))
+        {
+        activePpu->isParked  = TRUE;
+        metrics.ppIdleParks += 1;
+        }
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Check a CM reference against the Cyber 180 OS bounds register
 **
@@ -1109,6 +1226,58 @@ static bool ppCheckOsBounds(u32 address)
     return FALSE;
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Determine the CM address of the next word of a CRM, CWM,
+**                  CRML or CWML block transfer and how many words of the
+**                  block may be moved in this step.
+**
+**  Parameters:     Name        Description.
+**                  address     (out) absolute CM address of next word
+**
+**  Returns:        Number of words to move. A burst never crosses the OS
+**                  boundary or a wrap of the A register, so the relocation
+**                  and bounds check made for its first word hold for all.
+**
+**------------------------------------------------------------------------*/
+static u32 ppCmBurstLength(u32 *address)
+    {
+    u32 count;
+    u32 limit;
+
+    if (((activePpu->regA & Sign18) != 0) && ((features & HasRelocationReg) != 0))
+        {
+        *address = activePpu->regR + (activePpu->regA & Mask17);
+        limit    = (Mask17 + 1) - (activePpu->regA & Mask17);
+        }
+    else
+        {
+        *address = activePpu->regA & Mask18;
+        limit    = (Mask18 + 1) - *address;
+        }
+
+    if (ppCmBurst == 1)
+        {
+        return 1;
+        }
+
+    count = (activePpu->regQ == 0) ? (Mask12 + 1) : activePpu->regQ;
+    if ((ppCmBurst != 0) && (count > ppCmBurst))
+        {
+        count = ppCmBurst;
+        }
+    if (count > limit)
+        {
+        count = limit;
+        }
+    if (isCyber180 && activePpu->osBoundsCheckEnabled
+        && (*address < iouOsBoundary) && (*address + count > iouOsBoundary))
+        {
+        count = iouOsBoundary - *address;
+        }
+
+    return count;
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        18 bit ones-complement subtraction
 **
@@ -1162,6 +1331,10 @@ static void ppOpRJM(void)     // 02
 static void ppOpUJN(void)     // 03
     {
     PpAddOffset(activePpu->regP, activePpu->opD);
+    if ((activePpu->opD >= 040) && (ppIdleDetector != NULL))
+        {
+        ppCheckIdleLoop();
+        }
     }
 
 static void ppOpZJN(void)     // 04
@@ -1169,6 +1342,10 @@ static void ppOpZJN(void)     // 04
     if (activePpu->regA == 0)
         {
         PpAddOffset(activePpu->regP, activePpu->opD);
+        if ((activePpu->opD >= 040) && (ppIdleDetector != NULL))
+            {
+            ppCheckIdleLoop();
+            }
         }
     }
 
@@ -1612,6 +1789,7 @@ static void ppOpCRD(void)     // 60
 static void ppOpCRM(void)     // 61
     {
     u32    address;
+    u32    count;
     CpWord data;
 
     if (!activePpu->busy)
@@ -1622,32 +1800,33 @@ static void ppOpCRM(void)     // 61
         activePpu->regP   = activePpu->mem[activePpu->regP] & Mask12;
         }
 
-    if (((activePpu->regA & Sign18) != 0) && ((features & HasRelocationReg) != 0))
+    count = ppCmBurstLength(&address);
+    do
         {
-        address = activePpu->regR + (activePpu->regA & Mask17);
-        }
-    else
-        {
-        address = activePpu->regA & Mask18;
-        }
-    cpuPpReadMem(address, &data);
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 48) & Mask12);
-    PpIncrement(activePpu->regP);
+        cpuPpReadMem(address++, &data);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 48) & Mask12);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 36) & Mask12);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 36) & Mask12);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 24) & Mask12);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 24) & Mask12);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 12) & Mask12);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 12) & Mask12);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)(data & Mask12);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)(data & Mask12);
+        PpIncrement(activePpu->regP);
 
-    activePpu->regA = (activePpu->regA + 1) & Mask18;
-    PpDecrement(activePpu->regQ);
+        activePpu->regA = (activePpu->regA + 1) & Mask18;
+        PpDecrement(activePpu->regQ);
+
+#if CcDebug == 1
+        traceCmWord(data);
+#endif
+        }
+    while (--count > 0);
 
     if (activePpu->regQ == 0)
         {
@@ -1655,10 +1834,6 @@ static void ppOpCRM(void)     // 61
         PpIncrement(activePpu->regP);
         activePpu->busy = FALSE;
         }
-
-#if CcDebug == 1
-    traceCmWord(data);
-#endif
     }
 
 static void ppOpCWD(void)     // 62
@@ -1703,7 +1878,9 @@ static void ppOpCWD(void)     // 62
 static void ppOpCWM(void)     // 63
     {
     u32    address;
+    u32    count;
     CpWord data;
+    bool   isFault;
 
     if (!activePpu->busy)
         {
@@ -1712,55 +1889,49 @@ static void ppOpCWM(void)     // 63
         activePpu->mem[0] = activePpu->regP;
         activePpu->regP   = activePpu->mem[activePpu->regP] & Mask12;
         }
-    data = (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 48;
-    PpIncrement(activePpu->regP);
 
-    data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 36;
-    PpIncrement(activePpu->regP);
+    count   = ppCmBurstLength(&address);
+    isFault = ppCheckOsBounds(address);
+    if (isFault && activePpu->isStopEnabled)
+        {
+        activePpu->isStopped = TRUE;
 
-    data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 24;
-    PpIncrement(activePpu->regP);
+        return;
+        }
 
-    data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 12;
-    PpIncrement(activePpu->regP);
+    do
+        {
+        data = (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 48;
+        PpIncrement(activePpu->regP);
 
-    data |= activePpu->mem[activePpu->regP] & Mask12;
-    PpIncrement(activePpu->regP);
+        data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 36;
+        PpIncrement(activePpu->regP);
+
+        data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 24;
+        PpIncrement(activePpu->regP);
+
+        data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask12) << 12;
+        PpIncrement(activePpu->regP);
+
+        data |= activePpu->mem[activePpu->regP] & Mask12;
+        PpIncrement(activePpu->regP);
 
-    if (((activePpu->regA & Sign18) != 0) && ((features & HasRelocationReg) != 0))
-        {
-        address = activePpu->regR + (activePpu->regA & Mask17);
-        }
-    else
-        {
-        address = activePpu->regA & Mask18;
-        }
 #if DEBUG_CM_WRITE
-    ppValidateCmWrite("CWM", address, data);
+        ppValidateCmWrite("CWM", address, data);
 #endif
-    if (ppCheckOsBounds(address))
-        {
-        if (activePpu->isStopEnabled)
+        if (!isFault)
             {
-            activePpu->isStopped = TRUE;
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            return;
-            }
-        }
-    else
-        {
-        cpuPpWriteMem(address, data);
+            cpuPpWriteMem(address, data);
 
 #if CcDebug == 1
-        traceCmWord(data);
+            traceCmWord(data);
 #endif
+            }
+        address        += 1;
+        activePpu->regA = (activePpu->regA + 1) & Mask18;
+        PpDecrement(activePpu->regQ);
         }
-    activePpu->regA = (activePpu->regA + 1) & Mask18;
-    PpDecrement(activePpu->regQ);
+    while (--count > 0);
 
     if (activePpu->regQ == 0)
         {
@@ -2594,6 +2765,7 @@ static void ppOpCRDL(void)    // 1060
 static void ppOpCRML(void)    // 1061
     {
     u32    address;
+    u32    count;
     CpWord data;
 
     if (!activePpu->busy)
@@ -2604,29 +2776,30 @@ static void ppOpCRML(void)    // 1061
         activePpu->regP   = activePpu->mem[activePpu->regP] & Mask12;
         }
 
-    if (((activePpu->regA & Sign18) != 0) && ((features & HasRelocationReg) != 0))
-        {
-        address = activePpu->regR + (activePpu->regA & Mask17);
-        }
-    else
+    count = ppCmBurstLength(&address);
+    do
         {
-        address = activePpu->regA & Mask18;
-        }
-    cpu180PpReadMem(address, &data);
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 48) & Mask16);
-    PpIncrement(activePpu->regP);
+        cpu180PpReadMem(address++, &data);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 48) & Mask16);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 32) & Mask16);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 32) & Mask16);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data >> 16) & Mask16);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data >> 16) & Mask16);
+        PpIncrement(activePpu->regP);
 
-    activePpu->mem[activePpu->regP] = (PpWord)((data) & Mask16);
-    PpIncrement(activePpu->regP);
+        activePpu->mem[activePpu->regP] = (PpWord)((data) & Mask16);
+        PpIncrement(activePpu->regP);
 
-    activePpu->regA = (activePpu->regA + 1) & Mask18;
-    PpDecrement(activePpu->regQ);
+        activePpu->regA = (activePpu->regA + 1) & Mask18;
+        PpDecrement(activePpu->regQ);
+
+#if CcDebug == 1
+        traceCmWord64(data);
+#endif
+        }
+    while (--count > 0);
 
     if (activePpu->regQ == 0)
         {
@@ -2634,10 +2807,6 @@ static void ppOpCRML(void)    // 1061
         PpIncrement(activePpu->regP);
         activePpu->busy = FALSE;
         }
-
-#if CcDebug == 1
-    traceCmWord64(data);
-#endif
     }
 
 static void ppOpCWDL(void)    // 1062
@@ -2678,7 +2847,9 @@ static void ppOpCWDL(void)    // 1062
 static void ppOpCWML(void)    // 1063
     {
     u32    address;
+    u32    count;
     CpWord data;
+    bool   isFault;
 
     if (!activePpu->busy)
         {
@@ -2687,48 +2858,43 @@ static void ppOpCWML(void)    // 1063
         activePpu->mem[0] = activePpu->regP;
         activePpu->regP   = activePpu->mem[activePpu->regP] & Mask12;
         }
-    data = (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 48;
-    PpIncrement(activePpu->regP);
-
-    data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 32;
-    PpIncrement(activePpu->regP);
-
-    data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 16;
-    PpIncrement(activePpu->regP);
 
-    data |= activePpu->mem[activePpu->regP] & Mask16;
-    PpIncrement(activePpu->regP);
-
-    if (((activePpu->regA & Sign18) != 0) && ((features & HasRelocationReg) != 0))
-        {
-        address = activePpu->regR + (activePpu->regA & Mask17);
-        }
-    else
+    count   = ppCmBurstLength(&address);
+    isFault = ppCheckOsBounds(address);
+    if (isFault && activePpu->isStopEnabled)
         {
-        address = activePpu->regA & Mask18;
+        activePpu->isStopped = TRUE;
+
+        return;
         }
-    if (ppCheckOsBounds(address))
+
+    do
         {
-        if (activePpu->isStopEnabled)
+        data = (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 48;
+        PpIncrement(activePpu->regP);
+
+        data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 32;
+        PpIncrement(activePpu->regP);
+
+        data |= (CpWord)(activePpu->mem[activePpu->regP] & Mask16) << 16;
+        PpIncrement(activePpu->regP);
+
+        data |= activePpu->mem[activePpu->regP] & Mask16;
+        PpIncrement(activePpu->regP);
+
+        if (!isFault)
             {
-            activePpu->isStopped = TRUE;
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            PpDecrement(activePpu->regP);
-            return;
-            }
-        }
-    else
-        {
-        cpu180PpWriteMem(address, data);
+            cpu180PpWriteMem(address, data);
 
 #if CcDebug == 1
-        traceCmWord64(data);
+            traceCmWord64(data);
 #endif
+            }
+        address        += 1;
+        activePpu->regA = (activePpu->regA + 1) & Mask18;
+        PpDecrement(activePpu->regQ);
         }
-    activePpu->regA = (activePpu->regA + 1) & Mask18;
-    PpDecrement(activePpu->regQ);
+    while (--count > 0);
 
     if (activePpu->regQ == 0)
         {
@@ -0,0 +1,445 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: profile.c
+**
+**  Description:
+**      Sample the program addresses of the emulated CPUs and PPs and
+**      aggregate them into histograms which can be written as a folded
+**      stack report suitable for flame graph tools.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+#define ProfileTableSize        65536   /* must be a power of 2 */
+#define ProfileMaxProbes        64
+
+/*
+**  Sample kinds.
+*/
+#define ProfileCpu170           1
+#define ProfileCpu180           2
+#define ProfilePp               3
+
+/*
+**  CPU modes.
+*/
+#define ProfileModeUser         0
+#define ProfileModeMonitor      1
+#define ProfileModeIdle         2
+#define ProfileModeStopped      3
+
+/*
+**  NOS and KRONOS keep a copy of the PP's input register in direct
+**  cells 50-54. The upper 18 bits hold the name of the resident program.
+*/
+#define ProfileNosIr            050
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+typedef struct profileEntry
+    {
+    u8  kind;                           /* sample kind, 0 if slot is free */
+    u8  unit;                           /* CPU or PP number */
+    u8  mode;                           /* CPU mode */
+    u32 base;                           /* CYBER 170 RA or PP program name */
+    u64 addr;                           /* P register or CYBER 180 PVA */
+    u64 count;                          /* number of samples */
+    } ProfileEntry;
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void profileCount(u8 kind, u8 unit, u8 mode, u32 base, u64 addr);
+static u32 profilePpName(PpSlot *pp);
+static void profileSample(void *arg);
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static ProfileEntry *profileTable   = NULL;
+static bool         profileActive   = FALSE;
+static u32          profileInterval = 1000;
+static SchedEvent   profileEvent;
+static u64          profileSamples  = 0;
+static u64          profileDropped  = 0;
+static u32          profileEntries  = 0;
+static bool         profilePpNames  = FALSE;
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Discard all samples collected so far.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void profileReset(void)
+    {
+    if (profileTable != NULL)
+        {
+        memset(profileTable, 0, ProfileTableSize * sizeof(ProfileEntry));
+        }
+    profileSamples = 0;
+    profileDropped = 0;
+    profileEntries = 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Display profiler status.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void profileShowStatus(void)
+    {
+    opDisplay("    > Profiler: %s, sampling every %u cycles\n", profileActive ? "ON" : "OFF", profileInterval);
+    opDisplay("    > %llu samples, %u distinct addresses, %llu dropped\n",
+              (unsigned long long)profileSamples, profileEntries, (unsigned long long)profileDropped);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Start sampling.
+**
+**  Parameters:     Name        Description.
+**                  interval    number of major cycles between samples
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void profileStart(u32 interval)
+    {
+    if (profileTable == NULL)
+        {
+        profileTable = (ProfileEntry *)calloc(ProfileTableSize, sizeof(ProfileEntry));
+        if (profileTable == NULL)
+            {
+            logDtError(LogErrorLocation, "Failed to allocate profiler sample table\n");
+            exit(1);
+            }
+        schedInitEvent(&profileEvent, profileSample, NULL);
+        }
+
+    if (interval > 0)
+        {
+        profileInterval = interval;
+        }
+    profilePpNames = (strcasecmp(osType, "nos") == 0) || (strcasecmp(osType, "kronos") == 0);
+    profileActive  = TRUE;
+    schedAfter(&profileEvent, profileInterval);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stop sampling. Collected samples are retained.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void profileStop(void)
+    {
+    profileActive = FALSE;
+    if (profileTable != NULL)
+        {
+        schedCancel(&profileEvent);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Write collected samples as folded stacks, one line
+**                  per distinct address followed by its sample count.
+**
+**  Parameters:     Name        Description.
+**                  path        report file path
+**
+**  Returns:        TRUE if the report was written.
+**
+**------------------------------------------------------------------------*/
+bool profileWrite(char *path)
+    {
+    ProfileEntry *ep;
+    FILE         *fcb;
+    u32          i;
+    char         name[4];
+    static char  *modes[] = { "user", "monitor", "idle", "stopped" };
+
+    fcb = fopen(path, "w");
+    if (fcb == NULL)
+        {
+        return FALSE;
+        }
+
+    if (profileTable != NULL)
+        {
+        for (i = 0; i < ProfileTableSize; i++)
+            {
+            ep = profileTable + i;
+            switch (ep->kind)
+                {
+            default:
+                continue;
+
+            case ProfileCpu170:
+                fprintf(fcb, "cpu%u;%s", ep->unit, modes[ep->mode]);
+                if (ep->mode < ProfileModeIdle)
+                    {
+                    fprintf(fcb, ";ra=%08o;p=%06o", ep->base, (u32)ep->addr);
+                    }
+                break;
+
+            case ProfileCpu180:
+                fprintf(fcb, "cpu%u;180 %s", ep->unit, modes[ep->mode]);
+                if (ep->mode < ProfileModeIdle)
+                    {
+                    fprintf(fcb, ";ring=%x;seg=%03x;bn=%08x",
+                            (u32)((ep->addr >> 44) & Mask4), (u32)((ep->addr >> 32) & Mask12), (u32)(ep->addr & Mask32));
+                    }
+                break;
+
+            case ProfilePp:
+                fprintf(fcb, "pp%02o", ep->unit);
+                if (ep->base != 0)
+                    {
+                    name[0] = cdcToAscii[(ep->base >> 12) & Mask6];
+                    name[1] = cdcToAscii[(ep->base >> 6) & Mask6];
+                    name[2] = cdcToAscii[ep->base & Mask6];
+                    name[3] = '\0';
+                    fprintf(fcb, ";%s", name);
+                    }
+                fprintf(fcb, ";p=%04o", (u32)ep->addr);
+                break;
+                }
+            fprintf(fcb, " %llu\n", (unsigned long long)ep->count);
+            }
+        }
+
+    fclose(fcb);
+
+    return TRUE;
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Add one sample to the histogram.
+**
+**  Parameters:     Name        Description.
+**                  kind        sample kind
+**                  unit        CPU or PP number
+**                  mode        CPU mode
+**                  base        CYBER 170 RA or PP program name
+**                  addr        P register or CYBER 180 PVA
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void profileCount(u8 kind, u8 unit, u8 mode, u32 base, u64 addr)
+    {
+    ProfileEntry *ep;
+    u64          hash;
+    int          probe;
+
+    hash  = ((u64)kind << 56) ^ ((u64)unit << 48) ^ ((u64)mode << 40) ^ ((u64)base << 20) ^ addr;
+    hash *= 0x9e3779b97f4a7c15ULL;
+    hash >>= 40;
+
+    for (probe = 0; probe < ProfileMaxProbes; probe++)
+        {
+        ep = profileTable + ((hash + probe) & (ProfileTableSize - 1));
+        if (ep->kind == 0)
+            {
+            ep->kind        = kind;
+            ep->unit        = unit;
+            ep->mode        = mode;
+            ep->base        = base;
+            ep->addr        = addr;
+            ep->count       = 1;
+            profileEntries += 1;
+
+            return;
+            }
+        if ((ep->kind == kind) && (ep->unit == unit) && (ep->mode == mode) && (ep->base == base) && (ep->addr == addr))
+            {
+            ep->count += 1;
+
+            return;
+            }
+        }
+
+    profileDropped += 1;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Get the name of the program resident in a PP.
+**
+**  Parameters:     Name        Description.
+**                  pp          PP context
+**
+**  Returns:        18-bit display code name, 0 if not recognisable.
+**
+**------------------------------------------------------------------------*/
+static u32 profilePpName(PpSlot *pp)
+    {
+    u32 name;
+    int shift;
+    u8  c;
+
+    name = ((u32)(pp->mem[ProfileNosIr] & Mask12) << 6) | ((pp->mem[ProfileNosIr + 1] >> 6) & Mask6);
+    for (shift = 12; shift >= 0; shift -= 6)
+        {
+        c = (name >> shift) & Mask6;
+        if ((c == 0) || (c > 044))
+            {
+            return 0;
+            }
+        }
+
+    return name;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Take a sample and schedule the next one.
+**
+**  Parameters:     Name        Description.
+**                  arg         not used
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void profileSample(void *arg)
+    {
+    Cpu180Context *ctx180;
+    Cpu170Context *ctx;
+    int           i;
+    u8            mode;
+    PpSlot        *pp;
+
+    schedAfter(&profileEvent, profileInterval);
+    profileSamples += 1;
+
+    for (i = 0; i < cpuCount; i++)
+        {
+        ctx = cpus170 + i;
+        if (isCyber180)
+            {
+            ctx180 = cpus180 + i;
+            if (ctx180->regVmid == 0)
+                {
+                if (ctx180->isStopped)
+                    {
+                    mode = ProfileModeStopped;
+                    }
+                else if ((*idleDetector)(ctx))
+                    {
+                    mode = ProfileModeIdle;
+                    }
+                else
+                    {
+                    mode = ctx180->isMonitorMode ? ProfileModeMonitor : ProfileModeUser;
+                    }
+                profileCount(ProfileCpu180, (u8)i, mode, 0, mode >= ProfileModeIdle ? 0 : ctx180->regP);
+                continue;
+                }
+            }
+
+        if (ctx->isStopped)
+            {
+            mode = ProfileModeStopped;
+            }
+        else if ((*idleDetector)(ctx))
+            {
+            mode = ProfileModeIdle;
+            }
+        else
+            {
+            mode = ctx->isMonitorMode ? ProfileModeMonitor : ProfileModeUser;
+            }
+        if (mode >= ProfileModeIdle)
+            {
+            profileCount(ProfileCpu170, (u8)i, mode, 0, 0);
+            }
+        else
+            {
+            profileCount(ProfileCpu170, (u8)i, mode, ctx->regRaCm, ctx->regP);
+            }
+        }
+
+    for (i = 0; i < ppuCount; i++)
+        {
+        pp = ppu + i;
+        if (pp->isStopped || pp->isIdle)
+            {
+            continue;
+            }
+        profileCount(ProfilePp, pp->id, 0, profilePpNames ? profilePpName(pp) : 0, pp->regP);
+        }
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
@@ -91,9 +91,18 @@ void channelOut(void);
 void channelIn(void);
 void channelSetFull(void);
 void channelSetEmpty(void);
-void channelStep(void);
+void channelDelayDisconnect(ChSlot *cc, u8 cycles);
+void channelDelayStatus(ChSlot *cc, u8 cycles);
 void channelDisplayContext();
 
+/*
+**  charset.c
+*/
+int  charsetPack8To12(PpWord *dst, const u8 *src, int len);
+void charsetTranslate(u8 *dst, const u8 *src, int len, const u8 *table);
+int  charsetUnpack12To8(u8 *dst, const PpWord *src, int words);
+void charsetUnpack60To6(u8 *dst, const CpWord *src, int words);
+
 /*
 **  cdcnet.c
 */
@@ -157,6 +166,7 @@ void cpu180MacWriteCp(Cpu180Context *ctx, u8 type, u8 byte);
 void cpu180PpReadMem(u32 address, CpWord *data);
 void cpu180PpWriteMem(u32 address, CpWord data);
 bool cpu180PvaToRma(Cpu180Context *ctx, u64 pva, Cpu180AccessMode access, u32 *rma, u32 *pti, MonitorCondition *cond);
+bool cpu180ReadBytes(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, Cpu180AccessMode access, u8 *buffer, MonitorCondition *cond);
 void cpu180SetMonitorCondition(Cpu180Context *ctx, MonitorCondition cond);
 void cpu180SetUserCondition(Cpu180Context *ctx, UserCondition cond);
 void cpu180Step(Cpu180Context *activeCpu);
@@ -164,11 +174,13 @@ void cpu180Store170Xp(Cpu180Context *ctx, u32 xpa);
 bool cpu180TranslatePvaSequence(Cpu180Context *ctx, u64 pva, u16 count, u8 incr, u8 ring, Cpu180AccessMode access, u32 *rmas, MonitorCondition *cond);
 void cpu180Trap(Cpu180Context *ctx);
 void cpu180UpdateIntervalTimers(Cpu180Context *ctx);
+bool cpu180WriteBytes(Cpu180Context *ctx, u64 pva, u16 count, u8 ring, u8 *buffer, MonitorCondition *cond);
 
 /*
 **  cr405.c
 */
 void cr405Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
+bool cr405IsTrayFull(int channelNo, int equipmentNo);
 void cr405GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params);
 void cr405PostProcess(char *fname, int channelNo, int equipmentNo, char *params);
 void cr405LoadCards(char *fname, int channelNo, int equipmentNo, char *params);
@@ -185,6 +197,7 @@ void cp3446ShowStatus();
 **  cr3447.c
 */
 void cr3447Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
+bool cr3447IsTrayFull(int channelNo, int equipmentNo);
 void cr3447GetNextDeck(char *fname, int channelNo, int equipmentNo, char *params);
 void cr3447PostProcess(char *fname, int channelNo, int equipmentNo, char *params);
 void cr3447LoadCards(char *fname, int channelNo, int equipmentNo, char *params);
@@ -209,9 +222,10 @@ void dd844Init_2(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void dd844Init_4(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void dd885Init_1(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void dd885InitLs(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
-void dd8xxLoadDisk(char *params);
+bool dd8xxOpenDisk(char *params, MediaMount *mp);
 void dd8xxUnloadDisk(char *params);
 void dd8xxShowDiskStatus();
+void dd8xxTerminate(DevSlot *dp);
 
 /*
 **  dd885_42.c
@@ -280,6 +294,8 @@ bool float180SubFloat(Cpu180Context *ctx, u64 minend, u64 subend, u64 *diff);
 **  fsmon.c
 */
 bool fsCreateThread(fswContext *parms);
+bool fsDequeueDeck(u8 channelNo, u8 eqNo, int devType, char *fname, int size);
+int  fsQueueDepth(u8 channelNo, u8 eqNo, int devType);
 
 /*
 **  init.c
@@ -308,6 +324,7 @@ void lp1612ShowStatus();
 void lp501Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceParams);
 void lp512Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceParams);
 void lp3000RemovePaper(char *params);
+void lp3000Terminate(DevSlot *dp);
 void lp3000ShowStatus();
 
 /*
@@ -338,6 +355,20 @@ void mchSetCpStateRegister(Cpu180Context *ctx, u8 reg, u64 word);
 */
 void mdiInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 
+/*
+**  metrics.c
+*/
+void metricsCountIo(u8 devType, bool isWrite, u32 bytes);
+void metricsCountUnitIo(MetricsUnit *up, int kind, u32 bytes, u64 startUsec);
+void metricsCountUnitOps(MetricsUnit *up, int kind, u32 bytes);
+MetricsUnit *metricsRegisterUnit(u8 devType, u8 channelNo, u8 eqNo, u8 unitNo);
+bool metricsOpenReport(char *path);
+void metricsShowIoStatus(void);
+bool metricsStartListening(int port);
+void metricsStopListening(void);
+void metricsStartReport(void);
+bool metricsWriteReport(void);
+
 /*
 **  msufrend.c
 */
@@ -349,7 +380,7 @@ void msufrendShowStatus();
 */
 void mt362xInit_7(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void mt362xInit_9(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
-void mt362xLoadTape(char *params);
+bool mt362xOpenTape(char *params, MediaMount *mp);
 void mt362xUnloadTape(char *params);
 void mt362xShowTapeStatus();
 
@@ -363,7 +394,7 @@ void mt607Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 */
 void mt669Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void mt669Terminate(DevSlot *dp);
-void mt669LoadTape(char *params);
+bool mt669OpenTape(char *params, MediaMount *mp);
 void mt669UnloadTape(char *params);
 void mt669ShowTapeStatus();
 
@@ -372,7 +403,7 @@ void mt669ShowTapeStatus();
 */
 void mt679Init(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 void mt679Terminate(DevSlot *dp);
-void mt679LoadTape(char *params);
+bool mt679OpenTape(char *params, MediaMount *mp);
 void mt679UnloadTape(char *params);
 void mt679ShowTapeStatus();
 
@@ -407,16 +438,24 @@ int    netGetErrorStatus(SOCKET sd);
 char  *netGetLocalTcpAddress(SOCKET sd);
 char  *netGetPeerTcpAddress(SOCKET sd);
 SOCKET netInitiateConnection(struct sockaddr *sap);
+void   netPollAdd(NetPollEntry *ep, SOCKET sd, u8 events);
 #else
 int    netAcceptConnection(int sd);
 void   netCloseConnection(int sd);
 int    netCreateListener(int port);
+int    netCreateLocalListener(char *path);
 int    netCreateSocket(int port, bool isReuse);
 int    netGetErrorStatus(int sd);
 char  *netGetLocalTcpAddress(int sd);
 char  *netGetPeerTcpAddress(int sd);
 int    netInitiateConnection(struct sockaddr *sap);
+int    netInitiateLocalConnection(char *path);
+void   netPollAdd(NetPollEntry *ep, int sd, u8 events);
+int    netPollAddIdleFds(fd_set *fds, int maxFd);
 #endif
+void   netPollRemove(NetPollEntry *ep);
+bool   netPollTake(NetPollEntry *ep, u8 event);
+void   netPollWant(NetPollEntry *ep, u8 events);
 
 /*
 **  niu.c
@@ -459,6 +498,7 @@ void pciConsoleInit(u8 eqNo, u8 unitNo, u8 channelNo, char *deviceName);
 /*
 **  pp.c
 */
+bool ppIdleDetectorNOS(PpSlot *pp, PpWord loopAddr, PpWord jumpAddr);
 void ppInit(u8 count);
 u64  ppMacGetIouRegister(u8 reg);
 void ppMacInit(void);
@@ -469,6 +509,22 @@ void ppMacWriteIou(u8 byte);
 void ppTerminate(void);
 void ppStep(void);
 
+/*
+**  profile.c
+*/
+void profileReset(void);
+void profileShowStatus(void);
+void profileStart(u32 interval);
+void profileStop(void);
+bool profileWrite(char *path);
+
+/*
+**  ramdisk.c
+*/
+void ramDiskClose(FILE *fcb);
+bool ramDiskIsRam(FILE *fcb);
+FILE *ramDiskOpen(char *fileName, long size, bool isSaved, bool *isNew);
+
 /*
 **  rtc.c
 */
@@ -477,6 +533,14 @@ void rtcTick(void);
 void rtcStartTimer(void);
 double rtcStopTimer(void);
 
+/*
+**  sched.c
+*/
+void schedAfter(SchedEvent *ev, u32 cycles);
+void schedCancel(SchedEvent *ev);
+void schedInitEvent(SchedEvent *ev, void (*handler)(void *arg), void *arg);
+void schedRun(void);
+
 /*
 **  scr_channel.c
 */
@@ -492,9 +556,17 @@ CpWord shiftUnpack(CpWord number, u32 *expo);
 CpWord shiftNormalize(CpWord number, u32 *shift, bool round);
 CpWord shiftMask(u8 count);
 
+/*
+**  tapeimage.c
+*/
+bool tapeImageCompress(FILE *in, FILE *out);
+bool tapeImageExpand(FILE *in, FILE *out);
+FILE *tapeImageOpen(char *fileName, char *mode);
+
 /*
 **  time.c
 */
+u64 getMicroseconds(void);
 u64 getMilliseconds(void);
 time_t getSeconds(void);
 void sleepMsec(u32 msec);
@@ -592,6 +664,7 @@ extern const u8            asciiToEbcdic[256];
 extern const int           asciiToPlatoString[256];
 extern const i8            asciiToPlato[128];
 extern const char          bcdToAscii[64];
+extern bool                benchmarkMode;
 extern bool                bigEndian;
 extern bool                cc545Enabled;
 extern const char          cdcToAscii[64];
@@ -617,6 +690,7 @@ extern u8                  deviceCount;
 extern DevDesc             deviceDesc[];
 extern char                displayName[];
 extern const u8            ebcdicToAscii[256];
+extern char                ecsSharedName[];
 extern bool                emulationActive;
 extern const char          extBcdToAscii[64];
 extern u32                 extMaxMemory;
@@ -634,6 +708,7 @@ extern char                fontName[];                      // Console
 extern long                heightPX;                        // Console
 extern u32                 iouOsBoundary;
 extern bool                isCyber180;
+extern Metrics             metrics;
 extern ModelType           modelType;
 extern u16                 mux6676TelnetConns;
 extern u16                 mux6676TelnetPort;
@@ -648,6 +723,7 @@ extern NpuSoftware         npuSw;
 extern u8                  npuSvmNpuNode;
 extern char                *npuSvmTermStates[];
 extern volatile bool       opActive;
+extern volatile bool       opHandoffActive;
 extern char                opKeyIn;
 extern u32                 opKeyInterval;
 extern volatile bool       opPaused;
@@ -655,6 +731,8 @@ extern char                persistDir[];
 extern u16                 platoConns;
 extern u16                 platoPort;
 extern const unsigned char platoStringToAscii[4][65];
+extern u32                 ppCmBurst;
+extern bool                (*ppIdleDetector)(PpSlot *pp, PpWord loopAddr, PpWord jumpAddr);
 extern char                ppKeyIn;
 extern PpSlot              *ppu;
 extern u8                  ppuCount;
@@ -688,7 +766,10 @@ bool idleDetectorCOS(Cpu170Context *ctx);   /* COS */
 bool idleDetectorMACE(Cpu170Context *ctx);  /* KRONOS1 or MACE, possibly SCOPE too) */
 bool idleDetectorNOS(Cpu170Context *ctx);   /* KRONOS2.1 - NOS 2.8.7 */
 bool idleDetectorNOSBE(Cpu170Context *ctx); /* NOS/BE (only tested with TUB) */
+void idleInit(void);
+void idleShowStatus(void);
 void idleThrottle(Cpu170Context *ctx);
+void idleWake(void);
 
 #endif /* PROTO_H */
 /*---------------------------  End Of File  ------------------------------*/
@@ -0,0 +1,328 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: ramdisk.c
+**
+**  Description:
+**      Keep disk containers in host memory. A RAM disk is presented to
+**      the disk drivers as an ordinary stream, so they access it with
+**      the same calls as a container file. It is optionally loaded from
+**      an image file when opened and written back to it when closed.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+typedef struct ramDisk
+    {
+    struct ramDisk *next;
+    FILE           *fcb;                /* stream open on the data */
+    u8             *data;               /* container contents */
+    long           size;                /* container size in bytes */
+    bool           isSaved;             /* TRUE if written back when closed */
+    char           fileName[MaxFSPath]; /* image file */
+    } RamDisk;
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void ramDiskSave(RamDisk *rp);
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static RamDisk *ramDisks = NULL;
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Close a disk container. If the container is a RAM
+**                  disk, write it back to its image file if requested
+**                  and release its memory.
+**
+**  Parameters:     Name        Description.
+**                  fcb         container stream
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void ramDiskClose(FILE *fcb)
+    {
+    RamDisk **rpp;
+    RamDisk *rp;
+
+    fclose(fcb);
+
+    for (rpp = &ramDisks; *rpp != NULL; rpp = &(*rpp)->next)
+        {
+        rp = *rpp;
+        if (rp->fcb == fcb)
+            {
+            if (rp->isSaved)
+                {
+                ramDiskSave(rp);
+                }
+            *rpp = rp->next;
+            free(rp->data);
+            free(rp);
+
+            return;
+            }
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Determine whether a disk container is a RAM disk.
+**
+**  Parameters:     Name        Description.
+**                  fcb         container stream
+**
+**  Returns:        TRUE if the container is held in memory.
+**
+**------------------------------------------------------------------------*/
+bool ramDiskIsRam(FILE *fcb)
+    {
+    RamDisk *rp;
+
+    for (rp = ramDisks; rp != NULL; rp = rp->next)
+        {
+        if (rp->fcb == fcb)
+            {
+            return TRUE;
+            }
+        }
+
+    return FALSE;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Open a RAM disk. The container is loaded from its
+**                  image file if the file exists, otherwise it starts
+**                  out zeroed and the caller must format it. An image
+**                  which is not exactly the size of the container is
+**                  refused rather than formatted and saved over.
+**
+**  Parameters:     Name        Description.
+**                  fileName    image file
+**                  size        container size in bytes
+**                  isSaved     TRUE if the container is to be written
+**                              back to the image file when closed
+**                  isNew       set to TRUE if no image file was loaded
+**
+**  Returns:        Stream open on the container, NULL on failure.
+**
+**------------------------------------------------------------------------*/
+FILE *ramDiskOpen(char *fileName, long size, bool isSaved, bool *isNew)
+    {
+#if defined(_WIN32)
+    logDtError(LogErrorLocation, "RAM disks are not supported on Windows\n");
+
+    return NULL;
+
+#else
+    FILE    *image;
+    size_t  len;
+    RamDisk *rp;
+
+    rp = (RamDisk *)calloc(1, sizeof(RamDisk));
+    if (rp == NULL)
+        {
+        return NULL;
+        }
+
+    /*
+    **  The container is allocated zeroed, so pages which are never
+    **  written cost no host memory.
+    */
+    rp->data = (u8 *)calloc(1, size);
+    if (rp->data == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to allocate %ld bytes for RAM disk %s\n", size, fileName);
+        free(rp);
+
+        return NULL;
+        }
+    rp->size    = size;
+    rp->isSaved = isSaved;
+    strcpy(rp->fileName, fileName);
+
+    *isNew = TRUE;
+    image  = fopen(fileName, "rb");
+    if (image != NULL)
+        {
+        len = fread(rp->data, 1, size, image);
+        if ((len == (size_t)size) && (fgetc(image) == EOF) && !ferror(image))
+            {
+            *isNew = FALSE;
+            }
+        else if ((len != 0) || ferror(image))
+            {
+            logDtError(LogErrorLocation, "RAM disk image %s is not a %ld byte container\n", fileName, size);
+            fclose(image);
+            free(rp->data);
+            free(rp);
+
+            return NULL;
+            }
+        fclose(image);
+        }
+
+    rp->fcb = fmemopen(rp->data, size, "r+b");
+    if (rp->fcb == NULL)
+        {
+        free(rp->data);
+        free(rp);
+
+        return NULL;
+        }
+
+    rp->next = ramDisks;
+    ramDisks = rp;
+
+    return rp->fcb;
+#endif
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Write a RAM disk to its image file. Runs of zero
+**                  blocks are skipped so that the file stays sparse.
+**                  The image is written to a temporary file which then
+**                  replaces the old image, so a failed save leaves the
+**                  old image intact.
+**
+**  Parameters:     Name        Description.
+**                  rp          RAM disk
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void ramDiskSave(RamDisk *rp)
+    {
+    static u8 zeros[4096];
+    FILE      *image;
+    bool      isOk;
+    long      len;
+    long      pos;
+    char      tmpName[MaxFSPath + 4];
+
+    sprintf(tmpName, "%s.tmp", rp->fileName);
+    image = fopen(tmpName, "wb");
+    if (image == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to save RAM disk to %s\n", tmpName);
+
+        return;
+        }
+
+    isOk = TRUE;
+
+    for (pos = 0; pos < rp->size; pos += len)
+        {
+        len = rp->size - pos;
+        if (len > (long)sizeof(zeros))
+            {
+            len = sizeof(zeros);
+            }
+        if ((memcmp(rp->data + pos, zeros, len) == 0) && (pos + len < rp->size))
+            {
+            continue;
+            }
+        if ((fseek(image, pos, SEEK_SET) != 0) || (fwrite(rp->data + pos, 1, len, image) != (size_t)len))
+            {
+            isOk = FALSE;
+            break;
+            }
+        }
+
+    if (fflush(image) != 0)
+        {
+        isOk = FALSE;
+        }
+#if !defined(_WIN32)
+    if (isOk && (fsync(fileno(image)) != 0))
+        {
+        isOk = FALSE;
+        }
+#endif
+    if (fclose(image) != 0)
+        {
+        isOk = FALSE;
+        }
+
+    if (!isOk || (rename(tmpName, rp->fileName) != 0))
+        {
+        logDtError(LogErrorLocation, "Failed to save RAM disk to %s, previous image kept\n", rp->fileName);
+        remove(tmpName);
+        }
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
@@ -0,0 +1,296 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: sched.c
+**
+**  Description:
+**      Schedule emulated timing events, such as delayed channel status
+**      changes, in major cycles. Events are kept in a priority queue
+**      ordered by due cycle, so the main loop only touches events which
+**      are due.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+#define MaxSchedEvents    256
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static void schedSiftDown(int slot);
+static void schedSiftUp(int slot);
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+static SchedEvent *schedQueue[MaxSchedEvents];
+static int        schedCount = 0;
+static u64        schedCycle = 0;
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Initialise an event.
+**
+**  Parameters:     Name        Description.
+**                  ev          pointer to event
+**                  handler     function called when the event is due
+**                  arg         argument passed to the handler
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void schedInitEvent(SchedEvent *ev, void (*handler)(void *arg), void *arg)
+    {
+    ev->due     = 0;
+    ev->handler = handler;
+    ev->arg     = arg;
+    ev->slot    = -1;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Schedule an event a number of major cycles from now.
+**                  An event which is already scheduled is rescheduled.
+**
+**  Parameters:     Name        Description.
+**                  ev          pointer to event
+**                  cycles      number of major cycles until the event is
+**                              due, at least 1
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void schedAfter(SchedEvent *ev, u32 cycles)
+    {
+    u64 due;
+
+    due = schedCycle + (cycles > 0 ? cycles : 1);
+    if (ev->slot >= 0)
+        {
+        if (due < ev->due)
+            {
+            ev->due = due;
+            schedSiftUp(ev->slot);
+            }
+        else
+            {
+            ev->due = due;
+            schedSiftDown(ev->slot);
+            }
+
+        return;
+        }
+
+    if (schedCount >= MaxSchedEvents)
+        {
+        logDtError(LogErrorLocation, "Too many scheduled events\n");
+        exit(1);
+        }
+    ev->due                = due;
+    ev->slot               = schedCount;
+    schedQueue[schedCount] = ev;
+    schedCount            += 1;
+    schedSiftUp(ev->slot);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Remove an event from the schedule, if it is scheduled.
+**
+**  Parameters:     Name        Description.
+**                  ev          pointer to event
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void schedCancel(SchedEvent *ev)
+    {
+    SchedEvent *last;
+    int        slot;
+
+    slot = ev->slot;
+    if (slot < 0)
+        {
+        return;
+        }
+    ev->slot    = -1;
+    schedCount -= 1;
+    if (slot == schedCount)
+        {
+        return;
+        }
+
+    /*
+    **  Fill the hole with the last event and restore heap order.
+    */
+    last             = schedQueue[schedCount];
+    schedQueue[slot] = last;
+    last->slot       = slot;
+    if ((slot > 0) && (last->due < schedQueue[(slot - 1) / 2]->due))
+        {
+        schedSiftUp(slot);
+        }
+    else
+        {
+        schedSiftDown(slot);
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Advance the schedule by one major cycle and call the
+**                  handlers of all events which have become due.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+void schedRun(void)
+    {
+    SchedEvent *ev;
+
+    schedCycle += 1;
+    while ((schedCount > 0) && (schedQueue[0]->due <= schedCycle))
+        {
+        ev = schedQueue[0];
+        schedCancel(ev);
+        ev->handler(ev->arg);
+        }
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Move an event towards the root of the queue until it
+**                  is not due before its parent.
+**
+**  Parameters:     Name        Description.
+**                  slot        position of the event in the queue
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void schedSiftUp(int slot)
+    {
+    SchedEvent *ev;
+    int        parent;
+
+    ev = schedQueue[slot];
+    while (slot > 0)
+        {
+        parent = (slot - 1) / 2;
+        if (schedQueue[parent]->due <= ev->due)
+            {
+            break;
+            }
+        schedQueue[slot]       = schedQueue[parent];
+        schedQueue[slot]->slot = slot;
+        slot                   = parent;
+        }
+    schedQueue[slot] = ev;
+    ev->slot         = slot;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Move an event towards the leaves of the queue until
+**                  neither of its children is due before it.
+**
+**  Parameters:     Name        Description.
+**                  slot        position of the event in the queue
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void schedSiftDown(int slot)
+    {
+    int        child;
+    SchedEvent *ev;
+
+    ev = schedQueue[slot];
+    for (;;)
+        {
+        child = (2 * slot) + 1;
+        if (child >= schedCount)
+            {
+            break;
+            }
+        if ((child + 1 < schedCount) && (schedQueue[child + 1]->due < schedQueue[child]->due))
+            {
+            child += 1;
+            }
+        if (ev->due <= schedQueue[child]->due)
+            {
+            break;
+            }
+        schedQueue[slot]       = schedQueue[child];
+        schedQueue[slot]->slot = slot;
+        slot                   = child;
+        }
+    schedQueue[slot] = ev;
+    ev->slot         = slot;
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
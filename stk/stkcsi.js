@@ -18,6 +18,8 @@ class StkCSI extends Program {
   static TAPE_READ_FAILURE   = 0x80000000;
   static RECORD_ERROR_FLAG   = 0x80000000;
   static MAX_TAPE_SIZE       = 200000000;
+  static MAX_READ_AHEAD      = 16;
+  static MAX_WRITE_BATCH     = 64;
 
   static COMMAND_AUDIT       = 1;
   static COMMAND_CANCEL      = 2;
@@ -645,7 +647,11 @@ class StkCSI extends Program {
   addTapeServerClient(socket) {
     this.tapeServerClients.push({
       client: socket,
-      data: Buffer.allocUnsafe(0)
+      data: Buffer.allocUnsafe(0),
+      readAhead: 0,
+      readHistory: [],
+      writeBatch: 0,
+      writesPending: 0
     });
   }
 
@@ -758,6 +764,35 @@ class StkCSI extends Program {
     }
   }
 
+  //
+  // FEATURES READAHEAD <n> WRITEBATCH <n>
+  //
+  // Negotiates protocol extensions. READAHEAD is the number of READFWD requests a client
+  // may pipeline beyond the one it is waiting for; the client cancels unwanted ones with
+  // UNREAD. WRITEBATCH is the number of WRITE requests which may be acknowledged by a
+  // single "200 <count> written" response. Granted values are returned in the response.
+  //
+  processFeaturesRequest(client, request) {
+    client.data = Buffer.allocUnsafe(0);
+    client.readAhead = 0;
+    client.writeBatch = 0;
+    for (let i = 1; i + 1 < request.length; i += 2) {
+      let value = parseInt(request[i + 1]);
+      if (isNaN(value) || value < 0) continue;
+      switch (request[i]) {
+      case "READAHEAD":
+        client.readAhead = Math.min(value, StkCSI.MAX_READ_AHEAD);
+        break;
+      case "WRITEBATCH":
+        client.writeBatch = Math.min(value, StkCSI.MAX_WRITE_BATCH);
+        break;
+      default:
+        break;
+      }
+    }
+    this.sendResponse(client, `200 READAHEAD ${client.readAhead} WRITEBATCH ${client.writeBatch}`);
+  }
+
   processLocateBlockRequest(client, request) {
     client.data = Buffer.allocUnsafe(0);
     if (request.length < 2) {
@@ -1041,6 +1076,35 @@ class StkCSI extends Program {
     console.log(`${new Date().toLocaleString()} ${driveKey} registered by ${client.client.remoteAddress}`);
   }
 
+  //
+  // UNREAD <n>
+  //
+  // Backs up over the last <n> blocks read by READFWD requests which a client
+  // pipelined as read-ahead and no longer wants.
+  //
+  processUnreadRequest(client, request) {
+    client.data = Buffer.allocUnsafe(0);
+    let count = (request.length > 1) ? parseInt(request[1]) : NaN;
+    if (isNaN(count) || count < 0 || count > client.readHistory.length) {
+      client.readHistory = [];
+      this.sendResponse(client, "400 Bad request");
+      return;
+    }
+    if (count > 0) {
+      let entry = client.readHistory[client.readHistory.length - count];
+      let volume = this.getVolumeForClient(client);
+      if (volume === null || volume !== entry.volume) {
+        client.readHistory = [];
+        this.sendResponse(client, "403 No tape mounted");
+        return;
+      }
+      volume.position = entry.position;
+      volume.blockId = entry.blockId;
+      client.readHistory.length -= count;
+    }
+    this.sendResponse(client, "200 Ok");
+  }
+
   processWriteRequest(client, request, dataIndex) {
     let volume = this.getVolumeForClient(client);
     if (volume === null) {
@@ -1089,7 +1153,13 @@ class StkCSI extends Program {
     }
     volume.position += 4;
     volume.blockId += 1;
-    this.sendResponse(client, "200 Ok");
+    if (client.writeBatch > 0) {
+      client.writesPending += 1;
+      if (client.writesPending >= client.writeBatch) this.sendWriteAcknowledgement(client);
+    }
+    else {
+      this.sendResponse(client, "200 Ok");
+    }
   }
 
   processWriteTapeMarkRequest(client, request) {
@@ -1114,10 +1184,27 @@ class StkCSI extends Program {
   }
 
   sendResponse(client, response) {
+    //
+    // Acknowledgements of batched writes always precede any other response or event
+    //
+    if (client.writesPending > 0) this.sendWriteAcknowledgement(client);
     client.client.write(`${response}\n`);
     this.debugLog(`StkCSI TCP ${client.client.remoteAddress}:${client.client.remotePort} => ${response}`);
   }
 
+  sendWriteAcknowledgement(client) {
+    let response = `200 ${client.writesPending} written`;
+    client.writesPending = 0;
+    client.client.write(`${response}\n`);
+    this.debugLog(`StkCSI TCP ${client.client.remoteAddress}:${client.client.remotePort} => ${response}`);
+  }
+
+  //
+  // Requests may be pipelined, so process every complete request received. A WRITE
+  // request is complete when all of its data has arrived. Each handler discards
+  // client.data, so it is given only its own request, and the remainder is restored
+  // afterwards.
+  //
   handleTapeServerRequest(socket, data) {
     let idx = this.tapeServerClients.findIndex(client => {
       return client.client.remoteAddress === socket.remoteAddress && client.client.remotePort === socket.remotePort;
@@ -1125,58 +1212,81 @@ class StkCSI extends Program {
     if (idx !== -1) {
       let client = this.tapeServerClients[idx];
       client.data = Buffer.concat([client.data, data]);
-      idx = client.data.indexOf("\n");
-      if (idx !== -1) {
+      while ((idx = client.data.indexOf("\n")) !== -1) {
         let request = client.data.slice(0, idx).toString().trim();
-        this.debugLog(`StkCSI TCP ${client.client.remoteAddress}:${client.client.remotePort} <= ${request}`);
+        let end = idx + 1;
         request = request.split(" ");
-        if (request.length > 0) {
-          switch (request[0]) {
-          case "DISMOUNT":
-            this.processDismountRequest(client, request);
-            break;
-          case "LOCATEBLOCK":
-            this.processLocateBlockRequest(client, request);
-            break;
-          case "MOUNT":
-            this.processMountRequest(client, request);
-            break;
-          case "PING":
-            this.processPingRequest(client, request);
-            break;
-          case "READBKW":
-            this.processReadBkwRequest(client, request, true);
-            break;
-          case "READBLOCKID":
-            this.processReadBlockIdRequest(client, request);
-            break;
-          case "READFWD":
-            this.processReadFwdRequest(client, request, true);
-            break;
-          case "REGISTER":
-            this.processRegisterRequest(client, request);
-            break;
-          case "REWIND":
-            this.processRewindRequest(client, request);
-            break;
-          case "SPACEBKW":
-            this.processReadBkwRequest(client, request, false);
-            break;
-          case "SPACEFWD":
-            this.processReadFwdRequest(client, request, false);
-            break;
-          case "WRITE":
-            this.processWriteRequest(client, request, idx + 1);
-            break;
-          case "WRITEMARK":
-            this.processWriteTapeMarkRequest(client, request);
-            break;
-          default:
-            this.sendResponse(client, `401 ${request[0]}?`);
-            client.data = Buffer.allocUnsafe(0);
-            break;
+        if (request[0] === "WRITE" && request.length > 1) {
+          let dataLength = parseInt(request[1]);
+          if (!isNaN(dataLength)) {
+            if (client.data.length - end < dataLength) break;
+            end += dataLength;
           }
         }
+        let remainder = client.data.slice(end);
+        client.data = client.data.slice(0, end);
+        this.debugLog(`StkCSI TCP ${client.client.remoteAddress}:${client.client.remotePort} <= ${request.join(" ")}`);
+        if (request[0] === "READFWD") {
+          let volume = this.getVolumeForClient(client);
+          if (volume !== null) {
+            client.readHistory.push({volume:volume, position:volume.position, blockId:volume.blockId});
+            if (client.readHistory.length > client.readAhead + 1) client.readHistory.shift();
+          }
+        }
+        else if (request[0] !== "UNREAD") {
+          client.readHistory = [];
+        }
+        switch (request[0]) {
+        case "DISMOUNT":
+          this.processDismountRequest(client, request);
+          break;
+        case "FEATURES":
+          this.processFeaturesRequest(client, request);
+          break;
+        case "LOCATEBLOCK":
+          this.processLocateBlockRequest(client, request);
+          break;
+        case "MOUNT":
+          this.processMountRequest(client, request);
+          break;
+        case "PING":
+          this.processPingRequest(client, request);
+          break;
+        case "READBKW":
+          this.processReadBkwRequest(client, request, true);
+          break;
+        case "READBLOCKID":
+          this.processReadBlockIdRequest(client, request);
+          break;
+        case "READFWD":
+          this.processReadFwdRequest(client, request, true);
+          break;
+        case "REGISTER":
+          this.processRegisterRequest(client, request);
+          break;
+        case "REWIND":
+          this.processRewindRequest(client, request);
+          break;
+        case "SPACEBKW":
+          this.processReadBkwRequest(client, request, false);
+          break;
+        case "SPACEFWD":
+          this.processReadFwdRequest(client, request, false);
+          break;
+        case "UNREAD":
+          this.processUnreadRequest(client, request);
+          break;
+        case "WRITE":
+          this.processWriteRequest(client, request, idx + 1);
+          break;
+        case "WRITEMARK":
+          this.processWriteTapeMarkRequest(client, request);
+          break;
+        default:
+          this.sendResponse(client, `401 ${request[0]}?`);
+          break;
+        }
+        client.data = remainder;
       }
     }
   }
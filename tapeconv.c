@@ -0,0 +1,161 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: tapeconv.c
+**
+**  Description:
+**      Convert tape images between the plain TAP format and the
+**      compressed format which the tape drivers read through
+**      tapeImageOpen.
+**
+**          tapeconv -c <plain image> <compressed image>
+**          tapeconv -x <compressed image> <plain image>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Converter main entry.
+**
+**  Parameters:     Name        Description.
+**                  argc        argument count
+**                  argv        argument list
+**
+**  Returns:        Exit status.
+**
+**------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+    {
+    FILE *in;
+    bool isCompress;
+    FILE *out;
+    bool result;
+
+    if ((argc != 4) || ((strcmp(argv[1], "-c") != 0) && (strcmp(argv[1], "-x") != 0)))
+        {
+        fprintf(stderr, "Usage: tapeconv -c <plain image> <compressed image>\n");
+        fprintf(stderr, "       tapeconv -x <compressed image> <plain image>\n");
+
+        return 1;
+        }
+    isCompress = argv[1][1] == 'c';
+
+    in = fopen(argv[2], "rb");
+    if (in == NULL)
+        {
+        fprintf(stderr, "(tapeconv) Failed to open %s\n", argv[2]);
+
+        return 1;
+        }
+    out = fopen(argv[3], "wb");
+    if (out == NULL)
+        {
+        fprintf(stderr, "(tapeconv) Failed to create %s\n", argv[3]);
+        fclose(in);
+
+        return 1;
+        }
+
+    result = isCompress ? tapeImageCompress(in, out) : tapeImageExpand(in, out);
+    fclose(in);
+    if (fclose(out) != 0)
+        {
+        result = FALSE;
+        }
+    if (!result)
+        {
+        fprintf(stderr, "(tapeconv) Failed to %s %s\n", isCompress ? "compress" : "expand", argv[2]);
+        remove(argv[3]);
+
+        return 1;
+        }
+
+    return 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stubs for functions the tape image module references.
+**
+**------------------------------------------------------------------------*/
+void logDtError(char *file, int line, char *fmt, ...)
+    {
+    va_list param;
+
+    va_start(param, fmt);
+    fprintf(stderr, "(%s:%d) ", file, line);
+    vfprintf(stderr, fmt, param);
+    va_end(param);
+    }
+
+/*---------------------------  End Of File  ------------------------------*/
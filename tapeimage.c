@@ -0,0 +1,1165 @@
+/*--------------------------------------------------------------------------
+**
+**  Copyright (c) 2025, Kevin Jordan
+**
+**  Name: tapeimage.c
+**
+**  Description:
+**      Read compressed TAP tape images. A compressed image holds the
+**      TAP data in independently compressed chunks followed by an index
+**      of the chunks, so that the tape drivers can space and read
+**      backwards through it. It is presented to the drivers as an
+**      ordinary read only stream, and a helper thread expands the chunk
+**      following the one being read so that sequential reads do not
+**      wait for decompression.
+**
+**      Chunks are compressed with a byte oriented LZ77 code in the style
+**      of LZ4, which needs no external library. Conversion to and from
+**      plain TAP images is done by the tapeconv utility.
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License version 3 as
+**  published by the Free Software Foundation.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License version 3 for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  version 3 along with this program in file "license-gpl-3.0.txt".
+**  If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+**
+**--------------------------------------------------------------------------
+*/
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+/*
+**  Images may exceed 2 GiB, so 32 bit builds need 64 bit file offsets.
+*/
+#if !defined(_WIN32)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+/*
+**  -------------
+**  Include Files
+**  -------------
+*/
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "types.h"
+#include "proto.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sys/types.h>
+#endif
+
+/*
+**  -----------------
+**  Private Constants
+**  -----------------
+*/
+
+/*
+**  Image layout. The header is followed by the compressed chunks and
+**  the index, which holds an entry for each chunk.
+*/
+#define TapeImageMagic          "DtCTap01"
+#define TapeImageHeaderSize     32
+#define TapeImageEntrySize      16
+#define TapeImageChunkSize      (256 * 1024)
+#define TapeImageMaxChunkSize   (16 * 1024 * 1024)
+
+/*
+**  Number of expanded chunks kept per open image: the one being read,
+**  the next one and the previous one for backward reads.
+*/
+#define TapeImageSlots          3
+
+/*
+**  Chunk slot states.
+*/
+#define ChunkEmpty              0
+#define ChunkPending            1
+#define ChunkValid              2
+#define ChunkFailed             3
+
+/*
+**  LZ77 code parameters.
+*/
+#define LzHashBits              14
+#define LzMinMatch              4
+#define LzMaxOffset             65535
+
+/*
+**  -----------------------
+**  Private Macro Functions
+**  -----------------------
+*/
+#define LzRead32(p)             ((u32)(p)[0] | ((u32)(p)[1] << 8) | ((u32)(p)[2] << 16) | ((u32)(p)[3] << 24))
+#define LzHash(v)               (((v) * 2654435761U) >> (32 - LzHashBits))
+
+#if defined(_WIN32)
+#define TapeImageSeek(fcb, offset)  _fseeki64((fcb), (__int64)(offset), SEEK_SET)
+#else
+#define TapeImageSeek(fcb, offset)  fseeko((fcb), (off_t)(offset), SEEK_SET)
+#endif
+
+/*
+**  -----------------------------------------
+**  Private Typedef and Structure Definitions
+**  -----------------------------------------
+*/
+typedef struct tapeChunkEntry
+    {
+    u64 offset;                         /* image offset of compressed chunk */
+    u32 compressedLen;                  /* equal to rawLen if stored */
+    u32 rawLen;
+    } TapeChunkEntry;
+
+#if !defined(_WIN32)
+typedef struct tapeChunk
+    {
+    u8  *data;                          /* expanded chunk */
+    u32 chunkNo;
+    u32 lastUse;                        /* for least recently used replacement */
+    u8  state;                          /* ChunkEmpty, ChunkPending, ... */
+    } TapeChunk;
+
+typedef struct tapeImage
+    {
+    FILE            *fcb;               /* compressed image */
+    u32             chunkSize;
+    u32             chunkCount;
+    u64             rawSize;
+    u64             position;           /* offset in expanded TAP data */
+    TapeChunkEntry  *index;
+    u8              *compressed;        /* compressed chunk being expanded */
+    TapeChunk       chunks[TapeImageSlots];
+    u32             useCount;
+    bool            isStopping;
+    pthread_t       thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t  requestCond;        /* signals the helper thread */
+    pthread_cond_t  doneCond;           /* signals the reader */
+    } TapeImage;
+#endif
+
+/*
+**  ---------------------------
+**  Private Function Prototypes
+**  ---------------------------
+*/
+static u32  tapeImageCompressChunk(u8 *src, u32 srcLen, u8 *dst, u32 dstCap);
+static bool tapeImageExpandChunk(u8 *src, u32 srcLen, u8 *dst, u32 dstLen);
+static void tapeImagePut32(u8 *p, u32 value);
+static void tapeImagePut64(u8 *p, u64 value);
+static u32  tapeImageGet32(u8 *p);
+static u64  tapeImageGet64(u8 *p);
+static TapeChunkEntry *tapeImageReadIndex(FILE *fcb, u32 *chunkSize, u32 *chunkCount, u64 *rawSize);
+
+#if !defined(_WIN32)
+static int      tapeImageClose(void *cookie);
+static TapeChunk *tapeImageGetChunk(TapeImage *ip, u32 chunkNo);
+static i64      tapeImageRead(TapeImage *ip, char *buf, i64 size);
+static TapeChunk *tapeImageRequest(TapeImage *ip, u32 chunkNo);
+static i64      tapeImageSeek(TapeImage *ip, i64 offset, int whence);
+static void     *tapeImageThread(void *param);
+
+#if defined(__linux__)
+static ssize_t tapeImageCookieRead(void *cookie, char *buf, size_t size);
+static int     tapeImageCookieSeek(void *cookie, off64_t *offset, int whence);
+#else
+static int    tapeImageCookieRead(void *cookie, char *buf, int size);
+static fpos_t tapeImageCookieSeek(void *cookie, fpos_t offset, int whence);
+#endif
+#endif
+
+/*
+**  ----------------
+**  Public Variables
+**  ----------------
+*/
+
+/*
+**  -----------------
+**  Private Variables
+**  -----------------
+*/
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Public Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Convert a plain TAP image to a compressed image.
+**
+**  Parameters:     Name        Description.
+**                  in          plain TAP image
+**                  out         compressed image, positioned at its start
+**
+**  Returns:        TRUE if successful.
+**
+**------------------------------------------------------------------------*/
+bool tapeImageCompress(FILE *in, FILE *out)
+    {
+    u32            chunkCount;
+    u8             *compressed;
+    u32            compressedLen;
+    TapeChunkEntry *ep;
+    TapeChunkEntry *index;
+    u32            indexSize;
+    u8             header[TapeImageHeaderSize];
+    u8             entry[TapeImageEntrySize];
+    u64            offset;
+    u8             *raw;
+    u32            rawLen;
+    u64            rawSize;
+    bool           result;
+
+    raw        = (u8 *)malloc(TapeImageChunkSize);
+    compressed = (u8 *)malloc(TapeImageChunkSize);
+    indexSize  = 64;
+    index      = (TapeChunkEntry *)malloc(indexSize * sizeof(TapeChunkEntry));
+    result     = FALSE;
+    if ((raw == NULL) || (compressed == NULL) || (index == NULL))
+        {
+        goto done;
+        }
+
+    /*
+    **  Reserve space for the header, which is written once the index
+    **  location is known.
+    */
+    memset(header, 0, sizeof(header));
+    if (fwrite(header, 1, sizeof(header), out) != sizeof(header))
+        {
+        goto done;
+        }
+
+    offset     = TapeImageHeaderSize;
+    rawSize    = 0;
+    chunkCount = 0;
+    while ((rawLen = (u32)fread(raw, 1, TapeImageChunkSize, in)) > 0)
+        {
+        if (chunkCount >= indexSize)
+            {
+            indexSize *= 2;
+            ep         = (TapeChunkEntry *)realloc(index, indexSize * sizeof(TapeChunkEntry));
+            if (ep == NULL)
+                {
+                goto done;
+                }
+            index = ep;
+            }
+
+        /*
+        **  Chunks which do not shrink are stored as they are.
+        */
+        compressedLen = tapeImageCompressChunk(raw, rawLen, compressed, rawLen - 1);
+        ep            = &index[chunkCount++];
+        ep->offset    = offset;
+        ep->rawLen    = rawLen;
+        if (compressedLen == 0)
+            {
+            ep->compressedLen = rawLen;
+            if (fwrite(raw, 1, rawLen, out) != rawLen)
+                {
+                goto done;
+                }
+            }
+        else
+            {
+            ep->compressedLen = compressedLen;
+            if (fwrite(compressed, 1, compressedLen, out) != compressedLen)
+                {
+                goto done;
+                }
+            }
+        offset  += ep->compressedLen;
+        rawSize += rawLen;
+        }
+
+    if (ferror(in))
+        {
+        goto done;
+        }
+
+    for (ep = index; ep < index + chunkCount; ep++)
+        {
+        tapeImagePut64(entry, ep->offset);
+        tapeImagePut32(entry + 8, ep->compressedLen);
+        tapeImagePut32(entry + 12, ep->rawLen);
+        if (fwrite(entry, 1, sizeof(entry), out) != sizeof(entry))
+            {
+            goto done;
+            }
+        }
+
+    memcpy(header, TapeImageMagic, 8);
+    tapeImagePut32(header + 8, TapeImageChunkSize);
+    tapeImagePut32(header + 12, chunkCount);
+    tapeImagePut64(header + 16, rawSize);
+    tapeImagePut64(header + 24, offset);
+    if ((fseek(out, 0, SEEK_SET) == 0) && (fwrite(header, 1, sizeof(header), out) == sizeof(header)))
+        {
+        result = fflush(out) == 0;
+        }
+
+done:
+    free(raw);
+    free(compressed);
+    free(index);
+
+    return result;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Convert a compressed image to a plain TAP image.
+**
+**  Parameters:     Name        Description.
+**                  in          compressed image
+**                  out         plain TAP image
+**
+**  Returns:        TRUE if successful.
+**
+**------------------------------------------------------------------------*/
+bool tapeImageExpand(FILE *in, FILE *out)
+    {
+    u32            chunkCount;
+    u32            chunkSize;
+    u8             *compressed;
+    TapeChunkEntry *ep;
+    TapeChunkEntry *index;
+    u8             *raw;
+    u64            rawSize;
+    bool           result;
+
+    index = tapeImageReadIndex(in, &chunkSize, &chunkCount, &rawSize);
+    if (index == NULL)
+        {
+        return FALSE;
+        }
+
+    raw        = (u8 *)malloc(chunkSize);
+    compressed = (u8 *)malloc(chunkSize);
+    result     = (raw != NULL) && (compressed != NULL);
+    for (ep = index; result && ep < index + chunkCount; ep++)
+        {
+        result = (TapeImageSeek(in, ep->offset) == 0)
+                 && (fread(compressed, 1, ep->compressedLen, in) == ep->compressedLen);
+        if (result && (ep->compressedLen != ep->rawLen))
+            {
+            result = tapeImageExpandChunk(compressed, ep->compressedLen, raw, ep->rawLen);
+            }
+        if (result)
+            {
+            result = fwrite(ep->compressedLen == ep->rawLen ? compressed : raw, 1, ep->rawLen, out) == ep->rawLen;
+            }
+        }
+
+    free(raw);
+    free(compressed);
+    free(index);
+
+    return result && (fflush(out) == 0);
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Open a tape image. Plain TAP images are opened in the
+**                  requested mode, compressed images are opened read
+**                  only and expanded as they are read.
+**
+**  Parameters:     Name        Description.
+**                  fileName    image file
+**                  mode        fopen mode
+**
+**  Returns:        Stream open on the TAP data, NULL on failure with
+**                  errno set to EROFS if a compressed image was opened
+**                  for writing.
+**
+**------------------------------------------------------------------------*/
+FILE *tapeImageOpen(char *fileName, char *mode)
+    {
+    FILE      *fcb;
+    u8        magic[8];
+#if !defined(_WIN32)
+    int       i;
+    TapeImage *ip;
+    FILE      *stream;
+#endif
+#if defined(__linux__)
+    cookie_io_functions_t funcs;
+#endif
+
+    fcb = fopen(fileName, mode);
+    if (fcb == NULL)
+        {
+        return NULL;
+        }
+
+    if ((fread(magic, 1, sizeof(magic), fcb) != sizeof(magic)) || (memcmp(magic, TapeImageMagic, 8) != 0))
+        {
+        rewind(fcb);
+
+        return fcb;
+        }
+
+    if (strpbrk(mode, "w+a") != NULL)
+        {
+        logDtError(LogErrorLocation, "Compressed tape image %s can only be mounted read only\n", fileName);
+        fclose(fcb);
+        errno = EROFS;
+
+        return NULL;
+        }
+
+#if defined(_WIN32)
+    logDtError(LogErrorLocation, "Compressed tape images are not supported on Windows\n");
+    fclose(fcb);
+
+    return NULL;
+
+#else
+    ip = (TapeImage *)calloc(1, sizeof(TapeImage));
+    if (ip == NULL)
+        {
+        fclose(fcb);
+
+        return NULL;
+        }
+    ip->fcb   = fcb;
+    ip->index = tapeImageReadIndex(fcb, &ip->chunkSize, &ip->chunkCount, &ip->rawSize);
+    if (ip->index == NULL)
+        {
+        logDtError(LogErrorLocation, "Invalid compressed tape image %s\n", fileName);
+        fclose(fcb);
+        free(ip);
+
+        return NULL;
+        }
+
+    ip->compressed = (u8 *)malloc(ip->chunkSize);
+    for (i = 0; i < TapeImageSlots; i++)
+        {
+        ip->chunks[i].data = (u8 *)malloc(ip->chunkSize);
+        if (ip->chunks[i].data == NULL)
+            {
+            ip->compressed = NULL;
+            }
+        }
+    if (ip->compressed == NULL)
+        {
+        logDtError(LogErrorLocation, "Failed to allocate buffers for compressed tape image %s\n", fileName);
+        exit(1);
+        }
+
+    pthread_mutex_init(&ip->mutex, NULL);
+    pthread_cond_init(&ip->requestCond, NULL);
+    pthread_cond_init(&ip->doneCond, NULL);
+    if (pthread_create(&ip->thread, NULL, tapeImageThread, ip) != 0)
+        {
+        logDtError(LogErrorLocation, "Failed to create tape image thread\n");
+        exit(1);
+        }
+
+#if defined(__linux__)
+    funcs.read  = tapeImageCookieRead;
+    funcs.write = NULL;
+    funcs.seek  = tapeImageCookieSeek;
+    funcs.close = tapeImageClose;
+    stream      = fopencookie(ip, "rb", funcs);
+#else
+    stream = funopen(ip, tapeImageCookieRead, NULL, tapeImageCookieSeek, tapeImageClose);
+#endif
+    if (stream == NULL)
+        {
+        tapeImageClose(ip);
+        }
+
+    return stream;
+#endif
+    }
+
+/*
+ **--------------------------------------------------------------------------
+ **
+ **  Private Functions
+ **
+ **--------------------------------------------------------------------------
+ */
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Compress a chunk.
+**
+**  Parameters:     Name        Description.
+**                  src         data to compress
+**                  srcLen      length of data
+**                  dst         buffer receiving the compressed data
+**                  dstCap      size of buffer
+**
+**  Returns:        Compressed length, 0 if it would exceed dstCap.
+**
+**------------------------------------------------------------------------*/
+static u32 tapeImageCompressChunk(u8 *src, u32 srcLen, u8 *dst, u32 dstCap)
+    {
+    static u32 table[1 << LzHashBits];
+    u32        anchor;
+    u32        h;
+    u32        len;
+    u32        literals;
+    u32        matchLen;
+    u32        op;
+    u32        pos;
+    u32        ref;
+    u8         *token;
+
+    memset(table, 0, sizeof(table));
+    anchor = 0;
+    op     = 0;
+    pos    = 0;
+
+    for (;;)
+        {
+        /*
+        **  Find the next match, or the end of the input.
+        */
+        matchLen = 0;
+        ref      = 0;
+        while (pos + LzMinMatch <= srcLen)
+            {
+            h        = LzHash(LzRead32(src + pos));
+            ref      = table[h];
+            table[h] = pos + 1;
+            if ((ref != 0) && (pos + 1 - ref <= LzMaxOffset) && (LzRead32(src + ref - 1) == LzRead32(src + pos)))
+                {
+                ref     -= 1;
+                matchLen = LzMinMatch;
+                while ((pos + matchLen < srcLen) && (src[ref + matchLen] == src[pos + matchLen]))
+                    {
+                    matchLen += 1;
+                    }
+                break;
+                }
+            pos += 1;
+            }
+        if (matchLen == 0)
+            {
+            pos = srcLen;
+            }
+
+        /*
+        **  Emit the token and the literals which precede the match.
+        */
+        literals = pos - anchor;
+        if (op + 1 + (literals / 255) + 1 + literals + 2 + ((matchLen / 255) + 1) > dstCap)
+            {
+            return 0;
+            }
+        token = &dst[op++];
+        if (literals >= 15)
+            {
+            *token = 15 << 4;
+            for (len = literals - 15; len >= 255; len -= 255)
+                {
+                dst[op++] = 255;
+                }
+            dst[op++] = (u8)len;
+            }
+        else
+            {
+            *token = (u8)(literals << 4);
+            }
+        memcpy(dst + op, src + anchor, literals);
+        op += literals;
+
+        /*
+        **  The last sequence has literals only.
+        */
+        if (matchLen == 0)
+            {
+            return op;
+            }
+
+        dst[op++] = (u8)((pos - ref) & 0xFF);
+        dst[op++] = (u8)((pos - ref) >> 8);
+        if (matchLen - LzMinMatch >= 15)
+            {
+            *token |= 15;
+            for (len = matchLen - LzMinMatch - 15; len >= 255; len -= 255)
+                {
+                dst[op++] = 255;
+                }
+            dst[op++] = (u8)len;
+            }
+        else
+            {
+            *token |= (u8)(matchLen - LzMinMatch);
+            }
+
+        pos   += matchLen;
+        anchor = pos;
+        }
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Expand a compressed chunk.
+**
+**  Parameters:     Name        Description.
+**                  src         compressed data
+**                  srcLen      length of compressed data
+**                  dst         buffer receiving the expanded data
+**                  dstLen      expected expanded length
+**
+**  Returns:        TRUE if the chunk is intact.
+**
+**------------------------------------------------------------------------*/
+static bool tapeImageExpandChunk(u8 *src, u32 srcLen, u8 *dst, u32 dstLen)
+    {
+    u32 b;
+    u32 ip;
+    u32 len;
+    u32 offset;
+    u32 op;
+    u8  token;
+
+    ip = 0;
+    op = 0;
+    while (ip < srcLen)
+        {
+        token = src[ip++];
+
+        /*
+        **  Copy the literals.
+        */
+        len = token >> 4;
+        if (len == 15)
+            {
+            do
+                {
+                if (ip >= srcLen)
+                    {
+                    return FALSE;
+                    }
+                b    = src[ip++];
+                len += b;
+                } while (b == 255);
+            }
+        if ((len > srcLen - ip) || (len > dstLen - op))
+            {
+            return FALSE;
+            }
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+        if (ip == srcLen)
+            {
+            break;
+            }
+
+        /*
+        **  Copy the match, which may overlap its own output.
+        */
+        if (ip + 2 > srcLen)
+            {
+            return FALSE;
+            }
+        offset = src[ip] | (src[ip + 1] << 8);
+        ip    += 2;
+        if ((offset == 0) || (offset > op))
+            {
+            return FALSE;
+            }
+        len = token & 15;
+        if (len == 15)
+            {
+            do
+                {
+                if (ip >= srcLen)
+                    {
+                    return FALSE;
+                    }
+                b    = src[ip++];
+                len += b;
+                } while (b == 255);
+            }
+        len += LzMinMatch;
+        if (len > dstLen - op)
+            {
+            return FALSE;
+            }
+        while (len-- > 0)
+            {
+            dst[op] = dst[op - offset];
+            op     += 1;
+            }
+        }
+
+    return op == dstLen;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Read the header and index of a compressed image.
+**
+**  Parameters:     Name        Description.
+**                  fcb         compressed image
+**                  chunkSize   returns expanded chunk size
+**                  chunkCount  returns number of chunks
+**                  rawSize     returns expanded image size
+**
+**  Returns:        Index, NULL if the image is invalid.
+**
+**------------------------------------------------------------------------*/
+static TapeChunkEntry *tapeImageReadIndex(FILE *fcb, u32 *chunkSize, u32 *chunkCount, u64 *rawSize)
+    {
+    u8             entry[TapeImageEntrySize];
+    TapeChunkEntry *ep;
+    u64            fileSize;
+    u8             header[TapeImageHeaderSize];
+    TapeChunkEntry *index;
+    u64            indexOffset;
+    u64            total;
+
+    if ((fseek(fcb, 0, SEEK_SET) != 0)
+        || (fread(header, 1, sizeof(header), fcb) != sizeof(header))
+        || (memcmp(header, TapeImageMagic, 8) != 0))
+        {
+        return NULL;
+        }
+    *chunkSize  = tapeImageGet32(header + 8);
+    *chunkCount = tapeImageGet32(header + 12);
+    *rawSize    = tapeImageGet64(header + 16);
+    indexOffset = tapeImageGet64(header + 24);
+    if ((*chunkSize == 0) || (*chunkSize > TapeImageMaxChunkSize))
+        {
+        return NULL;
+        }
+
+    /*
+    **  Only the last chunk may be short, and the index must fit in the
+    **  file, which bounds the index allocation.
+    */
+    if ((u64)*chunkCount != (*rawSize / *chunkSize) + ((*rawSize % *chunkSize) != 0))
+        {
+        return NULL;
+        }
+#if defined(_WIN32)
+    if (_fseeki64(fcb, 0, SEEK_END) != 0)
+        {
+        return NULL;
+        }
+    fileSize = (u64)_ftelli64(fcb);
+#else
+    if (fseeko(fcb, 0, SEEK_END) != 0)
+        {
+        return NULL;
+        }
+    fileSize = (u64)ftello(fcb);
+#endif
+    if ((indexOffset > fileSize)
+        || ((u64)*chunkCount > (fileSize - indexOffset) / TapeImageEntrySize)
+        || (TapeImageSeek(fcb, indexOffset) != 0))
+        {
+        return NULL;
+        }
+
+    index = (TapeChunkEntry *)calloc((size_t)*chunkCount + 1, sizeof(TapeChunkEntry));
+    if (index == NULL)
+        {
+        return NULL;
+        }
+
+    total = 0;
+    for (ep = index; ep < index + *chunkCount; ep++)
+        {
+        if (fread(entry, 1, sizeof(entry), fcb) != sizeof(entry))
+            {
+            free(index);
+
+            return NULL;
+            }
+        ep->offset        = tapeImageGet64(entry);
+        ep->compressedLen = tapeImageGet32(entry + 8);
+        ep->rawLen        = tapeImageGet32(entry + 12);
+        if ((ep->rawLen > *chunkSize) || (ep->compressedLen > ep->rawLen)
+            || ((ep->rawLen < *chunkSize) && (ep < index + *chunkCount - 1)))
+            {
+            free(index);
+
+            return NULL;
+            }
+        total += ep->rawLen;
+        }
+
+    if (total != *rawSize)
+        {
+        free(index);
+
+        return NULL;
+        }
+
+    return index;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Store and fetch little endian integers.
+**
+**  Parameters:     Name        Description.
+**                  p           pointer to integer bytes
+**                  value       value to store
+**
+**  Returns:        Value fetched.
+**
+**------------------------------------------------------------------------*/
+static void tapeImagePut32(u8 *p, u32 value)
+    {
+    p[0] = (u8)(value >> 0);
+    p[1] = (u8)(value >> 8);
+    p[2] = (u8)(value >> 16);
+    p[3] = (u8)(value >> 24);
+    }
+
+static void tapeImagePut64(u8 *p, u64 value)
+    {
+    tapeImagePut32(p, (u32)value);
+    tapeImagePut32(p + 4, (u32)(value >> 32));
+    }
+
+static u32 tapeImageGet32(u8 *p)
+    {
+    return LzRead32(p);
+    }
+
+static u64 tapeImageGet64(u8 *p)
+    {
+    return (u64)tapeImageGet32(p) | ((u64)tapeImageGet32(p + 4) << 32);
+    }
+
+#if !defined(_WIN32)
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Close a compressed image stream.
+**
+**  Parameters:     Name        Description.
+**                  cookie      image
+**
+**  Returns:        0.
+**
+**------------------------------------------------------------------------*/
+static int tapeImageClose(void *cookie)
+    {
+    int       i;
+    TapeImage *ip = (TapeImage *)cookie;
+
+    pthread_mutex_lock(&ip->mutex);
+    ip->isStopping = TRUE;
+    pthread_cond_signal(&ip->requestCond);
+    pthread_mutex_unlock(&ip->mutex);
+    pthread_join(ip->thread, NULL);
+
+    pthread_mutex_destroy(&ip->mutex);
+    pthread_cond_destroy(&ip->requestCond);
+    pthread_cond_destroy(&ip->doneCond);
+    fclose(ip->fcb);
+    for (i = 0; i < TapeImageSlots; i++)
+        {
+        free(ip->chunks[i].data);
+        }
+    free(ip->compressed);
+    free(ip->index);
+    free(ip);
+
+    return 0;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Get an expanded chunk, waiting for the helper thread
+**                  if necessary, and ask for the following chunk to be
+**                  expanded ahead of the reader.
+**
+**  Parameters:     Name        Description.
+**                  ip          image
+**                  chunkNo     chunk number
+**
+**  Returns:        Chunk, NULL if it could not be read.
+**
+**------------------------------------------------------------------------*/
+static TapeChunk *tapeImageGetChunk(TapeImage *ip, u32 chunkNo)
+    {
+    TapeChunk *cp;
+
+    pthread_mutex_lock(&ip->mutex);
+    cp = tapeImageRequest(ip, chunkNo);
+    if ((cp != NULL) && (chunkNo + 1 < ip->chunkCount))
+        {
+        tapeImageRequest(ip, chunkNo + 1);
+        }
+    while ((cp != NULL) && (cp->state == ChunkPending))
+        {
+        pthread_cond_wait(&ip->doneCond, &ip->mutex);
+        }
+    if ((cp != NULL) && (cp->state != ChunkValid))
+        {
+        cp = NULL;
+        }
+    pthread_mutex_unlock(&ip->mutex);
+
+    return cp;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Read expanded TAP data.
+**
+**  Parameters:     Name        Description.
+**                  ip          image
+**                  buf         buffer receiving the data
+**                  size        number of bytes requested
+**
+**  Returns:        Number of bytes read, -1 on error.
+**
+**------------------------------------------------------------------------*/
+static i64 tapeImageRead(TapeImage *ip, char *buf, i64 size)
+    {
+    TapeChunk *cp;
+    i64       count;
+    u32       len;
+    u32       offset;
+
+    count = 0;
+    while ((count < size) && (ip->position < ip->rawSize))
+        {
+        cp = tapeImageGetChunk(ip, (u32)(ip->position / ip->chunkSize));
+        if (cp == NULL)
+            {
+            errno = EIO;
+
+            return -1;
+            }
+        offset = (u32)(ip->position % ip->chunkSize);
+        len    = ip->index[cp->chunkNo].rawLen - offset;
+        if (len > size - count)
+            {
+            len = (u32)(size - count);
+            }
+        memcpy(buf + count, cp->data + offset, len);
+        count        += len;
+        ip->position += len;
+        }
+
+    return count;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Find the slot of a chunk, or queue the chunk to be
+**                  expanded into the least recently used slot. Called
+**                  with the image mutex held.
+**
+**  Parameters:     Name        Description.
+**                  ip          image
+**                  chunkNo     chunk number
+**
+**  Returns:        Chunk slot, NULL if all slots are busy.
+**
+**------------------------------------------------------------------------*/
+static TapeChunk *tapeImageRequest(TapeImage *ip, u32 chunkNo)
+    {
+    TapeChunk *cp;
+    int       i;
+    TapeChunk *victim;
+
+    victim = NULL;
+    for (i = 0; i < TapeImageSlots; i++)
+        {
+        cp = &ip->chunks[i];
+        if ((cp->state != ChunkEmpty) && (cp->chunkNo == chunkNo))
+            {
+            cp->lastUse = ++ip->useCount;
+
+            return cp;
+            }
+        if ((cp->state != ChunkPending) && ((victim == NULL) || (cp->lastUse < victim->lastUse)))
+            {
+            victim = cp;
+            }
+        }
+
+    if (victim != NULL)
+        {
+        victim->chunkNo = chunkNo;
+        victim->state   = ChunkPending;
+        victim->lastUse = ++ip->useCount;
+        pthread_cond_signal(&ip->requestCond);
+        }
+
+    return victim;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Reposition a compressed image stream.
+**
+**  Parameters:     Name        Description.
+**                  ip          image
+**                  offset      offset
+**                  whence      SEEK_SET, SEEK_CUR or SEEK_END
+**
+**  Returns:        New position, -1 on error.
+**
+**------------------------------------------------------------------------*/
+static i64 tapeImageSeek(TapeImage *ip, i64 offset, int whence)
+    {
+    switch (whence)
+        {
+    case SEEK_SET:
+        break;
+
+    case SEEK_CUR:
+        offset += (i64)ip->position;
+        break;
+
+    case SEEK_END:
+        offset += (i64)ip->rawSize;
+        break;
+
+    default:
+        errno = EINVAL;
+
+        return -1;
+        }
+
+    if (offset < 0)
+        {
+        errno = EINVAL;
+
+        return -1;
+        }
+    ip->position = (u64)offset;
+
+    return offset;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Helper thread. Expands requested chunks, oldest
+**                  request first.
+**
+**  Parameters:     Name        Description.
+**                  param       image
+**
+**  Returns:        Nothing.
+**
+**------------------------------------------------------------------------*/
+static void *tapeImageThread(void *param)
+    {
+    TapeChunk      *cp;
+    TapeChunkEntry *ep;
+    int            i;
+    TapeImage      *ip = (TapeImage *)param;
+    bool           isValid;
+
+    pthread_mutex_lock(&ip->mutex);
+    for (;;)
+        {
+        cp = NULL;
+        for (i = 0; i < TapeImageSlots; i++)
+            {
+            if ((ip->chunks[i].state == ChunkPending) && ((cp == NULL) || (ip->chunks[i].lastUse < cp->lastUse)))
+                {
+                cp = &ip->chunks[i];
+                }
+            }
+        if (ip->isStopping)
+            {
+            break;
+            }
+        if (cp == NULL)
+            {
+            pthread_cond_wait(&ip->requestCond, &ip->mutex);
+            continue;
+            }
+        pthread_mutex_unlock(&ip->mutex);
+
+        /*
+        **  The reader does not touch a pending slot, so it is filled
+        **  without holding the mutex.
+        */
+        ep      = &ip->index[cp->chunkNo];
+        isValid = (TapeImageSeek(ip->fcb, ep->offset) == 0);
+        if (ep->compressedLen == ep->rawLen)
+            {
+            isValid = isValid && (fread(cp->data, 1, ep->rawLen, ip->fcb) == ep->rawLen);
+            }
+        else
+            {
+            isValid = isValid && (fread(ip->compressed, 1, ep->compressedLen, ip->fcb) == ep->compressedLen)
+                      && tapeImageExpandChunk(ip->compressed, ep->compressedLen, cp->data, ep->rawLen);
+            }
+
+        pthread_mutex_lock(&ip->mutex);
+        cp->state = isValid ? ChunkValid : ChunkFailed;
+        pthread_cond_broadcast(&ip->doneCond);
+        }
+    pthread_mutex_unlock(&ip->mutex);
+
+    return NULL;
+    }
+
+/*--------------------------------------------------------------------------
+**  Purpose:        Stream callbacks for fopencookie (Linux) and funopen
+**                  (BSD and macOS).
+**
+**  Parameters:     Name        Description.
+**                  cookie      image
+**                  buf         buffer receiving the data
+**                  size        number of bytes requested
+**                  offset      seek offset
+**                  whence      seek origin
+**
+**  Returns:        As required by the stream library.
+**
+**------------------------------------------------------------------------*/
+#if defined(__linux__)
+static ssize_t tapeImageCookieRead(void *cookie, char *buf, size_t size)
+    {
+    return (ssize_t)tapeImageRead((TapeImage *)cookie, buf, (i64)size);
+    }
+
+static int tapeImageCookieSeek(void *cookie, off64_t *offset, int whence)
+    {
+    i64 result;
+
+    result = tapeImageSeek((TapeImage *)cookie, (i64)*offset, whence);
+    if (result < 0)
+        {
+        return -1;
+        }
+    *offset = (off64_t)result;
+
+    return 0;
+    }
+
+#else
+static int tapeImageCookieRead(void *cookie, char *buf, int size)
+    {
+    return (int)tapeImageRead((TapeImage *)cookie, buf, (i64)size);
+    }
+
+static fpos_t tapeImageCookieSeek(void *cookie, fpos_t offset, int whence)
+    {
+    return (fpos_t)tapeImageSeek((TapeImage *)cookie, (i64)offset, whence);
+    }
+
+#endif
+#endif
+
+/*---------------------------  End Of File  ------------------------------*/
@@ -67,6 +67,27 @@ u64 getMilliseconds(void)
 #endif
     }
 
+/*--------------------------------------------------------------------------
+**  Purpose:        Returns the current system microsecond clock value.
+**
+**  Parameters:     Name        Description.
+**
+**  Returns:        Current microsecond clock value.
+**
+**------------------------------------------------------------------------*/
+u64 getMicroseconds(void)
+    {
+#if defined(_WIN32)
+    return getMilliseconds() * (u64)1000;
+#else
+    struct timeval tod;
+
+    gettimeofday(&tod, NULL);
+
+    return ((u64)tod.tv_sec * (u64)1000000) + (u64)tod.tv_usec;
+#endif
+    }
+
 /*--------------------------------------------------------------------------
 **  Purpose:        Returns the current system second clock value.
 **
@@ -244,18 +244,20 @@
 */
 typedef struct portParam
     {
-    u8     id;
-    bool   active;
-    int    connFd;
-    int    listenFd;
-    int    listenPort;
-    PpWord status;
-    int    inInIdx;
-    int    inOutIdx;
-    u8     inBuffer[InBufSize];
-    int    outInIdx;
-    int    outOutIdx;
-    u8     outBuffer[OutBufSize];
+    u8           id;
+    bool         active;
+    int          connFd;
+    NetPollEntry poll;
+    int          listenFd;
+    NetPollEntry listenPoll;
+    int          listenPort;
+    PpWord       status;
+    int          inInIdx;
+    int          inOutIdx;
+    u8           inBuffer[InBufSize];
+    int          outInIdx;
+    int          outOutIdx;
+    u8           outBuffer[OutBufSize];
     } PortParam;
 
 /*
@@ -406,6 +408,7 @@ void tpMuxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *params)
         logDtError(LogErrorLocation, "Can't listen on port %d\n", portVector[0].listenPort);
         exit(1);
         }
+    netPollAdd(&portVector[0].listenPoll, portVector[0].listenFd, NetPollIn);
     if (portVector[0].listenPort != portVector[1].listenPort)
         {
         portVector[1].listenFd = (int)netCreateListener(portVector[1].listenPort);
@@ -418,6 +421,7 @@ void tpMuxInit(u8 eqNo, u8 unitNo, u8 channelNo, char *params)
             logDtError(LogErrorLocation, "Can't listen on port %d\n", portVector[1].listenPort);
             exit(1);
             }
+        netPollAdd(&portVector[1].listenPoll, portVector[1].listenFd, NetPollIn);
         }
 
     tpMuxEnabled = TRUE;
@@ -494,15 +498,12 @@ static void tpMuxCheckIo(void)
 #else
     socklen_t fromLen;
 #endif
+    u8             events;
     int            fd;
     int            i;
-    int            maxFd;
     ssize_t        n;
     int            optEnable = 1;
     PortParam      *pp;
-    fd_set         readFds;
-    struct timeval timeout;
-    fd_set         writeFds;
 
     ioTurns = (ioTurns + 1) % IoTurnsPerPoll;
     if (ioTurns != 0)
@@ -510,59 +511,26 @@ static void tpMuxCheckIo(void)
         return;
         }
 
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-    maxFd = 0;
-
+    /*
+    **  Declare what each port is ready for and act on the readiness found
+    **  by the network poller.
+    */
     for (i = 0, pp = portVector; i < 2; i++, pp++)
         {
-        if (pp->listenFd != 0)
-            {
-            FD_SET(pp->listenFd, &readFds);
-            if (pp->listenFd > maxFd)
-                {
-                maxFd = pp->listenFd;
-                }
-            }
         if (pp->active)
             {
+            events = 0;
             if (pp->inInIdx < InBufSize)
                 {
-                FD_SET(pp->connFd, &readFds);
-                if (pp->connFd > maxFd)
-                    {
-                    maxFd = pp->connFd;
-                    }
+                events |= NetPollIn;
                 }
             if (pp->outInIdx > pp->outOutIdx)
                 {
-                FD_SET(pp->connFd, &writeFds);
-                if (pp->connFd > maxFd)
-                    {
-                    maxFd = pp->connFd;
-                    }
+                events |= NetPollOut;
                 }
-            }
-        }
+            netPollWant(&pp->poll, events);
 
-    if (maxFd < 1)
-        {
-        return;
-        }
-
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 0;
-    n = select(maxFd + 1, &readFds, &writeFds, NULL, &timeout);
-    if (n < 1)
-        {
-        return;
-        }
-
-    for (i = 0, pp = portVector; i < 2; i++, pp++)
-        {
-        if (pp->active)
-            {
-            if (FD_ISSET(pp->connFd, &readFds))
+            if (netPollTake(&pp->poll, NetPollIn))
                 {
                 n = recv(pp->connFd, &pp->inBuffer[pp->inInIdx], InBufSize - pp->inInIdx, 0);
                 if (n > 0)
@@ -571,11 +539,12 @@ static void tpMuxCheckIo(void)
                     }
                 else
                     {
+                    netPollRemove(&pp->poll);
                     netCloseConnection(pp->connFd);
                     pp->active = FALSE;
                     }
                 }
-            if (FD_ISSET(pp->connFd, &writeFds) && (pp->outOutIdx < pp->outInIdx))
+            if (netPollTake(&pp->poll, NetPollOut) && (pp->outOutIdx < pp->outInIdx))
                 {
                 n = send(pp->connFd, &pp->outBuffer[pp->outOutIdx], pp->outInIdx - pp->outOutIdx, 0);
                 if (n >= 0)
@@ -589,7 +558,7 @@ static void tpMuxCheckIo(void)
                     }
                 }
             }
-        if ((pp->listenFd != 0) && FD_ISSET(pp->listenFd, &readFds))
+        if ((pp->listenFd != 0) && netPollTake(&pp->listenPoll, NetPollIn))
             {
             fromLen = sizeof(from);
             fd      = (int)accept(pp->listenFd, (struct sockaddr *)&from, &fromLen);
@@ -620,6 +589,7 @@ static void tpMuxCheckIo(void)
                 {
                 availablePort->active    = TRUE;
                 availablePort->connFd    = fd;
+                netPollAdd(&availablePort->poll, fd, 0);
                 availablePort->inInIdx   = 0;
                 availablePort->inOutIdx  = 0;
                 availablePort->outInIdx  = 0;
@@ -182,24 +182,63 @@ typedef struct devSlot
     i8             selectedUnit;        /* selected unit */
     } DevSlot;
 
+/*
+**  Medium opened on the operator thread by load_disk or load_tape and
+**  waiting to be installed on its unit by the emulation thread.
+*/
+typedef struct mediaMount
+    {
+    void           (*install)(struct mediaMount *mp); /* installs medium on its unit */
+    DevSlot        *dp;                 /* device the unit belongs to */
+    int            unitNo;              /* unit number */
+    FILE           *fcb;                /* opened medium */
+    FILE           *auxFcb;             /* additional stream, e.g. for disk prefetch */
+    bool           ringIn;              /* tape mounted with write ring */
+    char           fileName[MaxFSPath]; /* path name of medium */
+    } MediaMount;
+
+/*
+**  Scheduled timing event.
+*/
+typedef struct schedEvent
+    {
+    u64     due;                        /* major cycle at which the event is due */
+    void    (*handler)(void *arg);      /* function called when the event is due */
+    void    *arg;                       /* argument passed to handler */
+    int     slot;                       /* position in event queue, -1 if not scheduled */
+    } SchedEvent;
+
+/*
+**  Socket registered with the network poller.
+*/
+typedef struct netPollEntry
+    {
+    u8      events;                     /* readiness of interest */
+    u8      revents;                    /* readiness found and not yet taken */
+    int     slot;                       /* position in poll table + 1, 0 if not registered */
+    } NetPollEntry;
+
 /*
 **  Channel control block.
 */
 typedef struct chSlot
     {
-    DevSlot *firstDevice;               /* linked list of devices attached to this channel */
-    DevSlot *ioDevice;                  /* device which deals with current function */
-    PpWord  data;                       /* channel data */
-    PpWord  status;                     /* channel status */
-    bool    active;                     /* channel active flag */
-    bool    full;                       /* channel full flag */
-    bool    discAfterInput;             /* disconnect channel after input flag */
-    bool    flag;                       /* optional channel flag */
-    bool    inputPending;               /* input pending flag */
-    bool    hardwired;                  /* hardwired devices */
-    u8      id;                         /* channel number */
-    u8      delayStatus;                /* time to delay change of empty/full status */
-    u8      delayDisconnect;            /* time to delay disconnect */
+    DevSlot    *firstDevice;            /* linked list of devices attached to this channel */
+    DevSlot    *ioDevice;               /* device which deals with current function */
+    PpWord     data;                    /* channel data */
+    PpWord     status;                  /* channel status */
+    bool       active;                  /* channel active flag */
+    bool       full;                    /* channel full flag */
+    bool       discAfterInput;          /* disconnect channel after input flag */
+    bool       flag;                    /* optional channel flag */
+    bool       inputPending;            /* input pending flag */
+    bool       hardwired;               /* hardwired devices */
+    u8         id;                      /* channel number */
+    u8         delayStatus;             /* time to delay change of empty/full status */
+    u8         delayDisconnect;         /* time to delay disconnect */
+    SchedEvent statusEvent;             /* ends delayStatus */
+    SchedEvent disconnectEvent;         /* ends delayDisconnect */
+    u64        wordCount;               /* PP words transferred (metrics) */
     } ChSlot;
 
 /*
@@ -225,11 +264,14 @@ typedef struct
     bool   isIdle;                      /* TRUE if PP is idled */
     bool   isDump;                      /* TRUE if PP is in dump mode */
     bool   isLoad;                      /* TRUE if PP is in load mode */
+    bool   isParked;                    /* TRUE if PP is parked in its idle loop */
+    u32    idleAddress;                 /* CM address polled by the parked idle loop */
     bool   osBoundsCheckEnabled;        /* whether OS bounds checking is enabled */
     bool   isBelowOsBound;              /* whether checking is below/above OS bound register */
     bool   isStopEnabled;               /* whether PP stop enabled on OS bounds violation */
     PpWord ioBuf[4];                    /* used by IAPM/OAPM instructions */
     u8     ioBufIdx;
+    u64    instructionCount;            /* instructions executed (metrics) */
     } PpSlot;
 
 /*
@@ -269,6 +311,7 @@ typedef struct
     bool            floatException;       /* TRUE if CPU detected float exception */
     bool            doDeadstart;          /* TRUE if deadstart requested */
     volatile u32    idleCycles;           /* Counter for how many times we've seen the idle loop */
+    u64             instructionCount;     /* instructions executed (metrics) */
 
     /*
     **  Instruction word stack.
@@ -424,6 +467,7 @@ typedef struct
 #define PR_SIT        0x04                /*   system  interval timer interrupt request */
 #define PR_PIT        0x08                /*   process interval timer interrupt request */
 #define PR_HALT       0x10                /*   halt request                             */
+    bool            isConditionPending;   /* TRUE if MCR/UCR must be examined before next instruction */
     u8              opCode;               /* Opcode field (first 8 bits) */
     u8              opI;                  /* i field of current instruction */
     u8              opJ;                  /* j field of current instruction */
@@ -447,6 +491,7 @@ typedef struct
     u32             softMemoryIndices[7]; /* soft memory image indices */
     u8              *registerFile;        /* internal register file */
     u32             registerFileIdx;      /* internal register file index */
+    u64             instructionCount;     /* instructions executed (metrics) */
     } Cpu180Context;
 
 /*
@@ -517,6 +562,47 @@ typedef enum
     ESM
     } ExtMemory;
 
+/*
+**  Performance metrics counters.
+*/
+typedef struct
+    {
+    u64 readOps;                        /* read operations (sectors, records or words) */
+    u64 writeOps;                       /* write operations (sectors, records or words) */
+    u64 bytesRead;                      /* bytes read from host storage */
+    u64 bytesWritten;                   /* bytes written to host storage */
+    } MetricsIo;
+
+typedef struct metricsUnit
+    {
+    struct metricsUnit *next;
+    u8                 devType;
+    u8                 channelNo;
+    u8                 eqNo;
+    u8                 unitNo;
+    u64                ops[MetricsIoKinds];   /* operations by kind */
+    u64                bytes[MetricsIoKinds]; /* bytes transferred to or from host storage */
+    u64                usec[MetricsIoKinds];  /* host microseconds spent */
+    u64                latency[MetricsIoKinds][MetricsLatencyBuckets]; /* bucket n counts latencies up to 2^n us */
+    u64                cacheHits;             /* reads satisfied from a prefetch cache */
+    u64                cacheMisses;           /* reads which went to host storage */
+    } MetricsUnit;
+
+typedef struct
+    {
+    u64       majorCycles;              /* emulation main loop iterations */
+    u64       idleSleeps;               /* number of idle throttle sleeps */
+    u64       idleSleepUsec;            /* microseconds spent in idle waits */
+    u64       idleWakeups;              /* idle waits ended early by an event */
+    u64       idleWakeLatencyUsec;      /* microseconds from wake events to resumption */
+    u64       ppIdleParks;              /* PPs parked in their idle loops */
+    u64       npuUplineBlocks;          /* NPU blocks sent to the host */
+    u64       npuUplineBytes;           /* NPU bytes sent to the host */
+    u64       npuDownlineBlocks;        /* NPU blocks received from the host */
+    u64       npuDownlineBytes;         /* NPU bytes received from the host */
+    MetricsIo io[MaxDevTypes];          /* disk and tape I/O by device type */
+    } Metrics;
+
 typedef enum
     {
     SwCCP = 0,